@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "core/ccl/include/ccl.hpp"
+
+namespace {
+
+using ppc::ccl::Connectivity;
+using ppc::ccl::LabelingOptions;
+
+// breadth-first search from every unlabeled foreground pixel in raster order
+std::vector<int> ReferenceLabels(const std::vector<uint8_t>& image, int rows, int cols, Connectivity connectivity) {
+  std::vector<std::pair<int, int>> steps = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+  if (connectivity != Connectivity::k4) {
+    steps.insert(steps.end(), {{-1, -1}, {1, 1}});
+  }
+  if (connectivity == Connectivity::k8) {
+    steps.insert(steps.end(), {{-1, 1}, {1, -1}});
+  }
+  std::vector<int> labels(image.size(), 0);
+  int next_label = 1;
+  for (int start = 0; start < rows * cols; ++start) {
+    if (image[start] == 0 || labels[start] != 0) {
+      continue;
+    }
+    std::queue<int> queue;
+    queue.push(start);
+    labels[start] = next_label;
+    while (!queue.empty()) {
+      int pixel = queue.front();
+      queue.pop();
+      for (auto [dr, dc] : steps) {
+        int r = (pixel / cols) + dr;
+        int c = (pixel % cols) + dc;
+        int neighbour = (r * cols) + c;
+        if (r >= 0 && r < rows && c >= 0 && c < cols && image[neighbour] != 0 && labels[neighbour] == 0) {
+          labels[neighbour] = next_label;
+          queue.push(neighbour);
+        }
+      }
+    }
+    ++next_label;
+  }
+  return labels;
+}
+
+std::vector<uint8_t> RandomImage(int rows, int cols, double density, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::bernoulli_distribution foreground(density);
+  std::vector<uint8_t> image(static_cast<size_t>(rows) * cols);
+  for (auto& pixel : image) {
+    pixel = foreground(gen) ? 1 : 0;
+  }
+  return image;
+}
+
+std::vector<int> Label(const std::vector<uint8_t>& image, int rows, int cols, Connectivity connectivity) {
+  std::vector<int> labels(image.size(), -1);
+  ppc::ccl::LabelComponents(std::span<const uint8_t>(image), rows, cols, std::span<int>(labels),
+                            {.connectivity = connectivity});
+  return labels;
+}
+
+}  // namespace
+
+TEST(ccl_tests, union_find_unites_sets) {
+  ppc::ccl::UnionFind sets(4);
+  EXPECT_EQ(sets.Add(), 4U);
+  sets.Unite(0, 1);
+  sets.Unite(3, 4);
+  EXPECT_EQ(sets.Find(0), sets.Find(1));
+  EXPECT_EQ(sets.Find(3), sets.Find(4));
+  EXPECT_NE(sets.Find(1), sets.Find(3));
+  EXPECT_EQ(sets.Find(2), 2U);
+  sets.Unite(1, 4);
+  EXPECT_EQ(sets.Find(0), sets.Find(3));
+  EXPECT_EQ(sets.Size(), 5U);
+}
+
+TEST(ccl_tests, diagonals_depend_on_connectivity) {
+  // a main diagonal and an anti-diagonal
+  std::vector<uint8_t> image = {1, 0, 1, 0, 1, 0, 1, 0, 1};
+  EXPECT_EQ(Label(image, 3, 3, Connectivity::k4), (std::vector<int>{1, 0, 2, 0, 3, 0, 4, 0, 5}));
+  EXPECT_EQ(Label(image, 3, 3, Connectivity::k6), (std::vector<int>{1, 0, 2, 0, 1, 0, 3, 0, 1}));
+  EXPECT_EQ(Label(image, 3, 3, Connectivity::k8), (std::vector<int>{1, 0, 1, 0, 1, 0, 1, 0, 1}));
+}
+
+TEST(ccl_tests, labels_follow_first_pixel_in_raster_order) {
+  // the U is found at its right arm first, but starts in the top left corner
+  std::vector<uint8_t> image = {1, 0, 0, 1, 0,  //
+                                1, 0, 0, 1, 0,  //
+                                1, 1, 1, 1, 0,  //
+                                0, 0, 0, 0, 1};
+  for (auto connectivity : {Connectivity::k4, Connectivity::k6, Connectivity::k8}) {
+    EXPECT_EQ(Label(image, 4, 5, connectivity), ReferenceLabels(image, 4, 5, connectivity));
+  }
+  EXPECT_EQ(Label(image, 4, 5, Connectivity::k8)[19], 1);
+  EXPECT_EQ(Label(image, 4, 5, Connectivity::k4)[19], 2);
+}
+
+TEST(ccl_tests, background_value_and_labels_are_configurable) {
+  std::vector<int> image = {0, 1, 0, 1, 1, 1, 0, 1, 0};
+  std::vector<int> labels(image.size());
+  auto count = ppc::ccl::LabelComponents(std::span<const int>(image), 3, 3, std::span<int>(labels),
+                                         {.connectivity = Connectivity::k4,
+                                          .background_value = 1,
+                                          .background_label = 1,
+                                          .first_label = 2});
+  EXPECT_EQ(count, 4U);
+  EXPECT_EQ(labels, (std::vector<int>{2, 1, 3, 1, 1, 1, 4, 1, 5}));
+}
+
+TEST(ccl_tests, matches_reference_on_random_images) {
+  const std::vector<std::pair<int, int>> sizes = {{1, 1}, {1, 17}, {17, 1}, {31, 23}, {64, 64}};
+  for (auto [rows, cols] : sizes) {
+    for (double density : {0.3, 0.5, 0.7}) {
+      auto image = RandomImage(rows, cols, density, static_cast<unsigned>((rows * 1000) + cols));
+      for (auto connectivity : {Connectivity::k4, Connectivity::k6, Connectivity::k8}) {
+        EXPECT_EQ(Label(image, rows, cols, connectivity), ReferenceLabels(image, rows, cols, connectivity))
+            << rows << "x" << cols << ", density " << density;
+      }
+    }
+  }
+}
+
+TEST(ccl_tests, strips_merged_across_borders_match_whole_image) {
+  const int rows = 40;
+  const int cols = 37;
+  auto image = RandomImage(rows, cols, 0.55, 7);
+  for (auto connectivity : {Connectivity::k4, Connectivity::k6, Connectivity::k8}) {
+    const LabelingOptions options{.connectivity = connectivity};
+    std::vector<int> labels(image.size());
+    const std::vector<int> strip_rows = {0, 9, 10, 25, rows};
+    int64_t next_label = options.first_label;
+    for (size_t strip = 0; strip + 1 < strip_rows.size(); ++strip) {
+      auto offset = static_cast<size_t>(strip_rows[strip]) * cols;
+      auto size = static_cast<size_t>(strip_rows[strip + 1] - strip_rows[strip]) * cols;
+      LabelingOptions strip_options = options;
+      strip_options.first_label = next_label;
+      next_label += static_cast<int64_t>(
+          ppc::ccl::LabelComponents(std::span<const uint8_t>(image).subspan(offset, size),
+                                    strip_rows[strip + 1] - strip_rows[strip], cols,
+                                    std::span<int>(labels).subspan(offset, size), strip_options));
+    }
+    ppc::ccl::UnionFind components(static_cast<size_t>(next_label - options.first_label));
+    for (size_t strip = 1; strip + 1 < strip_rows.size(); ++strip) {
+      auto border = static_cast<size_t>(strip_rows[strip]) * cols;
+      ppc::ccl::UniteAcrossBorder(std::span<const int>(labels).subspan(border - cols, cols),
+                                  std::span<const int>(labels).subspan(border, cols), options, components);
+    }
+    ppc::ccl::RelabelInRasterOrder(std::span<int>(labels), options, components);
+    EXPECT_EQ(labels, ReferenceLabels(image, rows, cols, connectivity));
+  }
+}
+
+TEST(ccl_tests, strips_numbered_from_border_pairs_match_whole_image) {
+  const int rows = 45;
+  const int cols = 29;
+  // components of a strip are often joined through the strips below it
+  auto image = RandomImage(rows, cols, 0.6, 11);
+  for (auto connectivity : {Connectivity::k4, Connectivity::k6, Connectivity::k8}) {
+    const LabelingOptions options{.connectivity = connectivity};
+    std::vector<int> labels(image.size());
+    const std::vector<int> strip_rows = {0, 1, 12, 12, 30, rows};
+    const size_t strips = strip_rows.size() - 1;
+    std::vector<size_t> counts(strips);
+    std::vector<uint32_t> strip_offsets = {0};
+    for (size_t strip = 0; strip < strips; ++strip) {
+      auto offset = static_cast<size_t>(strip_rows[strip]) * cols;
+      auto size = static_cast<size_t>(strip_rows[strip + 1] - strip_rows[strip]) * cols;
+      counts[strip] = ppc::ccl::LabelComponents(std::span<const uint8_t>(image).subspan(offset, size),
+                                                strip_rows[strip + 1] - strip_rows[strip], cols,
+                                                std::span<int>(labels).subspan(offset, size), options);
+      strip_offsets.push_back(strip_offsets[strip] + static_cast<uint32_t>(counts[strip]));
+    }
+    std::vector<uint32_t> pairs;
+    for (size_t strip = 1; strip < strips; ++strip) {
+      auto border = static_cast<size_t>(strip_rows[strip]) * cols;
+      if (border == 0 || strip_rows[strip] == strip_rows[strip + 1]) {
+        continue;
+      }
+      // the strip above is the last non-empty one
+      size_t above = strip - 1;
+      while (strip_rows[above] == strip_rows[above + 1]) {
+        --above;
+      }
+      std::vector<uint32_t> upper(cols);
+      std::vector<uint32_t> lower(cols);
+      ppc::ccl::BorderElements(std::span<const int>(labels).subspan(border - cols, cols), options,
+                               strip_offsets[above], std::span<uint32_t>(upper));
+      ppc::ccl::BorderElements(std::span<const int>(labels).subspan(border, cols), options, strip_offsets[strip],
+                               std::span<uint32_t>(lower));
+      ppc::ccl::AppendBorderPairs(upper, lower, connectivity, pairs);
+    }
+    auto numberings = ppc::ccl::NumberStrips(pairs, strip_offsets);
+    ASSERT_EQ(numberings.size(), strips);
+    for (size_t strip = 0; strip < strips; ++strip) {
+      auto offset = static_cast<size_t>(strip_rows[strip]) * cols;
+      auto size = static_cast<size_t>(strip_rows[strip + 1] - strip_rows[strip]) * cols;
+      ppc::ccl::RenumberStrip(std::span<int>(labels).subspan(offset, size), options, counts[strip],
+                              numberings[strip]);
+    }
+    EXPECT_EQ(labels, ReferenceLabels(image, rows, cols, connectivity));
+  }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ppc::ccl {
+
+// Which neighbours of a pixel belong to the same component.
+enum class Connectivity : uint8_t {
+  k4,  // left, right, up, down
+  k6,  // k4 and the main diagonal (up-left, down-right): a hexagonal grid stored row by row
+  k8,  // k4 and both diagonals
+};
+
+// Disjoint sets over the elements 0, 1, ... in flat arrays, with union by rank
+// and path compression.
+class UnionFind {
+ public:
+  UnionFind() = default;
+  // singletons 0 .. size - 1
+  explicit UnionFind(size_t size);
+
+  // appends a singleton and returns it
+  uint32_t Add();
+  uint32_t Find(uint32_t element);
+  // merges the sets of a and b, returns the root of the union
+  uint32_t Unite(uint32_t a, uint32_t b);
+
+  [[nodiscard]] size_t Size() const { return parent_.size(); }
+
+ private:
+  std::vector<uint32_t> parent_;
+  std::vector<uint8_t> rank_;
+};
+
+struct LabelingOptions {
+  Connectivity connectivity = Connectivity::k8;
+  // pixels equal to this value are background, all others are foreground
+  int background_value = 0;
+  // label of background pixels
+  int64_t background_label = 0;
+  // components are numbered first_label, first_label + 1, ... in raster order of their first pixel
+  int64_t first_label = 1;
+};
+
+// Two-pass connected-component labeling of a row-major rows x cols image.
+// The first pass gives every pixel a provisional label and records the
+// equivalences in a UnionFind, the second one writes the final labels. With
+// k8 the scan works on 2 x 2 blocks (foreground pixels of a block are always
+// connected), so it needs a quarter of the provisional labels and lookups.
+// Returns the number of components.
+// Pixel: uint8_t or int; Label: int or uint32_t.
+template <typename Pixel, typename Label>
+size_t LabelComponents(std::span<const Pixel> image, size_t rows, size_t cols, std::span<Label> labels,
+                       const LabelingOptions& options = {});
+
+// Labeling of an image split into horizontal strips: label every strip with
+// its own first_label, so that the labels of all strips are distinct, put
+// label - options.first_label of all of them into one UnionFind, call
+// UniteAcrossBorder for every pair of adjacent strips and finally
+// RelabelInRasterOrder on the whole image.
+
+// Unites the components that touch across a border; upper is the last row of
+// labels above it, lower the first row below it.
+template <typename Label>
+void UniteAcrossBorder(std::span<const Label> upper, std::span<const Label> lower, const LabelingOptions& options,
+                       UnionFind& components);
+
+// Replaces every label by options.first_label + the number of its set, the
+// sets numbered in raster order of their first label. Returns the number of sets.
+template <typename Label>
+size_t RelabelInRasterOrder(std::span<Label> labels, const LabelingOptions& options, UnionFind& components);
+
+// Labeling of an image whose horizontal strips stay on different processes,
+// only border rows and equivalences of border components travel:
+//  1. every strip is labeled with LabelComponents; its components are the
+//     elements offset, offset + 1, ... of the whole image, offset being the
+//     number of components in the strips above,
+//  2. the last row of a strip goes to the strip below as elements
+//     (BorderElements), which lists the touching pairs with AppendBorderPairs,
+//  3. one process collects the pairs of all borders and calls NumberStrips,
+//  4. every strip applies its StripNumbering with RenumberStrip.
+// MergeStripBorders (ccl_mpi.hpp) does steps 2-4 for strips on the ranks of an MPI communicator.
+constexpr uint32_t kNoElement = UINT32_MAX;
+
+// elements of a row of labels, kNoElement for background
+template <typename Label>
+void BorderElements(std::span<const Label> labels, const LabelingOptions& options, uint32_t offset,
+                    std::span<uint32_t> elements);
+
+// appends (lower element, upper element) for the touching pixels of two rows of elements
+void AppendBorderPairs(std::span<const uint32_t> upper, std::span<const uint32_t> lower, Connectivity connectivity,
+                       std::vector<uint32_t>& pairs);
+
+// Final numbers (0, 1, ... in raster order) of the components of one strip.
+struct StripNumbering {
+  // components whose first pixel lies in an earlier strip
+  uint32_t numbered_before = 0;
+  // (component of the strip, its number) for the components joined to an
+  // earlier one, flat and sorted; all others are numbered in order after numbered_before
+  std::vector<uint32_t> joined;
+};
+
+// pairs: from AppendBorderPairs of all borders; strip_offsets: the first
+// element of every strip, followed by the total number of elements
+std::vector<StripNumbering> NumberStrips(std::span<const uint32_t> pairs, std::span<const uint32_t> strip_offsets);
+
+// replaces the labels of a strip with count components by options.first_label + their final number
+template <typename Label>
+void RenumberStrip(std::span<Label> labels, const LabelingOptions& options, size_t count,
+                   const StripNumbering& numbering);
+
+}  // namespace ppc::ccl
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "core/ccl/include/ccl.hpp"
+
+namespace ppc::ccl {
+
+// Steps 2-4 of the strip labeling in ccl.hpp for one strip per rank of comm,
+// the strips in rank order (empty ones allowed): labels holds the strip of
+// labels.size() / cols rows labeled with LabelComponents and count components.
+// The last row goes to the next non-empty strip, rank 0 numbers the components
+// from the touching pairs of all borders only, and every rank renumbers its
+// strip in place, so the labels never leave their rank.
+template <typename Label>
+void MergeStripBorders(std::span<Label> labels, size_t cols, size_t count, const LabelingOptions& options,
+                       MPI_Comm comm) {
+  int rank = 0;
+  int size = 0;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  // (rows, components) of every strip
+  const size_t rows = cols == 0 ? 0 : labels.size() / cols;
+  std::array<uint32_t, 2> own_strip = {static_cast<uint32_t>(rows), static_cast<uint32_t>(count)};
+  std::vector<uint32_t> strips(2 * static_cast<size_t>(size));
+  MPI_Allgather(own_strip.data(), 2, MPI_UINT32_T, strips.data(), 2, MPI_UINT32_T, comm);
+  std::vector<uint32_t> strip_offsets(size + 1, 0);
+  for (int i = 0; i < size; ++i) {
+    strip_offsets[i + 1] = strip_offsets[i] + strips[(2 * i) + 1];
+  }
+  const uint32_t offset = strip_offsets[rank];
+
+  std::vector<uint32_t> pairs;
+  if (rows > 0) {
+    int above = rank - 1;
+    while (above >= 0 && strips[2 * above] == 0) {
+      --above;
+    }
+    int below = rank + 1;
+    while (below < size && strips[2 * below] == 0) {
+      ++below;
+    }
+    const int width = static_cast<int>(cols);
+    std::vector<uint32_t> last_row(cols);
+    MPI_Request send_request = MPI_REQUEST_NULL;
+    if (below < size) {
+      BorderElements<Label>(labels.last(cols), options, offset, last_row);
+      MPI_Isend(last_row.data(), width, MPI_UINT32_T, below, 0, comm, &send_request);
+    }
+    if (above >= 0) {
+      std::vector<uint32_t> upper(cols);
+      std::vector<uint32_t> lower(cols);
+      MPI_Recv(upper.data(), width, MPI_UINT32_T, above, 0, comm, MPI_STATUS_IGNORE);
+      BorderElements<Label>(labels.first(cols), options, offset, lower);
+      AppendBorderPairs(upper, lower, options.connectivity, pairs);
+    }
+    MPI_Wait(&send_request, MPI_STATUS_IGNORE);
+  }
+
+  int pair_count = static_cast<int>(pairs.size());
+  std::vector<int> pair_counts(size);
+  MPI_Gather(&pair_count, 1, MPI_INT, pair_counts.data(), 1, MPI_INT, 0, comm);
+  std::vector<int> pair_displs(size, 0);
+  for (int i = 1; i < size; ++i) {
+    pair_displs[i] = pair_displs[i - 1] + pair_counts[i - 1];
+  }
+  std::vector<uint32_t> all_pairs(rank == 0 ? std::accumulate(pair_counts.begin(), pair_counts.end(), size_t{0}) : 0);
+  MPI_Gatherv(pairs.data(), pair_count, MPI_UINT32_T, all_pairs.data(), pair_counts.data(), pair_displs.data(),
+              MPI_UINT32_T, 0, comm);
+
+  // per rank: numbered_before, then the joined components
+  std::vector<uint32_t> packed;
+  std::vector<int> packed_sizes;
+  std::vector<int> packed_displs;
+  if (rank == 0) {
+    for (const auto& numbering : NumberStrips(all_pairs, strip_offsets)) {
+      packed_displs.push_back(static_cast<int>(packed.size()));
+      packed_sizes.push_back(static_cast<int>(numbering.joined.size() + 1));
+      packed.push_back(numbering.numbered_before);
+      packed.insert(packed.end(), numbering.joined.begin(), numbering.joined.end());
+    }
+  }
+  int own_size = 0;
+  MPI_Scatter(packed_sizes.data(), 1, MPI_INT, &own_size, 1, MPI_INT, 0, comm);
+  std::vector<uint32_t> own(own_size);
+  MPI_Scatterv(packed.data(), packed_sizes.data(), packed_displs.data(), MPI_UINT32_T, own.data(), own_size,
+               MPI_UINT32_T, 0, comm);
+  RenumberStrip(labels, options, count,
+                {.numbered_before = own[0], .joined = std::vector<uint32_t>(own.begin() + 1, own.end())});
+}
+
+}  // namespace ppc::ccl
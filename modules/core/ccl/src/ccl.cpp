@@ -0,0 +1,398 @@
+#include "core/ccl/include/ccl.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+ppc::ccl::UnionFind::UnionFind(size_t size) : parent_(size), rank_(size, 0) {
+  std::iota(parent_.begin(), parent_.end(), 0U);
+}
+
+uint32_t ppc::ccl::UnionFind::Add() {
+  auto element = static_cast<uint32_t>(parent_.size());
+  parent_.push_back(element);
+  rank_.push_back(0);
+  return element;
+}
+
+uint32_t ppc::ccl::UnionFind::Find(uint32_t element) {
+  uint32_t root = element;
+  while (parent_[root] != root) {
+    root = parent_[root];
+  }
+  while (parent_[element] != root) {
+    element = std::exchange(parent_[element], root);
+  }
+  return root;
+}
+
+uint32_t ppc::ccl::UnionFind::Unite(uint32_t a, uint32_t b) {
+  a = Find(a);
+  b = Find(b);
+  if (a == b) {
+    return a;
+  }
+  if (rank_[a] < rank_[b]) {
+    std::swap(a, b);
+  }
+  parent_[b] = a;
+  if (rank_[a] == rank_[b]) {
+    ++rank_[a];
+  }
+  return a;
+}
+
+namespace {
+
+using ppc::ccl::Connectivity;
+using ppc::ccl::LabelingOptions;
+using ppc::ccl::UnionFind;
+
+// Maps sets to consecutive numbers in the order they are first asked for.
+class SetNumbering {
+ public:
+  explicit SetNumbering(UnionFind& components) : components_(components), numbers_(components.Size(), 0) {}
+
+  uint32_t Number(uint32_t element) {
+    uint32_t& number = numbers_[components_.Find(element)];
+    if (number == 0) {
+      number = ++count_;
+    }
+    return number - 1;
+  }
+
+  [[nodiscard]] size_t Count() const { return count_; }
+
+ private:
+  UnionFind& components_;
+  std::vector<uint32_t> numbers_;
+  uint32_t count_ = 0;
+};
+
+// First pass for k4 and k6: provisional labels go to labels directly.
+// Decision tree on the neighbours up (u), left (l) and up-left (d): d touches
+// both u and l in k4 and k6, so if it is set they are already equivalent.
+template <typename Pixel, typename Label>
+void ScanPixels(std::span<const Pixel> image, size_t rows, size_t cols, std::span<Label> labels,
+                const LabelingOptions& options, UnionFind& components) {
+  const int background = options.background_value;
+  const bool diagonal = options.connectivity == Connectivity::k6;
+  for (size_t row = 0; row < rows; ++row) {
+    const Pixel* pixels = image.data() + (row * cols);
+    Label* out = labels.data() + (row * cols);
+    // the first row has no row above, its own one stands in and is never read
+    const Pixel* pixels_up = row > 0 ? pixels - cols : pixels;
+    const Label* out_up = row > 0 ? out - cols : out;
+    for (size_t col = 0; col < cols; ++col) {
+      if (static_cast<int>(pixels[col]) == background) {
+        continue;
+      }
+      const bool l = col > 0 && static_cast<int>(pixels[col - 1]) != background;
+      const bool u = row > 0 && static_cast<int>(pixels_up[col]) != background;
+      const bool d = row > 0 && col > 0 && static_cast<int>(pixels_up[col - 1]) != background;
+      if (u) {
+        out[col] = out_up[col];
+        if (l && !d) {
+          components.Unite(static_cast<uint32_t>(out[col]), static_cast<uint32_t>(out[col - 1]));
+        }
+      } else if (d && diagonal) {
+        out[col] = out_up[col - 1];
+      } else if (l) {
+        out[col] = out[col - 1];
+      } else {
+        out[col] = static_cast<Label>(components.Add());
+      }
+    }
+  }
+}
+
+template <typename Pixel, typename Label>
+void ResolvePixels(std::span<const Pixel> image, size_t pixel_count, std::span<Label> labels,
+                   const LabelingOptions& options, SetNumbering& numbering) {
+  const auto background_label = static_cast<Label>(options.background_label);
+  const auto first_label = static_cast<Label>(options.first_label);
+  for (size_t i = 0; i < pixel_count; ++i) {
+    if (static_cast<int>(image[i]) == options.background_value) {
+      labels[i] = background_label;
+    } else {
+      labels[i] = static_cast<Label>(first_label + numbering.Number(static_cast<uint32_t>(labels[i])));
+    }
+  }
+}
+
+// First pass for k8 on 2 x 2 blocks, one provisional label per block.
+// A block with top-left pixel (r, c) is connected to the block
+//   up-left if (r, c) and (r - 1, c - 1) are set,
+//   up if one of (r, c), (r, c + 1) and one of (r - 1, c), (r - 1, c + 1) is set,
+//   up-right if (r, c + 1) and (r - 1, c + 2) are set,
+//   left if one of (r, c), (r + 1, c) and one of (r, c - 1), (r + 1, c - 1) is set.
+template <typename Pixel>
+std::vector<uint32_t> ScanBlocks(std::span<const Pixel> image, size_t rows, size_t cols, const LabelingOptions& options,
+                                 UnionFind& components) {
+  const size_t block_rows = (rows + 1) / 2;
+  const size_t block_cols = (cols + 1) / 2;
+  std::vector<uint32_t> blocks(block_rows * block_cols);
+  auto set = [&](size_t r, size_t c) {
+    return r < rows && c < cols && static_cast<int>(image[(r * cols) + c]) != options.background_value;
+  };
+  for (size_t block_row = 0; block_row < block_rows; ++block_row) {
+    const size_t r = 2 * block_row;
+    uint32_t* out = blocks.data() + (block_row * block_cols);
+    const uint32_t* out_up = r > 0 ? out - block_cols : out;
+    for (size_t block_col = 0; block_col < block_cols; ++block_col) {
+      const size_t c = 2 * block_col;
+      const bool p = set(r, c);
+      const bool q = set(r, c + 1);
+      const bool s = set(r + 1, c);
+      if (!p && !q && !s && !set(r + 1, c + 1)) {
+        continue;
+      }
+      const bool has_left = c > 0;
+      const bool x = r > 0 && set(r - 1, c);
+      const bool y = r > 0 && set(r - 1, c + 1);
+      uint32_t label = 0;
+      bool labeled = false;
+      auto connect = [&](uint32_t neighbour) {
+        if (labeled) {
+          components.Unite(label, neighbour);
+        } else {
+          label = neighbour;
+          labeled = true;
+        }
+      };
+      if ((p || q) && (x || y)) {
+        connect(out_up[block_col]);
+      }
+      // skipped if the up block holds a pixel next to the one in question, it is connected then
+      if (p && !x && r > 0 && has_left && set(r - 1, c - 1)) {
+        connect(out_up[block_col - 1]);
+      }
+      if (q && !y && r > 0 && set(r - 1, c + 2)) {
+        connect(out_up[block_col + 1]);
+      }
+      if (has_left && (p || s) && (set(r, c - 1) || set(r + 1, c - 1))) {
+        connect(out[block_col - 1]);
+      }
+      out[block_col] = labeled ? label : components.Add();
+    }
+  }
+  return blocks;
+}
+
+template <typename Pixel, typename Label>
+void ResolveBlocks(std::span<const Pixel> image, size_t rows, size_t cols, const std::vector<uint32_t>& blocks,
+                   std::span<Label> labels, const LabelingOptions& options, SetNumbering& numbering) {
+  const size_t block_cols = (cols + 1) / 2;
+  const auto background_label = static_cast<Label>(options.background_label);
+  const auto first_label = static_cast<Label>(options.first_label);
+  for (size_t row = 0; row < rows; ++row) {
+    const Pixel* pixels = image.data() + (row * cols);
+    const uint32_t* row_blocks = blocks.data() + ((row / 2) * block_cols);
+    Label* out = labels.data() + (row * cols);
+    for (size_t col = 0; col < cols; ++col) {
+      if (static_cast<int>(pixels[col]) == options.background_value) {
+        out[col] = background_label;
+      } else {
+        out[col] = static_cast<Label>(first_label + numbering.Number(row_blocks[col / 2]));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename Pixel, typename Label>
+size_t ppc::ccl::LabelComponents(std::span<const Pixel> image, size_t rows, size_t cols, std::span<Label> labels,
+                                 const LabelingOptions& options) {
+  const size_t pixel_count = rows * cols;
+  if (image.size() < pixel_count || labels.size() < pixel_count) {
+    throw std::invalid_argument("LabelComponents: image or labels smaller than rows * cols");
+  }
+  UnionFind components;
+  if (options.connectivity == Connectivity::k8) {
+    auto blocks = ScanBlocks(image, rows, cols, options, components);
+    SetNumbering numbering(components);
+    ResolveBlocks(image, rows, cols, blocks, labels, options, numbering);
+    return numbering.Count();
+  }
+  ScanPixels(image, rows, cols, labels, options, components);
+  SetNumbering numbering(components);
+  ResolvePixels(image, pixel_count, labels, options, numbering);
+  return numbering.Count();
+}
+
+template <typename Label>
+void ppc::ccl::UniteAcrossBorder(std::span<const Label> upper, std::span<const Label> lower,
+                                 const LabelingOptions& options, UnionFind& components) {
+  if (upper.size() != lower.size()) {
+    throw std::invalid_argument("UniteAcrossBorder: rows of different length");
+  }
+  const auto background_label = static_cast<Label>(options.background_label);
+  auto element = [&](Label label) { return static_cast<uint32_t>(label - static_cast<Label>(options.first_label)); };
+  const bool up_left = options.connectivity != Connectivity::k4;
+  const bool up_right = options.connectivity == Connectivity::k8;
+  const size_t cols = lower.size();
+  for (size_t col = 0; col < cols; ++col) {
+    if (lower[col] == background_label) {
+      continue;
+    }
+    const uint32_t below = element(lower[col]);
+    if (upper[col] != background_label) {
+      components.Unite(below, element(upper[col]));
+    }
+    if (up_left && col > 0 && upper[col - 1] != background_label) {
+      components.Unite(below, element(upper[col - 1]));
+    }
+    if (up_right && col + 1 < cols && upper[col + 1] != background_label) {
+      components.Unite(below, element(upper[col + 1]));
+    }
+  }
+}
+
+template <typename Label>
+size_t ppc::ccl::RelabelInRasterOrder(std::span<Label> labels, const LabelingOptions& options,
+                                      UnionFind& components) {
+  const auto background_label = static_cast<Label>(options.background_label);
+  const auto first_label = static_cast<Label>(options.first_label);
+  SetNumbering numbering(components);
+  for (auto& label : labels) {
+    if (label != background_label) {
+      label = static_cast<Label>(first_label + numbering.Number(static_cast<uint32_t>(label - first_label)));
+    }
+  }
+  return numbering.Count();
+}
+
+template <typename Label>
+void ppc::ccl::BorderElements(std::span<const Label> labels, const LabelingOptions& options, uint32_t offset,
+                              std::span<uint32_t> elements) {
+  const auto background_label = static_cast<Label>(options.background_label);
+  const auto first_label = static_cast<Label>(options.first_label);
+  for (size_t col = 0; col < labels.size(); ++col) {
+    elements[col] =
+        labels[col] == background_label ? kNoElement : offset + static_cast<uint32_t>(labels[col] - first_label);
+  }
+}
+
+void ppc::ccl::AppendBorderPairs(std::span<const uint32_t> upper, std::span<const uint32_t> lower,
+                                 Connectivity connectivity, std::vector<uint32_t>& pairs) {
+  if (upper.size() != lower.size()) {
+    throw std::invalid_argument("AppendBorderPairs: rows of different length");
+  }
+  auto append = [&pairs](uint32_t below, uint32_t above) {
+    // runs along the border give the same pair again and again
+    const size_t size = pairs.size();
+    if (above == kNoElement || (size >= 2 && pairs[size - 2] == below && pairs[size - 1] == above)) {
+      return;
+    }
+    pairs.push_back(below);
+    pairs.push_back(above);
+  };
+  const size_t cols = lower.size();
+  for (size_t col = 0; col < cols; ++col) {
+    if (lower[col] == kNoElement) {
+      continue;
+    }
+    if (connectivity != Connectivity::k4 && col > 0) {
+      append(lower[col], upper[col - 1]);
+    }
+    append(lower[col], upper[col]);
+    if (connectivity == Connectivity::k8 && col + 1 < cols) {
+      append(lower[col], upper[col + 1]);
+    }
+  }
+}
+
+std::vector<ppc::ccl::StripNumbering> ppc::ccl::NumberStrips(std::span<const uint32_t> pairs,
+                                                             std::span<const uint32_t> strip_offsets) {
+  // union-find over the elements that occur in pairs only
+  std::vector<uint32_t> elements(pairs.begin(), pairs.end());
+  std::ranges::sort(elements);
+  elements.erase(std::ranges::unique(elements).begin(), elements.end());
+  auto index = [&elements](uint32_t element) {
+    return static_cast<uint32_t>(std::ranges::lower_bound(elements, element) - elements.begin());
+  };
+  UnionFind components(elements.size());
+  for (size_t i = 0; i + 1 < pairs.size(); i += 2) {
+    components.Unite(index(pairs[i]), index(pairs[i + 1]));
+  }
+
+  // a merged component is represented by its smallest element, the others are joined to it
+  std::vector<uint32_t> smallest(elements.size(), kNoElement);
+  std::vector<uint32_t> joined;
+  std::vector<uint32_t> joined_to;
+  for (size_t i = 0; i < elements.size(); ++i) {
+    uint32_t& representative = smallest[components.Find(static_cast<uint32_t>(i))];
+    if (representative == kNoElement) {
+      representative = elements[i];
+    } else {
+      joined.push_back(elements[i]);
+      joined_to.push_back(representative);
+    }
+  }
+  // the number of a representative is the count of representatives before it
+  auto number = [&joined](uint32_t element) {
+    return element - static_cast<uint32_t>(std::ranges::lower_bound(joined, element) - joined.begin());
+  };
+
+  std::vector<StripNumbering> numberings(strip_offsets.empty() ? 0 : strip_offsets.size() - 1);
+  size_t next = 0;
+  for (size_t strip = 0; strip < numberings.size(); ++strip) {
+    numberings[strip].numbered_before = number(strip_offsets[strip]);
+    for (; next < joined.size() && joined[next] < strip_offsets[strip + 1]; ++next) {
+      numberings[strip].joined.push_back(joined[next] - strip_offsets[strip]);
+      numberings[strip].joined.push_back(number(joined_to[next]));
+    }
+  }
+  return numberings;
+}
+
+template <typename Label>
+void ppc::ccl::RenumberStrip(std::span<Label> labels, const LabelingOptions& options, size_t count,
+                             const StripNumbering& numbering) {
+  std::vector<uint32_t> numbers(count);
+  uint32_t next_number = numbering.numbered_before;
+  size_t next_joined = 0;
+  for (size_t component = 0; component < count; ++component) {
+    if (next_joined + 1 < numbering.joined.size() && numbering.joined[next_joined] == component) {
+      numbers[component] = numbering.joined[next_joined + 1];
+      next_joined += 2;
+    } else {
+      numbers[component] = next_number++;
+    }
+  }
+  const auto background_label = static_cast<Label>(options.background_label);
+  const auto first_label = static_cast<Label>(options.first_label);
+  for (auto& label : labels) {
+    if (label != background_label) {
+      label = static_cast<Label>(first_label + numbers[static_cast<size_t>(label - first_label)]);
+    }
+  }
+}
+
+template size_t ppc::ccl::LabelComponents<uint8_t, int>(std::span<const uint8_t>, size_t, size_t, std::span<int>,
+                                                        const LabelingOptions&);
+template size_t ppc::ccl::LabelComponents<uint8_t, uint32_t>(std::span<const uint8_t>, size_t, size_t,
+                                                             std::span<uint32_t>, const LabelingOptions&);
+template size_t ppc::ccl::LabelComponents<int, int>(std::span<const int>, size_t, size_t, std::span<int>,
+                                                    const LabelingOptions&);
+template size_t ppc::ccl::LabelComponents<int, uint32_t>(std::span<const int>, size_t, size_t, std::span<uint32_t>,
+                                                         const LabelingOptions&);
+template void ppc::ccl::UniteAcrossBorder<int>(std::span<const int>, std::span<const int>, const LabelingOptions&,
+                                               UnionFind&);
+template void ppc::ccl::UniteAcrossBorder<uint32_t>(std::span<const uint32_t>, std::span<const uint32_t>,
+                                                    const LabelingOptions&, UnionFind&);
+template size_t ppc::ccl::RelabelInRasterOrder<int>(std::span<int>, const LabelingOptions&, UnionFind&);
+template size_t ppc::ccl::RelabelInRasterOrder<uint32_t>(std::span<uint32_t>, const LabelingOptions&, UnionFind&);
+template void ppc::ccl::BorderElements<int>(std::span<const int>, const LabelingOptions&, uint32_t,
+                                            std::span<uint32_t>);
+template void ppc::ccl::BorderElements<uint32_t>(std::span<const uint32_t>, const LabelingOptions&, uint32_t,
+                                                 std::span<uint32_t>);
+template void ppc::ccl::RenumberStrip<int>(std::span<int>, const LabelingOptions&, size_t, const StripNumbering&);
+template void ppc::ccl::RenumberStrip<uint32_t>(std::span<uint32_t>, const LabelingOptions&, size_t,
+                                                const StripNumbering&);
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/graph/include/graph.hpp"
+
+namespace {
+
+using ppc::graph::CsrGraph;
+using ppc::graph::Queue;
+
+// Bellman-Ford over the edge list
+std::vector<int> ReferenceDistances(const std::vector<int>& edges, int n, int st) {
+  std::vector<int64_t> dist(n, INT64_MAX);
+  dist[st] = 0;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (size_t i = 0; i < edges.size(); i += 3) {
+      if (dist[edges[i]] != INT64_MAX && dist[edges[i]] + edges[i + 2] < dist[edges[i + 1]]) {
+        dist[edges[i + 1]] = dist[edges[i]] + edges[i + 2];
+        changed = true;
+      }
+    }
+  }
+  std::vector<int> result(n);
+  for (int v = 0; v < n; v++) {
+    result[v] = dist[v] == INT64_MAX ? INT_MAX : static_cast<int>(dist[v]);
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(graph, matrix_and_edge_list_give_the_same_csr) {
+  std::vector<int> matrix;
+  std::vector<int> edges;
+  ppc::graph::GenerateSparseGraph(40, 3, 50, matrix, edges);
+  CsrGraph from_matrix;
+  CsrGraph from_edges;
+  ppc::graph::ConvertToCrs(matrix, from_matrix, 40);
+  ppc::graph::ConvertEdgesToCrs(edges, from_edges, 40);
+  EXPECT_EQ(from_matrix.row_ptr, from_edges.row_ptr);
+  EXPECT_EQ(from_matrix.col_index, from_edges.col_index);
+  EXPECT_EQ(from_matrix.values, from_edges.values);
+}
+
+TEST(graph, dijkstra_queues_match_bellman_ford) {
+  const int n = 500;
+  for (int max_weight : {1, 7, 1000}) {
+    auto edges = ppc::graph::GenerateRandomEdges(n, 2, max_weight, 1234U + max_weight);
+    CsrGraph graph;
+    ppc::graph::ConvertEdgesToCrs(edges, graph, n);
+    auto expected = ReferenceDistances(edges, n, 3);
+    for (Queue queue : {Queue::kBinaryHeap, Queue::kRadixHeap}) {
+      std::vector<int> dist(n);
+      ppc::graph::Dijkstra(graph, 3, queue, dist);
+      EXPECT_EQ(expected, dist);
+    }
+  }
+}
+
+TEST(graph, dijkstra_marks_unreachable_vertices) {
+  std::vector<int> edges = {0, 1, 5, 1, 2, 2, 3, 0, 1};
+  CsrGraph graph;
+  ppc::graph::ConvertEdgesToCrs(edges, graph, 4);
+  std::vector<int> dist(4);
+  ppc::graph::Dijkstra(graph, 0, Queue::kRadixHeap, dist);
+  EXPECT_EQ(dist, (std::vector<int>{0, 5, 7, INT_MAX}));
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ppc::graph {
+
+// Weighted directed graph in compressed sparse rows: the edges of vertex v are
+// col_index / values [row_ptr[v], row_ptr[v + 1]).
+struct CsrGraph {
+  std::vector<int> values;
+  std::vector<int> col_index;
+  std::vector<int> row_ptr;
+};
+
+// n x n adjacency matrix (0 = no edge) to CSR
+void ConvertToCrs(std::span<const int> w, CsrGraph& matrix, int n);
+// edge list of (from, to, weight) triples to CSR, the edges of a vertex keep their order
+void ConvertEdgesToCrs(std::span<const int> edges, CsrGraph& matrix, int n);
+
+// kBinaryHeap: O((V + E) log V) with lazy deletion.
+// kRadixHeap: monotone radix heap on the integer distances, O(E + V log C) for the largest weight C.
+enum class Queue : uint8_t { kBinaryHeap, kRadixHeap };
+
+// distances from st over non-negative weights, INT_MAX for unreachable vertices
+void Dijkstra(const CsrGraph& matrix, int st, Queue queue, std::span<int> dist);
+
+// Test graphs with weights in [1, max_weight].
+// about n * degree random edges without loops, as an n x n matrix and as the edge list of its non-zeros
+void GenerateSparseGraph(int n, int degree, int max_weight, std::vector<int>& matrix, std::vector<int>& edges);
+// exactly degree edges out of every vertex (loops and parallel edges included), reproducible for a seed
+std::vector<int> GenerateRandomEdges(int n, int degree, int max_weight, uint32_t seed);
+
+}  // namespace ppc::graph
@@ -0,0 +1,185 @@
+#include "core/graph/include/graph.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kUnreached = std::numeric_limits<uint64_t>::max();
+
+// (distance, vertex) min-queue with lazy deletion: stale entries are skipped when popped
+class BinaryHeap {
+ public:
+  void Push(uint64_t distance, int vertex) { heap_.emplace(distance, vertex); }
+  [[nodiscard]] bool Empty() const { return heap_.empty(); }
+  std::pair<uint64_t, int> Pop() {
+    auto top = heap_.top();
+    heap_.pop();
+    return top;
+  }
+
+ private:
+  std::priority_queue<std::pair<uint64_t, int>, std::vector<std::pair<uint64_t, int>>, std::greater<>> heap_;
+};
+
+// Monotone radix heap: popped distances never decrease, so an entry waits in the
+// bucket of the highest bit in which it differs from the last popped distance.
+// Bucket 0 holds entries equal to it; an emptied bucket 0 is refilled by
+// splitting the lowest non-empty bucket around its minimum.
+class RadixHeap {
+ public:
+  void Push(uint64_t distance, int vertex) {
+    buckets_[BucketOf(distance)].emplace_back(distance, vertex);
+    size_++;
+  }
+  [[nodiscard]] bool Empty() const { return size_ == 0; }
+  std::pair<uint64_t, int> Pop() {
+    if (buckets_[0].empty()) {
+      size_t i = 1;
+      while (buckets_[i].empty()) {
+        i++;
+      }
+      last_ = std::ranges::min(buckets_[i]).first;
+      for (const auto& entry : buckets_[i]) {
+        buckets_[BucketOf(entry.first)].push_back(entry);
+      }
+      buckets_[i].clear();
+    }
+    auto& bucket = buckets_[0];
+    auto top = bucket[bucket.size() - 1];
+    bucket.pop_back();
+    size_--;
+    return top;
+  }
+
+ private:
+  [[nodiscard]] size_t BucketOf(uint64_t distance) const { return std::bit_width(distance ^ last_); }
+
+  std::array<std::vector<std::pair<uint64_t, int>>, 65> buckets_;
+  uint64_t last_ = 0;
+  size_t size_ = 0;
+};
+
+template <typename Heap>
+void SettleAll(const ppc::graph::CsrGraph& matrix, Heap& heap, std::vector<uint64_t>& d) {
+  while (!heap.Empty()) {
+    const auto [distance, u] = heap.Pop();
+    if (distance != d[u]) {
+      continue;
+    }
+    for (int j = matrix.row_ptr[u]; j < matrix.row_ptr[u + 1]; j++) {
+      const uint64_t candidate = distance + static_cast<uint64_t>(matrix.values[j]);
+      const int v = matrix.col_index[j];
+      if (candidate < d[v]) {
+        d[v] = candidate;
+        heap.Push(candidate, v);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void ppc::graph::ConvertToCrs(std::span<const int> w, CsrGraph& matrix, int n) {
+  matrix.values.clear();
+  matrix.col_index.clear();
+  matrix.row_ptr.resize(n + 1);
+  int nnz = 0;
+  for (int i = 0; i < n; i++) {
+    matrix.row_ptr[i] = nnz;
+    for (int j = 0; j < n; j++) {
+      int weight = w[(i * n) + j];
+      if (weight != 0) {
+        matrix.values.emplace_back(weight);
+        matrix.col_index.emplace_back(j);
+        nnz++;
+      }
+    }
+  }
+  matrix.row_ptr[n] = nnz;
+}
+
+void ppc::graph::ConvertEdgesToCrs(std::span<const int> edges, CsrGraph& matrix, int n) {
+  const size_t nnz = edges.size() / 3;
+  matrix.row_ptr.assign(n + 1, 0);
+  for (size_t i = 0; i < edges.size(); i += 3) {
+    matrix.row_ptr[edges[i] + 1]++;
+  }
+  for (int v = 0; v < n; v++) {
+    matrix.row_ptr[v + 1] += matrix.row_ptr[v];
+  }
+  matrix.values.resize(nnz);
+  matrix.col_index.resize(nnz);
+  std::vector<int> position(matrix.row_ptr.begin(), matrix.row_ptr.end() - 1);
+  for (size_t i = 0; i < edges.size(); i += 3) {
+    const int j = position[edges[i]]++;
+    matrix.col_index[j] = edges[i + 1];
+    matrix.values[j] = edges[i + 2];
+  }
+}
+
+void ppc::graph::Dijkstra(const CsrGraph& matrix, int st, Queue queue, std::span<int> dist) {
+  std::vector<uint64_t> d(dist.size(), kUnreached);
+  d[st] = 0;
+  if (queue == Queue::kRadixHeap) {
+    RadixHeap heap;
+    heap.Push(0, st);
+    SettleAll(matrix, heap, d);
+  } else {
+    BinaryHeap heap;
+    heap.Push(0, st);
+    SettleAll(matrix, heap, d);
+  }
+  for (size_t v = 0; v < dist.size(); v++) {
+    dist[v] = static_cast<int>(std::min<uint64_t>(d[v], INT_MAX));
+  }
+}
+
+void ppc::graph::GenerateSparseGraph(int n, int degree, int max_weight, std::vector<int>& matrix,
+                                     std::vector<int>& edges) {
+  std::random_device dev;
+  std::mt19937 gen(dev());
+  std::uniform_int_distribution<int> vertex(0, n - 1);
+  std::uniform_int_distribution<int> weight(1, max_weight);
+  matrix.assign(static_cast<size_t>(n) * n, 0);
+  for (int i = 0; i < n * degree; i++) {
+    const int from = vertex(gen);
+    const int to = vertex(gen);
+    if (from != to) {
+      matrix[(from * n) + to] = weight(gen);
+    }
+  }
+  edges.clear();
+  for (int from = 0; from < n; from++) {
+    for (int to = 0; to < n; to++) {
+      if (matrix[(from * n) + to] != 0) {
+        edges.insert(edges.end(), {from, to, matrix[(from * n) + to]});
+      }
+    }
+  }
+}
+
+std::vector<int> ppc::graph::GenerateRandomEdges(int n, int degree, int max_weight, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> vertex(0, n - 1);
+  std::uniform_int_distribution<int> weight(1, max_weight);
+  std::vector<int> edges;
+  edges.reserve(static_cast<size_t>(n) * degree * 3);
+  for (int i = 0; i < n; i++) {
+    for (int k = 0; k < degree; k++) {
+      edges.insert(edges.end(), {i, vertex(gen), weight(gen)});
+    }
+  }
+  return edges;
+}
@@ -1,13 +1,20 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "core/perf/func_tests/test_task.hpp"
 #include "core/perf/include/perf.hpp"
 #include "core/task/include/task.hpp"
+#include "core/util/include/util.hpp"
 
 TEST(perf_tests, check_perf_pipeline) {
   // Create data
@@ -175,3 +182,340 @@ TEST(perf_tests, check_perf_task_float) {
   ASSERT_LE(perf_results->time_sec, ppc::core::PerfResults::kMaxTime);
   EXPECT_EQ(out[0], in.size());
 }
+
+TEST(perf_tests, check_perf_samples_with_warmup) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  task_data->inputs_count.emplace_back(in.size());
+  task_data->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  task_data->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto test_task = std::make_shared<ppc::test::perf::TestTask<uint32_t>>(task_data);
+
+  // Create Perf attributes with a fake timer: every call moves time forward by 10 ms
+  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
+  perf_attr->num_running = 10;
+  perf_attr->num_warmup = 3;
+  double ticks = 0.0;
+  perf_attr->current_timer = [&] {
+    ticks += 0.01;
+    return ticks;
+  };
+
+  // Create and init perf results
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perf_analyzer(test_task);
+  perf_analyzer.PipelineRun(perf_attr, perf_results);
+
+  // Get perf statistic
+  ppc::core::Perf::PrintPerfStatistic(perf_results);
+  ASSERT_EQ(perf_results->samples.size(), 10U);
+  EXPECT_EQ(perf_results->profile.GetPhases().at("Run").count, 13U);
+  EXPECT_NEAR(perf_results->time_sec, 0.1, 1e-9);
+  EXPECT_NEAR(perf_results->statistics.median, 0.01, 1e-9);
+  EXPECT_NEAR(perf_results->statistics.stddev, 0.0, 1e-9);
+  EXPECT_EQ(out[0], in.size());
+}
+
+TEST(perf_tests, check_perf_throughput) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  task_data->inputs_count.emplace_back(in.size());
+  task_data->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  task_data->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto test_task = std::make_shared<ppc::test::perf::TestTask<uint32_t>>(task_data);
+
+  // Create Perf attributes with a fake timer: every call moves time forward by 10 ms
+  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
+  perf_attr->num_running = 10;
+  double ticks = 0.0;
+  perf_attr->current_timer = [&] {
+    ticks += 0.01;
+    return ticks;
+  };
+
+  // Create and init perf results
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perf_analyzer(test_task);
+  perf_analyzer.ThroughputRun(perf_attr, perf_results);
+
+  // Get perf statistic
+  ppc::core::Perf::PrintPerfStatistic(perf_results);
+  ASSERT_EQ(perf_results->samples.size(), 10U);
+  EXPECT_TRUE(test_task->IsPrepared());
+  EXPECT_EQ(perf_results->profile.GetPhases().at("Validation").count, 1U);
+  EXPECT_EQ(perf_results->profile.GetPhases().at("PreProcessing").count, 1U);
+  EXPECT_EQ(perf_results->profile.GetPhases().at("Run").count, 10U);
+  EXPECT_EQ(perf_results->profile.GetPhases().at("PostProcessing").count, 10U);
+  EXPECT_NEAR(perf_results->runs_per_sec, 100.0, 1e-6);
+  // output is not reset between runs of a prepared task
+  EXPECT_EQ(out[0], in.size() * 10);
+}
+
+TEST(perf_tests, check_compute_statistics) {
+  std::vector<double> samples = {10.0, 9.0, 8.0, 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0};
+
+  auto stats = ppc::core::Perf::ComputeStatistics(samples);
+
+  EXPECT_EQ(stats.num_samples, samples.size());
+  EXPECT_EQ(stats.num_outliers, 0U);
+  EXPECT_DOUBLE_EQ(stats.min, 1.0);
+  EXPECT_DOUBLE_EQ(stats.max, 10.0);
+  EXPECT_DOUBLE_EQ(stats.mean, 5.5);
+  EXPECT_DOUBLE_EQ(stats.median, 5.5);
+  EXPECT_NEAR(stats.p90, 9.1, 1e-9);
+  EXPECT_NEAR(stats.p99, 9.91, 1e-9);
+  EXPECT_NEAR(stats.stddev, 3.0276503540974917, 1e-9);
+  EXPECT_NEAR(stats.ci95, 1.96 * 3.0276503540974917 / std::sqrt(10.0), 1e-9);
+}
+
+TEST(perf_tests, check_compute_statistics_outliers) {
+  std::vector<double> samples(9, 1.0);
+  samples.push_back(100.0);
+
+  auto stats = ppc::core::Perf::ComputeStatistics(samples, 1.5);
+
+  EXPECT_EQ(stats.num_samples, 9U);
+  EXPECT_EQ(stats.num_outliers, 1U);
+  EXPECT_DOUBLE_EQ(stats.max, 1.0);
+  EXPECT_DOUBLE_EQ(stats.mean, 1.0);
+}
+
+TEST(perf_tests, check_perf_adaptive_running) {
+  // Create data
+  std::vector<float> in(2000, 1);
+  std::vector<float> out(1, 0);
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  task_data->inputs_count.emplace_back(in.size());
+  task_data->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  task_data->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto test_task = std::make_shared<ppc::test::perf::TestTask<float>>(task_data);
+
+  // Create Perf attributes with a noisy fake timer: runs take 1 ms and 3 ms in turn
+  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
+  perf_attr->num_running = 2;
+  perf_attr->target_relative_ci = 1e-9;
+  perf_attr->max_running = 50;
+  double ticks = 0.0;
+  uint64_t calls = 0;
+  perf_attr->current_timer = [&] {
+    ticks += (calls++ % 2 == 0) ? 0.001 : 0.003;
+    return ticks;
+  };
+
+  // Create and init perf results
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer: unreachable confidence, so it stops at max_running
+  ppc::core::Perf perf_analyzer(test_task);
+  perf_analyzer.TaskRun(perf_attr, perf_results);
+  EXPECT_EQ(perf_results->samples.size(), perf_attr->max_running);
+
+  // Reachable confidence stops well before max_running
+  perf_attr->target_relative_ci = 0.5;
+  perf_analyzer.TaskRun(perf_attr, perf_results);
+  EXPECT_GT(perf_results->samples.size(), perf_attr->num_running);
+  EXPECT_LT(perf_results->samples.size(), perf_attr->max_running);
+  EXPECT_LE(perf_results->statistics.ci95 / perf_results->statistics.mean, 0.5);
+  EXPECT_EQ(out[0], in.size());
+}
+
+TEST(perf_tests, check_perf_mpi_mode) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  task_data->inputs_count.emplace_back(in.size());
+  task_data->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  task_data->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto test_task = std::make_shared<ppc::test::perf::TestTask<uint32_t>>(task_data);
+
+  // Create Perf attributes: every run takes 5 ms on this rank, and a fake
+  // second rank is two times slower
+  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
+  perf_attr->num_running = 5;
+  double ticks = 0.0;
+  perf_attr->current_timer = [&] {
+    ticks += 0.005;
+    return ticks;
+  };
+  int barriers = 0;
+  perf_attr->barrier = [&] { barriers++; };
+  perf_attr->gather_samples = [](const std::vector<double> &local_samples) {
+    std::vector<double> all_samples(local_samples);
+    for (double sample : local_samples) {
+      all_samples.push_back(2.0 * sample);
+    }
+    return all_samples;
+  };
+
+  // Create and init perf results
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perf_analyzer(test_task);
+  perf_analyzer.PipelineRun(perf_attr, perf_results);
+
+  // Get perf statistic
+  ppc::core::Perf::PrintPerfStatistic(perf_results);
+  EXPECT_EQ(barriers, 5);
+  ASSERT_EQ(perf_results->samples.size(), 5U);
+  EXPECT_NEAR(perf_results->samples[0], 0.01, 1e-9);
+  EXPECT_NEAR(perf_results->time_sec, 0.05, 1e-9);
+  ASSERT_EQ(perf_results->ranks.rank_times.size(), 2U);
+  EXPECT_NEAR(perf_results->ranks.min, 0.025, 1e-9);
+  EXPECT_NEAR(perf_results->ranks.max, 0.05, 1e-9);
+  EXPECT_NEAR(perf_results->ranks.imbalance, 0.05 / 0.0375, 1e-9);
+  EXPECT_EQ(out[0], in.size());
+
+  auto report_path = (std::filesystem::temp_directory_path() / "ppc_perf_ranks_report.json").string();
+  ppc::core::Perf::WriteRanksReport(perf_results, report_path);
+  std::ifstream report(report_path);
+  std::stringstream report_str;
+  report_str << report.rdbuf();
+  EXPECT_NE(report_str.str().find("\"num_ranks\": 2"), std::string::npos);
+  EXPECT_NE(report_str.str().find("\"type\": \"pipeline\""), std::string::npos);
+  std::filesystem::remove(report_path);
+}
+
+TEST(perf_tests, check_perf_result_record) {
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+  perf_results->type_of_running = ppc::core::PerfResults::TypeOfRunning::kTaskRun;
+  perf_results->samples = {0.25, 0.5};
+  perf_results->statistics = ppc::core::Perf::ComputeStatistics(perf_results->samples);
+  perf_results->time_sec = 0.75;
+  perf_results->input_size = 42;
+
+  auto json_path = (std::filesystem::temp_directory_path() / "ppc_perf_results.jsonl").string();
+  std::filesystem::remove(json_path);
+  ppc::core::Perf::WriteResultRecord(perf_results, "tasks/mpi/example_task", json_path);
+  ppc::core::Perf::WriteResultRecord(perf_results, "tasks/mpi/example_task", json_path);
+  std::ifstream json(json_path);
+  std::string line;
+  int records = 0;
+  while (std::getline(json, line)) {
+    records++;
+    EXPECT_NE(line.find("\"task\": \"example_task\", \"backend\": \"mpi\", \"type\": \"task_run\""), std::string::npos);
+    EXPECT_NE(line.find(R"("variant": "", "test": "check_perf_result_record")"), std::string::npos);
+    EXPECT_NE(line.find("\"ranks\": 1"), std::string::npos);
+    EXPECT_NE(line.find("\"input_size\": 42"), std::string::npos);
+    EXPECT_NE(line.find("\"samples\": [0.25, 0.5]"), std::string::npos);
+  }
+  EXPECT_EQ(records, 2);
+  json.close();
+  std::filesystem::remove(json_path);
+
+  auto csv_path = (std::filesystem::temp_directory_path() / "ppc_perf_results.csv").string();
+  std::filesystem::remove(csv_path);
+  ppc::core::Perf::WriteResultRecord(perf_results, "tasks/seq/example_task", csv_path);
+  ppc::core::Perf::WriteResultRecord(perf_results, "tasks/seq/example_task", csv_path);
+  std::ifstream csv(csv_path);
+  std::string header;
+  std::getline(csv, header);
+  EXPECT_EQ(header.rfind("task,backend,type,variant,test,ranks,threads,input_size,time_sec", 0), 0U);
+  std::string row;
+  std::getline(csv, row);
+  EXPECT_EQ(row.rfind("example_task,seq,task_run,,check_perf_result_record,1,", 0), 0U);
+  EXPECT_TRUE(row.ends_with(",0.25;0.5"));
+  std::getline(csv, row);
+  EXPECT_EQ(row.rfind("example_task,seq,task_run,,check_perf_result_record,1,", 0), 0U);
+  EXPECT_FALSE(std::getline(csv, row));
+  csv.close();
+  std::filesystem::remove(csv_path);
+}
+
+TEST(perf_tests, check_perf_variant_separates_records) {
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+  perf_results->type_of_running = ppc::core::PerfResults::TypeOfRunning::kTaskRun;
+  perf_results->variant = "radix_heap";
+  perf_results->samples = {0.25};
+  perf_results->statistics = ppc::core::Perf::ComputeStatistics(perf_results->samples);
+  perf_results->time_sec = 0.25;
+
+  testing::internal::CaptureStdout();
+  ppc::core::Perf::PrintPerfStatistic(perf_results);
+  const auto output = testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find(":task_run.radix_heap:0.25"), std::string::npos);
+  EXPECT_NE(output.find(":task_run.radix_heap:statistics:"), std::string::npos);
+
+  auto csv_path = (std::filesystem::temp_directory_path() / "ppc_perf_results_variant.csv").string();
+  std::filesystem::remove(csv_path);
+  ppc::core::Perf::WriteResultRecord(perf_results, "tasks/seq/example_task", csv_path);
+  std::ifstream csv(csv_path);
+  std::string row;
+  std::getline(csv, row);
+  std::getline(csv, row);
+  EXPECT_EQ(row.rfind("example_task,seq,task_run,radix_heap,check_perf_variant_separates_records,", 0), 0U);
+  csv.close();
+  std::filesystem::remove(csv_path);
+}
+
+TEST(perf_tests, check_perf_result_record_escapes_strings) {
+#ifndef _WIN32
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+  perf_results->type_of_running = ppc::core::PerfResults::TypeOfRunning::kPipeline;
+  const auto launched = ppc::util::GetEnvVariable("OMPI_COMM_WORLD_SIZE");
+  setenv("OMPI_COMM_WORLD_SIZE", "4", 1);     // NOLINT(misc-include-cleaner)
+  setenv("PPC_GIT_COMMIT", "abc\"1,\\2", 1);  // NOLINT(misc-include-cleaner)
+
+  auto json_path = (std::filesystem::temp_directory_path() / "ppc_perf_results_escaped.jsonl").string();
+  std::filesystem::remove(json_path);
+  ppc::core::Perf::WriteResultRecord(perf_results, "tasks/mpi/task\"name", json_path);
+  std::ifstream json(json_path);
+  std::string line;
+  std::getline(json, line);
+  EXPECT_NE(line.find(R"("task": "task\"name")"), std::string::npos);
+  EXPECT_NE(line.find("\"ranks\": 4"), std::string::npos);
+  EXPECT_NE(line.find(R"("git_commit": "abc\"1,\\2")"), std::string::npos);
+  json.close();
+  std::filesystem::remove(json_path);
+
+  auto csv_path = (std::filesystem::temp_directory_path() / "ppc_perf_results_escaped.csv").string();
+  std::filesystem::remove(csv_path);
+  ppc::core::Perf::WriteResultRecord(perf_results, "tasks/seq/task,name", csv_path);
+  std::ifstream csv(csv_path);
+  std::string row;
+  std::getline(csv, row);
+  std::getline(csv, row);
+  EXPECT_EQ(row.rfind("\"task,name\",seq,pipeline,,check_perf_result_record_escapes_strings,4,", 0), 0U);
+  EXPECT_NE(row.find(R"(,"abc""1,\2",)"), std::string::npos);
+  csv.close();
+  std::filesystem::remove(csv_path);
+
+  unsetenv("PPC_GIT_COMMIT");  // NOLINT(misc-include-cleaner)
+  if (launched.empty()) {
+    unsetenv("OMPI_COMM_WORLD_SIZE");  // NOLINT(misc-include-cleaner)
+  } else {
+    setenv("OMPI_COMM_WORLD_SIZE", launched.c_str(), 1);  // NOLINT(misc-include-cleaner)
+  }
+#else
+  GTEST_SKIP();
+#endif
+}
@@ -1,24 +1,94 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "core/task/include/task.hpp"
+#include "core/task/include/time_budget.hpp"
 
 namespace ppc::core {
 
 struct PerfAttr {
   // count of task's running
   uint64_t num_running;
+  // count of untimed runs before measurement (cold caches, lazy allocations)
+  uint64_t num_warmup = 0;
+  // Tukey fence factor: samples outside [Q1 - k*IQR, Q3 + k*IQR] are excluded
+  // from statistics (0 disables outlier rejection)
+  double outlier_factor = 0.0;
+  // adaptive mode: keep running after num_running until the relative 95%
+  // confidence interval of the mean is below this value (0 disables)
+  double target_relative_ci = 0.0;
+  // upper bound of runs in adaptive mode
+  uint64_t max_running = 1000;
   std::function<double()> current_timer = [&] { return 0.0; };
+  // MPI mode (enabled when both are set): barrier is called before every
+  // measured run, gather_samples must return the run times of all ranks
+  // concatenated in rank order on every rank. Adaptive mode is ignored here,
+  // because ranks could disagree about the number of runs.
+  std::function<void()> barrier;
+  std::function<std::vector<double>(const std::vector<double>&)> gather_samples;
+};
+
+struct PerfStatistics {
+  // all values (except counters) are in seconds per single run
+  double min = 0.0;
+  double max = 0.0;
+  double mean = 0.0;
+  double median = 0.0;
+  double p90 = 0.0;
+  double p99 = 0.0;
+  double stddev = 0.0;
+  // half-width of the 95% confidence interval of the mean
+  double ci95 = 0.0;
+  size_t num_samples = 0;
+  size_t num_outliers = 0;
+};
+
+struct PerfRanksStatistics {
+  // total measured time of every rank (in seconds)
+  std::vector<double> rank_times;
+  double max = 0.0;
+  double min = 0.0;
+  double mean = 0.0;
+  // max / mean of rank times: 1.0 means perfectly balanced ranks
+  double imbalance = 0.0;
 };
 
 struct PerfResults {
   // measurement of task's time (in seconds)
   double time_sec = 0.0;
-  enum TypeOfRunning : uint8_t { kPipeline, kTaskRun, kNone } type_of_running = kNone;
+  // measured runs per second of time_sec
+  double runs_per_sec = 0.0;
+  // time of every measured run (in seconds), warmup runs are not included;
+  // in MPI mode it is the time of the slowest rank in every run
+  std::vector<double> samples;
+  PerfStatistics statistics;
+  // filled in MPI mode only
+  PerfRanksStatistics ranks;
+  // phases and named scopes of the task collected during the measurement
+  TaskProfile profile;
+  // high-water mark of the task's scratch arena (in bytes)
+  uint64_t scratch_peak_bytes = 0;
+  // total count of input elements of the task (of rank 0 in MPI tasks)
+  uint64_t input_size = 0;
+  enum TypeOfRunning : uint8_t { kPipeline, kTaskRun, kThroughput, kNone } type_of_running = kNone;
+  // label of the measured configuration (engine, filter, queue...) when one
+  // test binary has several perf tests of the same type and input size; it is
+  // appended to the type in the output ("task_run.radix_heap") and recorded
+  // with the gtest test name by WriteResultRecord
+  std::string variant;
+  // default limit of time_sec
   constexpr static double kMaxTime = 10.0;
+  // limit checked by PrintPerfStatistic; if unset, kMaxTime with overrides of
+  // TimeBudget::FromEnvironment(): PPC_PERF_TIME_LIMIT and the model of
+  // "<backend>/<task>:<type>" from PPC_TIME_BUDGET_FILE
+  std::optional<TimeBudget> time_budget;
 };
 
 class Perf {
@@ -33,13 +103,32 @@ class Perf {
   void PipelineRun(const std::shared_ptr<PerfAttr>& perf_attr, const std::shared_ptr<PerfResults>& perf_results) const;
   // Check performance of task's Run() function
   void TaskRun(const std::shared_ptr<PerfAttr>& perf_attr, const std::shared_ptr<PerfResults>& perf_results) const;
+  // Check steady-state throughput of a prepared task: Prepare() once (unless
+  // already prepared), then Execute() = Run() -> PostProcessing() per run
+  void ThroughputRun(const std::shared_ptr<PerfAttr>& perf_attr,
+                     const std::shared_ptr<PerfResults>& perf_results) const;
   // Pint results for automation checkers
   static void PrintPerfStatistic(const std::shared_ptr<PerfResults>& perf_results);
+  // Compute order statistics, moments and confidence interval of samples
+  static PerfStatistics ComputeStatistics(const std::vector<double>& samples, double outlier_factor = 0.0);
+  // Write per-rank breakdown of MPI mode as JSON file
+  static void WriteRanksReport(const std::shared_ptr<PerfResults>& perf_results, const std::string& path);
+  // Append results as one record (task, backend, variant, gtest test name,
+  // ranks, threads, input size, samples, git commit, host) to a JSON Lines
+  // file, or to a CSV file if the path ends with ".csv". task_path is
+  // "tasks/<backend>/<task>". Called by PrintPerfStatistic when
+  // PPC_PERF_RESULTS is set, see scripts/compare_perf_results.py
+  static void WriteResultRecord(const std::shared_ptr<PerfResults>& perf_results, const std::string& task_path,
+                                const std::string& path);
 
  private:
   std::shared_ptr<Task> task_;
+  // copy profile, memory and input size of the task after a measurement
+  void CollectTaskResults(const std::shared_ptr<PerfResults>& perf_results) const;
   static void CommonRun(const std::shared_ptr<PerfAttr>& perf_attr, const std::function<void()>& pipeline,
                         const std::shared_ptr<PerfResults>& perf_results);
+  static void CommonMpiRun(const std::shared_ptr<PerfAttr>& perf_attr, const std::function<void()>& pipeline,
+                           const std::shared_ptr<PerfResults>& perf_results);
 };
 
 }  // namespace ppc::core
@@ -2,16 +2,117 @@
 
 #include <gtest/gtest.h>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iomanip>
+#include <ios>
 #include <iostream>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "core/task/include/task.hpp"
+#include "core/task/include/time_budget.hpp"
+#include "core/util/include/util.hpp"
+
+namespace {
+
+// two-sided 95% quantile of the normal distribution
+constexpr double kZ95 = 1.96;
+
+// linear interpolation between closest ranks of a sorted sample
+double Percentile(const std::vector<double>& sorted, double q) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const double pos = q * static_cast<double>(sorted.size() - 1);
+  const auto lo = static_cast<size_t>(std::floor(pos));
+  const auto hi = std::min(lo + 1, sorted.size() - 1);
+  return sorted[lo] + ((sorted[hi] - sorted[lo]) * (pos - static_cast<double>(lo)));
+}
+
+std::string TypeOfRunningName(ppc::core::PerfResults::TypeOfRunning type_of_running) {
+  if (type_of_running == ppc::core::PerfResults::TypeOfRunning::kTaskRun) {
+    return "task_run";
+  }
+  if (type_of_running == ppc::core::PerfResults::TypeOfRunning::kPipeline) {
+    return "pipeline";
+  }
+  if (type_of_running == ppc::core::PerfResults::TypeOfRunning::kThroughput) {
+    return "throughput";
+  }
+  return "none";
+}
+
+// type of running with the variant of the measured configuration, if any
+std::string RunName(const ppc::core::PerfResults& perf_results) {
+  const auto type = TypeOfRunningName(perf_results.type_of_running);
+  return perf_results.variant.empty() ? type : type + "." + perf_results.variant;
+}
+
+// name of the running gtest test, empty outside of a test
+std::string CurrentTestName() {
+  const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  return test_info != nullptr ? test_info->name() : "";
+}
+
+std::string HostName() {
+#ifdef _WIN32
+  auto host = ppc::util::GetEnvVariable("COMPUTERNAME");
+#else
+  std::array<char, 256> buffer{};
+  std::string host = gethostname(buffer.data(), buffer.size() - 1) == 0 ? buffer.data() : "";
+#endif
+  return host.empty() ? "unknown" : host;
+}
+
+// string value of a JSON record, quotes included
+std::string JsonString(const std::string& value) {
+  std::ostringstream out;
+  out << '"';
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+  return out.str();
+}
+
+// CSV field (RFC 4180): quoted, with doubled quotes, if it holds a separator, a quote or a line break
+std::string CsvField(const std::string& value) {
+  if (value.find_first_of(",\"\r\n") == std::string::npos) {
+    return value;
+  }
+  std::string quoted = "\"";
+  for (const char c : value) {
+    quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+  }
+  return quoted + "\"";
+}
+
+}  // namespace
 
 ppc::core::Perf::Perf(const std::shared_ptr<Task>& task_ptr) { SetTask(task_ptr); }
 
@@ -24,6 +125,7 @@ void ppc::core::Perf::PipelineRun(const std::shared_ptr<PerfAttr>& perf_attr,
                                   const std::shared_ptr<ppc::core::PerfResults>& perf_results) const {
   perf_results->type_of_running = PerfResults::TypeOfRunning::kPipeline;
 
+  task_->ResetProfile();
   CommonRun(
       perf_attr,
       [&]() {
@@ -33,16 +135,19 @@ void ppc::core::Perf::PipelineRun(const std::shared_ptr<PerfAttr>& perf_attr,
         task_->PostProcessing();
       },
       perf_results);
+  CollectTaskResults(perf_results);
 }
 
 void ppc::core::Perf::TaskRun(const std::shared_ptr<PerfAttr>& perf_attr,
                               const std::shared_ptr<ppc::core::PerfResults>& perf_results) const {
   perf_results->type_of_running = PerfResults::TypeOfRunning::kTaskRun;
 
+  task_->ResetProfile();
   task_->Validation();
   task_->PreProcessing();
   CommonRun(perf_attr, [&]() { task_->Run(); }, perf_results);
   task_->PostProcessing();
+  CollectTaskResults(perf_results);
 
   task_->Validation();
   task_->PreProcessing();
@@ -50,49 +155,325 @@ void ppc::core::Perf::TaskRun(const std::shared_ptr<PerfAttr>& perf_attr,
   task_->PostProcessing();
 }
 
+void ppc::core::Perf::ThroughputRun(const std::shared_ptr<PerfAttr>& perf_attr,
+                                    const std::shared_ptr<ppc::core::PerfResults>& perf_results) const {
+  perf_results->type_of_running = PerfResults::TypeOfRunning::kThroughput;
+
+  task_->ResetProfile();
+  if (!task_->IsPrepared() && !task_->Prepare()) {
+    throw std::runtime_error("Task can not be prepared for the throughput run");
+  }
+  CommonRun(perf_attr, [&]() { task_->Execute(); }, perf_results);
+  CollectTaskResults(perf_results);
+}
+
+void ppc::core::Perf::CollectTaskResults(const std::shared_ptr<PerfResults>& perf_results) const {
+  perf_results->profile = task_->GetProfile();
+  perf_results->scratch_peak_bytes = task_->GetScratchArena().GetHighWaterMark();
+  const auto& inputs_count = task_->GetData()->inputs_count;
+  perf_results->input_size = std::accumulate(inputs_count.begin(), inputs_count.end(), uint64_t{0});
+}
+
 void ppc::core::Perf::CommonRun(const std::shared_ptr<PerfAttr>& perf_attr, const std::function<void()>& pipeline,
                                 const std::shared_ptr<ppc::core::PerfResults>& perf_results) {
+  if (perf_attr->barrier && perf_attr->gather_samples) {
+    CommonMpiRun(perf_attr, pipeline, perf_results);
+    return;
+  }
+
+  for (uint64_t i = 0; i < perf_attr->num_warmup; i++) {
+    pipeline();
+  }
+
+  auto& samples = perf_results->samples;
+  samples.clear();
+  samples.reserve(perf_attr->num_running);
+
+  // running mean and sum of squared deviations (Welford) for the adaptive mode
+  double mean = 0.0;
+  double m2 = 0.0;
+  auto need_more_runs = [&]() {
+    if (perf_attr->target_relative_ci <= 0.0 || samples.size() >= perf_attr->max_running) {
+      return false;
+    }
+    if (samples.size() < 2) {
+      return true;
+    }
+    if (mean <= 0.0) {
+      return false;
+    }
+    const auto n = static_cast<double>(samples.size());
+    const double ci95 = kZ95 * std::sqrt(m2 / (n - 1.0)) / std::sqrt(n);
+    return ci95 / mean > perf_attr->target_relative_ci;
+  };
+
   auto begin = perf_attr->current_timer();
+  auto last = begin;
+  while (samples.size() < perf_attr->num_running || need_more_runs()) {
+    pipeline();
+    auto now = perf_attr->current_timer();
+    const double sample = now - last;
+    last = now;
+    samples.push_back(sample);
+
+    const double delta = sample - mean;
+    mean += delta / static_cast<double>(samples.size());
+    m2 += delta * (sample - mean);
+  }
+  perf_results->time_sec = last - begin;
+  perf_results->runs_per_sec =
+      perf_results->time_sec > 0.0 ? static_cast<double>(samples.size()) / perf_results->time_sec : 0.0;
+  perf_results->statistics = ComputeStatistics(samples, perf_attr->outlier_factor);
+}
+
+void ppc::core::Perf::CommonMpiRun(const std::shared_ptr<PerfAttr>& perf_attr, const std::function<void()>& pipeline,
+                                   const std::shared_ptr<ppc::core::PerfResults>& perf_results) {
+  for (uint64_t i = 0; i < perf_attr->num_warmup; i++) {
+    pipeline();
+  }
+
+  // every rank measures its own runs, synchronized so that all ranks start together
+  std::vector<double> local_samples;
+  local_samples.reserve(perf_attr->num_running);
   for (uint64_t i = 0; i < perf_attr->num_running; i++) {
+    perf_attr->barrier();
+    auto begin = perf_attr->current_timer();
     pipeline();
+    auto end = perf_attr->current_timer();
+    local_samples.push_back(end - begin);
+  }
+
+  const std::vector<double> all_samples = perf_attr->gather_samples(local_samples);
+  const size_t num_runs = local_samples.size();
+
+  // a run lasts as long as its slowest rank
+  auto& samples = perf_results->samples;
+  samples.assign(num_runs, 0.0);
+  auto& ranks = perf_results->ranks;
+  ranks = PerfRanksStatistics{};
+  for (size_t offset = 0; num_runs > 0 && offset + num_runs <= all_samples.size(); offset += num_runs) {
+    double rank_time = 0.0;
+    for (size_t i = 0; i < num_runs; i++) {
+      samples[i] = std::max(samples[i], all_samples[offset + i]);
+      rank_time += all_samples[offset + i];
+    }
+    ranks.rank_times.push_back(rank_time);
+  }
+
+  if (!ranks.rank_times.empty()) {
+    const auto [min_it, max_it] = std::ranges::minmax_element(ranks.rank_times);
+    ranks.min = *min_it;
+    ranks.max = *max_it;
+    ranks.mean = std::accumulate(ranks.rank_times.begin(), ranks.rank_times.end(), 0.0) /
+                 static_cast<double>(ranks.rank_times.size());
+    ranks.imbalance = ranks.mean > 0.0 ? ranks.max / ranks.mean : 1.0;
+  }
+
+  perf_results->time_sec = std::accumulate(samples.begin(), samples.end(), 0.0);
+  perf_results->runs_per_sec =
+      perf_results->time_sec > 0.0 ? static_cast<double>(samples.size()) / perf_results->time_sec : 0.0;
+  perf_results->statistics = ComputeStatistics(samples, perf_attr->outlier_factor);
+}
+
+ppc::core::PerfStatistics ppc::core::Perf::ComputeStatistics(const std::vector<double>& samples,
+                                                             double outlier_factor) {
+  PerfStatistics stats;
+  if (samples.empty()) {
+    return stats;
   }
-  auto end = perf_attr->current_timer();
-  perf_results->time_sec = end - begin;
+
+  std::vector<double> sorted(samples);
+  std::ranges::sort(sorted);
+
+  if (outlier_factor > 0.0 && sorted.size() >= 4) {
+    const double q1 = Percentile(sorted, 0.25);
+    const double q3 = Percentile(sorted, 0.75);
+    const double iqr = q3 - q1;
+    auto first = std::ranges::lower_bound(sorted, q1 - (outlier_factor * iqr));
+    auto last = std::ranges::upper_bound(sorted, q3 + (outlier_factor * iqr));
+    stats.num_outliers = sorted.size() - static_cast<size_t>(last - first);
+    sorted = std::vector<double>(first, last);
+  }
+
+  const auto n = static_cast<double>(sorted.size());
+  stats.num_samples = sorted.size();
+  stats.min = sorted.front();
+  stats.max = sorted.back();
+  stats.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+  stats.median = Percentile(sorted, 0.5);
+  stats.p90 = Percentile(sorted, 0.9);
+  stats.p99 = Percentile(sorted, 0.99);
+  if (sorted.size() > 1) {
+    double sq_sum = 0.0;
+    for (double sample : sorted) {
+      sq_sum += (sample - stats.mean) * (sample - stats.mean);
+    }
+    stats.stddev = std::sqrt(sq_sum / (n - 1.0));
+    stats.ci95 = kZ95 * stats.stddev / std::sqrt(n);
+  }
+  return stats;
 }
 
 void ppc::core::Perf::PrintPerfStatistic(const std::shared_ptr<PerfResults>& perf_results) {
   std::string relative_path(::testing::UnitTest::GetInstance()->current_test_info()->file());
   std::string ppc_regex_template("parallel_programming_course");
   std::string perf_regex_template("perf_tests");
-  std::string type_test_name;
+  std::string type_test_name = RunName(*perf_results);
 
   auto time_secs = perf_results->time_sec;
 
-  if (perf_results->type_of_running == PerfResults::TypeOfRunning::kTaskRun) {
-    type_test_name = "task_run";
-  } else if (perf_results->type_of_running == PerfResults::TypeOfRunning::kPipeline) {
-    type_test_name = "pipeline";
-  } else {
-    type_test_name = "none";
-  }
-
   auto first_found_position = relative_path.find(ppc_regex_template) + ppc_regex_template.length() + 1;
   relative_path.erase(0, first_found_position);
 
   auto last_found_position = relative_path.find(perf_regex_template) - 1;
   relative_path.erase(last_found_position, relative_path.length() - 1);
 
+  auto [backend, task] = ppc::util::SplitTaskPath(relative_path);
+  // variants share the budget of their type
+  const auto budget = perf_results->time_budget.value_or(
+      TimeBudget::FromEnvironment(PerfResults::kMaxTime, "PPC_PERF_TIME_LIMIT",
+                                  backend + "/" + task + ":" + TypeOfRunningName(perf_results->type_of_running)));
+  const auto num_runs = std::max<uint64_t>(perf_results->samples.size(), 1);
+  const bool exceeded = time_secs >= budget.LimitFor(perf_results->input_size, num_runs);
+
   std::stringstream perf_res_str;
-  if (time_secs < PerfResults::kMaxTime) {
-    perf_res_str << std::fixed << std::setprecision(10) << time_secs;
-    std::cout << relative_path << ":" << type_test_name << ":" << perf_res_str.str() << '\n';
-  } else {
-    std::stringstream err_msg;
-    err_msg << '\n' << "Task execute time need to be: ";
-    err_msg << "time < " << PerfResults::kMaxTime << " secs." << '\n';
-    err_msg << "Original time in secs: " << time_secs << '\n';
-    perf_res_str << std::fixed << std::setprecision(10) << -1.0;
-    std::cout << relative_path << ":" << type_test_name << ":" << perf_res_str.str() << '\n';
-    throw std::runtime_error(err_msg.str().c_str());
+  perf_res_str << std::fixed << std::setprecision(10)
+               << (exceeded && budget.policy == BudgetPolicy::kFail ? -1.0 : time_secs);
+  std::cout << relative_path << ":" << type_test_name << ":" << perf_res_str.str() << '\n';
+
+  // per-run statistics go to a separate line, so scripts/create_perf_table.py keeps parsing the total time
+  if (!perf_results->samples.empty()) {
+    const auto& stats = perf_results->statistics;
+    std::stringstream stats_str;
+    stats_str << std::fixed << std::setprecision(10) << "samples=" << stats.num_samples
+              << ",outliers=" << stats.num_outliers << ",min=" << stats.min << ",median=" << stats.median
+              << ",mean=" << stats.mean << ",p90=" << stats.p90 << ",p99=" << stats.p99 << ",max=" << stats.max
+              << ",stddev=" << stats.stddev << ",ci95=" << stats.ci95 << ",runs_per_sec=" << perf_results->runs_per_sec;
+    std::cout << relative_path << ":" << type_test_name << ":statistics:" << stats_str.str() << '\n';
+  }
+
+  if (!perf_results->ranks.rank_times.empty()) {
+    const auto& ranks = perf_results->ranks;
+    std::stringstream ranks_str;
+    ranks_str << std::fixed << std::setprecision(10) << "num=" << ranks.rank_times.size() << ",min=" << ranks.min
+              << ",mean=" << ranks.mean << ",max=" << ranks.max << ",imbalance=" << ranks.imbalance;
+    std::cout << relative_path << ":" << type_test_name << ":ranks:" << ranks_str.str() << '\n';
+  }
+
+  if (perf_results->scratch_peak_bytes > 0) {
+    std::cout << relative_path << ":" << type_test_name
+              << ":memory:scratch_peak_bytes=" << perf_results->scratch_peak_bytes << '\n';
+  }
+
+  const auto& phases = perf_results->profile.GetPhases();
+  if (!phases.empty()) {
+    std::stringstream phases_str;
+    phases_str << std::fixed << std::setprecision(10);
+    std::string separator;
+    for (const auto* records : {&phases, &perf_results->profile.GetScopes()}) {
+      for (const auto& [name, record] : *records) {
+        phases_str << separator << name << "=" << record.wall_sec;
+        separator = ",";
+      }
+    }
+    std::cout << relative_path << ":" << type_test_name << ":phases:" << phases_str.str() << '\n';
+  }
+
+  const auto results_path = ppc::util::GetEnvVariable("PPC_PERF_RESULTS");
+  if (!results_path.empty()) {
+    WriteResultRecord(perf_results, relative_path, results_path);
+  }
+
+  budget.Check(time_secs, perf_results->input_size, num_runs);
+}
+
+void ppc::core::Perf::WriteRanksReport(const std::shared_ptr<PerfResults>& perf_results, const std::string& path) {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("Can't open file for ranks report: " + path);
+  }
+
+  const auto& ranks = perf_results->ranks;
+  file << std::fixed << std::setprecision(10);
+  file << "{\n";
+  file << "  \"type\": \"" << TypeOfRunningName(perf_results->type_of_running) << "\",\n";
+  file << "  \"time_sec\": " << perf_results->time_sec << ",\n";
+  file << "  \"num_ranks\": " << ranks.rank_times.size() << ",\n";
+  file << "  \"min\": " << ranks.min << ",\n";
+  file << "  \"mean\": " << ranks.mean << ",\n";
+  file << "  \"max\": " << ranks.max << ",\n";
+  file << "  \"imbalance\": " << ranks.imbalance << ",\n";
+  file << "  \"rank_times\": [";
+  for (size_t i = 0; i < ranks.rank_times.size(); i++) {
+    file << (i == 0 ? "" : ", ") << ranks.rank_times[i];
+  }
+  file << "]\n";
+  file << "}\n";
+}
+
+void ppc::core::Perf::WriteResultRecord(const std::shared_ptr<PerfResults>& perf_results, const std::string& task_path,
+                                        const std::string& path) {
+  const bool is_csv = path.ends_with(".csv");
+  const bool write_header = is_csv && (!std::filesystem::exists(path) || std::filesystem::file_size(path) == 0);
+  std::ofstream file(path, std::ios::app);
+  if (!file.is_open()) {
+    throw std::runtime_error("Can't open file for perf results: " + path);
+  }
+
+  auto [backend, task] = ppc::util::SplitTaskPath(task_path);
+  const auto& stats = perf_results->statistics;
+  // the gathered rank times if the task has them, otherwise the size of the launch
+  const auto num_ranks = perf_results->ranks.rank_times.empty()
+                             ? static_cast<size_t>(ppc::util::GetLaunchedRanks())
+                             : perf_results->ranks.rank_times.size();
+  const auto run_type = TypeOfRunningName(perf_results->type_of_running);
+  const auto test_name = CurrentTestName();
+  const auto host = HostName();
+  const auto timestamp =
+      std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  auto git_commit = ppc::util::GetEnvVariable("PPC_GIT_COMMIT");
+  if (git_commit.empty()) {
+    git_commit = "unknown";
+  }
+
+  file << std::setprecision(10);
+  if (is_csv) {
+    if (write_header) {
+      file << "task,backend,type,variant,test,ranks,threads,input_size,time_sec,runs_per_sec,num_samples,"
+              "num_outliers,min,median,mean,p90,p99,max,stddev,ci95,scratch_peak_bytes,git_commit,host,"
+              "hardware_concurrency,timestamp,samples\n";
+    }
+    file << CsvField(task) << ',' << CsvField(backend) << ',' << run_type << ',' << CsvField(perf_results->variant)
+         << ',' << CsvField(test_name) << ',' << num_ranks << ',' << ppc::util::GetPPCNumThreads() << ','
+         << perf_results->input_size << ',' << perf_results->time_sec << ',' << perf_results->runs_per_sec << ','
+         << stats.num_samples << ',' << stats.num_outliers << ',' << stats.min << ',' << stats.median << ','
+         << stats.mean << ',' << stats.p90 << ',' << stats.p99 << ',' << stats.max << ',' << stats.stddev << ','
+         << stats.ci95 << ','
+         << perf_results->scratch_peak_bytes << ',' << CsvField(git_commit) << ',' << CsvField(host) << ','
+         << std::thread::hardware_concurrency() << ',' << timestamp << ',';
+    // samples are kept in one column
+    for (size_t i = 0; i < perf_results->samples.size(); i++) {
+      file << (i == 0 ? "" : ";") << perf_results->samples[i];
+    }
+    file << '\n';
+    return;
+  }
+
+  file << "{\"task\": " << JsonString(task) << ", \"backend\": " << JsonString(backend) << ", \"type\": \""
+       << run_type << "\", \"variant\": " << JsonString(perf_results->variant)
+       << ", \"test\": " << JsonString(test_name) << ", \"ranks\": " << num_ranks
+       << ", \"threads\": " << ppc::util::GetPPCNumThreads() << ", \"input_size\": " << perf_results->input_size
+       << ", \"time_sec\": " << perf_results->time_sec << ", \"runs_per_sec\": " << perf_results->runs_per_sec
+       << ", \"statistics\": {\"num_samples\": " << stats.num_samples << ", \"num_outliers\": " << stats.num_outliers
+       << ", \"min\": " << stats.min << ", \"median\": " << stats.median << ", \"mean\": " << stats.mean
+       << ", \"p90\": " << stats.p90 << ", \"p99\": " << stats.p99 << ", \"max\": " << stats.max
+       << ", \"stddev\": " << stats.stddev << ", \"ci95\": " << stats.ci95
+       << "}, \"scratch_peak_bytes\": " << perf_results->scratch_peak_bytes
+       << ", \"git_commit\": " << JsonString(git_commit) << ", \"host\": " << JsonString(host)
+       << ", \"hardware_concurrency\": " << std::thread::hardware_concurrency()
+       << ", \"timestamp\": " << timestamp << ", \"samples\": [";
+  for (size_t i = 0; i < perf_results->samples.size(); i++) {
+    file << (i == 0 ? "" : ", ") << perf_results->samples[i];
   }
+  file << "]}\n";
 }
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "core/sort/include/sort.hpp"
+
+namespace {
+
+using ppc::sort::KeyPosition;
+
+// the parts every rank would receive from ExchangeBySplitters, merged
+std::vector<std::vector<uint64_t>> SimulateExchange(std::vector<std::vector<uint64_t>> blocks) {
+  const int parts = static_cast<int>(blocks.size());
+  std::vector<KeyPosition> samples;
+  for (int rank = 0; rank < parts; ++rank) {
+    std::ranges::sort(blocks[rank]);
+    auto block_samples =
+        ppc::sort::RegularSamples(blocks[rank], rank, std::min(parts, static_cast<int>(blocks[rank].size())));
+    samples.insert(samples.end(), block_samples.begin(), block_samples.end());
+  }
+  const auto splitters = ppc::sort::ChooseSplitters(samples, parts);
+
+  std::vector<std::vector<uint64_t>> received(parts);
+  std::vector<std::vector<int>> run_sizes(parts);
+  for (int rank = 0; rank < parts; ++rank) {
+    auto sizes = ppc::sort::PartitionBySplitters(blocks[rank], rank, splitters, parts);
+    size_t begin = 0;
+    for (int part = 0; part < parts; ++part) {
+      received[part].insert(received[part].end(), blocks[rank].begin() + static_cast<std::ptrdiff_t>(begin),
+                            blocks[rank].begin() + static_cast<std::ptrdiff_t>(begin + sizes[part]));
+      run_sizes[part].push_back(sizes[part]);
+      begin += sizes[part];
+    }
+    EXPECT_EQ(begin, blocks[rank].size());
+  }
+  for (int part = 0; part < parts; ++part) {
+    ppc::sort::MergeRuns(received[part], run_sizes[part]);
+  }
+  return received;
+}
+
+void ExpectSortedInRankOrder(const std::vector<std::vector<uint64_t>>& parts, std::vector<uint64_t> all) {
+  std::vector<uint64_t> joined;
+  for (const auto& part : parts) {
+    joined.insert(joined.end(), part.begin(), part.end());
+  }
+  std::ranges::sort(all);
+  EXPECT_EQ(joined, all);
+}
+
+}  // namespace
+
+TEST(sort, keys_keep_the_order_of_doubles) {
+  std::vector<double> values = {-std::numeric_limits<double>::infinity(), -1e300, -2.5, -0.0, 0.0, 1e-300, 3.0,
+                                std::numeric_limits<double>::infinity()};
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(ppc::sort::FromKey(ppc::sort::ToKey(values[i])), values[i]);
+    if (i > 0) {
+      EXPECT_LT(ppc::sort::ToKey(values[i - 1]), ppc::sort::ToKey(values[i]));
+    }
+  }
+}
+
+TEST(sort, merge_runs_merges_any_number_of_runs) {
+  std::vector<uint64_t> keys = {1, 4, 9, 2, 3, 0, 5, 6, 7, 8};
+  std::vector<int> run_sizes = {3, 2, 0, 1, 4};
+  ppc::sort::MergeRuns(keys, run_sizes);
+  EXPECT_EQ(keys, (std::vector<uint64_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(sort, splitters_give_sorted_ranges) {
+  std::mt19937_64 gen(3);
+  std::vector<std::vector<uint64_t>> blocks(5);
+  std::vector<uint64_t> all;
+  for (auto& block : blocks) {
+    block.resize(1000 + (gen() % 100));
+    for (auto& key : block) {
+      key = gen();
+    }
+    all.insert(all.end(), block.begin(), block.end());
+  }
+  ExpectSortedInRankOrder(SimulateExchange(blocks), all);
+}
+
+TEST(sort, equal_keys_are_split_between_ranks) {
+  for (int ranks : {2, 3, 4, 7}) {
+    const int block_size = 1000;
+    std::vector<std::vector<uint64_t>> blocks(ranks, std::vector<uint64_t>(block_size, 42));
+    auto parts = SimulateExchange(blocks);
+    ExpectSortedInRankOrder(parts, std::vector<uint64_t>(blocks.size() * block_size, 42));
+    for (const auto& part : parts) {
+      EXPECT_LE(part.size(), 2U * block_size);
+    }
+  }
+}
+
+TEST(sort, fewer_keys_than_ranks) {
+  std::vector<std::vector<uint64_t>> blocks = {{5}, {}, {}, {5}};
+  ExpectSortedInRankOrder(SimulateExchange(blocks), {5, 5});
+  ExpectSortedInRankOrder(SimulateExchange({{}, {}, {}}), {});
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ppc::sort {
+
+// order-preserving map of doubles to unsigned keys and back
+uint64_t ToKey(double value);
+double FromKey(uint64_t key);
+
+// merges the sorted runs of the given sizes lying back to back in keys, pairwise in log(runs) passes
+void MergeRuns(std::vector<uint64_t>& keys, std::span<const int> run_sizes);
+
+// Splitters of a sample sort over the sorted key blocks of several ranks
+// (ExchangeBySplitters in sort_mpi.hpp). A key is compared together with its
+// rank and its index in the block, which orders all keys strictly: a run of
+// equal keys is cut between ranks like any other run instead of going to one.
+struct KeyPosition {
+  uint64_t key;
+  int rank;
+  uint64_t index;
+
+  auto operator<=>(const KeyPosition&) const = default;
+};
+
+// count regular samples of the sorted keys of rank
+std::vector<KeyPosition> RegularSamples(std::span<const uint64_t> keys, int rank, int count);
+
+// parts - 1 splitters evenly spaced among the samples of all ranks, none without samples
+std::vector<KeyPosition> ChooseSplitters(std::vector<KeyPosition> samples, int parts);
+
+// Sizes of the parts of the sorted keys of rank: part i gets the keys above
+// splitter i - 1 and up to splitter i, part splitters.size() the rest.
+std::vector<int> PartitionBySplitters(std::span<const uint64_t> keys, int rank, std::span<const KeyPosition> splitters,
+                                      int parts);
+
+}  // namespace ppc::sort
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "core/sort/include/sort.hpp"
+
+namespace ppc::sort {
+
+// Sample sort step: keys is the sorted block of every rank of comm. Regular
+// samples of all blocks give size - 1 splitters (ChooseSplitters), one
+// MPI_Alltoallv sends every key to the rank of its splitter range, and the
+// runs received there are merged. Returns the sorted keys of the own range;
+// the ranges follow the rank order.
+inline std::vector<uint64_t> ExchangeBySplitters(const std::vector<uint64_t>& keys, MPI_Comm comm) {
+  int rank = 0;
+  int size = 0;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  // samples travel as (key, index) pairs, the rank follows from where they land
+  auto samples = RegularSamples(keys, rank, std::min(size, static_cast<int>(keys.size())));
+  std::vector<uint64_t> flat_samples;
+  for (const auto& sample : samples) {
+    flat_samples.insert(flat_samples.end(), {sample.key, sample.index});
+  }
+  int flat_count = static_cast<int>(flat_samples.size());
+  std::vector<int> flat_counts(size);
+  MPI_Allgather(&flat_count, 1, MPI_INT, flat_counts.data(), 1, MPI_INT, comm);
+  std::vector<int> flat_offsets(size, 0);
+  for (int i = 1; i < size; ++i) {
+    flat_offsets[i] = flat_offsets[i - 1] + flat_counts[i - 1];
+  }
+  std::vector<uint64_t> all_flat(std::accumulate(flat_counts.begin(), flat_counts.end(), size_t{0}));
+  MPI_Allgatherv(flat_samples.data(), flat_count, MPI_UINT64_T, all_flat.data(), flat_counts.data(),
+                 flat_offsets.data(), MPI_UINT64_T, comm);
+  std::vector<KeyPosition> all_samples;
+  all_samples.reserve(all_flat.size() / 2);
+  for (int source = 0; source < size; ++source) {
+    for (int i = flat_offsets[source]; i < flat_offsets[source] + flat_counts[source]; i += 2) {
+      all_samples.push_back({.key = all_flat[i], .rank = source, .index = all_flat[i + 1]});
+    }
+  }
+  const auto splitters = ChooseSplitters(std::move(all_samples), size);
+
+  std::vector<int> send_counts = PartitionBySplitters(keys, rank, splitters, size);
+  std::vector<int> send_offsets(size, 0);
+  for (int i = 1; i < size; ++i) {
+    send_offsets[i] = send_offsets[i - 1] + send_counts[i - 1];
+  }
+  std::vector<int> recv_counts(size);
+  MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm);
+  std::vector<int> recv_offsets(size, 0);
+  for (int i = 1; i < size; ++i) {
+    recv_offsets[i] = recv_offsets[i - 1] + recv_counts[i - 1];
+  }
+  std::vector<uint64_t> received(std::accumulate(recv_counts.begin(), recv_counts.end(), size_t{0}));
+  MPI_Alltoallv(keys.data(), send_counts.data(), send_offsets.data(), MPI_UINT64_T, received.data(),
+                recv_counts.data(), recv_offsets.data(), MPI_UINT64_T, comm);
+
+  MergeRuns(received, recv_counts);
+  return received;
+}
+
+}  // namespace ppc::sort
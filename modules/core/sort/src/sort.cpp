@@ -0,0 +1,93 @@
+#include "core/sort/include/sort.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kSignMask = 1ULL << 63;
+
+// number of keys at or before the position splitter
+size_t CountUpTo(std::span<const uint64_t> keys, int rank, const ppc::sort::KeyPosition& splitter) {
+  if (rank < splitter.rank) {
+    return std::ranges::upper_bound(keys, splitter.key) - keys.begin();
+  }
+  if (rank > splitter.rank) {
+    return std::ranges::lower_bound(keys, splitter.key) - keys.begin();
+  }
+  return splitter.index + 1;
+}
+
+}  // namespace
+
+uint64_t ppc::sort::ToKey(double value) {
+  uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(double));
+  return (bits & kSignMask) != 0 ? ~bits : (bits | kSignMask);
+}
+
+double ppc::sort::FromKey(uint64_t key) {
+  const uint64_t bits = (key & kSignMask) != 0 ? (key & ~kSignMask) : ~key;
+  double value = 0.0;
+  std::memcpy(&value, &bits, sizeof(double));
+  return value;
+}
+
+void ppc::sort::MergeRuns(std::vector<uint64_t>& keys, std::span<const int> run_sizes) {
+  std::vector<size_t> bounds = {0};
+  for (int run_size : run_sizes) {
+    bounds.push_back(bounds[bounds.size() - 1] + run_size);
+  }
+  std::vector<uint64_t> buffer(keys.size());
+  while (bounds.size() > 2) {
+    std::vector<size_t> next_bounds = {0};
+    for (size_t run = 0; run + 1 < bounds.size(); run += 2) {
+      const size_t end = bounds[std::min(run + 2, bounds.size() - 1)];
+      std::merge(keys.data() + bounds[run], keys.data() + bounds[run + 1], keys.data() + bounds[run + 1],
+                 keys.data() + end, buffer.data() + bounds[run]);
+      next_bounds.push_back(end);
+    }
+    keys.swap(buffer);
+    bounds.swap(next_bounds);
+  }
+}
+
+std::vector<ppc::sort::KeyPosition> ppc::sort::RegularSamples(std::span<const uint64_t> keys, int rank, int count) {
+  std::vector<KeyPosition> samples(count);
+  for (int i = 0; i < count; ++i) {
+    const uint64_t index = (static_cast<uint64_t>(i) * keys.size()) / count;
+    samples[i] = {.key = keys[index], .rank = rank, .index = index};
+  }
+  return samples;
+}
+
+std::vector<ppc::sort::KeyPosition> ppc::sort::ChooseSplitters(std::vector<KeyPosition> samples, int parts) {
+  if (samples.empty()) {
+    return {};
+  }
+  std::ranges::sort(samples);
+  std::vector<KeyPosition> splitters(parts - 1);
+  for (int i = 0; i + 1 < parts; ++i) {
+    splitters[i] = samples[((i + 1) * samples.size()) / parts];
+  }
+  return splitters;
+}
+
+std::vector<int> ppc::sort::PartitionBySplitters(std::span<const uint64_t> keys, int rank,
+                                                 std::span<const KeyPosition> splitters, int parts) {
+  std::vector<int> sizes(parts, 0);
+  size_t begin = 0;
+  for (int i = 0; i < parts; ++i) {
+    size_t end = keys.size();
+    if (static_cast<size_t>(i) < splitters.size()) {
+      end = std::max(begin, CountUpTo(keys, rank, splitters[i]));
+    }
+    sizes[i] = static_cast<int>(end - begin);
+    begin = end;
+  }
+  return sizes;
+}
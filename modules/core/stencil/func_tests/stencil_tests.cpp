@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/stencil/include/stencil.hpp"
+
+namespace {
+
+using ppc::stencil::Filter;
+
+const std::vector<Filter> kFilters = {Filter::kSobel3, Filter::kSobel5,    Filter::kScharr3,  Filter::kBox3,
+                                      Filter::kBox5,   Filter::kGaussian3, Filter::kGaussian5};
+
+// rows x cols pixels, random or random 0 / 255 (the largest sums)
+std::vector<uint8_t> RandomImage(size_t rows, size_t cols, bool extremes, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> value(0, 255);
+  std::vector<uint8_t> image(rows * cols);
+  for (auto& pixel : image) {
+    pixel = static_cast<uint8_t>(extremes ? (value(gen) % 2) * 255 : value(gen));
+  }
+  return image;
+}
+
+// direct 2-D convolution of the pixel (y, x) of a rows x cols image with the full kernels
+uint8_t Reference(Filter filter, const std::vector<uint8_t>& image, size_t cols, size_t y, size_t x) {
+  const std::vector<int> smooth3 = {1, 2, 1};
+  const std::vector<int> smooth5 = {1, 4, 6, 4, 1};
+  const std::vector<int> scharr = {3, 10, 3};
+  const std::vector<int> derivative3 = {-1, 0, 1};
+  const std::vector<int> derivative5 = {-1, -2, 0, 2, 1};
+  const std::vector<int> box3 = {1, 1, 1};
+  const std::vector<int> box5 = {1, 1, 1, 1, 1};
+  const auto radius = static_cast<int>(ppc::stencil::Radius(filter));
+  auto convolve = [&](const std::vector<int>& column_taps, const std::vector<int>& row_taps) {
+    int sum = 0;
+    for (int dy = -radius; dy <= radius; ++dy) {
+      for (int dx = -radius; dx <= radius; ++dx) {
+        sum += column_taps[dy + radius] * row_taps[dx + radius] * image[((y + dy) * cols) + x + dx];
+      }
+    }
+    return sum;
+  };
+  auto magnitude = [&](const std::vector<int>& smooth, const std::vector<int>& derivative) {
+    const int gx = convolve(smooth, derivative);
+    const int gy = convolve(derivative, smooth);
+    return static_cast<uint8_t>(std::min(std::sqrt(static_cast<double>((gx * gx) + (gy * gy))), 255.0));
+  };
+  auto mean = [&](const std::vector<int>& taps, int divisor) {
+    return static_cast<uint8_t>(std::lround(static_cast<double>(convolve(taps, taps)) / divisor));
+  };
+  switch (filter) {
+    case Filter::kSobel3:
+      return magnitude(smooth3, derivative3);
+    case Filter::kSobel5:
+      return magnitude(smooth5, derivative5);
+    case Filter::kScharr3:
+      return magnitude(scharr, derivative3);
+    case Filter::kBox3:
+      return mean(box3, 9);
+    case Filter::kBox5:
+      return mean(box5, 25);
+    case Filter::kGaussian3:
+      return mean(smooth3, 16);
+    case Filter::kGaussian5:
+      return mean(smooth5, 256);
+  }
+  return 0;
+}
+
+// Sobel 3 x 3 of the pixel (y, x) from the full kernels, with the direction
+// of its gradient rounded to 0, 45, 90 or 135 degrees (y pointing down)
+struct Gradient {
+  uint8_t magnitude;
+  int direction;
+};
+
+Gradient SobelReference(const std::vector<uint8_t>& image, size_t cols, size_t y, size_t x,
+                        ppc::stencil::Magnitude norm) {
+  const std::vector<int> smooth = {1, 2, 1};
+  const std::vector<int> derivative = {-1, 0, 1};
+  int gx = 0;
+  int gy = 0;
+  for (int dy = -1; dy <= 1; ++dy) {
+    for (int dx = -1; dx <= 1; ++dx) {
+      const int pixel = image[((y + dy) * cols) + x + dx];
+      gx += smooth[dy + 1] * derivative[dx + 1] * pixel;
+      gy += derivative[dy + 1] * smooth[dx + 1] * pixel;
+    }
+  }
+  const double length = norm == ppc::stencil::Magnitude::kL2 ? std::hypot(gx, gy) : std::abs(gx) + std::abs(gy);
+  const auto magnitude = static_cast<uint8_t>(std::min(length, 255.0));
+  // the sectors of 0 and 90 degrees end at the slopes 2 / 5 and 5 / 2
+  const double slope = static_cast<double>(std::abs(gy)) / std::max(std::abs(gx), 1);
+  int direction = (gx < 0) == (gy < 0) ? 1 : 3;
+  if (gx != 0 && slope < 0.4) {
+    direction = 0;
+  } else if (gy != 0 && (gx == 0 || slope > 2.5)) {
+    direction = 2;
+  }
+  return {.magnitude = magnitude, .direction = direction};
+}
+
+// Sobel with non-maximum suppression of the pixel (y, x), 2 pixels from the edges
+uint8_t SuppressedReference(const std::vector<uint8_t>& image, size_t cols, size_t y, size_t x,
+                            ppc::stencil::Magnitude norm) {
+  // neighbours along 0, 45, 90 and 135 degrees
+  const std::vector<std::vector<int>> steps = {{0, 1}, {1, 1}, {1, 0}, {1, -1}};
+  const auto center = SobelReference(image, cols, y, x, norm);
+  const auto& step = steps[center.direction];
+  const auto before = SobelReference(image, cols, y - step[0], x - step[1], norm);
+  const auto after = SobelReference(image, cols, y + step[0], x + step[1], norm);
+  const bool maximum = center.magnitude >= before.magnitude && center.magnitude >= after.magnitude;
+  return maximum ? center.magnitude : 0;
+}
+
+// ppc::stencil::Sobel over the image but its SobelRadius() edges against the references
+void ExpectSobelMatches(const std::vector<uint8_t>& image, size_t rows, size_t cols,
+                        const ppc::stencil::SobelOptions& options) {
+  const size_t radius = ppc::stencil::SobelRadius(options);
+  const size_t tile_rows = rows - (2 * radius);
+  const size_t tile_cols = cols - (2 * radius);
+  std::vector<uint8_t> output(tile_rows * tile_cols);
+  ppc::stencil::Sobel(image.data() + (radius * cols) + radius, cols, tile_rows, tile_cols, output.data(), tile_cols,
+                      options);
+  for (size_t y = 0; y < tile_rows; ++y) {
+    for (size_t x = 0; x < tile_cols; ++x) {
+      const uint8_t expected =
+          options.non_max_suppression
+              ? SuppressedReference(image, cols, y + radius, x + radius, options.magnitude)
+              : SobelReference(image, cols, y + radius, x + radius, options.magnitude).magnitude;
+      ASSERT_EQ(output[(y * tile_cols) + x], expected)
+          << "L" << (options.magnitude == ppc::stencil::Magnitude::kL2 ? 2 : 1) << ", suppression "
+          << options.non_max_suppression << ", " << cols << " columns, pixel " << y << ", " << x << ", kernels "
+          << ppc::stencil::SobelKernelName();
+    }
+  }
+}
+
+const std::vector<ppc::stencil::SobelOptions> kSobelOptions = {
+    {.magnitude = ppc::stencil::Magnitude::kL2, .non_max_suppression = false},
+    {.magnitude = ppc::stencil::Magnitude::kL1, .non_max_suppression = false},
+    {.magnitude = ppc::stencil::Magnitude::kL2, .non_max_suppression = true},
+    {.magnitude = ppc::stencil::Magnitude::kL1, .non_max_suppression = true}};
+
+}  // namespace
+
+TEST(stencil_tests, radius_is_half_the_window) {
+  EXPECT_EQ(ppc::stencil::Radius(Filter::kSobel3), 1U);
+  EXPECT_EQ(ppc::stencil::Radius(Filter::kScharr3), 1U);
+  EXPECT_EQ(ppc::stencil::Radius(Filter::kSobel5), 2U);
+  EXPECT_EQ(ppc::stencil::Radius(Filter::kGaussian5), 2U);
+}
+
+TEST(stencil_tests, matches_direct_convolution) {
+  // widths around the vector width of the kernels in use
+  const size_t rows = 9;
+  for (size_t cols : {5U, 20U, 21U, 36U, 53U}) {
+    for (bool extremes : {false, true}) {
+      const auto image = RandomImage(rows, cols, extremes, static_cast<unsigned>(cols));
+      for (auto filter : kFilters) {
+        const size_t radius = ppc::stencil::Radius(filter);
+        const size_t tile_rows = rows - (2 * radius);
+        const size_t tile_cols = cols - (2 * radius);
+        std::vector<uint8_t> output(tile_rows * tile_cols);
+        ppc::stencil::ApplyFilter(filter, image.data() + (radius * cols) + radius, cols, tile_rows, tile_cols,
+                                  output.data(), tile_cols);
+        for (size_t y = 0; y < tile_rows; ++y) {
+          for (size_t x = 0; x < tile_cols; ++x) {
+            ASSERT_EQ(output[(y * tile_cols) + x], Reference(filter, image, cols, y + radius, x + radius))
+                << "filter " << static_cast<int>(filter) << ", " << cols << " columns, pixel " << y << ", " << x
+                << ", kernels " << ppc::stencil::FilterKernelName();
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(stencil_tests, writes_only_the_tile) {
+  const size_t rows = 12;
+  const size_t cols = 40;
+  const auto image = RandomImage(rows, cols, false, 3);
+  std::vector<uint8_t> output(rows * cols, 7);
+  // rows 3-7, columns 2-34
+  ppc::stencil::ApplyFilter(Filter::kGaussian5, image.data() + (3 * cols) + 2, cols, 5, 33,
+                            output.data() + (3 * cols) + 2, cols);
+  for (size_t y = 0; y < rows; ++y) {
+    for (size_t x = 0; x < cols; ++x) {
+      if (y >= 3 && y < 8 && x >= 2 && x < 35) {
+        EXPECT_EQ(output[(y * cols) + x], Reference(Filter::kGaussian5, image, cols, y, x));
+      } else {
+        EXPECT_EQ(output[(y * cols) + x], 7);
+      }
+    }
+  }
+}
+
+TEST(stencil_tests, constant_image_keeps_its_value) {
+  const std::vector<uint8_t> image(10 * 30, 200);
+  for (auto filter : kFilters) {
+    std::vector<uint8_t> output(6 * 26);
+    ppc::stencil::ApplyFilter(filter, image.data() + (2 * 30) + 2, 30, 6, 26, output.data(), 26);
+    const uint8_t expected = (filter == Filter::kSobel3 || filter == Filter::kSobel5 || filter == Filter::kScharr3)
+                                 ? 0
+                                 : 200;
+    EXPECT_TRUE(std::ranges::all_of(output, [&](uint8_t value) { return value == expected; }));
+  }
+}
+
+TEST(stencil_tests, sobel_radius_grows_with_suppression) {
+  EXPECT_EQ(ppc::stencil::SobelRadius({}), 1U);
+  EXPECT_EQ(ppc::stencil::SobelRadius({.magnitude = ppc::stencil::Magnitude::kL1, .non_max_suppression = true}), 2U);
+}
+
+TEST(stencil_tests, sobel_matches_direct_convolution) {
+  const size_t rows = 9;
+  for (size_t cols : {5U, 12U, 20U, 21U, 36U, 53U}) {
+    for (bool extremes : {false, true}) {
+      const auto image = RandomImage(rows, cols, extremes, static_cast<unsigned>(cols) + 100);
+      for (const auto& options : kSobelOptions) {
+        ExpectSobelMatches(image, rows, cols, options);
+      }
+    }
+  }
+}
+
+TEST(stencil_tests, sobel_suppression_thins_a_ramp) {
+  // brightness grows to the right up to column 10 and then falls: wide
+  // horizontal gradients with plateaus and a turn
+  const size_t rows = 8;
+  const size_t cols = 24;
+  std::vector<uint8_t> image(rows * cols);
+  for (size_t y = 0; y < rows; ++y) {
+    for (size_t x = 0; x < cols; ++x) {
+      image[(y * cols) + x] = static_cast<uint8_t>(x < 10 ? x * x : 100 - ((x - 10) * 3));
+    }
+  }
+  ExpectSobelMatches(image, rows, cols, {.magnitude = ppc::stencil::Magnitude::kL2, .non_max_suppression = true});
+}
+
+TEST(stencil_tests, sobel_wide_rows_go_in_tiles) {
+  // more than two tiles of columns and a tail
+  const size_t rows = 7;
+  const size_t cols = 4133;
+  const auto image = RandomImage(rows, cols, false, 11);
+  for (const auto& options : kSobelOptions) {
+    ExpectSobelMatches(image, rows, cols, options);
+  }
+}
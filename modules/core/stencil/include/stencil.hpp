@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ppc::stencil {
+
+// 3 x 3 and 5 x 5 filters of 8-bit grayscale images. All of them are
+// separable and computed in two 16-bit passes (columns, then rows) whose
+// results are exact:
+//  - gradients (Sobel, Scharr): min(sqrt(gx^2 + gy^2), 255), rounded down,
+//  - smoothing (box, Gaussian): the weighted mean, rounded to nearest.
+// Scharr has no common 5 x 5 form and is 3 x 3 only.
+enum class Filter : uint8_t { kSobel3, kSobel5, kScharr3, kBox3, kBox5, kGaussian3, kGaussian5 };
+
+// half the window: 1 for the 3 x 3 filters, 2 for the 5 x 5 ones
+size_t Radius(Filter filter);
+
+// Filters a rows x cols tile. input points to its first pixel and must be
+// readable Radius(filter) pixels around the tile; strides are the distances
+// between the starts of rows, in pixels.
+void ApplyFilter(Filter filter, const uint8_t* input, size_t input_stride, size_t rows, size_t cols, uint8_t* output,
+                 size_t output_stride);
+
+// vector kernels in use: "avx2" or "scalar"
+const char* FilterKernelName();
+
+// Sobel 3 x 3 in integers only: column sums and differences, row sums and
+// differences and the magnitude of 16 (AVX2) or 8 (SSE4.1) pixels at a time
+// in 16-bit lanes, without intermediate images. Wide images go in tiles of
+// columns, so that the rows of a tile stay in L1.
+enum class Magnitude : uint8_t {
+  kL2,  // min(sqrt(gx^2 + gy^2), 255), rounded down: the same as Filter::kSobel3
+  kL1,  // min(|gx| + |gy|, 255)
+};
+
+struct SobelOptions {
+  Magnitude magnitude = Magnitude::kL2;
+  // keep a magnitude only if neither neighbour along the gradient direction,
+  // rounded to a multiple of 45 degrees, has a larger one; 0 otherwise.
+  // The rounding takes |gy| / |gx| < 2 / 5 as horizontal, > 5 / 2 as vertical.
+  bool non_max_suppression = false;
+};
+
+// 1, or 2 with non-maximum suppression
+size_t SobelRadius(const SobelOptions& options);
+
+// Sobel magnitudes of a rows x cols tile, laid out as for ApplyFilter; input
+// must be readable SobelRadius(options) pixels around the tile
+void Sobel(const uint8_t* input, size_t input_stride, size_t rows, size_t cols, uint8_t* output, size_t output_stride,
+           const SobelOptions& options = {});
+
+// vector kernels in use: "avx2", "sse4.1" or "scalar"
+const char* SobelKernelName();
+
+}  // namespace ppc::stencil
@@ -0,0 +1,616 @@
+#include "core/stencil/include/stencil.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#include "core/util/include/simd_dispatch.hpp"
+
+namespace {
+
+using ppc::stencil::Filter;
+
+constexpr size_t kMaxTaps = 5;
+
+// The 2-D kernels are outer products of a column and a row of taps. Sums
+// are kept in 16 bits; the vector kernels wrap around like the scalar ones
+// (modular conversion to int16_t), and the final sums fit: gradients in
+// int16_t (|gx| <= 16 * 6 * 255 for Sobel 5 x 5), smoothing sums in
+// uint16_t (<= 256 * 255 for Gaussian 5 x 5).
+struct FilterSpec {
+  size_t radius;
+  bool gradient;
+  std::array<int16_t, kMaxTaps> smooth;
+  // gradients: gx = smooth (columns) then derivative (rows), gy the other way round
+  std::array<int16_t, kMaxTaps> derivative;
+  // smoothing: mean = (sum + divisor / 2) / divisor
+  //                 = (((sum + divisor / 2) * multiplier) >> 16) >> shift for every sum up to 255 * divisor
+  uint16_t divisor;
+  uint16_t multiplier;
+  int shift;
+};
+
+const FilterSpec& Spec(Filter filter) {
+  static constexpr FilterSpec kSobel3{.radius = 1,
+                                      .gradient = true,
+                                      .smooth = {1, 2, 1},
+                                      .derivative = {-1, 0, 1},
+                                      .divisor = 0,
+                                      .multiplier = 0,
+                                      .shift = 0};
+  static constexpr FilterSpec kSobel5{.radius = 2,
+                                      .gradient = true,
+                                      .smooth = {1, 4, 6, 4, 1},
+                                      .derivative = {-1, -2, 0, 2, 1},
+                                      .divisor = 0,
+                                      .multiplier = 0,
+                                      .shift = 0};
+  static constexpr FilterSpec kScharr3{.radius = 1,
+                                       .gradient = true,
+                                       .smooth = {3, 10, 3},
+                                       .derivative = {-1, 0, 1},
+                                       .divisor = 0,
+                                       .multiplier = 0,
+                                       .shift = 0};
+  static constexpr FilterSpec kBox3{.radius = 1,
+                                    .gradient = false,
+                                    .smooth = {1, 1, 1},
+                                    .derivative = {},
+                                    .divisor = 9,
+                                    .multiplier = 7282,
+                                    .shift = 0};
+  static constexpr FilterSpec kBox5{.radius = 2,
+                                    .gradient = false,
+                                    .smooth = {1, 1, 1, 1, 1},
+                                    .derivative = {},
+                                    .divisor = 25,
+                                    .multiplier = 5243,
+                                    .shift = 1};
+  static constexpr FilterSpec kGaussian3{.radius = 1,
+                                         .gradient = false,
+                                         .smooth = {1, 2, 1},
+                                         .derivative = {},
+                                         .divisor = 16,
+                                         .multiplier = 4096,
+                                         .shift = 0};
+  static constexpr FilterSpec kGaussian5{.radius = 2,
+                                         .gradient = false,
+                                         .smooth = {1, 4, 6, 4, 1},
+                                         .derivative = {},
+                                         .divisor = 256,
+                                         .multiplier = 256,
+                                         .shift = 0};
+  switch (filter) {
+    case Filter::kSobel3:
+      return kSobel3;
+    case Filter::kSobel5:
+      return kSobel5;
+    case Filter::kScharr3:
+      return kScharr3;
+    case Filter::kBox3:
+      return kBox3;
+    case Filter::kBox5:
+      return kBox5;
+    case Filter::kGaussian3:
+      return kGaussian3;
+    case Filter::kGaussian5:
+      return kGaussian5;
+  }
+  throw std::invalid_argument("ApplyFilter: unknown filter");
+}
+
+// sums[x] = sum of taps[k] * input[k * stride + x] over the 2 * radius + 1 rows of the window
+using ColumnPass = void (*)(const uint8_t* input, size_t stride, const int16_t* taps, size_t taps_count, size_t width,
+                            int16_t* sums);
+// out[x] = magnitude of (sum of derivative[k] * smooth_sums[x + k], sum of smooth[k] * derivative_sums[x + k])
+using GradientPass = void (*)(const int16_t* smooth_sums, const int16_t* derivative_sums, const FilterSpec& spec,
+                              size_t cols, uint8_t* out);
+// out[x] = normalized sum of smooth[k] * sums[x + k]
+using MeanPass = void (*)(const int16_t* sums, const FilterSpec& spec, size_t cols, uint8_t* out);
+
+void ColumnPassScalar(const uint8_t* input, size_t stride, const int16_t* taps, size_t taps_count, size_t begin,
+                      size_t width, int16_t* sums) {
+  for (size_t x = begin; x < width; ++x) {
+    int sum = 0;
+    for (size_t k = 0; k < taps_count; ++k) {
+      sum += taps[k] * input[(k * stride) + x];
+    }
+    sums[x] = static_cast<int16_t>(sum);
+  }
+}
+
+uint8_t Magnitude(int gx, int gy) {
+  const float magnitude = std::sqrt(static_cast<float>((gx * gx) + (gy * gy)));
+  return static_cast<uint8_t>(std::min(magnitude, 255.0F));
+}
+
+void GradientPassScalar(const int16_t* smooth_sums, const int16_t* derivative_sums, const FilterSpec& spec,
+                        size_t begin, size_t cols, uint8_t* out) {
+  const size_t taps_count = (2 * spec.radius) + 1;
+  for (size_t x = begin; x < cols; ++x) {
+    int gx = 0;
+    int gy = 0;
+    for (size_t k = 0; k < taps_count; ++k) {
+      gx += spec.derivative[k] * smooth_sums[x + k];
+      gy += spec.smooth[k] * derivative_sums[x + k];
+    }
+    out[x] = Magnitude(static_cast<int16_t>(gx), static_cast<int16_t>(gy));
+  }
+}
+
+void MeanPassScalar(const int16_t* sums, const FilterSpec& spec, size_t begin, size_t cols, uint8_t* out) {
+  const size_t taps_count = (2 * spec.radius) + 1;
+  for (size_t x = begin; x < cols; ++x) {
+    int sum = 0;
+    for (size_t k = 0; k < taps_count; ++k) {
+      sum += spec.smooth[k] * sums[x + k];
+    }
+    out[x] = static_cast<uint8_t>((static_cast<uint16_t>(sum) + (spec.divisor / 2)) / spec.divisor);
+  }
+}
+
+[[maybe_unused]] void ColumnPassPortable(const uint8_t* input, size_t stride, const int16_t* taps, size_t taps_count,
+                                         size_t width, int16_t* sums) {
+  ColumnPassScalar(input, stride, taps, taps_count, 0, width, sums);
+}
+
+[[maybe_unused]] void GradientPassPortable(const int16_t* smooth_sums, const int16_t* derivative_sums,
+                                           const FilterSpec& spec, size_t cols, uint8_t* out) {
+  GradientPassScalar(smooth_sums, derivative_sums, spec, 0, cols, out);
+}
+
+[[maybe_unused]] void MeanPassPortable(const int16_t* sums, const FilterSpec& spec, size_t cols, uint8_t* out) {
+  MeanPassScalar(sums, spec, 0, cols, out);
+}
+
+#ifdef PPC_HAS_AVX2
+// 16 pixels per step; the tails go through the scalar passes
+constexpr size_t kAvx2Width = 16;
+
+PPC_TARGET("avx2")
+void ColumnPassAvx2(const uint8_t* input, size_t stride, const int16_t* taps, size_t taps_count, size_t width,
+                    int16_t* sums) {
+  size_t x = 0;
+  for (; x + kAvx2Width <= width; x += kAvx2Width) {
+    __m256i sum = _mm256_setzero_si256();
+    for (size_t k = 0; k < taps_count; ++k) {
+      if (taps[k] == 0) {
+        continue;
+      }
+      const auto* row = reinterpret_cast<const __m128i*>(input + (k * stride) + x);
+      const __m256i pixels = _mm256_cvtepu8_epi16(_mm_loadu_si128(row));
+      sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(pixels, _mm256_set1_epi16(taps[k])));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + x), sum);
+  }
+  ColumnPassScalar(input, stride, taps, taps_count, x, width, sums);
+}
+
+PPC_TARGET("avx2")
+__m256i RowSumAvx2(const int16_t* sums, const int16_t* taps, size_t taps_count) {
+  __m256i sum = _mm256_setzero_si256();
+  for (size_t k = 0; k < taps_count; ++k) {
+    if (taps[k] == 0) {
+      continue;
+    }
+    const __m256i column_sums = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sums + k));
+    sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(column_sums, _mm256_set1_epi16(taps[k])));
+  }
+  return sum;
+}
+
+// 16 int16_t lanes in order -> 16 bytes in order
+PPC_TARGET("avx2")
+void StoreBytesAvx2(__m256i values, uint8_t* out) {
+  const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(values, values), 0b1000);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+}
+
+// min(sqrt(a^2 + b^2), 255) of interleaved int16_t pairs (a, b), rounded down
+PPC_TARGET("avx2")
+__m256i MagnitudeAvx2(__m256i pairs) {
+  const __m256 squares = _mm256_cvtepi32_ps(_mm256_madd_epi16(pairs, pairs));
+  return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_sqrt_ps(squares), _mm256_set1_ps(255.0F)));
+}
+
+PPC_TARGET("avx2")
+void GradientPassAvx2(const int16_t* smooth_sums, const int16_t* derivative_sums, const FilterSpec& spec, size_t cols,
+                      uint8_t* out) {
+  const size_t taps_count = (2 * spec.radius) + 1;
+  size_t x = 0;
+  for (; x + kAvx2Width <= cols; x += kAvx2Width) {
+    const __m256i gx = RowSumAvx2(smooth_sums + x, spec.derivative.data(), taps_count);
+    const __m256i gy = RowSumAvx2(derivative_sums + x, spec.smooth.data(), taps_count);
+    // gx^2 + gy^2 of lanes 0-3, 8-11 and 4-7, 12-15; packs_epi32 restores the order
+    const __m256i low = _mm256_unpacklo_epi16(gx, gy);
+    const __m256i high = _mm256_unpackhi_epi16(gx, gy);
+    StoreBytesAvx2(_mm256_packs_epi32(MagnitudeAvx2(low), MagnitudeAvx2(high)), out + x);
+  }
+  GradientPassScalar(smooth_sums, derivative_sums, spec, x, cols, out);
+}
+
+PPC_TARGET("avx2")
+void MeanPassAvx2(const int16_t* sums, const FilterSpec& spec, size_t cols, uint8_t* out) {
+  const size_t taps_count = (2 * spec.radius) + 1;
+  const __m256i half = _mm256_set1_epi16(static_cast<int16_t>(spec.divisor / 2));
+  const __m256i multiplier = _mm256_set1_epi16(static_cast<int16_t>(spec.multiplier));
+  const __m128i shift = _mm_cvtsi32_si128(spec.shift);
+  size_t x = 0;
+  for (; x + kAvx2Width <= cols; x += kAvx2Width) {
+    const __m256i sum = _mm256_add_epi16(RowSumAvx2(sums + x, spec.smooth.data(), taps_count), half);
+    StoreBytesAvx2(_mm256_srl_epi16(_mm256_mulhi_epu16(sum, multiplier), shift), out + x);
+  }
+  MeanPassScalar(sums, spec, x, cols, out);
+}
+#endif
+
+struct Kernels {
+  ColumnPass column;
+  GradientPass gradient;
+  MeanPass mean;
+  const char* name;
+};
+
+Kernels SelectKernels() {
+#ifdef PPC_RUNTIME_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") != 0) {
+    return {.column = ColumnPassAvx2, .gradient = GradientPassAvx2, .mean = MeanPassAvx2, .name = "avx2"};
+  }
+  return {.column = ColumnPassPortable, .gradient = GradientPassPortable, .mean = MeanPassPortable, .name = "scalar"};
+#elif defined(PPC_HAS_AVX2)
+  return {.column = ColumnPassAvx2, .gradient = GradientPassAvx2, .mean = MeanPassAvx2, .name = "avx2"};
+#else
+  return {.column = ColumnPassPortable, .gradient = GradientPassPortable, .mean = MeanPassPortable, .name = "scalar"};
+#endif
+}
+
+const Kernels& GetKernels() {
+  static const Kernels kKernels = SelectKernels();
+  return kKernels;
+}
+
+// Sobel 3 x 3 of one row: gx = S(x + 1) - S(x - 1) over the column sums
+// S = top + 2 mid + bottom, gy = D(x - 1) + 2 D(x) + D(x + 1) over the column
+// differences D = bottom - top. Directions, if not null, get the direction
+// of the gradient, for non-maximum suppression: 0 horizontal, 1 along the
+// main diagonal (gx and gy of the same sign), 2 vertical, 3 along the other one.
+using SobelRow = void (*)(const uint8_t* center, size_t stride, size_t cols, ppc::stencil::Magnitude magnitude,
+                          uint8_t* magnitudes, uint8_t* directions);
+
+// floor(sqrt(value)), bit by bit from the top
+uint8_t IntegerSqrt(uint32_t value) {
+  uint32_t root = 0;
+  for (uint32_t bit = 128; bit != 0; bit >>= 1) {
+    const uint32_t candidate = root | bit;
+    if (candidate * candidate <= value) {
+      root = candidate;
+    }
+  }
+  return static_cast<uint8_t>(root);
+}
+
+// both norms saturate at 255, so |gx| and |gy| may be clamped to 255 first,
+// and then a^2 + b^2 to 65535, which keeps the vector kernels in 16 bits
+uint8_t SobelMagnitude(int gx, int gy, ppc::stencil::Magnitude magnitude) {
+  const int a = std::min(std::abs(gx), 255);
+  const int b = std::min(std::abs(gy), 255);
+  if (magnitude == ppc::stencil::Magnitude::kL1) {
+    return static_cast<uint8_t>(std::min(a + b, 255));
+  }
+  return IntegerSqrt(static_cast<uint32_t>(std::min((a * a) + (b * b), 65535)));
+}
+
+// the boundaries are tan(22.5 deg) ~ 2 / 5 and tan(67.5 deg) ~ 5 / 2
+uint8_t SobelDirection(int gx, int gy) {
+  const int a = std::abs(gx);
+  const int b = std::abs(gy);
+  if (2 * a > 5 * b) {
+    return 0;
+  }
+  if (2 * b > 5 * a) {
+    return 2;
+  }
+  return (gx ^ gy) >= 0 ? 1 : 3;
+}
+
+void SobelRowScalar(const uint8_t* center, size_t stride, size_t begin, size_t cols, ppc::stencil::Magnitude magnitude,
+                    uint8_t* magnitudes, uint8_t* directions) {
+  for (size_t x = begin; x < cols; ++x) {
+    const uint8_t* top = center - stride + x;
+    const uint8_t* mid = center + x;
+    const uint8_t* bottom = center + stride + x;
+    const int smooth_left = top[-1] + (2 * mid[-1]) + bottom[-1];
+    const int smooth_right = top[1] + (2 * mid[1]) + bottom[1];
+    const int gx = smooth_right - smooth_left;
+    const int gy = (bottom[-1] - top[-1]) + (2 * (bottom[0] - top[0])) + (bottom[1] - top[1]);
+    magnitudes[x] = SobelMagnitude(gx, gy, magnitude);
+    if (directions != nullptr) {
+      directions[x] = SobelDirection(gx, gy);
+    }
+  }
+}
+
+[[maybe_unused]] void SobelRowPortable(const uint8_t* center, size_t stride, size_t cols,
+                                       ppc::stencil::Magnitude magnitude, uint8_t* magnitudes, uint8_t* directions) {
+  SobelRowScalar(center, stride, 0, cols, magnitude, magnitudes, directions);
+}
+
+#ifdef PPC_HAS_AVX2
+PPC_TARGET("avx2")
+__m256i LoadWideAvx2(const uint8_t* pixels) {
+  return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels)));
+}
+
+// SobelMagnitude of 16 lanes; the square root is IntegerSqrt, a compare and a blend per bit
+PPC_TARGET("avx2")
+__m256i SobelMagnitudeAvx2(__m256i gx, __m256i gy, ppc::stencil::Magnitude magnitude) {
+  const __m256i limit = _mm256_set1_epi16(255);
+  const __m256i a = _mm256_min_epu16(_mm256_abs_epi16(gx), limit);
+  const __m256i b = _mm256_min_epu16(_mm256_abs_epi16(gy), limit);
+  if (magnitude == ppc::stencil::Magnitude::kL1) {
+    return _mm256_min_epu16(_mm256_add_epi16(a, b), limit);
+  }
+  const __m256i squares = _mm256_adds_epu16(_mm256_mullo_epi16(a, a), _mm256_mullo_epi16(b, b));
+  __m256i root = _mm256_setzero_si256();
+  for (int bit = 128; bit != 0; bit >>= 1) {
+    const __m256i candidate = _mm256_or_si256(root, _mm256_set1_epi16(static_cast<int16_t>(bit)));
+    const __m256i square = _mm256_mullo_epi16(candidate, candidate);
+    const __m256i fits = _mm256_cmpeq_epi16(_mm256_max_epu16(square, squares), squares);
+    root = _mm256_blendv_epi8(root, candidate, fits);
+  }
+  return root;
+}
+
+PPC_TARGET("avx2")
+__m256i SobelDirectionAvx2(__m256i gx, __m256i gy) {
+  const __m256i a = _mm256_abs_epi16(gx);
+  const __m256i b = _mm256_abs_epi16(gy);
+  const __m256i horizontal = _mm256_cmpgt_epi16(_mm256_slli_epi16(a, 1), _mm256_add_epi16(_mm256_slli_epi16(b, 2), b));
+  const __m256i vertical = _mm256_cmpgt_epi16(_mm256_slli_epi16(b, 1), _mm256_add_epi16(_mm256_slli_epi16(a, 2), a));
+  const __m256i same_sign = _mm256_cmpgt_epi16(_mm256_xor_si256(gx, gy), _mm256_set1_epi16(-1));
+  const __m256i diagonal = _mm256_blendv_epi8(_mm256_set1_epi16(3), _mm256_set1_epi16(1), same_sign);
+  return _mm256_andnot_si256(horizontal, _mm256_blendv_epi8(diagonal, _mm256_set1_epi16(2), vertical));
+}
+
+PPC_TARGET("avx2")
+void SobelRowAvx2(const uint8_t* center, size_t stride, size_t cols, ppc::stencil::Magnitude magnitude,
+                  uint8_t* magnitudes, uint8_t* directions) {
+  size_t x = 0;
+  for (; x + kAvx2Width <= cols; x += kAvx2Width) {
+    const uint8_t* top = center - stride + x;
+    const uint8_t* mid = center + x;
+    const uint8_t* bottom = center + stride + x;
+    const __m256i top_left = LoadWideAvx2(top - 1);
+    const __m256i top_right = LoadWideAvx2(top + 1);
+    const __m256i bottom_left = LoadWideAvx2(bottom - 1);
+    const __m256i bottom_right = LoadWideAvx2(bottom + 1);
+    const __m256i smooth_left =
+        _mm256_add_epi16(_mm256_add_epi16(top_left, bottom_left), _mm256_slli_epi16(LoadWideAvx2(mid - 1), 1));
+    const __m256i smooth_right =
+        _mm256_add_epi16(_mm256_add_epi16(top_right, bottom_right), _mm256_slli_epi16(LoadWideAvx2(mid + 1), 1));
+    const __m256i difference = _mm256_sub_epi16(LoadWideAvx2(bottom), LoadWideAvx2(top));
+    const __m256i gx = _mm256_sub_epi16(smooth_right, smooth_left);
+    const __m256i gy = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_sub_epi16(bottom_left, top_left), _mm256_sub_epi16(bottom_right, top_right)),
+        _mm256_slli_epi16(difference, 1));
+    StoreBytesAvx2(SobelMagnitudeAvx2(gx, gy, magnitude), magnitudes + x);
+    if (directions != nullptr) {
+      StoreBytesAvx2(SobelDirectionAvx2(gx, gy), directions + x);
+    }
+  }
+  SobelRowScalar(center, stride, x, cols, magnitude, magnitudes, directions);
+}
+
+// the same in 128 bits, for the processors without AVX2
+constexpr size_t kSse41Width = 8;
+
+PPC_TARGET("sse4.1")
+__m128i LoadWideSse41(const uint8_t* pixels) {
+  return _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels)));
+}
+
+PPC_TARGET("sse4.1")
+void StoreBytesSse41(__m128i values, uint8_t* out) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(values, values));
+}
+
+PPC_TARGET("sse4.1")
+__m128i SobelMagnitudeSse41(__m128i gx, __m128i gy, ppc::stencil::Magnitude magnitude) {
+  const __m128i limit = _mm_set1_epi16(255);
+  const __m128i a = _mm_min_epu16(_mm_abs_epi16(gx), limit);
+  const __m128i b = _mm_min_epu16(_mm_abs_epi16(gy), limit);
+  if (magnitude == ppc::stencil::Magnitude::kL1) {
+    return _mm_min_epu16(_mm_add_epi16(a, b), limit);
+  }
+  const __m128i squares = _mm_adds_epu16(_mm_mullo_epi16(a, a), _mm_mullo_epi16(b, b));
+  __m128i root = _mm_setzero_si128();
+  for (int bit = 128; bit != 0; bit >>= 1) {
+    const __m128i candidate = _mm_or_si128(root, _mm_set1_epi16(static_cast<int16_t>(bit)));
+    const __m128i square = _mm_mullo_epi16(candidate, candidate);
+    const __m128i fits = _mm_cmpeq_epi16(_mm_max_epu16(square, squares), squares);
+    root = _mm_blendv_epi8(root, candidate, fits);
+  }
+  return root;
+}
+
+PPC_TARGET("sse4.1")
+__m128i SobelDirectionSse41(__m128i gx, __m128i gy) {
+  const __m128i a = _mm_abs_epi16(gx);
+  const __m128i b = _mm_abs_epi16(gy);
+  const __m128i horizontal = _mm_cmpgt_epi16(_mm_slli_epi16(a, 1), _mm_add_epi16(_mm_slli_epi16(b, 2), b));
+  const __m128i vertical = _mm_cmpgt_epi16(_mm_slli_epi16(b, 1), _mm_add_epi16(_mm_slli_epi16(a, 2), a));
+  const __m128i same_sign = _mm_cmpgt_epi16(_mm_xor_si128(gx, gy), _mm_set1_epi16(-1));
+  const __m128i diagonal = _mm_blendv_epi8(_mm_set1_epi16(3), _mm_set1_epi16(1), same_sign);
+  return _mm_andnot_si128(horizontal, _mm_blendv_epi8(diagonal, _mm_set1_epi16(2), vertical));
+}
+
+PPC_TARGET("sse4.1")
+void SobelRowSse41(const uint8_t* center, size_t stride, size_t cols, ppc::stencil::Magnitude magnitude,
+                   uint8_t* magnitudes, uint8_t* directions) {
+  size_t x = 0;
+  for (; x + kSse41Width <= cols; x += kSse41Width) {
+    const uint8_t* top = center - stride + x;
+    const uint8_t* mid = center + x;
+    const uint8_t* bottom = center + stride + x;
+    const __m128i top_left = LoadWideSse41(top - 1);
+    const __m128i top_right = LoadWideSse41(top + 1);
+    const __m128i bottom_left = LoadWideSse41(bottom - 1);
+    const __m128i bottom_right = LoadWideSse41(bottom + 1);
+    const __m128i smooth_left =
+        _mm_add_epi16(_mm_add_epi16(top_left, bottom_left), _mm_slli_epi16(LoadWideSse41(mid - 1), 1));
+    const __m128i smooth_right =
+        _mm_add_epi16(_mm_add_epi16(top_right, bottom_right), _mm_slli_epi16(LoadWideSse41(mid + 1), 1));
+    const __m128i difference = _mm_sub_epi16(LoadWideSse41(bottom), LoadWideSse41(top));
+    const __m128i gx = _mm_sub_epi16(smooth_right, smooth_left);
+    const __m128i gy =
+        _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(bottom_left, top_left), _mm_sub_epi16(bottom_right, top_right)),
+                      _mm_slli_epi16(difference, 1));
+    StoreBytesSse41(SobelMagnitudeSse41(gx, gy, magnitude), magnitudes + x);
+    if (directions != nullptr) {
+      StoreBytesSse41(SobelDirectionSse41(gx, gy), directions + x);
+    }
+  }
+  SobelRowScalar(center, stride, x, cols, magnitude, magnitudes, directions);
+}
+#endif
+
+struct SobelKernels {
+  SobelRow row;
+  const char* name;
+};
+
+SobelKernels SelectSobelKernels() {
+#ifdef PPC_RUNTIME_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") != 0) {
+    return {.row = SobelRowAvx2, .name = "avx2"};
+  }
+  if (__builtin_cpu_supports("sse4.1") != 0) {
+    return {.row = SobelRowSse41, .name = "sse4.1"};
+  }
+  return {.row = SobelRowPortable, .name = "scalar"};
+#elif defined(PPC_HAS_AVX2)
+  return {.row = SobelRowAvx2, .name = "avx2"};
+#else
+  return {.row = SobelRowPortable, .name = "scalar"};
+#endif
+}
+
+const SobelKernels& GetSobelKernels() {
+  static const SobelKernels kKernels = SelectSobelKernels();
+  return kKernels;
+}
+
+// columns per tile: three input rows, three rows of magnitudes and of
+// directions of a tile take 18 KiB
+constexpr size_t kSobelTileCols = 2048;
+
+// keeps magnitudes[x] if it is not smaller than its two neighbours along
+// directions[x]; the rows above, at and below start one column left of the output
+void SuppressNonMaxima(const uint8_t* above, const uint8_t* row, const uint8_t* below, const uint8_t* directions,
+                       size_t cols, uint8_t* out) {
+  const std::array<const uint8_t*, 4> first = {row, above, above + 1, above + 2};
+  const std::array<const uint8_t*, 4> second = {row + 2, below + 2, below + 1, below};
+  for (size_t x = 0; x < cols; ++x) {
+    const uint8_t direction = directions[x + 1];
+    const uint8_t magnitude = row[x + 1];
+    const bool maximum = magnitude >= first[direction][x] && magnitude >= second[direction][x];
+    out[x] = maximum ? magnitude : 0;
+  }
+}
+
+// magnitudes of the tile rows -1 .. rows, columns -1 .. cols, in a ring of
+// three rows, then the suppression of every tile row from its neighbours
+void SobelSuppressed(const SobelKernels& kernels, const uint8_t* input, size_t input_stride, size_t rows, size_t cols,
+                     ppc::stencil::Magnitude magnitude, uint8_t* output, size_t output_stride) {
+  const size_t width = std::min(cols, kSobelTileCols) + 2;
+  std::array<std::vector<uint8_t>, 3> magnitudes;
+  std::array<std::vector<uint8_t>, 3> directions;
+  for (size_t k = 0; k < 3; ++k) {
+    magnitudes[k].resize(width);
+    directions[k].resize(width);
+  }
+  const auto stride = static_cast<std::ptrdiff_t>(input_stride);
+  for (size_t tile = 0; tile < cols; tile += kSobelTileCols) {
+    const size_t tile_cols = std::min(kSobelTileCols, cols - tile);
+    auto compute = [&](std::ptrdiff_t y) {
+      const size_t slot = static_cast<size_t>(y + 1) % 3;
+      kernels.row(input + (y * stride) + tile - 1, input_stride, tile_cols + 2, magnitude, magnitudes[slot].data(),
+                  directions[slot].data());
+    };
+    compute(-1);
+    compute(0);
+    for (size_t y = 0; y < rows; ++y) {
+      compute(static_cast<std::ptrdiff_t>(y) + 1);
+      SuppressNonMaxima(magnitudes[y % 3].data(), magnitudes[(y + 1) % 3].data(), magnitudes[(y + 2) % 3].data(),
+                        directions[(y + 1) % 3].data(), tile_cols, output + (y * output_stride) + tile);
+    }
+  }
+}
+
+}  // namespace
+
+size_t ppc::stencil::Radius(Filter filter) { return Spec(filter).radius; }
+
+void ppc::stencil::ApplyFilter(Filter filter, const uint8_t* input, size_t input_stride, size_t rows, size_t cols,
+                               uint8_t* output, size_t output_stride) {
+  if (rows == 0 || cols == 0) {
+    return;
+  }
+  if (filter == Filter::kSobel3) {
+    // the fused integer kernel gives the same magnitudes
+    Sobel(input, input_stride, rows, cols, output, output_stride);
+    return;
+  }
+  const auto& spec = Spec(filter);
+  const auto& kernels = GetKernels();
+  const size_t radius = spec.radius;
+  const size_t taps_count = (2 * radius) + 1;
+  const size_t width = cols + (2 * radius);
+  // column sums of one row of the tile, starting radius pixels left of it
+  std::vector<int16_t> smooth_sums(width);
+  std::vector<int16_t> derivative_sums(spec.gradient ? width : 0);
+  for (size_t y = 0; y < rows; ++y) {
+    const auto top = static_cast<std::ptrdiff_t>(y) - static_cast<std::ptrdiff_t>(radius);
+    const uint8_t* window = input + (top * static_cast<std::ptrdiff_t>(input_stride)) - radius;
+    uint8_t* out = output + (y * output_stride);
+    kernels.column(window, input_stride, spec.smooth.data(), taps_count, width, smooth_sums.data());
+    if (spec.gradient) {
+      kernels.column(window, input_stride, spec.derivative.data(), taps_count, width, derivative_sums.data());
+      kernels.gradient(smooth_sums.data(), derivative_sums.data(), spec, cols, out);
+    } else {
+      kernels.mean(smooth_sums.data(), spec, cols, out);
+    }
+  }
+}
+
+const char* ppc::stencil::FilterKernelName() { return GetKernels().name; }
+
+size_t ppc::stencil::SobelRadius(const SobelOptions& options) { return options.non_max_suppression ? 2 : 1; }
+
+void ppc::stencil::Sobel(const uint8_t* input, size_t input_stride, size_t rows, size_t cols, uint8_t* output,
+                         size_t output_stride, const SobelOptions& options) {
+  if (rows == 0 || cols == 0) {
+    return;
+  }
+  const auto& kernels = GetSobelKernels();
+  if (options.non_max_suppression) {
+    SobelSuppressed(kernels, input, input_stride, rows, cols, options.magnitude, output, output_stride);
+    return;
+  }
+  for (size_t tile = 0; tile < cols; tile += kSobelTileCols) {
+    const size_t tile_cols = std::min(kSobelTileCols, cols - tile);
+    for (size_t y = 0; y < rows; ++y) {
+      kernels.row(input + (y * input_stride) + tile, input_stride, tile_cols, options.magnitude,
+                  output + (y * output_stride) + tile, nullptr);
+    }
+  }
+}
+
+const char* ppc::stencil::SobelKernelName() { return GetSobelKernels().name; }
@@ -2,11 +2,18 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "core/task/func_tests/test_task.hpp"
 #include "core/task/include/task.hpp"
+#include "core/task/include/time_budget.hpp"
 
 TEST(task_tests, check_int32_t) {
   // Create data
@@ -178,6 +185,373 @@ TEST(task_tests, check_wrong_order) {
   ASSERT_ANY_THROW(test_task.PostProcessing());
 }
 
+TEST(task_tests, check_profile) {
+  // Create data
+  std::vector<int32_t> in(20, 1);
+  std::vector<int32_t> out(1, 0);
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  task_data->inputs_count.emplace_back(in.size());
+  task_data->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  task_data->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  ppc::test::task::ScopedTestTask<int32_t> test_task(task_data);
+  ASSERT_EQ(test_task.Validation(), true);
+  test_task.PreProcessing();
+  test_task.Run();
+  test_task.Run();
+  test_task.PostProcessing();
+
+  const auto &profile = test_task.GetProfile();
+  ASSERT_EQ(profile.GetPhases().size(), 4U);
+  EXPECT_EQ(profile.GetPhases().at("Validation").count, 1U);
+  EXPECT_EQ(profile.GetPhases().at("Run").count, 2U);
+  ASSERT_EQ(profile.GetScopes().size(), 1U);
+  EXPECT_EQ(profile.GetScopes().at("local compute").count, 2U);
+  EXPECT_LE(profile.GetScopes().at("local compute").wall_sec, profile.GetPhases().at("Run").wall_sec);
+  EXPECT_EQ(profile.GetEvents().size(), 7U);
+  EXPECT_EQ(profile.GetBytesIn(), in.size() * sizeof(int32_t));
+  EXPECT_EQ(profile.GetBytesOut(), sizeof(int32_t));
+
+  std::stringstream trace;
+  profile.WriteChromeTrace(trace, 3);
+  EXPECT_NE(trace.str().find("{\"name\":\"local compute\",\"cat\":\"scope\",\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(trace.str().find("\"pid\":3"), std::string::npos);
+
+  test_task.ResetProfile();
+  EXPECT_TRUE(test_task.GetProfile().GetPhases().empty());
+  EXPECT_TRUE(test_task.GetProfile().GetEvents().empty());
+}
+
+TEST(task_tests, check_buffer_view) {
+  // Create data
+  std::vector<double> in = {1, 2, 3, 4, 5, 6};
+  std::vector<int32_t> legacy(4, 7);
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->inputs.emplace_back(reinterpret_cast<uint8_t *>(legacy.data()));
+  task_data->inputs_count.emplace_back(legacy.size());
+  task_data->AddInput(in.data(), {2, 3});
+
+  ASSERT_EQ(task_data->inputs_count.size(), 2U);
+  EXPECT_EQ(task_data->inputs_count[1], in.size());
+  ASSERT_EQ(task_data->inputs_layout.size(), 2U);
+  EXPECT_EQ(task_data->inputs_layout[0].type, ppc::core::DataType::kUnknown);
+  EXPECT_EQ(task_data->inputs_layout[1].type, ppc::core::DataType::kDouble);
+  EXPECT_GE(task_data->inputs_layout[1].alignment, alignof(double));
+  EXPECT_EQ(task_data->inputs_layout[1].alignment % alignof(double), 0U);
+  EXPECT_EQ(task_data->InputShape(0), std::vector<uint64_t>{legacy.size()});
+  EXPECT_EQ(task_data->InputShape(1), (std::vector<uint64_t>{2, 3}));
+
+  // buffers without layout are 1-d
+  auto legacy_view = task_data->InputView<const int32_t>(0);
+  ASSERT_EQ(legacy_view.Rank(), 1U);
+  EXPECT_EQ(legacy_view.Size(), legacy.size());
+  EXPECT_EQ(legacy_view.Span().data(), legacy.data());
+
+  auto matrix = task_data->InputView<const double>(1);
+  ASSERT_EQ(matrix.Rank(), 2U);
+  EXPECT_EQ(matrix.Extent(0), 2U);
+  EXPECT_EQ(matrix.Extent(1), 3U);
+  EXPECT_EQ(matrix.Stride(0), 3U);
+  EXPECT_TRUE(matrix.IsContiguous());
+  EXPECT_EQ(matrix.Data(), in.data());
+  EXPECT_EQ(matrix(1, 2), 6.0);
+  EXPECT_EQ(matrix.At(0, 1), 2.0);
+  EXPECT_THROW((void)matrix.At(2, 0), std::out_of_range);
+  EXPECT_THROW((void)matrix.At(0), std::out_of_range);
+  EXPECT_THROW((void)task_data->InputView<const float>(1), std::invalid_argument);
+  EXPECT_THROW((void)task_data->InputView<const double>(2), std::out_of_range);
+
+  // views are writable when requested so
+  task_data->InputView<double>(1).At(0, 0) = 10.0;
+  EXPECT_EQ(in[0], 10.0);
+
+  // transposed view of the same memory
+  ppc::core::BufferView<const double> transposed(in.data(), {3, 2}, {1, 3});
+  EXPECT_FALSE(transposed.IsContiguous());
+  EXPECT_EQ(transposed.At(2, 1), 6.0);
+  EXPECT_THROW((void)transposed.Span(), std::logic_error);
+}
+
+TEST(task_tests, check_copy_input) {
+  // Create data
+  std::vector<int32_t> in = {1, 2, 3, 4, 5, 6};
+  std::vector<int32_t> out(1, 0);
+
+  // Create task_data with a transposed (column-major) input
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->AddInput(in.data(), {3, 2});
+  task_data->inputs_layout[0].strides = {1, 3};
+  task_data->AddOutput(out.data(), {1});
+
+  // Create Task
+  ppc::test::task::CopyTestTask<int32_t> test_task(task_data);
+  ASSERT_EQ(test_task.Validation(), true);
+  test_task.PreProcessing();
+  test_task.Run();
+  test_task.PostProcessing();
+
+  std::vector<int32_t> expected = {1, 4, 2, 5, 3, 6};
+  EXPECT_EQ(test_task.GetCopy(), expected);
+  EXPECT_EQ(test_task.GetProfile().GetBytesIn(), in.size() * sizeof(int32_t));
+  EXPECT_EQ(out[0], 21);
+}
+
+TEST(task_tests, check_64bit_extents) {
+  // Create data: only the layout is checked, the memory is never touched
+  std::vector<uint8_t> in(1, 0);
+  const uint64_t rows = uint64_t{1} << 20;
+  const uint64_t cols = uint64_t{1} << 13;
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->AddInput(in.data(), {rows, cols});
+
+  EXPECT_EQ(task_data->inputs_count[0], uint64_t{1} << 33);
+  auto view = task_data->InputView<const uint8_t>(0);
+  EXPECT_EQ(view.Size(), uint64_t{1} << 33);
+  EXPECT_EQ(view.Stride(0), cols);
+  EXPECT_EQ(view.Stride(1), 1U);
+}
+
+TEST(task_tests, check_prepared_lifecycle) {
+  // Create data
+  std::vector<int32_t> in(20, 1);
+  std::vector<int32_t> out(1, 0);
+  std::vector<int32_t> other_in(20, 2);
+  std::vector<int32_t> other_out(1, 0);
+  std::vector<int32_t> wrong_in(10, 1);
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->AddInput(in.data(), {in.size()});
+  task_data->AddOutput(out.data(), {out.size()});
+  auto other_task_data = std::make_shared<ppc::core::TaskData>();
+  other_task_data->AddInput(other_in.data(), {other_in.size()});
+  other_task_data->AddOutput(other_out.data(), {other_out.size()});
+  auto wrong_task_data = std::make_shared<ppc::core::TaskData>();
+  wrong_task_data->AddInput(wrong_in.data(), {wrong_in.size()});
+  wrong_task_data->AddOutput(other_out.data(), {other_out.size()});
+
+  // Create Task
+  ppc::test::task::TestTask<int32_t> test_task(task_data);
+  EXPECT_THROW(test_task.Execute(), std::logic_error);
+  ASSERT_TRUE(test_task.Prepare());
+  ASSERT_TRUE(test_task.IsPrepared());
+  ASSERT_TRUE(test_task.Execute());
+  ASSERT_TRUE(test_task.Execute());
+  EXPECT_EQ(out[0], 40);
+
+  ASSERT_TRUE(test_task.Rebind(other_task_data));
+  ASSERT_TRUE(test_task.Execute());
+  EXPECT_EQ(other_out[0], 40);
+  EXPECT_EQ(out[0], 40);
+  EXPECT_THROW(test_task.Rebind(wrong_task_data), std::invalid_argument);
+
+  EXPECT_EQ(test_task.GetProfile().GetPhases().at("Validation").count, 1U);
+  EXPECT_EQ(test_task.GetProfile().GetPhases().at("PreProcessing").count, 1U);
+  EXPECT_EQ(test_task.GetProfile().GetPhases().at("Run").count, 3U);
+
+  // the regular lifecycle is not allowed on a prepared task
+  EXPECT_THROW(test_task.Validation(), std::invalid_argument);
+
+  // SetData returns to the regular lifecycle
+  test_task.SetData(task_data);
+  EXPECT_FALSE(test_task.IsPrepared());
+  ASSERT_TRUE(test_task.Validation());
+}
+
+TEST(task_tests, check_scratch_arena) {
+  ppc::core::ScratchArena arena(1024);
+
+  auto first = arena.AllocateArray<double>(10);
+  ASSERT_EQ(first.size(), 10U);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(first.data()) % ppc::core::ScratchArena::kDefaultAlignment, 0U);
+  EXPECT_EQ(first[9], 0.0);
+
+  auto mark = arena.GetMark();
+  auto* aligned = arena.Allocate(3, 256);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 256, 0U);
+  // does not fit into the first chunk
+  auto big = arena.AllocateArray<uint8_t>(4000);
+  EXPECT_EQ(big.size(), 4000U);
+  EXPECT_EQ(arena.GetCapacityBytes(), 1024U + 4000U + ppc::core::ScratchArena::kDefaultAlignment);
+  const auto peak = arena.GetUsedBytes();
+  EXPECT_EQ(arena.GetHighWaterMark(), peak);
+
+  arena.Rewind(mark);
+  EXPECT_EQ(arena.GetUsedBytes(), mark.used);
+  EXPECT_EQ(arena.Allocate(3, 256), aligned);
+  EXPECT_THROW((void)arena.Allocate(8, 3), std::invalid_argument);
+
+  // chunks are merged, nothing is released to the heap
+  const auto capacity = arena.GetCapacityBytes();
+  arena.Reset();
+  EXPECT_EQ(arena.GetUsedBytes(), 0U);
+  EXPECT_EQ(arena.GetCapacityBytes(), capacity);
+  EXPECT_EQ(arena.GetHighWaterMark(), peak);
+  arena.ResetHighWaterMark();
+  EXPECT_EQ(arena.GetHighWaterMark(), 0U);
+}
+
+TEST(task_tests, check_task_scratch) {
+  // Create data
+  std::vector<int32_t> in(1000, 1);
+  std::vector<int32_t> out(1, 0);
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->AddInput(in.data(), {in.size()});
+  task_data->AddOutput(out.data(), {out.size()});
+
+  // Create Task
+  ppc::test::task::ScratchTestTask<int32_t> test_task(task_data);
+  ASSERT_TRUE(test_task.Validation());
+  test_task.PreProcessing();
+  test_task.Run();
+  const auto peak = test_task.GetScratchArena().GetHighWaterMark();
+  const auto capacity = test_task.GetScratchArena().GetCapacityBytes();
+  EXPECT_GE(peak, in.size() * sizeof(int32_t));
+
+  // scratch of RunImpl is reused by the next runs
+  test_task.Run();
+  test_task.Run();
+  test_task.PostProcessing();
+  EXPECT_EQ(test_task.GetScratchArena().GetHighWaterMark(), peak);
+  EXPECT_EQ(test_task.GetScratchArena().GetCapacityBytes(), capacity);
+  EXPECT_EQ(out[0], 3000);
+
+  // and released by the next cycle
+  ASSERT_TRUE(test_task.Validation());
+  EXPECT_EQ(test_task.GetScratchArena().GetUsedBytes(), 0U);
+}
+
+TEST(task_tests, check_time_budget_model) {
+  ppc::core::TimeModel model{.complexity = ppc::core::Complexity::kNLogN, .coefficient = 1e-9};
+  EXPECT_NEAR(model.Predict(1023), 1e-9 * 1023 * 10, 1e-15);
+  EXPECT_NEAR((ppc::core::TimeModel{.complexity = ppc::core::Complexity::kQuadratic, .coefficient = 2.0}.Predict(3)),
+              18.0, 1e-12);
+
+  ppc::core::TimeBudget budget;
+  EXPECT_EQ(budget.LimitFor(1000000), ppc::core::Task::kDefaultTimeLimit);
+  EXPECT_TRUE(budget.Check(0.5, 10));
+  EXPECT_THROW(budget.Check(1.5, 10), std::runtime_error);
+
+  // the limit follows the input size, but not below the floor
+  budget.model = model;
+  budget.tolerance = 2.0;
+  budget.floor_sec = 1e-6;
+  EXPECT_NEAR(budget.LimitFor(1023), 2.0 * 1e-9 * 1023 * 10, 1e-15);
+  EXPECT_NEAR(budget.LimitFor(1023, 3), 3 * 2.0 * 1e-9 * 1023 * 10, 1e-15);
+  EXPECT_EQ(budget.LimitFor(1), 1e-6);
+
+  budget.policy = ppc::core::BudgetPolicy::kWarn;
+  EXPECT_FALSE(budget.Check(1.0, 1023));
+  budget.policy = ppc::core::BudgetPolicy::kOff;
+  EXPECT_FALSE(budget.Check(1.0, 1023));
+
+  EXPECT_EQ(ppc::core::ParseComplexity("nlogn"), ppc::core::Complexity::kNLogN);
+  EXPECT_EQ(ppc::core::ComplexityName(ppc::core::Complexity::kCubic), "n3");
+  EXPECT_THROW(ppc::core::ParseComplexity("n4"), std::invalid_argument);
+  EXPECT_EQ(ppc::core::ParseBudgetPolicy("warn"), ppc::core::BudgetPolicy::kWarn);
+  EXPECT_THROW(ppc::core::ParseBudgetPolicy("ignore"), std::invalid_argument);
+}
+
+TEST(task_tests, check_time_budget_file) {
+  auto path = (std::filesystem::temp_directory_path() / "ppc_time_budgets.txt").string();
+  {
+    std::ofstream file(path);
+    file << "# calibrated\n";
+    file << "mpi/example:pipeline nlogn 2.5e-9\n";
+    file << "seq/example:task_run n2 1e-10  # comment\n";
+    file << "seq/broken:task_run n2\n";
+  }
+  auto model = ppc::core::TimeBudget::LoadModel(path, "seq/example:task_run");
+  ASSERT_TRUE(model.has_value());
+  EXPECT_EQ(model->complexity, ppc::core::Complexity::kQuadratic);
+  EXPECT_EQ(model->coefficient, 1e-10);
+  EXPECT_FALSE(ppc::core::TimeBudget::LoadModel(path, "mpi/example:task_run").has_value());
+  EXPECT_THROW(ppc::core::TimeBudget::LoadModel(path, "seq/broken:task_run"), std::runtime_error);
+  EXPECT_THROW(ppc::core::TimeBudget::LoadModel(path + ".missing", "mpi/example:pipeline"), std::runtime_error);
+
+#ifndef _WIN32
+  setenv("PPC_TIME_BUDGET_FILE", path.c_str(), 1);  // NOLINT(misc-include-cleaner)
+  setenv("PPC_TIME_BUDGET_POLICY", "warn", 1);      // NOLINT(misc-include-cleaner)
+  setenv("PPC_TEST_TIME_LIMIT", "3.5", 1);          // NOLINT(misc-include-cleaner)
+  auto budget = ppc::core::TimeBudget::FromEnvironment(1.0, "PPC_TEST_TIME_LIMIT", "mpi/example:pipeline");
+  EXPECT_EQ(budget.limit_sec, 3.5);
+  EXPECT_EQ(budget.policy, ppc::core::BudgetPolicy::kWarn);
+  ASSERT_TRUE(budget.model.has_value());
+  EXPECT_EQ(budget.model->complexity, ppc::core::Complexity::kNLogN);
+
+  setenv("PPC_TEST_TIME_LIMIT", "-1", 1);  // NOLINT(misc-include-cleaner)
+  EXPECT_THROW(ppc::core::TimeBudget::FromEnvironment(1.0, "PPC_TEST_TIME_LIMIT"), std::invalid_argument);
+
+  unsetenv("PPC_TIME_BUDGET_FILE");    // NOLINT(misc-include-cleaner)
+  unsetenv("PPC_TIME_BUDGET_POLICY");  // NOLINT(misc-include-cleaner)
+  unsetenv("PPC_TEST_TIME_LIMIT");     // NOLINT(misc-include-cleaner)
+#endif
+  std::filesystem::remove(path);
+}
+
+TEST(task_tests, check_task_time_budget) {
+  // Create data
+  std::vector<int32_t> in(20, 1);
+  std::vector<int32_t> out(1, 0);
+
+  // Create task_data
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->AddInput(in.data(), {in.size()});
+  task_data->AddOutput(out.data(), {out.size()});
+
+  // Create Task with a budget no run can meet
+  ppc::test::task::TestTask<int32_t> test_task(task_data);
+  ppc::core::TimeBudget budget;
+  budget.model = ppc::core::TimeModel{.complexity = ppc::core::Complexity::kConstant, .coefficient = 1e-15};
+  budget.floor_sec = 0.0;
+  test_task.SetTimeBudget(budget);
+  ASSERT_TRUE(test_task.Validation());
+  test_task.PreProcessing();
+  test_task.Run();
+  EXPECT_THROW(test_task.PostProcessing(), std::runtime_error);
+
+  budget.policy = ppc::core::BudgetPolicy::kWarn;
+  test_task.SetTimeBudget(budget);
+  ASSERT_TRUE(test_task.Validation());
+  test_task.PreProcessing();
+  test_task.Run();
+  EXPECT_NO_THROW(test_task.PostProcessing());
+}
+
+TEST(task_tests, check_task_time_budget_is_lazy) {
+#ifndef _WIN32
+  std::vector<int32_t> in(20, 1);
+  std::vector<int32_t> out(1, 0);
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->AddInput(in.data(), {in.size()});
+  task_data->AddOutput(out.data(), {out.size()});
+
+  // a broken environment does not break constructing tasks, only their first timed cycle
+  setenv("PPC_FUNC_TIME_LIMIT", "abc", 1);  // NOLINT(misc-include-cleaner)
+  std::optional<ppc::test::task::TestTask<int32_t>> test_task;
+  ASSERT_NO_THROW(test_task.emplace(task_data));
+  EXPECT_THROW((void)test_task->GetTimeBudget(), std::invalid_argument);
+
+  setenv("PPC_FUNC_TIME_LIMIT", "7", 1);  // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(test_task->GetTimeBudget().limit_sec, 7.0);
+  unsetenv("PPC_FUNC_TIME_LIMIT");  // NOLINT(misc-include-cleaner)
+  // resolved once
+  EXPECT_EQ(test_task->GetTimeBudget().limit_sec, 7.0);
+#else
+  GTEST_SKIP();
+#endif
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <thread>
 #include <vector>
 
@@ -46,4 +47,55 @@ class FakeSlowTask : public TestTask<T> {
   }
 };
 
+template <class T>
+class ScopedTestTask : public TestTask<T> {
+ public:
+  explicit ScopedTestTask(ppc::core::TaskDataPtr task_data) : TestTask<T>(task_data) {}
+
+  bool PreProcessingImpl() override {
+    this->CountBytesIn(this->task_data->inputs_count[0] * sizeof(T));
+    return TestTask<T>::PreProcessingImpl();
+  }
+
+  bool RunImpl() override {
+    auto scope = this->OpenScope("local compute");
+    return TestTask<T>::RunImpl();
+  }
+
+  bool PostProcessingImpl() override {
+    this->CountBytesOut(sizeof(T));
+    return TestTask<T>::PostProcessingImpl();
+  }
+};
+
+template <class T>
+class CopyTestTask : public TestTask<T> {
+ public:
+  explicit CopyTestTask(ppc::core::TaskDataPtr task_data) : TestTask<T>(task_data) {}
+
+  bool PreProcessingImpl() override {
+    copy_ = this->template CopyInput<T>(0);
+    return TestTask<T>::PreProcessingImpl();
+  }
+
+  [[nodiscard]] const std::vector<T> &GetCopy() const { return copy_; }
+
+ private:
+  std::vector<T> copy_;
+};
+
+template <class T>
+class ScratchTestTask : public TestTask<T> {
+ public:
+  explicit ScratchTestTask(ppc::core::TaskDataPtr task_data) : TestTask<T>(task_data) {}
+
+  bool RunImpl() override {
+    auto partial = this->Scratch().template AllocateArray<T>(this->task_data->inputs_count[0]);
+    for (size_t i = 0; i < partial.size(); i++) {
+      partial[i] = reinterpret_cast<T *>(this->task_data->inputs[0])[i];
+    }
+    return TestTask<T>::RunImpl();
+  }
+};
+
 }  // namespace ppc::test::task
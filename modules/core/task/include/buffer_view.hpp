@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ppc::core {
+
+// element type tag of a TaskData buffer
+enum class DataType : uint8_t {
+  kUnknown,
+  kInt8,
+  kUInt8,
+  kInt16,
+  kUInt16,
+  kInt32,
+  kUInt32,
+  kInt64,
+  kUInt64,
+  kFloat,
+  kDouble
+};
+
+template <class T>
+constexpr DataType DataTypeOf() {
+  using Type = std::remove_cv_t<T>;
+  if constexpr (std::is_same_v<Type, int8_t> || std::is_same_v<Type, char>) {
+    return DataType::kInt8;
+  } else if constexpr (std::is_same_v<Type, uint8_t>) {
+    return DataType::kUInt8;
+  } else if constexpr (std::is_same_v<Type, int16_t>) {
+    return DataType::kInt16;
+  } else if constexpr (std::is_same_v<Type, uint16_t>) {
+    return DataType::kUInt16;
+  } else if constexpr (std::is_same_v<Type, int32_t>) {
+    return DataType::kInt32;
+  } else if constexpr (std::is_same_v<Type, uint32_t>) {
+    return DataType::kUInt32;
+  } else if constexpr (std::is_same_v<Type, int64_t>) {
+    return DataType::kInt64;
+  } else if constexpr (std::is_same_v<Type, uint64_t>) {
+    return DataType::kUInt64;
+  } else if constexpr (std::is_same_v<Type, float>) {
+    return DataType::kFloat;
+  } else if constexpr (std::is_same_v<Type, double>) {
+    return DataType::kDouble;
+  } else {
+    return DataType::kUnknown;
+  }
+}
+
+// Shape of a buffer in elements. Strides are in elements too, empty strides
+// mean dense row-major layout.
+struct BufferLayout {
+  DataType type = DataType::kUnknown;
+  std::vector<uint64_t> shape;
+  std::vector<uint64_t> strides;
+  // guaranteed alignment of the first element in bytes (0 if unknown)
+  uint64_t alignment = 0;
+};
+
+// largest power of two (up to a page) the address is a multiple of
+inline uint64_t AlignmentOf(const void *data) {
+  constexpr uint64_t kMaxAlignment = 4096;
+  auto address = reinterpret_cast<uintptr_t>(data);
+  if (address == 0) {
+    return kMaxAlignment;
+  }
+  return std::min<uint64_t>(uint64_t{1} << std::countr_zero(address), kMaxAlignment);
+}
+
+// Non-owning typed N-d view over memory of a caller, nothing is copied.
+// Use BufferView<const T> for read-only access to inputs.
+template <class T>
+class BufferView {
+ public:
+  BufferView() = default;
+  BufferView(T *data, std::vector<uint64_t> shape, std::vector<uint64_t> strides = {})
+      : data_(data), shape_(std::move(shape)), strides_(std::move(strides)) {
+    if (strides_.empty()) {
+      strides_ = RowMajorStrides(shape_);
+    }
+    if (strides_.size() != shape_.size()) {
+      throw std::invalid_argument("BufferView: rank of strides " + std::to_string(strides_.size()) +
+                                  " does not match rank of shape " + std::to_string(shape_.size()));
+    }
+  }
+
+  [[nodiscard]] size_t Rank() const { return shape_.size(); }
+  [[nodiscard]] uint64_t Extent(size_t dim) const { return shape_.at(dim); }
+  [[nodiscard]] uint64_t Stride(size_t dim) const { return strides_.at(dim); }
+  [[nodiscard]] const std::vector<uint64_t> &Shape() const { return shape_; }
+  [[nodiscard]] const std::vector<uint64_t> &Strides() const { return strides_; }
+  [[nodiscard]] T *Data() const { return data_; }
+  [[nodiscard]] bool Empty() const { return Size() == 0; }
+
+  // number of elements
+  [[nodiscard]] uint64_t Size() const {
+    uint64_t size = 1;
+    for (auto extent : shape_) {
+      size *= extent;
+    }
+    return size;
+  }
+
+  [[nodiscard]] bool IsContiguous() const { return strides_ == RowMajorStrides(shape_); }
+
+  // flat view of a dense buffer, e.g. for std algorithms
+  [[nodiscard]] std::span<T> Span() const {
+    if (!IsContiguous()) {
+      throw std::logic_error("BufferView: strided view can not be flattened");
+    }
+    return {data_, static_cast<size_t>(Size())};
+  }
+
+  // unchecked access, one index per dimension
+  template <class... Index>
+  T &operator()(Index... index) const {
+    size_t dim = 0;
+    uint64_t offset = 0;
+    ((offset += static_cast<uint64_t>(index) * strides_[dim++]), ...);
+    return data_[offset];
+  }
+
+  // bounds-checked access
+  template <class... Index>
+  T &At(Index... index) const {
+    if (sizeof...(Index) != Rank()) {
+      throw std::out_of_range("BufferView: expected " + std::to_string(Rank()) + " indices, got " +
+                              std::to_string(sizeof...(Index)));
+    }
+    size_t dim = 0;
+    uint64_t offset = 0;
+    for (auto idx : std::array<uint64_t, sizeof...(Index)>{static_cast<uint64_t>(index)...}) {
+      if (idx >= shape_[dim]) {
+        throw std::out_of_range("BufferView: index " + std::to_string(idx) + " is out of extent " +
+                                std::to_string(shape_[dim]) + " in dimension " + std::to_string(dim));
+      }
+      offset += idx * strides_[dim++];
+    }
+    return data_[offset];
+  }
+
+  static std::vector<uint64_t> RowMajorStrides(const std::vector<uint64_t> &shape) {
+    std::vector<uint64_t> strides(shape.size(), 1);
+    for (size_t i = shape.size(); i > 1; i--) {
+      strides[i - 2] = strides[i - 1] * shape[i - 1];
+    }
+    return strides;
+  }
+
+ private:
+  T *data_ = nullptr;
+  std::vector<uint64_t> shape_;
+  std::vector<uint64_t> strides_;
+};
+
+}  // namespace ppc::core
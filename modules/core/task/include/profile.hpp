@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ppc::core {
+
+// aggregated measurements of a task phase or a named scope
+struct ProfileRecord {
+  uint64_t count = 0;
+  double wall_sec = 0.0;
+  double cpu_sec = 0.0;
+  // growth of the process peak resident set size while inside (in bytes)
+  uint64_t peak_rss_delta = 0;
+};
+
+// single interval for the trace timeline
+struct ProfileEvent {
+  std::string name;
+  bool is_phase = false;
+  // offsets from the creation (or last reset) of the profile, in microseconds
+  double start_us = 0.0;
+  double duration_us = 0.0;
+};
+
+// Timings of Validation/PreProcessing/Run/PostProcessing and of user scopes
+// opened inside them. Not thread-safe: open scopes from the calling thread only.
+class TaskProfile {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  TaskProfile();
+
+  void Record(const std::string& name, bool is_phase, Clock::time_point start, double cpu_sec,
+              uint64_t peak_rss_delta);
+  void AddBytesIn(uint64_t bytes) { bytes_in_ += bytes; }
+  void AddBytesOut(uint64_t bytes) { bytes_out_ += bytes; }
+  void Reset();
+
+  [[nodiscard]] const std::map<std::string, ProfileRecord>& GetPhases() const { return phases_; }
+  [[nodiscard]] const std::map<std::string, ProfileRecord>& GetScopes() const { return scopes_; }
+  [[nodiscard]] const std::vector<ProfileEvent>& GetEvents() const { return events_; }
+  [[nodiscard]] uint64_t GetDroppedEvents() const { return dropped_events_; }
+  [[nodiscard]] uint64_t GetBytesIn() const { return bytes_in_; }
+  [[nodiscard]] uint64_t GetBytesOut() const { return bytes_out_; }
+
+  // Chrome trace-event JSON (chrome://tracing, Perfetto); pid separates MPI ranks
+  void WriteChromeTrace(std::ostream& stream, int pid = 0) const;
+
+  // timeline is bounded, aggregated records are always kept
+  constexpr static size_t kMaxEvents = 10000;
+
+  // process-wide peak resident set size in bytes (0 where unsupported)
+  static uint64_t GetPeakRss();
+  // CPU time of the process in seconds
+  static double GetCpuTime();
+
+ private:
+  Clock::time_point origin_;
+  std::map<std::string, ProfileRecord> phases_;
+  std::map<std::string, ProfileRecord> scopes_;
+  std::vector<ProfileEvent> events_;
+  uint64_t dropped_events_ = 0;
+  uint64_t bytes_in_ = 0;
+  uint64_t bytes_out_ = 0;
+};
+
+// RAII interval: measured from construction to destruction
+class ProfileScope {
+ public:
+  ProfileScope(TaskProfile& profile, std::string name, bool is_phase = false);
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+  ProfileScope(ProfileScope&&) = delete;
+  ProfileScope& operator=(ProfileScope&&) = delete;
+
+ private:
+  TaskProfile& profile_;
+  std::string name_;
+  bool is_phase_;
+  TaskProfile::Clock::time_point start_;
+  double cpu_start_;
+  uint64_t peak_rss_start_;
+};
+
+}  // namespace ppc::core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace ppc::core {
+
+// Bump allocator for scratch buffers of a task. Memory is handed out from a
+// few large chunks and is given back all at once with Rewind()/Reset(), so
+// repeated runs reuse the same memory instead of going through the heap.
+// Only trivially destructible types are allowed: nothing is destroyed.
+class ScratchArena {
+ public:
+  // cache line, also enough for AVX-512 loads
+  constexpr static size_t kDefaultAlignment = 64;
+  constexpr static size_t kDefaultChunkSize = size_t{1} << 20;
+
+  // position to rewind to, everything allocated after it is released
+  struct Mark {
+    size_t chunk = 0;
+    size_t offset = 0;
+    uint64_t used = 0;
+  };
+
+  explicit ScratchArena(size_t chunk_size = kDefaultChunkSize);
+
+  void *Allocate(size_t bytes, size_t alignment = kDefaultAlignment);
+
+  // value-initialized array
+  template <class T>
+  std::span<T> AllocateArray(size_t count, size_t alignment = std::max(alignof(T), kDefaultAlignment)) {
+    static_assert(std::is_trivially_destructible_v<T>, "ScratchArena does not call destructors");
+    auto *data = static_cast<T *>(Allocate(count * sizeof(T), alignment));
+    std::uninitialized_value_construct_n(data, count);
+    return {data, count};
+  }
+
+  [[nodiscard]] Mark GetMark() const { return {.chunk = current_, .offset = offset_, .used = used_}; }
+  void Rewind(const Mark &mark);
+  // release everything; several chunks are merged into one to avoid chaining next time
+  void Reset();
+
+  // bytes handed out since the last Reset (including alignment padding)
+  [[nodiscard]] uint64_t GetUsedBytes() const { return used_; }
+  // bytes owned by the arena
+  [[nodiscard]] uint64_t GetCapacityBytes() const;
+  // maximum of GetUsedBytes() since construction or ResetHighWaterMark()
+  [[nodiscard]] uint64_t GetHighWaterMark() const { return high_water_mark_; }
+  void ResetHighWaterMark() { high_water_mark_ = used_; }
+
+ private:
+  struct Chunk {
+    std::unique_ptr<std::byte[]> data;
+    size_t size = 0;
+  };
+
+  // aligned position of `bytes` in chunk `index` starting from `offset`, if they fit
+  [[nodiscard]] std::optional<size_t> FitInChunk(size_t index, size_t offset, size_t bytes, size_t alignment) const;
+
+  size_t chunk_size_;
+  std::vector<Chunk> chunks_;
+  size_t current_ = 0;
+  size_t offset_ = 0;
+  uint64_t used_ = 0;
+  uint64_t high_water_mark_ = 0;
+};
+
+}  // namespace ppc::core
@@ -1,23 +1,115 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "core/task/include/buffer_view.hpp"
+#include "core/task/include/profile.hpp"
+#include "core/task/include/scratch_arena.hpp"
+#include "core/task/include/time_budget.hpp"
+
 namespace ppc::core {
 
 struct TaskData {
   std::vector<uint8_t *> inputs;
-  std::vector<std::uint32_t> inputs_count;
+  std::vector<std::uint64_t> inputs_count;
   std::vector<uint8_t *> outputs;
-  std::vector<std::uint32_t> outputs_count;
+  std::vector<std::uint64_t> outputs_count;
   enum StateOfTesting : uint8_t { kFunc, kPerf } state_of_testing;
+  // optional element type, shape and alignment of inputs/outputs with the same
+  // index; buffers without layout are treated as 1-d of inputs_count/outputs_count
+  std::vector<BufferLayout> inputs_layout;
+  std::vector<BufferLayout> outputs_layout;
+
+  // register caller memory together with its layout, nothing is copied
+  template <class T>
+  void AddInput(T *data, std::vector<uint64_t> shape) {
+    AddBuffer(inputs, inputs_count, inputs_layout, data, std::move(shape));
+  }
+  template <class T>
+  void AddOutput(T *data, std::vector<uint64_t> shape) {
+    AddBuffer(outputs, outputs_count, outputs_layout, data, std::move(shape));
+  }
+
+  // extents of a buffer: layout shape or {inputs_count[index]}
+  [[nodiscard]] std::vector<uint64_t> InputShape(size_t index) const {
+    return ShapeOf(inputs_count, inputs_layout, index);
+  }
+  [[nodiscard]] std::vector<uint64_t> OutputShape(size_t index) const {
+    return ShapeOf(outputs_count, outputs_layout, index);
+  }
+
+  // typed views over inputs/outputs, e.g.
+  //   auto matrix = task_data->InputView<const double>(0);
+  template <class T>
+  [[nodiscard]] BufferView<T> InputView(size_t index) const {
+    return MakeView<T>(inputs, inputs_count, inputs_layout, index);
+  }
+  template <class T>
+  [[nodiscard]] BufferView<T> OutputView(size_t index) const {
+    return MakeView<T>(outputs, outputs_count, outputs_layout, index);
+  }
+
+ private:
+  static std::vector<uint64_t> ShapeOf(const std::vector<std::uint64_t> &counts,
+                                       const std::vector<BufferLayout> &layouts, size_t index) {
+    if (index < layouts.size() && layouts[index].type != DataType::kUnknown) {
+      return layouts[index].shape;
+    }
+    if (index >= counts.size()) {
+      throw std::out_of_range("TaskData: no buffer with index " + std::to_string(index));
+    }
+    return {counts[index]};
+  }
+
+  template <class T>
+  static void AddBuffer(std::vector<uint8_t *> &buffers, std::vector<std::uint64_t> &counts,
+                        std::vector<BufferLayout> &layouts, T *data, std::vector<uint64_t> shape) {
+    uint64_t count = 1;
+    for (auto extent : shape) {
+      count *= extent;
+    }
+    layouts.resize(buffers.size());
+    buffers.emplace_back(reinterpret_cast<uint8_t *>(data));
+    counts.emplace_back(count);
+    layouts.push_back(BufferLayout{
+        .type = DataTypeOf<T>(), .shape = std::move(shape), .strides = {}, .alignment = AlignmentOf(data)});
+  }
+
+  template <class T>
+  static BufferView<T> MakeView(const std::vector<uint8_t *> &buffers, const std::vector<std::uint64_t> &counts,
+                                const std::vector<BufferLayout> &layouts, size_t index) {
+    if (index >= buffers.size() || index >= counts.size()) {
+      throw std::out_of_range("TaskData: no buffer with index " + std::to_string(index));
+    }
+    auto *data = reinterpret_cast<T *>(buffers[index]);
+    if (index >= layouts.size() || layouts[index].type == DataType::kUnknown) {
+      return BufferView<T>(data, {counts[index]});
+    }
+    const auto &layout = layouts[index];
+    if (layout.type != DataTypeOf<T>()) {
+      throw std::invalid_argument("TaskData: element type of buffer " + std::to_string(index) +
+                                  " does not match the requested view");
+    }
+    return BufferView<T>(data, layout.shape, layout.strides);
+  }
 };
 
 using TaskDataPtr = std::shared_ptr<ppc::core::TaskData>;
 
+// Where a distributed task leaves its result.
+// kGathered: the result is gathered into the outputs of rank 0.
+// kDistributed: every rank keeps its part (the task's LocalResult()), the parts
+// are ordered by rank; the outputs are neither written nor required.
+enum class ResultLayout : uint8_t { kGathered, kDistributed };
+
 // Memory of inputs and outputs need to be initialized before create object of
 // Task class
 class Task {
@@ -42,12 +134,77 @@ class Task {
   // get input and output data
   [[nodiscard]] TaskDataPtr GetData() const;
 
+  // Prepared lifecycle for repeated execution on same-shaped inputs:
+  //   task.Prepare();          // Validation() + PreProcessing(), once
+  //   task.Execute();          // Run() + PostProcessing(), any number of times
+  //   task.Rebind(new_data);   // other buffers of the same shapes, no validation
+  // SetData() returns the task to the regular lifecycle.
+  bool Prepare();
+  bool Execute();
+  bool Rebind(TaskDataPtr task_data);
+  [[nodiscard]] bool IsPrepared() const;
+
+  // per-phase and per-scope timings, bytes copied, peak RSS growth
+  [[nodiscard]] const TaskProfile &GetProfile() const;
+  void ResetProfile();
+
+  // scratch memory of the task: used bytes, capacity, high-water mark
+  [[nodiscard]] const ScratchArena &GetScratchArena() const;
+
+  // limit of one PreProcessing() -> PostProcessing() cycle in functional
+  // tests; kDefaultTimeLimit unless PPC_FUNC_TIME_LIMIT or other overrides of
+  // TimeBudget::FromEnvironment() are set. Unless set here, it is read from
+  // the environment on first use, with the model of "<backend>/<task>:func"
+  // (or else ":pipeline") of the running test's task from PPC_TIME_BUDGET_FILE.
+  void SetTimeBudget(const TimeBudget &time_budget);
+  [[nodiscard]] const TimeBudget &GetTimeBudget() const;
+  constexpr static double kDefaultTimeLimit = 1.0;
+
   virtual ~Task();
 
  protected:
   void InternalOrderTest(const std::string &str = __builtin_FUNCTION());
   TaskDataPtr task_data;
 
+  // named interval inside *Impl functions, e.g.
+  //   auto scope = OpenScope("local compute");
+  [[nodiscard]] ProfileScope OpenScope(const std::string &name);
+
+  // Scratch buffers which live until the next Validation(). Everything taken
+  // inside RunImpl() is given back before the next Run(), so repeated runs
+  // reuse the same memory:
+  //   auto local_a = Scratch().AllocateArray<double>(rows * cols);
+  ScratchArena &Scratch();
+
+  // account bytes copied out of inputs / into outputs of TaskData
+  void CountBytesIn(uint64_t bytes);
+  void CountBytesOut(uint64_t bytes);
+
+  // Opt-in ownership: private dense copy of an input for tasks which have to
+  // mutate it. Prefer task_data->InputView<const T>() when reading is enough.
+  template <class T>
+  std::vector<T> CopyInput(size_t index) {
+    auto view = task_data->InputView<const T>(index);
+    std::vector<T> copy;
+    copy.reserve(view.Size());
+    if (view.IsContiguous()) {
+      auto span = view.Span();
+      copy.assign(span.begin(), span.end());
+    } else {
+      for (uint64_t flat = 0; flat < view.Size(); flat++) {
+        uint64_t rest = flat;
+        uint64_t offset = 0;
+        for (size_t dim = view.Rank(); dim > 0; dim--) {
+          offset += (rest % view.Extent(dim - 1)) * view.Stride(dim - 1);
+          rest /= view.Extent(dim - 1);
+        }
+        copy.push_back(view.Data()[offset]);
+      }
+    }
+    CountBytesIn(copy.size() * sizeof(T));
+    return copy;
+  }
+
   // implementation of "validation" function
   virtual bool ValidationImpl() = 0;
 
@@ -60,11 +217,24 @@ class Task {
   // implementation of "post_processing" function
   virtual bool PostProcessingImpl() = 0;
 
+  // refresh state derived from task_data after Rebind(); the default repeats
+  // PreProcessingImpl(), tasks which only keep views can do less
+  virtual bool RebindImpl();
+
  private:
-  std::vector<std::string> functions_order_;
+  // calls checked against the expected order so far, and the last of them
+  size_t functions_count_ = 0;
+  std::string last_function_;
   std::vector<std::string> right_functions_order_ = {"Validation", "PreProcessing", "Run", "PostProcessing"};
-  const double max_test_time_ = 1.0;
+  std::vector<std::string> prepared_functions_order_ = {"Run", "PostProcessing"};
+  bool prepared_ = false;
+  // resolved lazily, see SetTimeBudget()
+  mutable std::optional<TimeBudget> time_budget_;
   std::chrono::high_resolution_clock::time_point tmp_time_point_;
+  TaskProfile profile_;
+  ScratchArena arena_;
+  ScratchArena::Mark pre_processing_mark_;
+  ScratchArena::Mark run_mark_;
 };
 
 }  // namespace ppc::core
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace ppc::core {
+
+// growth of the run time with the input size n
+enum class Complexity : uint8_t { kConstant, kLogN, kLinear, kNLogN, kQuadratic, kCubic };
+
+// what happens when a budget is exceeded: exception, warning on stderr or nothing
+enum class BudgetPolicy : uint8_t { kFail, kWarn, kOff };
+
+// expected time of one run: coefficient * f(n)
+struct TimeModel {
+  Complexity complexity = Complexity::kLinear;
+  double coefficient = 0.0;
+
+  [[nodiscard]] double Predict(uint64_t input_size) const;
+};
+
+// Time limit of a task. Without a model it is a fixed number of seconds,
+// with a model it follows the input size: tolerance * predicted time, but not
+// less than floor_sec, so that tiny inputs do not turn into timer noise.
+struct TimeBudget {
+  double limit_sec = 1.0;
+  std::optional<TimeModel> model;
+  double tolerance = 10.0;
+  double floor_sec = 0.01;
+  BudgetPolicy policy = BudgetPolicy::kFail;
+
+  // limit for `runs` runs on an input of input_size elements
+  [[nodiscard]] double LimitFor(uint64_t input_size, uint64_t runs = 1) const;
+  // true if time_sec is within the limit; otherwise throws std::runtime_error
+  // (kFail), prints a warning (kWarn) or does nothing (kOff) and returns false
+  bool Check(double time_sec, uint64_t input_size, uint64_t runs = 1) const;
+
+  // Budget with default_limit_sec, overridden by the environment:
+  //   <limit_variable>           fixed limit in seconds, e.g. PPC_FUNC_TIME_LIMIT=5
+  //   PPC_TIME_BUDGET_POLICY     fail, warn or off
+  //   PPC_TIME_BUDGET_TOLERANCE  tolerance of model-based limits
+  //   PPC_TIME_BUDGET_FILE       models of scripts/calibrate_time_budgets.py,
+  //                              the one of `key` is used if present
+  static TimeBudget FromEnvironment(double default_limit_sec, const std::string &limit_variable,
+                                    const std::string &key = "");
+  // model of `key` from a budget file with lines "<key> <complexity> <coefficient>"
+  static std::optional<TimeModel> LoadModel(const std::string &path, const std::string &key);
+};
+
+// "constant", "logn", "n", "nlogn", "n2", "n3"
+Complexity ParseComplexity(const std::string &name);
+std::string ComplexityName(Complexity complexity);
+// "fail", "warn", "off"
+BudgetPolicy ParseBudgetPolicy(const std::string &name);
+
+}  // namespace ppc::core
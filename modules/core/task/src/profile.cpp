@@ -0,0 +1,108 @@
+#include "core/task/include/profile.hpp"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <ios>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace {
+
+std::string EscapeJson(const std::string& str) {
+  std::string res;
+  res.reserve(str.size());
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      res += '\\';
+    }
+    res += (static_cast<unsigned char>(c) < 0x20) ? ' ' : c;
+  }
+  return res;
+}
+
+}  // namespace
+
+ppc::core::TaskProfile::TaskProfile() : origin_(Clock::now()) {}
+
+void ppc::core::TaskProfile::Record(const std::string& name, bool is_phase, Clock::time_point start, double cpu_sec,
+                                    uint64_t peak_rss_delta) {
+  auto end = Clock::now();
+  auto wall_sec = std::chrono::duration<double>(end - start).count();
+
+  auto& record = is_phase ? phases_[name] : scopes_[name];
+  record.count++;
+  record.wall_sec += wall_sec;
+  record.cpu_sec += cpu_sec;
+  record.peak_rss_delta += peak_rss_delta;
+
+  if (events_.size() < kMaxEvents) {
+    auto start_us = std::chrono::duration<double, std::micro>(start - origin_).count();
+    events_.push_back(ProfileEvent{.name = name, .is_phase = is_phase, .start_us = start_us,
+                                   .duration_us = wall_sec * 1e6});
+  } else {
+    dropped_events_++;
+  }
+}
+
+void ppc::core::TaskProfile::Reset() {
+  origin_ = Clock::now();
+  phases_.clear();
+  scopes_.clear();
+  events_.clear();
+  dropped_events_ = 0;
+  bytes_in_ = 0;
+  bytes_out_ = 0;
+}
+
+void ppc::core::TaskProfile::WriteChromeTrace(std::ostream& stream, int pid) const {
+  stream << std::fixed << std::setprecision(3);
+  stream << "{\"traceEvents\":[";
+  for (size_t i = 0; i < events_.size(); i++) {
+    const auto& event = events_[i];
+    stream << (i == 0 ? "\n" : ",\n");
+    stream << "{\"name\":\"" << EscapeJson(event.name) << "\",\"cat\":\"" << (event.is_phase ? "phase" : "scope")
+           << "\",\"ph\":\"X\",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us << ",\"pid\":" << pid
+           << ",\"tid\":0}";
+  }
+  stream << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"bytes_in\":" << bytes_in_
+         << ",\"bytes_out\":" << bytes_out_ << ",\"dropped_events\":" << dropped_events_ << "}}\n";
+}
+
+uint64_t ppc::core::TaskProfile::GetPeakRss() {
+#ifdef _WIN32
+  return 0;
+#else
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double ppc::core::TaskProfile::GetCpuTime() { return static_cast<double>(std::clock()) / CLOCKS_PER_SEC; }
+
+ppc::core::ProfileScope::ProfileScope(TaskProfile& profile, std::string name, bool is_phase)
+    : profile_(profile),
+      name_(std::move(name)),
+      is_phase_(is_phase),
+      start_(TaskProfile::Clock::now()),
+      cpu_start_(TaskProfile::GetCpuTime()),
+      peak_rss_start_(TaskProfile::GetPeakRss()) {}
+
+ppc::core::ProfileScope::~ProfileScope() {
+  auto cpu_sec = TaskProfile::GetCpuTime() - cpu_start_;
+  auto peak_rss = TaskProfile::GetPeakRss();
+  profile_.Record(name_, is_phase_, start_, cpu_sec, peak_rss > peak_rss_start_ ? peak_rss - peak_rss_start_ : 0);
+}
@@ -0,0 +1,79 @@
+#include "core/task/include/scratch_arena.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+ppc::core::ScratchArena::ScratchArena(size_t chunk_size) : chunk_size_(std::max<size_t>(chunk_size, 1)) {}
+
+std::optional<size_t> ppc::core::ScratchArena::FitInChunk(size_t index, size_t offset, size_t bytes,
+                                                          size_t alignment) const {
+  const auto &chunk = chunks_[index];
+  auto address = reinterpret_cast<uintptr_t>(chunk.data.get()) + offset;
+  auto aligned = (address + alignment - 1) & ~(uintptr_t{alignment} - 1);
+  auto position = offset + static_cast<size_t>(aligned - address);
+  if (position > chunk.size || chunk.size - position < bytes) {
+    return std::nullopt;
+  }
+  return position;
+}
+
+void *ppc::core::ScratchArena::Allocate(size_t bytes, size_t alignment) {
+  if (!std::has_single_bit(alignment)) {
+    throw std::invalid_argument("ScratchArena: alignment must be a power of two");
+  }
+
+  size_t index = current_;
+  size_t offset = offset_;
+  auto position = index < chunks_.size() ? FitInChunk(index, offset, bytes, alignment) : std::nullopt;
+  // the tail of a skipped chunk is not reused until the next rewind
+  while (!position && ++index < chunks_.size()) {
+    offset = 0;
+    position = FitInChunk(index, offset, bytes, alignment);
+  }
+  if (!position) {
+    const size_t size = std::max(chunk_size_, bytes + alignment);
+    chunks_.push_back(Chunk{.data = std::make_unique_for_overwrite<std::byte[]>(size), .size = size});
+    index = chunks_.size() - 1;
+    offset = 0;
+    position = FitInChunk(index, offset, bytes, alignment);
+  }
+
+  used_ += (index == current_ ? *position - offset_ : *position) + bytes;
+  current_ = index;
+  offset_ = *position + bytes;
+  high_water_mark_ = std::max(high_water_mark_, used_);
+  return chunks_[index].data.get() + *position;
+}
+
+void ppc::core::ScratchArena::Rewind(const Mark &mark) {
+  if (mark.used > used_) {
+    throw std::invalid_argument("ScratchArena: mark is newer than the current position");
+  }
+  current_ = mark.chunk;
+  offset_ = mark.offset;
+  used_ = mark.used;
+}
+
+void ppc::core::ScratchArena::Reset() {
+  if (chunks_.size() > 1) {
+    const auto capacity = static_cast<size_t>(GetCapacityBytes());
+    chunks_.clear();
+    chunks_.push_back(Chunk{.data = std::make_unique_for_overwrite<std::byte[]>(capacity), .size = capacity});
+  }
+  current_ = 0;
+  offset_ = 0;
+  used_ = 0;
+}
+
+uint64_t ppc::core::ScratchArena::GetCapacityBytes() const {
+  uint64_t capacity = 0;
+  for (const auto &chunk : chunks_) {
+    capacity += chunk.size;
+  }
+  return capacity;
+}
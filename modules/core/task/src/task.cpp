@@ -1,15 +1,69 @@
 #include "core/task/include/task.hpp"
 
+#include <gtest/gtest.h>
+
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <numeric>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "core/util/include/util.hpp"
+
+namespace {
+
+ppc::core::DataType TypeOf(const std::vector<ppc::core::BufferLayout>& layouts, size_t index) {
+  return index < layouts.size() ? layouts[index].type : ppc::core::DataType::kUnknown;
+}
+
+// same number of buffers with the same shapes and element types
+bool SameLayout(const ppc::core::TaskData& lhs, const ppc::core::TaskData& rhs) {
+  if (lhs.inputs.size() != rhs.inputs.size() || lhs.outputs.size() != rhs.outputs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs.inputs.size(); i++) {
+    if (lhs.InputShape(i) != rhs.InputShape(i) || TypeOf(lhs.inputs_layout, i) != TypeOf(rhs.inputs_layout, i)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < lhs.outputs.size(); i++) {
+    if (lhs.OutputShape(i) != rhs.OutputShape(i) || TypeOf(lhs.outputs_layout, i) != TypeOf(rhs.outputs_layout, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Budget of the functional test running now: the model of its task is
+// "<backend>/<task>:func", or the pipeline one, which times the same calls.
+ppc::core::TimeBudget FuncTestTimeBudget() {
+  const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const auto [backend, task] = ppc::util::SplitTaskPath(test_info != nullptr ? test_info->file() : "");
+  if (backend.empty()) {
+    return ppc::core::TimeBudget::FromEnvironment(ppc::core::Task::kDefaultTimeLimit, "PPC_FUNC_TIME_LIMIT");
+  }
+  const auto key = backend + "/" + task;
+  auto budget =
+      ppc::core::TimeBudget::FromEnvironment(ppc::core::Task::kDefaultTimeLimit, "PPC_FUNC_TIME_LIMIT", key + ":func");
+  if (!budget.model) {
+    budget = ppc::core::TimeBudget::FromEnvironment(ppc::core::Task::kDefaultTimeLimit, "PPC_FUNC_TIME_LIMIT",
+                                                    key + ":pipeline");
+  }
+  return budget;
+}
+
+}  // namespace
 
 void ppc::core::Task::SetData(TaskDataPtr task_data_ptr) {
   task_data_ptr->state_of_testing = TaskData::StateOfTesting::kFunc;
-  functions_order_.clear();
+  functions_count_ = 0;
+  last_function_.clear();
+  prepared_ = false;
   this->task_data = std::move(task_data_ptr);
 }
 
@@ -17,42 +71,119 @@ ppc::core::TaskDataPtr ppc::core::Task::GetData() const { return task_data; }
 
 ppc::core::Task::Task(TaskDataPtr task_data) { SetData(std::move(task_data)); }
 
+const ppc::core::TaskProfile& ppc::core::Task::GetProfile() const { return profile_; }
+
+void ppc::core::Task::ResetProfile() { profile_.Reset(); }
+
+ppc::core::ProfileScope ppc::core::Task::OpenScope(const std::string& name) { return {profile_, name}; }
+
+const ppc::core::ScratchArena& ppc::core::Task::GetScratchArena() const { return arena_; }
+
+ppc::core::ScratchArena& ppc::core::Task::Scratch() { return arena_; }
+
+void ppc::core::Task::SetTimeBudget(const TimeBudget& time_budget) { time_budget_ = time_budget; }
+
+const ppc::core::TimeBudget& ppc::core::Task::GetTimeBudget() const {
+  if (!time_budget_) {
+    time_budget_ = FuncTestTimeBudget();
+  }
+  return *time_budget_;
+}
+
+void ppc::core::Task::CountBytesIn(uint64_t bytes) { profile_.AddBytesIn(bytes); }
+
+void ppc::core::Task::CountBytesOut(uint64_t bytes) { profile_.AddBytesOut(bytes); }
+
+bool ppc::core::Task::Prepare() {
+  functions_count_ = 0;
+  last_function_.clear();
+  prepared_ = false;
+  if (!Validation() || !PreProcessing()) {
+    return false;
+  }
+  functions_count_ = 0;
+  last_function_.clear();
+  prepared_ = true;
+  return true;
+}
+
+bool ppc::core::Task::Execute() {
+  if (!prepared_) {
+    throw std::logic_error("Execute() needs a prepared task, call Prepare() first");
+  }
+  return Run() && PostProcessing();
+}
+
+bool ppc::core::Task::Rebind(TaskDataPtr task_data_ptr) {
+  if (!prepared_) {
+    throw std::logic_error("Rebind() needs a prepared task, call Prepare() first");
+  }
+  if (functions_count_ != 0 && last_function_ != "PostProcessing") {
+    throw std::logic_error("Rebind() is not allowed between Run() and PostProcessing()");
+  }
+  if (!SameLayout(*task_data, *task_data_ptr)) {
+    throw std::invalid_argument("Rebind() needs buffers of the same number, shapes and types");
+  }
+  task_data_ptr->state_of_testing = task_data->state_of_testing;
+  task_data = std::move(task_data_ptr);
+  arena_.Rewind(pre_processing_mark_);
+  auto result = RebindImpl();
+  run_mark_ = arena_.GetMark();
+  return result;
+}
+
+bool ppc::core::Task::IsPrepared() const { return prepared_; }
+
+bool ppc::core::Task::RebindImpl() { return PreProcessingImpl(); }
+
 bool ppc::core::Task::Validation() {
   InternalOrderTest();
+  ProfileScope scope(profile_, "Validation", true);
+  arena_.Reset();
   return ValidationImpl();
 }
 
 bool ppc::core::Task::PreProcessing() {
   InternalOrderTest();
-  return PreProcessingImpl();
+  ProfileScope scope(profile_, "PreProcessing", true);
+  pre_processing_mark_ = arena_.GetMark();
+  auto result = PreProcessingImpl();
+  run_mark_ = arena_.GetMark();
+  return result;
 }
 
 bool ppc::core::Task::Run() {
   InternalOrderTest();
+  ProfileScope scope(profile_, "Run", true);
+  arena_.Rewind(run_mark_);
   return RunImpl();
 }
 
 bool ppc::core::Task::PostProcessing() {
   InternalOrderTest();
+  ProfileScope scope(profile_, "PostProcessing", true);
   return PostProcessingImpl();
 }
 
 void ppc::core::Task::InternalOrderTest(const std::string& str) {
-  if (!functions_order_.empty() && str == functions_order_.back() && str == "Run") {
+  if (functions_count_ != 0 && str == last_function_ && str == "Run") {
     return;
   }
 
-  functions_order_.push_back(str);
-
-  for (size_t i = 0; i < functions_order_.size(); i++) {
-    if (functions_order_[i] != right_functions_order_[i % right_functions_order_.size()]) {
-      throw std::invalid_argument("ORDER OF FUCTIONS IS NOT RIGHT: \n" + std::string("Serial number: ") +
-                                  std::to_string(i + 1) + "\n" + std::string("Yours function: ") + functions_order_[i] +
-                                  "\n" + std::string("Expected function: ") + right_functions_order_[i]);
-    }
+  // the earlier calls are already checked, only the new one needs to be
+  const auto& right_order = prepared_ ? prepared_functions_order_ : right_functions_order_;
+  const auto& expected = right_order[functions_count_ % right_order.size()];
+  ++functions_count_;
+  last_function_ = str;
+  if (str != expected) {
+    throw std::invalid_argument("ORDER OF FUCTIONS IS NOT RIGHT: \n" + std::string("Serial number: ") +
+                                std::to_string(functions_count_) + "\n" + std::string("Yours function: ") + str +
+                                "\n" + std::string("Expected function: ") + expected);
   }
 
-  if (str == "PreProcessing" && task_data->state_of_testing == TaskData::StateOfTesting::kFunc) {
+  // prepared tasks are timed from Run(), the one-time setup is not included
+  const auto* first_timed = prepared_ ? "Run" : "PreProcessing";
+  if (str == first_timed && task_data->state_of_testing == TaskData::StateOfTesting::kFunc) {
     tmp_time_point_ = std::chrono::high_resolution_clock::now();
   }
 
@@ -60,16 +191,12 @@ void ppc::core::Task::InternalOrderTest(const std::string& str) {
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - tmp_time_point_).count();
     auto current_time = static_cast<double>(duration) * 1e-9;
-    if (current_time < max_test_time_) {
+    const auto& inputs_count = task_data->inputs_count;
+    const auto input_size = std::accumulate(inputs_count.begin(), inputs_count.end(), uint64_t{0});
+    if (GetTimeBudget().Check(current_time, input_size)) {
       std::cout << "Test time:" << std::fixed << std::setprecision(10) << current_time;
-    } else {
-      std::stringstream err_msg;
-      err_msg << "\nTask execute time need to be: ";
-      err_msg << "time < " << max_test_time_ << " secs.\n";
-      err_msg << "Original time in secs: " << current_time << '\n';
-      throw std::runtime_error(err_msg.str().c_str());
     }
   }
 }
 
-ppc::core::Task::~Task() { functions_order_.clear(); }
+ppc::core::Task::~Task() = default;
@@ -0,0 +1,175 @@
+#include "core/task/include/time_budget.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "core/util/include/util.hpp"
+
+namespace {
+
+double ParsePositive(const std::string &value, const std::string &name) {
+  try {
+    size_t end = 0;
+    const double result = std::stod(value, &end);
+    if (end == value.size() && std::isfinite(result) && result > 0.0) {
+      return result;
+    }
+  } catch (const std::logic_error &) {
+  }
+  throw std::invalid_argument(name + " must be a positive number, got '" + value + "'");
+}
+
+}  // namespace
+
+double ppc::core::TimeModel::Predict(uint64_t input_size) const {
+  const auto n = static_cast<double>(std::max<uint64_t>(input_size, 1));
+  switch (complexity) {
+    case Complexity::kConstant:
+      return coefficient;
+    case Complexity::kLogN:
+      return coefficient * std::log2(n + 1.0);
+    case Complexity::kLinear:
+      return coefficient * n;
+    case Complexity::kNLogN:
+      return coefficient * n * std::log2(n + 1.0);
+    case Complexity::kQuadratic:
+      return coefficient * n * n;
+    case Complexity::kCubic:
+      return coefficient * n * n * n;
+  }
+  return coefficient;
+}
+
+double ppc::core::TimeBudget::LimitFor(uint64_t input_size, uint64_t runs) const {
+  if (!model) {
+    return limit_sec;
+  }
+  const auto num_runs = static_cast<double>(std::max<uint64_t>(runs, 1));
+  return num_runs * std::max(floor_sec, tolerance * model->Predict(input_size));
+}
+
+bool ppc::core::TimeBudget::Check(double time_sec, uint64_t input_size, uint64_t runs) const {
+  const double limit = LimitFor(input_size, runs);
+  if (time_sec < limit) {
+    return true;
+  }
+  if (policy == BudgetPolicy::kOff) {
+    return false;
+  }
+
+  std::stringstream err_msg;
+  err_msg << "\nTask execute time need to be: ";
+  err_msg << "time < " << limit << " secs.\n";
+  err_msg << "Original time in secs: " << time_sec << '\n';
+  if (model) {
+    const auto num_runs = static_cast<double>(std::max<uint64_t>(runs, 1));
+    err_msg << "Expected time in secs: " << model->Predict(input_size) * num_runs << " ("
+            << ComplexityName(model->complexity) << " model, n = " << input_size << ")\n";
+  }
+  if (policy == BudgetPolicy::kFail) {
+    throw std::runtime_error(err_msg.str());
+  }
+  std::cerr << "Warning! Time budget is exceeded:" << err_msg.str();
+  return false;
+}
+
+ppc::core::TimeBudget ppc::core::TimeBudget::FromEnvironment(double default_limit_sec,
+                                                             const std::string &limit_variable,
+                                                             const std::string &key) {
+  TimeBudget budget;
+  budget.limit_sec = default_limit_sec;
+
+  const auto limit = ppc::util::GetEnvVariable(limit_variable);
+  if (!limit.empty()) {
+    budget.limit_sec = ParsePositive(limit, limit_variable);
+  }
+  const auto policy = ppc::util::GetEnvVariable("PPC_TIME_BUDGET_POLICY");
+  if (!policy.empty()) {
+    budget.policy = ParseBudgetPolicy(policy);
+  }
+  const auto tolerance = ppc::util::GetEnvVariable("PPC_TIME_BUDGET_TOLERANCE");
+  if (!tolerance.empty()) {
+    budget.tolerance = ParsePositive(tolerance, "PPC_TIME_BUDGET_TOLERANCE");
+  }
+  const auto file = ppc::util::GetEnvVariable("PPC_TIME_BUDGET_FILE");
+  if (!file.empty() && !key.empty()) {
+    budget.model = LoadModel(file, key);
+  }
+  return budget;
+}
+
+std::optional<ppc::core::TimeModel> ppc::core::TimeBudget::LoadModel(const std::string &path, const std::string &key) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("Can't open time budget file: " + path);
+  }
+
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(file, line)) {
+    line_number++;
+    line = line.substr(0, line.find('#'));
+    std::istringstream stream(line);
+    std::string line_key;
+    if (!(stream >> line_key) || line_key != key) {
+      continue;
+    }
+    std::string complexity;
+    std::string coefficient;
+    if (!(stream >> complexity >> coefficient)) {
+      throw std::runtime_error(path + ":" + std::to_string(line_number) +
+                               ": expected '<key> <complexity> <coefficient>'");
+    }
+    return TimeModel{.complexity = ParseComplexity(complexity),
+                     .coefficient = ParsePositive(coefficient, "coefficient of " + key)};
+  }
+  return std::nullopt;
+}
+
+ppc::core::Complexity ppc::core::ParseComplexity(const std::string &name) {
+  for (auto complexity : {Complexity::kConstant, Complexity::kLogN, Complexity::kLinear, Complexity::kNLogN,
+                          Complexity::kQuadratic, Complexity::kCubic}) {
+    if (ComplexityName(complexity) == name) {
+      return complexity;
+    }
+  }
+  throw std::invalid_argument("Unknown complexity: " + name);
+}
+
+std::string ppc::core::ComplexityName(Complexity complexity) {
+  switch (complexity) {
+    case Complexity::kConstant:
+      return "constant";
+    case Complexity::kLogN:
+      return "logn";
+    case Complexity::kLinear:
+      return "n";
+    case Complexity::kNLogN:
+      return "nlogn";
+    case Complexity::kQuadratic:
+      return "n2";
+    case Complexity::kCubic:
+      return "n3";
+  }
+  return "unknown";
+}
+
+ppc::core::BudgetPolicy ppc::core::ParseBudgetPolicy(const std::string &name) {
+  if (name == "fail") {
+    return BudgetPolicy::kFail;
+  }
+  if (name == "warn") {
+    return BudgetPolicy::kWarn;
+  }
+  if (name == "off") {
+    return BudgetPolicy::kOff;
+  }
+  throw std::invalid_argument("Unknown time budget policy: " + name + " (expected fail, warn or off)");
+}
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <array>
 #include <cstdlib>
 #include <string>
 #include <thread>
+#include <utility>
 
 #include "core/util/include/util.hpp"
 
@@ -34,3 +36,69 @@ TEST(util_tests, check_set_env) {
   GTEST_SKIP();
 #endif
 }
+
+TEST(util_tests, check_get_env_variable) {
+#ifndef _WIN32
+  setenv("PPC_UTIL_TEST_VARIABLE", "value", 1);  // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(ppc::util::GetEnvVariable("PPC_UTIL_TEST_VARIABLE"), "value");
+
+  unsetenv("PPC_UTIL_TEST_VARIABLE");  // NOLINT(misc-include-cleaner)
+  EXPECT_TRUE(ppc::util::GetEnvVariable("PPC_UTIL_TEST_VARIABLE").empty());
+#else
+  GTEST_SKIP();
+#endif
+}
+
+TEST(util_tests, check_perf_scale) {
+#ifndef _WIN32
+  unsetenv("PPC_PERF_SCALE");  // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(ppc::util::GetPerfScale(), 1.0);
+  EXPECT_EQ(ppc::util::GetScaledPerfSize(100), 100U);
+
+  setenv("PPC_PERF_SCALE", "4", 1);  // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(ppc::util::GetPerfScale(), 4.0);
+  EXPECT_EQ(ppc::util::GetScaledPerfSize(100), 400U);
+
+  setenv("PPC_PERF_SCALE", "0.001", 1);  // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(ppc::util::GetScaledPerfSize(100), 1U);
+
+  setenv("PPC_PERF_SCALE", "abc", 1);  // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(ppc::util::GetPerfScale(), 1.0);
+
+  unsetenv("PPC_PERF_SCALE");  // NOLINT(misc-include-cleaner)
+#else
+  GTEST_SKIP();
+#endif
+}
+
+TEST(util_tests, check_launched_ranks) {
+#ifndef _WIN32
+  // keep the values of the launcher this test may run under
+  const auto ompi = ppc::util::GetEnvVariable("OMPI_COMM_WORLD_SIZE");
+  const auto pmi = ppc::util::GetEnvVariable("PMI_SIZE");
+  const auto mvapich = ppc::util::GetEnvVariable("MV2_COMM_WORLD_SIZE");
+  unsetenv("OMPI_COMM_WORLD_SIZE");  // NOLINT(misc-include-cleaner)
+  unsetenv("PMI_SIZE");              // NOLINT(misc-include-cleaner)
+  unsetenv("MV2_COMM_WORLD_SIZE");   // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(ppc::util::GetLaunchedRanks(), 1);
+
+  setenv("PMI_SIZE", "4", 1);  // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(ppc::util::GetLaunchedRanks(), 4);
+  setenv("OMPI_COMM_WORLD_SIZE", "2", 1);  // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(ppc::util::GetLaunchedRanks(), 2);
+  setenv("OMPI_COMM_WORLD_SIZE", "x", 1);  // NOLINT(misc-include-cleaner)
+  EXPECT_EQ(ppc::util::GetLaunchedRanks(), 1);
+
+  unsetenv("OMPI_COMM_WORLD_SIZE");  // NOLINT(misc-include-cleaner)
+  unsetenv("PMI_SIZE");              // NOLINT(misc-include-cleaner)
+  const std::array<std::pair<const char *, std::string>, 3> saved = {
+      {{"OMPI_COMM_WORLD_SIZE", ompi}, {"PMI_SIZE", pmi}, {"MV2_COMM_WORLD_SIZE", mvapich}}};
+  for (const auto &[name, value] : saved) {
+    if (!value.empty()) {
+      setenv(name, value.c_str(), 1);  // NOLINT(misc-include-cleaner)
+    }
+  }
+#else
+  GTEST_SKIP();
+#endif
+}
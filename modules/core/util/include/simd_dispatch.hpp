@@ -0,0 +1,24 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Vector kernels are marked PPC_TARGET("avx2") etc. GCC and Clang compile them
+// for any x86 target, and the caller picks one at run time with
+// __builtin_cpu_supports (PPC_RUNTIME_DISPATCH). Other compilers only get the
+// kernels the build flags allow.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PPC_RUNTIME_DISPATCH
+#define PPC_HAS_AVX2
+#define PPC_HAS_AVX512
+#define PPC_TARGET(features) __attribute__((target(features)))
+#else
+#if defined(__AVX2__)
+#define PPC_HAS_AVX2
+#endif
+#if defined(__AVX512F__)
+#define PPC_HAS_AVX512
+#endif
+#define PPC_TARGET(features)
+#endif
@@ -1,9 +1,26 @@
 #pragma once
+#include <cstddef>
 #include <string>
+#include <utility>
 
 namespace ppc::util {
 
 std::string GetAbsolutePath(const std::string &relative_path);
 int GetPPCNumThreads();
+// value of an environment variable, empty if it is not set
+std::string GetEnvVariable(const std::string &name);
+// Factor for input sizes of perf tests (PPC_PERF_SCALE, 1.0 if unset or
+// invalid). scripts/run_scaling_sweep.py sets it to the number of workers
+// for weak scaling, so the work per worker stays the same.
+double GetPerfScale();
+// base_size * GetPerfScale(), at least 1
+size_t GetScaledPerfSize(size_t base_size);
+// Number of processes started by the MPI launcher, from its environment
+// (OMPI_COMM_WORLD_SIZE, PMI_SIZE, MV2_COMM_WORLD_SIZE), 1 outside of it.
+// Lets MPI-free code tell runs at different -np apart.
+int GetLaunchedRanks();
+// "<...>/tasks/<backend>/<task>/<...>" -> {backend, task}; paths of other
+// layouts give an empty backend and the whole path as the task
+std::pair<std::string, std::string> SplitTaskPath(const std::string &task_path);
 
 }  // namespace ppc::util
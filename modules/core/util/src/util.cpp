@@ -8,8 +8,12 @@
 #include <vector>
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <filesystem>
 #include <string>
+#include <utility>
 
 std::string ppc::util::GetAbsolutePath(const std::string &relative_path) {
   const std::filesystem::path path = std::string(PPC_PATH_TO_PROJECT) + "/tasks/" + relative_path;
@@ -30,3 +34,60 @@ int ppc::util::GetPPCNumThreads() {
   int num_threads = (omp_env != nullptr) ? std::atoi(omp_env) : 1;
   return num_threads;
 }
+
+std::string ppc::util::GetEnvVariable(const std::string &name) {
+#ifdef _WIN32
+  size_t len;
+  char value[1024];
+  errno_t err = getenv_s(&len, value, sizeof(value), name.c_str());
+  if (err != 0 || len == 0) {
+    return {};
+  }
+  return value;
+#else
+  const char *value = std::getenv(name.c_str());
+  return value != nullptr ? value : std::string{};
+#endif
+}
+
+double ppc::util::GetPerfScale() {
+  const auto value = GetEnvVariable("PPC_PERF_SCALE");
+  if (value.empty()) {
+    return 1.0;
+  }
+  char *end = nullptr;
+  const double scale = std::strtod(value.c_str(), &end);
+  return (end != value.c_str() && std::isfinite(scale) && scale > 0.0) ? scale : 1.0;
+}
+
+size_t ppc::util::GetScaledPerfSize(size_t base_size) {
+  return std::max<size_t>(1, static_cast<size_t>(std::llround(static_cast<double>(base_size) * GetPerfScale())));
+}
+
+int ppc::util::GetLaunchedRanks() {
+  for (const auto *name : {"OMPI_COMM_WORLD_SIZE", "PMI_SIZE", "MV2_COMM_WORLD_SIZE"}) {
+    const auto value = GetEnvVariable(name);
+    if (!value.empty()) {
+      const int ranks = std::atoi(value.c_str());
+      return ranks > 0 ? ranks : 1;
+    }
+  }
+  return 1;
+}
+
+std::pair<std::string, std::string> ppc::util::SplitTaskPath(const std::string &task_path) {
+  std::string path(task_path);
+  std::ranges::replace(path, '\\', '/');
+  const auto tasks_position = path.find("tasks/");
+  if (tasks_position == std::string::npos) {
+    return {"", path};
+  }
+  path.erase(0, tasks_position + std::string("tasks/").length());
+  const auto separator = path.find('/');
+  if (separator == std::string::npos) {
+    return {"", path};
+  }
+  auto task = path.substr(separator + 1);
+  task = task.substr(0, task.find('/'));
+  return {path.substr(0, separator), task};
+}
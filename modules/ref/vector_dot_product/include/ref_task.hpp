@@ -1,10 +1,9 @@
 #ifndef MODULES_REFERENCE_VECTOR_DOT_PRODUCT_REF_TASK_HPP_
 #define MODULES_REFERENCE_VECTOR_DOT_PRODUCT_REF_TASK_HPP_
 
-#include <cstddef>
 #include <memory>
 #include <numeric>
-#include <vector>
+#include <span>
 
 #include "core/task/include/task.hpp"
 
@@ -15,15 +14,9 @@ class VectorDotProduct : public ppc::core::Task {
  public:
   explicit VectorDotProduct(ppc::core::TaskDataPtr task_data) : Task(task_data) {}
   bool PreProcessingImpl() override {
-    // Init vectors
-    input_ = std::vector<std::vector<InOutType> >(2);
-    for (size_t i = 0; i < input_.size(); i++) {
-      input_[i] = std::vector<InOutType>(task_data->inputs_count[i]);
-      auto tmp_ptr = reinterpret_cast<InOutType*>(task_data->inputs[i]);
-      for (unsigned j = 0; j < task_data->inputs_count[i]; j++) {
-        input_[i][j] = tmp_ptr[j];
-      }
-    }
+    // Init views, inputs are read in place
+    lhs_ = task_data->template InputView<const InOutType>(0).Span();
+    rhs_ = task_data->template InputView<const InOutType>(1).Span();
 
     // Init value for output
     dor_product_ = 0;
@@ -36,7 +29,7 @@ class VectorDotProduct : public ppc::core::Task {
   }
 
   bool RunImpl() override {
-    dor_product_ = std::inner_product(input_[0].begin(), input_[0].end(), input_[1].begin(), 0.0);
+    dor_product_ = std::inner_product(lhs_.begin(), lhs_.end(), rhs_.begin(), 0.0);
     return true;
   }
 
@@ -46,7 +39,8 @@ class VectorDotProduct : public ppc::core::Task {
   }
 
  private:
-  std::vector<std::vector<InOutType> > input_;
+  std::span<const InOutType> lhs_;
+  std::span<const InOutType> rhs_;
   InOutType dor_product_;
 };
 
@@ -0,0 +1,80 @@
+import argparse
+import csv
+import json
+import math
+import os
+
+# Fits expected-time models of perf tests from result records (PPC_PERF_RESULTS, e.g. of a weak scaling sweep
+# of scripts/run_scaling_sweep.py) and writes a budget file for PPC_TIME_BUDGET_FILE. Every task gets the model
+# t(n) = c * f(n) with f from COMPLEXITIES that fits best (least squares); with a single input size the
+# complexity can not be told apart and --default-complexity is used.
+
+COMPLEXITIES = {
+    "constant": lambda n: 1.0,
+    "logn": lambda n: math.log2(n + 1.0),
+    "n": lambda n: n,
+    "nlogn": lambda n: n * math.log2(n + 1.0),
+    "n2": lambda n: n * n,
+    "n3": lambda n: n * n * n,
+}
+
+parser = argparse.ArgumentParser()
+parser.add_argument('-i', '--input', nargs='+', help='Result records (.jsonl or .csv)', required=True)
+parser.add_argument('-o', '--output', help='Budget file to write', required=True)
+parser.add_argument('--default-complexity', choices=COMPLEXITIES.keys(), default='n',
+                    help='Complexity of tasks measured at one input size only')
+parser.add_argument('--ranks', type=int, default=None, help='Use records of this rank count only')
+args = parser.parse_args()
+
+
+def read_records(path):
+    records = []
+    with open(path, "r") as file:
+        if path.endswith(".csv"):
+            for row in csv.DictReader(file):
+                records.append({"backend": row["backend"], "task": row["task"], "type": row["type"],
+                                "ranks": int(row["ranks"]), "input_size": int(row["input_size"]),
+                                "statistics": {"median": float(row["median"])}})
+        else:
+            for line in file:
+                if line.strip():
+                    records.append(json.loads(line))
+    return records
+
+
+def fit(points, complexity):
+    # least squares of t = c * f(n) through the origin, returns (c, relative rms error)
+    f = COMPLEXITIES[complexity]
+    numerator = sum(t * f(n) for n, t in points)
+    denominator = sum(f(n) ** 2 for n, _ in points)
+    if denominator <= 0 or numerator <= 0:
+        return None, math.inf
+    c = numerator / denominator
+    error = math.sqrt(sum(((c * f(n) - t) / t) ** 2 for n, t in points) / len(points))
+    return c, error
+
+
+points_by_key = {}
+for path in args.input:
+    for record in read_records(os.path.abspath(path)):
+        if args.ranks is not None and record["ranks"] != args.ranks:
+            continue
+        median = record["statistics"]["median"]
+        if median > 0:
+            key = f'{record["backend"]}/{record["task"]}:{record["type"]}'
+            points_by_key.setdefault(key, []).append((max(record["input_size"], 1), median))
+
+with open(os.path.abspath(args.output), "w") as file:
+    file.write("# <backend>/<task>:<type> <complexity> <coefficient>, fitted by scripts/calibrate_time_budgets.py\n")
+    for key in sorted(points_by_key):
+        points = points_by_key[key]
+        if len({n for n, _ in points}) > 1:
+            fits = {name: fit(points, name) for name in COMPLEXITIES}
+            complexity = min(fits, key=lambda name: fits[name][1])
+        else:
+            complexity = args.default_complexity
+        coefficient, error = fit(points, complexity)
+        if coefficient is None:
+            continue
+        file.write(f"{key} {complexity} {coefficient:.6e}\n")
+        print(f"{key}: {complexity}, c = {coefficient:.6e}, relative error = {error:.3f}, points = {len(points)}")
@@ -0,0 +1,133 @@
+import argparse
+import csv
+import json
+import math
+import os
+import sys
+
+# Compares perf results written by ppc::core::Perf::WriteResultRecord (set PPC_PERF_RESULTS=<file>.jsonl or .csv
+# when running perf tests) against a stored baseline. A task is a regression when its median time grew by more
+# than --threshold and the Mann-Whitney U test says the samples differ with p-value below --alpha. Records of one
+# task are told apart by the gtest test that wrote them and the variant it measured (engine, filter, queue...).
+
+parser = argparse.ArgumentParser()
+parser.add_argument('-b', '--baseline', help='Baseline results (.jsonl or .csv)', required=True)
+parser.add_argument('-c', '--current', help='Current results (.jsonl or .csv)', required=True)
+parser.add_argument('-t', '--threshold', help='Minimal relative change of the median to report', type=float,
+                    default=0.05)
+parser.add_argument('-a', '--alpha', help='Significance level of the Mann-Whitney U test', type=float, default=0.01)
+parser.add_argument('-o', '--output', help='Write the comparison as CSV table to this path', required=False)
+parser.add_argument('--no-fail', help='Exit with 0 even if regressions are found', action='store_true')
+args = parser.parse_args()
+
+KEY_FIELDS = ("backend", "task", "type", "variant", "test", "ranks", "threads", "input_size")
+
+
+def read_records(path):
+    records = []
+    with open(path, "r") as file:
+        if path.endswith(".csv"):
+            for row in csv.DictReader(file):
+                row["samples"] = [float(x) for x in row["samples"].split(";") if x]
+                for field in ("ranks", "threads", "input_size", "timestamp"):
+                    row[field] = int(row[field])
+                row["time_sec"] = float(row["time_sec"])
+                records.append(row)
+        else:
+            for line in file:
+                if line.strip():
+                    records.append(json.loads(line))
+    return records
+
+
+def latest_by_key(records):
+    # results files are appended, keep the newest record of every configuration
+    result = {}
+    for record in records:
+        # records written before the variant and test fields existed have them empty
+        key = tuple(record.get(field, "") for field in KEY_FIELDS)
+        if key not in result or record.get("timestamp", 0) >= result[key].get("timestamp", 0):
+            result[key] = record
+    return result
+
+
+def median(values):
+    values = sorted(values)
+    mid = len(values) // 2
+    return values[mid] if len(values) % 2 else (values[mid - 1] + values[mid]) / 2.0
+
+
+def mann_whitney_p_value(lhs, rhs):
+    # two-sided p-value, normal approximation with tie correction
+    n1, n2 = len(lhs), len(rhs)
+    merged = sorted([(x, 0) for x in lhs] + [(x, 1) for x in rhs])
+    ranks_sum = 0.0
+    ties = 0.0
+    i = 0
+    while i < len(merged):
+        j = i
+        while j + 1 < len(merged) and merged[j + 1][0] == merged[i][0]:
+            j += 1
+        rank = (i + j) / 2.0 + 1.0
+        ranks_sum += rank * sum(1 for k in range(i, j + 1) if merged[k][1] == 0)
+        count = j - i + 1
+        ties += count ** 3 - count
+        i = j + 1
+    u = ranks_sum - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    variance = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (abs(u - n1 * n2 / 2.0) - 0.5) / math.sqrt(variance)
+    return math.erfc(max(z, 0.0) / math.sqrt(2.0))
+
+
+def compare(baseline, current):
+    base_samples = baseline.get("samples") or [baseline["time_sec"]]
+    cur_samples = current.get("samples") or [current["time_sec"]]
+    base_median = median(base_samples)
+    cur_median = median(cur_samples)
+    change = (cur_median - base_median) / base_median if base_median > 0 else 0.0
+    # too few samples for a rank test, the threshold alone decides
+    p_value = mann_whitney_p_value(base_samples, cur_samples) if min(len(base_samples), len(cur_samples)) >= 3 else 0.0
+    status = "ok"
+    if abs(change) > args.threshold and p_value < args.alpha:
+        status = "regression" if change > 0 else "improvement"
+    return base_median, cur_median, change, p_value, status
+
+
+baseline_records = latest_by_key(read_records(os.path.abspath(args.baseline)))
+current_records = latest_by_key(read_records(os.path.abspath(args.current)))
+
+rows = []
+for key in sorted(current_records.keys(), key=str):
+    if key not in baseline_records:
+        rows.append(list(key) + ["", "", "", "", "new"])
+        continue
+    base_median, cur_median, change, p_value, status = compare(baseline_records[key], current_records[key])
+    rows.append(list(key) + [base_median, cur_median, change, p_value, status])
+for key in sorted(baseline_records.keys() - current_records.keys(), key=str):
+    rows.append(list(key) + ["", "", "", "", "missing"])
+
+header = list(KEY_FIELDS) + ["baseline_median", "current_median", "change", "p_value", "status"]
+for row in rows:
+    backend, task, perf_type, variant, test, ranks, threads, _ = row[:len(KEY_FIELDS)]
+    run_name = f"{perf_type}.{variant}" if variant else perf_type
+    test_name = f"{test}, " if test else ""
+    name = f"{backend}/{task}:{run_name} ({test_name}ranks={ranks}, threads={threads})"
+    base_median, cur_median, change, p_value, status = row[len(KEY_FIELDS):]
+    if base_median == "":
+        print(f"{name}: {status}")
+    else:
+        print(f"{name}: {base_median:.6f} -> {cur_median:.6f} sec ({change * 100:+.1f}%, p={p_value:.4f}) {status}")
+
+if args.output:
+    with open(os.path.abspath(args.output), "w", newline="") as file:
+        writer = csv.writer(file)
+        writer.writerow(header)
+        writer.writerows(rows)
+
+regressions = [row for row in rows if row[-1] == "regression"]
+print(f"Compared {len(rows)} results: {len(regressions)} regression(s)")
+if regressions and not args.no_fail:
+    sys.exit(1)
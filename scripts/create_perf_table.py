@@ -21,7 +21,7 @@ logs_lines = logs_file.readlines()
 for line in logs_lines:
     pattern = r'tasks[\/|\\](\w*)[\/|\\](\w*):(\w*):(-*\d*\.\d*)'
     result = re.findall(pattern, line)
-    if len(result):
+    if len(result) and result[0][2] in result_tables:
         task_name = result[0][1]
         perf_type = result[0][2]
         set_of_task_name.append(task_name)
@@ -33,7 +33,7 @@ for line in logs_lines:
 for line in logs_lines:
     pattern = r'tasks[\/|\\](\w*)[\/|\\](\w*):(\w*):(-*\d*\.\d*)'
     result = re.findall(pattern, line)
-    if len(result):
+    if len(result) and result[0][2] in result_tables:
         task_type = result[0][0]
         task_name = result[0][1]
         perf_type = result[0][2]
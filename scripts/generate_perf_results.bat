@@ -1,4 +1,8 @@
 @echo off
 mkdir build\perf_stat_dir
+rem structured results for scripts\compare_perf_results.py
+set PPC_PERF_RESULTS=%cd%\build\perf_stat_dir\perf_results.jsonl
+for /f %%i in ('git rev-parse HEAD') do set PPC_GIT_COMMIT=%%i
+if exist %PPC_PERF_RESULTS% del %PPC_PERF_RESULTS%
 python3 scripts/run_tests.py --running-type="performance" > build\perf_stat_dir\perf_log.txt
 python scripts\create_perf_table.py --input build\perf_stat_dir\perf_log.txt --output build\perf_stat_dir
@@ -1,3 +1,7 @@
 mkdir -p build/perf_stat_dir
+# structured results for scripts/compare_perf_results.py
+export PPC_PERF_RESULTS="$(pwd)/build/perf_stat_dir/perf_results.jsonl"
+export PPC_GIT_COMMIT="$(git rev-parse HEAD 2>/dev/null)"
+rm -f "$PPC_PERF_RESULTS"
 python3 scripts/run_tests.py --running-type="performance" | tee build/perf_stat_dir/perf_log.txt
 python3 scripts/create_perf_table.py --input build/perf_stat_dir/perf_log.txt --output build/perf_stat_dir
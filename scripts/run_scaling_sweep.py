@@ -0,0 +1,194 @@
+import argparse
+import csv
+import json
+import os
+import platform
+import subprocess
+import tempfile
+from pathlib import Path
+
+# Runs *_perf_tests across a matrix of MPI process counts and thread counts and reports speedup, efficiency and
+# the Karp-Flatt experimentally determined serial fraction of every task. Timings come from the records written
+# by ppc::core::Perf::WriteResultRecord (PPC_PERF_RESULTS).
+#
+# strong scaling: the input is fixed, S(p) = T(1) / T(p), E(p) = S(p) / p
+# weak scaling:   PPC_PERF_SCALE = p grows the input of tests that use ppc::util::GetScaledPerfSize,
+#                 E(p) = T(1) / T(p), scaled speedup S(p) = p * E(p)
+# Karp-Flatt:     e(p) = (1 / S(p) - 1 / p) / (1 - 1 / p), p > 1
+# p is the number of workers: processes * threads.
+
+
+def init_cmd_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--bin-dir', help='Directory with *_perf_tests (default: build/bin or install/bin)')
+    parser.add_argument('--types', default='all,mpi,omp,seq,stl,tbb',
+                        help='Comma-separated types of perf binaries to run')
+    parser.add_argument('--procs', default='1,2,4', help='Comma-separated MPI process counts')
+    parser.add_argument('--threads', default='1,2,4', help='Comma-separated thread counts (OMP_NUM_THREADS)')
+    parser.add_argument('--mode', default='both', choices=['strong', 'weak', 'both'], help='Scaling mode')
+    parser.add_argument('--gtest-filter', default='', help='gtest filter for the perf tests')
+    parser.add_argument('--additional-mpi-args', default='', help='Additional arguments of the mpirun command')
+    parser.add_argument('--output', default='build/scaling_stat_dir', help='Output directory')
+    return parser.parse_args()
+
+
+def parse_counts(value):
+    return sorted({int(x) for x in value.split(',') if x.strip()})
+
+
+def project_path():
+    return Path(__file__).resolve().parent.parent
+
+
+def find_bin_dir(bin_dir):
+    if bin_dir:
+        return Path(bin_dir)
+    for candidate in ("build/bin", "install/bin"):
+        if (project_path() / candidate).is_dir():
+            return project_path() / candidate
+    raise FileNotFoundError("Directory with perf binaries is not found, use --bin-dir")
+
+
+def configurations(task_type, procs, threads):
+    # (processes, threads) pairs a binary is run with
+    if task_type == "seq":
+        return [(1, 1)]
+    if task_type == "mpi":
+        return [(p, 1) for p in procs]
+    if task_type == "all":
+        return [(p, t) for p in procs for t in threads]
+    return [(1, t) for t in threads]
+
+
+def run_binary(binary, task_type, num_procs, num_threads, scale, args):
+    fd, results_path = tempfile.mkstemp(suffix=".jsonl")
+    os.close(fd)
+    env = dict(os.environ)
+    env["OMP_NUM_THREADS"] = str(num_threads)
+    env["PPC_PERF_SCALE"] = str(scale)
+    env["PPC_PERF_RESULTS"] = results_path
+
+    command = []
+    if task_type in ("mpi", "all"):
+        command += ["mpiexec" if platform.system() == "Windows" else "mpirun"]
+        command += args.additional_mpi_args.split() + ["-np", str(num_procs)]
+    command += [str(binary), "--gtest_color=0"]
+    if args.gtest_filter:
+        command += [f"--gtest_filter={args.gtest_filter}"]
+
+    print(f"Running {binary.name}: processes={num_procs}, threads={num_threads}, scale={scale}")
+    result = subprocess.run(command, env=env)
+    if result.returncode != 0:
+        # failed tests still write their records, time limits are often exceeded at large scales
+        print(f"Warning! {binary.name} returned {result.returncode}")
+
+    records = []
+    with open(results_path, "r") as file:
+        for line in file:
+            if line.strip():
+                records.append(json.loads(line))
+    os.remove(results_path)
+    return records
+
+
+def scaling_rows(measurements):
+    # measurements: {(mode, backend, task, type): {(procs, threads): record}}
+    rows = []
+    for (mode, backend, task, perf_type), by_config in sorted(measurements.items()):
+        reference = by_config.get((1, 1))
+        for (num_procs, num_threads), record in sorted(by_config.items()):
+            workers = num_procs * num_threads
+            time = record["statistics"]["median"]
+            row = {"mode": mode, "backend": backend, "task": task, "type": perf_type, "procs": num_procs,
+                   "threads": num_threads, "workers": workers, "input_size": record["input_size"], "time": time,
+                   "speedup": "", "efficiency": "", "karp_flatt": "", "note": ""}
+            if reference is None or time <= 0:
+                row["note"] = "no reference"
+            else:
+                ratio = reference["statistics"]["median"] / time
+                speedup = ratio if mode == "strong" else workers * ratio
+                row["speedup"] = speedup
+                row["efficiency"] = speedup / workers
+                if workers > 1 and speedup > 0:
+                    row["karp_flatt"] = (1.0 / speedup - 1.0 / workers) / (1.0 - 1.0 / workers)
+                if mode == "weak" and workers > 1 and record["input_size"] == reference["input_size"]:
+                    row["note"] = "input does not scale"
+            rows.append(row)
+    return rows
+
+
+def plot(rows, output_dir):
+    try:
+        import matplotlib
+        matplotlib.use("Agg")
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print("matplotlib is not found, curves are not plotted")
+        return
+
+    curves = {}
+    for row in rows:
+        if row["speedup"] != "":
+            key = (row["mode"], row["backend"], row["task"], row["type"])
+            curves.setdefault(key, []).append((row["workers"], row["speedup"], row["efficiency"]))
+    for (mode, backend, task, perf_type), points in curves.items():
+        points.sort()
+        workers = [p[0] for p in points]
+        figure, (speedup_axis, efficiency_axis) = plt.subplots(1, 2, figsize=(10, 4))
+        speedup_axis.plot(workers, [p[1] for p in points], marker="o", label="measured")
+        speedup_axis.plot(workers, workers, linestyle="--", label="ideal")
+        speedup_axis.set_xlabel("workers")
+        speedup_axis.set_ylabel("speedup")
+        speedup_axis.legend()
+        efficiency_axis.plot(workers, [p[2] for p in points], marker="o")
+        efficiency_axis.set_xlabel("workers")
+        efficiency_axis.set_ylabel("efficiency")
+        efficiency_axis.set_ylim(bottom=0)
+        figure.suptitle(f"{backend}/{task}:{perf_type} ({mode} scaling)")
+        figure.savefig(output_dir / f"{mode}_{backend}_{task}_{perf_type}.png")
+        plt.close(figure)
+
+
+if __name__ == "__main__":
+    args = init_cmd_args()
+    bin_dir = find_bin_dir(args.bin_dir)
+    output_dir = Path(args.output)
+    output_dir.mkdir(parents=True, exist_ok=True)
+    procs = parse_counts(args.procs)
+    threads = parse_counts(args.threads)
+    modes = ["strong", "weak"] if args.mode == "both" else [args.mode]
+
+    measurements = {}
+    for task_type in [x.strip() for x in args.types.split(',') if x.strip()]:
+        binary = bin_dir / (f"{task_type}_perf_tests" + (".exe" if platform.system() == "Windows" else ""))
+        if not binary.is_file():
+            print(f"Warning! {binary} is not found")
+            continue
+        for num_procs, num_threads in configurations(task_type, procs, threads):
+            workers = num_procs * num_threads
+            records = None
+            for mode in modes:
+                # without scaling both modes measure the same input
+                if records is None or (mode == "weak" and workers > 1):
+                    records = run_binary(binary, task_type, num_procs, num_threads,
+                                         workers if mode == "weak" else 1, args)
+                for record in records:
+                    key = (mode, record["backend"], record["task"], record["type"])
+                    measurements.setdefault(key, {})[(num_procs, num_threads)] = record
+
+    rows = scaling_rows(measurements)
+    fields = ["mode", "backend", "task", "type", "procs", "threads", "workers", "input_size", "time", "speedup",
+              "efficiency", "karp_flatt", "note"]
+    with open(output_dir / "scaling.csv", "w", newline="") as file:
+        writer = csv.DictWriter(file, fieldnames=fields)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    for row in rows:
+        if row["speedup"] == "":
+            continue
+        karp_flatt = f"{row['karp_flatt']:.3f}" if row["karp_flatt"] != "" else "-"
+        print(f"{row['mode']:6} {row['backend']}/{row['task']}:{row['type']} workers={row['workers']}: "
+              f"S={row['speedup']:.2f} E={row['efficiency']:.2f} e={karp_flatt} {row['note']}")
+    plot(rows, output_dir)
+    print(f"Results are written to {output_dir / 'scaling.csv'}")
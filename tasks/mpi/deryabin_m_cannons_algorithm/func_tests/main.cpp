@@ -1,14 +1,68 @@
 #include <gtest/gtest.h>
 
 #include <boost/mpi/communicator.hpp>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <random>
 #include <vector>
 
 #include "core/task/include/task.hpp"
+#include "mpi/deryabin_m_cannons_algorithm/include/local_gemm.hpp"
 #include "mpi/deryabin_m_cannons_algorithm/include/ops_mpi.hpp"
 
+namespace {
+
+// сравнивает выбранный способ умножения с последовательной задачей на матрице
+// dimension x dimension с целыми элементами, где результат не зависит от порядка суммирования
+void CheckEngine(deryabin_m_cannons_algorithm_mpi::Engine engine, size_t dimension, int replication = 0) {
+  boost::mpi::communicator world;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<> distribution(-10, 10);
+  std::vector<double> input_matrix_a(dimension * dimension);
+  std::vector<double> input_matrix_b(dimension * dimension);
+  for (size_t i = 0; i < input_matrix_a.size(); ++i) {
+    input_matrix_a[i] = distribution(gen);
+    input_matrix_b[i] = distribution(gen);
+  }
+  std::vector<std::vector<double>> out_matrix_c(1);
+
+  std::shared_ptr<ppc::core::TaskData> task_data_mpi = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t*>(input_matrix_a.data()));
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t*>(input_matrix_b.data()));
+    task_data_mpi->inputs_count.emplace_back(input_matrix_a.size());
+    task_data_mpi->inputs_count.emplace_back(input_matrix_b.size());
+    task_data_mpi->outputs.emplace_back(reinterpret_cast<uint8_t*>(out_matrix_c.data()));
+    task_data_mpi->outputs_count.emplace_back(out_matrix_c.size());
+  }
+  deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel test_mpi_task_parallel(task_data_mpi, engine,
+                                                                                           replication);
+  ASSERT_EQ(test_mpi_task_parallel.Validation(), true);
+  test_mpi_task_parallel.PreProcessing();
+  test_mpi_task_parallel.Run();
+  test_mpi_task_parallel.PostProcessing();
+
+  if (world.rank() == 0) {
+    std::vector<std::vector<double>> reference_out_matrix_c(1);
+    std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
+    task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t*>(input_matrix_a.data()));
+    task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t*>(input_matrix_b.data()));
+    task_data_seq->inputs_count.emplace_back(input_matrix_a.size());
+    task_data_seq->inputs_count.emplace_back(input_matrix_b.size());
+    task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t*>(reference_out_matrix_c.data()));
+    task_data_seq->outputs_count.emplace_back(reference_out_matrix_c.size());
+    deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskSequential test_mpi_task_sequential(task_data_seq);
+    ASSERT_EQ(test_mpi_task_sequential.Validation(), true);
+    test_mpi_task_sequential.PreProcessing();
+    test_mpi_task_sequential.Run();
+    test_mpi_task_sequential.PostProcessing();
+    ASSERT_EQ(reference_out_matrix_c[0], out_matrix_c[0]);
+  }
+}
+
+}  // namespace
+
 TEST(deryabin_m_cannons_algorithm_mpi, test_simple_matrix) {
   boost::mpi::communicator world;
   std::vector<double> input_matrix_a{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
@@ -258,3 +312,62 @@ TEST(deryabin_m_cannons_algorithm_mpi, test_square_and_non_square_matrices) {
     ASSERT_EQ(test_mpi_task_sequential.Validation(), false);
   }
 }
+
+TEST(deryabin_m_cannons_algorithm_mpi, test_local_gemm_ragged_blocks) {
+  // размеры не кратны микроядру и блокам кэша, матрицы лежат внутри более широких
+  constexpr size_t kM = 67;
+  constexpr size_t kN = 45;
+  constexpr size_t kK = 301;
+  constexpr size_t kLda = kK + 3;
+  constexpr size_t kLdb = kN + 5;
+  constexpr size_t kLdc = kN + 7;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<> distribution(-8, 8);
+  std::vector<double> a(kM * kLda);
+  std::vector<double> b(kK * kLdb);
+  std::vector<double> c(kM * kLdc);
+  for (auto& value : a) {
+    value = distribution(gen);
+  }
+  for (auto& value : b) {
+    value = distribution(gen);
+  }
+  for (auto& value : c) {
+    value = distribution(gen);
+  }
+  std::vector<double> expected = c;
+  for (size_t i = 0; i < kM; ++i) {
+    for (size_t j = 0; j < kN; ++j) {
+      for (size_t k = 0; k < kK; ++k) {
+        expected[(i * kLdc) + j] += a[(i * kLda) + k] * b[(k * kLdb) + j];
+      }
+    }
+  }
+  deryabin_m_cannons_algorithm_mpi::GemmAdd(a.data(), b.data(), c.data(), kM, kN, kK, kLda, kLdb, kLdc);
+  // целые значения считаются точно при любом порядке суммирования; хвосты строк C не трогаются
+  ASSERT_EQ(expected, c);
+}
+
+TEST(deryabin_m_cannons_algorithm_mpi, test_summa_ragged_matrix) {
+  CheckEngine(deryabin_m_cannons_algorithm_mpi::Engine::kSumma, 37);
+}
+
+TEST(deryabin_m_cannons_algorithm_mpi, test_summa_matrix_smaller_than_grid) {
+  CheckEngine(deryabin_m_cannons_algorithm_mpi::Engine::kSumma, 1);
+}
+
+TEST(deryabin_m_cannons_algorithm_mpi, test_25d_ragged_matrix) {
+  CheckEngine(deryabin_m_cannons_algorithm_mpi::Engine::k25D, 29, 2);
+}
+
+TEST(deryabin_m_cannons_algorithm_mpi, test_25d_default_replication) {
+  CheckEngine(deryabin_m_cannons_algorithm_mpi::Engine::k25D, 40);
+}
+
+TEST(deryabin_m_cannons_algorithm_mpi, test_cannon_falls_back_on_ragged_matrix) {
+  CheckEngine(deryabin_m_cannons_algorithm_mpi::Engine::kCannon, 33);
+}
+
+TEST(deryabin_m_cannons_algorithm_mpi, test_auto_engine) {
+  CheckEngine(deryabin_m_cannons_algorithm_mpi::Engine::kAuto, 48);
+}
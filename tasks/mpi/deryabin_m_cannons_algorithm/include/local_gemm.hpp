@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+namespace deryabin_m_cannons_algorithm_mpi {
+
+// C += A * B for row-major A (m x k), B (k x n) and C (m x n) with leading
+// dimensions lda, ldb, ldc. Cache-blocked loops around a 4 x 8 register-blocked
+// micro-kernel: AVX-512 or AVX2 + FMA if the CPU has them (detected at run time
+// with GCC and Clang, at compile time otherwise), portable C++ if not.
+// Every element of C is accumulated in increasing order of k, so splitting k
+// into blocks does not change the result.
+void GemmAdd(const double* a, const double* b, double* c, size_t m, size_t n, size_t k, size_t lda, size_t ldb,
+             size_t ldc);
+
+// micro-kernel in use: "avx512", "avx2" or "scalar"
+const char* GemmKernelName();
+
+}  // namespace deryabin_m_cannons_algorithm_mpi
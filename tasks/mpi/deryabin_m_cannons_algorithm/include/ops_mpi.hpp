@@ -1,8 +1,14 @@
 #pragma once
 
+#include <mpi.h>
+
+#include <boost/mpi/cartesian_communicator.hpp>
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -19,13 +25,28 @@ class CannonsAlgorithmMPITaskSequential : public ppc::core::Task {
   bool PostProcessingImpl() override;
 
  private:
-  std::vector<double> input_matrix_A_;
-  std::vector<double> input_matrix_B_;
+  std::span<const double> input_matrix_A_;
+  std::span<const double> input_matrix_B_;
   std::vector<double> output_matrix_C_;
 };
+// Способ параллельного умножения:
+//   kAuto   - Cannon, если он применим, иначе SUMMA
+//   kSerial - всё умножение на rank 0
+//   kCannon - сетка sqrt(p) x sqrt(p), размер матрицы кратен sqrt(p); иначе SUMMA
+//   kSumma  - сетка rows x columns из MPI_Dims_create, панели рассылаются по строкам и столбцам
+//   k25D    - replication слоёв SUMMA, каждый считает свою часть суммы по k,
+//             частичные C складываются reduce по слоям; порядок суммирования
+//             поэтому отличается от последовательного, и kAuto его не выбирает
+// SUMMA и 2.5D работают с любым числом процессов и любым размером матрицы:
+// блоки на краях могут отличаться на строку или столбец.
+enum class Engine : uint8_t { kAuto, kSerial, kCannon, kSumma, k25D };
+
 class CannonsAlgorithmMPITaskParallel : public ppc::core::Task {
  public:
-  explicit CannonsAlgorithmMPITaskParallel(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
+  // replication - число слоёв 2.5D; 0 - наибольший делитель p, куб которого не больше p
+  explicit CannonsAlgorithmMPITaskParallel(ppc::core::TaskDataPtr task_data, Engine engine = Engine::kAuto,
+                                           int replication = 0)
+      : Task(std::move(task_data)), engine_(engine), replication_(replication) {}
   bool PreProcessingImpl() override;
   bool ValidationImpl() override;
   bool RunImpl() override;
@@ -35,25 +56,31 @@ class CannonsAlgorithmMPITaskParallel : public ppc::core::Task {
   // --- Приватные методы для декомпозиции ---
   void HandleTrivialCase();
   void PerformCannonAlgorithm();
+  // SUMMA при layers == 1, 2.5D при layers > 1; layers делит world_.size()
+  void PerformSumma(int layers);
 
   // вспомогательные под-этапы алгоритма Каннона
   void InitializeAndBroadcastParams();
-  void DistributeDataIfRoot();
-  void PrepareLocalMatrices();
-  void DistributeDataAcrossProcesses();
-  void SendMatrixAData(unsigned short i, unsigned short j, unsigned short k, int destination_proc);
-  void SendMatrixBData(unsigned short i, unsigned short j, unsigned short k, int destination_proc);
-  void ReceiveDataIfNotRoot();
+  // блоки раздаются одним Scatterv уже со скосом: процесс (i, j) получает
+  // A(i, i + j) и B(i + j, j)
+  void ScatterSkewedBlocks(const boost::mpi::cartesian_communicator& grid, MPI_Datatype block_type);
   void MultiplyLocalBlocks();
-  void PerformCannonShifts();
-  void GatherResults();
-
-  std::vector<double> input_matrix_A_, local_input_matrix_A_;
-  std::vector<double> input_matrix_B_, local_input_matrix_B_;
-  std::vector<double> output_matrix_C_, local_output_matrix_C_;
-  unsigned short dimension_ = 0;
-  unsigned short block_dimension_ = 0;
-  unsigned short block_rows_columns_ = 0;
+  // умножение блоков, совмещённое со сдвигами следующего шага
+  void PerformCannonShifts(const boost::mpi::cartesian_communicator& grid);
+  void GatherResults(const boost::mpi::cartesian_communicator& grid, MPI_Datatype block_type);
+
+  std::vector<double> input_matrix_A_;
+  std::vector<double> input_matrix_B_;
+  std::vector<double> output_matrix_C_;
+  // блоки процесса в scratch-памяти задачи; next_* принимают блоки следующего шага
+  std::span<double> local_input_matrix_A_, next_input_matrix_A_;
+  std::span<double> local_input_matrix_B_, next_input_matrix_B_;
+  std::span<double> local_output_matrix_C_;
+  size_t dimension_ = 0;
+  size_t block_dimension_ = 0;
+  size_t block_rows_columns_ = 0;
+  Engine engine_;
+  int replication_;
   boost::mpi::communicator world_;
 };
 }  // namespace deryabin_m_cannons_algorithm_mpi
@@ -0,0 +1,177 @@
+#include "mpi/deryabin_m_cannons_algorithm/include/local_gemm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "core/util/include/simd_dispatch.hpp"
+
+namespace {
+
+// micro-tile of C kept in registers
+constexpr size_t kMr = 4;
+constexpr size_t kNr = 8;
+// cache blocks: a kKc x kNc panel of B stays in L2, a kMc x kKc panel of A in L1/L2
+constexpr size_t kKc = 128;
+constexpr size_t kMc = 64;
+constexpr size_t kNc = 256;
+
+using MicroKernel = void (*)(const double*, const double*, double*, size_t, size_t, size_t, size_t);
+using EdgeKernel = void (*)(const double*, const double*, double*, size_t, size_t, size_t, size_t, size_t, size_t);
+
+// partial tiles at the right and bottom edges; fused when the vector kernels are,
+// so that an element gets the same result whichever kernel computes it
+template <bool Fused>
+void EdgeKernelImpl(const double* a, const double* b, double* c, size_t mr, size_t nr, size_t kc, size_t lda,
+                    size_t ldb, size_t ldc) {
+  for (size_t i = 0; i < mr; ++i) {
+    for (size_t j = 0; j < nr; ++j) {
+      double acc = c[(i * ldc) + j];
+      for (size_t p = 0; p < kc; ++p) {
+        if constexpr (Fused) {
+          acc = std::fma(a[(i * lda) + p], b[(p * ldb) + j], acc);
+        } else {
+          acc += a[(i * lda) + p] * b[(p * ldb) + j];
+        }
+      }
+      c[(i * ldc) + j] = acc;
+    }
+  }
+}
+
+[[maybe_unused]] void MicroKernelScalar(const double* a, const double* b, double* c, size_t kc, size_t lda, size_t ldb,
+                                        size_t ldc) {
+  double acc[kMr][kNr];
+  for (size_t i = 0; i < kMr; ++i) {
+    for (size_t j = 0; j < kNr; ++j) {
+      acc[i][j] = c[(i * ldc) + j];
+    }
+  }
+  for (size_t p = 0; p < kc; ++p) {
+    const double* b_row = b + (p * ldb);
+    for (size_t i = 0; i < kMr; ++i) {
+      const double a_ip = a[(i * lda) + p];
+      for (size_t j = 0; j < kNr; ++j) {
+        acc[i][j] += a_ip * b_row[j];
+      }
+    }
+  }
+  for (size_t i = 0; i < kMr; ++i) {
+    for (size_t j = 0; j < kNr; ++j) {
+      c[(i * ldc) + j] = acc[i][j];
+    }
+  }
+}
+
+#if defined(PPC_HAS_AVX2) || defined(PPC_HAS_AVX512)
+PPC_TARGET("fma")
+void EdgeKernelFused(const double* a, const double* b, double* c, size_t mr, size_t nr, size_t kc, size_t lda,
+                     size_t ldb, size_t ldc) {
+  EdgeKernelImpl<true>(a, b, c, mr, nr, kc, lda, ldb, ldc);
+}
+#endif
+
+#ifdef PPC_HAS_AVX2
+PPC_TARGET("avx2,fma")
+void MicroKernelAvx2(const double* a, const double* b, double* c, size_t kc, size_t lda, size_t ldb, size_t ldc) {
+  __m256d acc[kMr][2];
+  for (size_t i = 0; i < kMr; ++i) {
+    acc[i][0] = _mm256_loadu_pd(c + (i * ldc));
+    acc[i][1] = _mm256_loadu_pd(c + (i * ldc) + 4);
+  }
+  for (size_t p = 0; p < kc; ++p) {
+    const __m256d b0 = _mm256_loadu_pd(b + (p * ldb));
+    const __m256d b1 = _mm256_loadu_pd(b + (p * ldb) + 4);
+    for (size_t i = 0; i < kMr; ++i) {
+      const __m256d a_ip = _mm256_broadcast_sd(a + (i * lda) + p);
+      acc[i][0] = _mm256_fmadd_pd(a_ip, b0, acc[i][0]);
+      acc[i][1] = _mm256_fmadd_pd(a_ip, b1, acc[i][1]);
+    }
+  }
+  for (size_t i = 0; i < kMr; ++i) {
+    _mm256_storeu_pd(c + (i * ldc), acc[i][0]);
+    _mm256_storeu_pd(c + (i * ldc) + 4, acc[i][1]);
+  }
+}
+#endif
+
+#ifdef PPC_HAS_AVX512
+PPC_TARGET("avx512f")
+void MicroKernelAvx512(const double* a, const double* b, double* c, size_t kc, size_t lda, size_t ldb, size_t ldc) {
+  __m512d acc[kMr];
+  for (size_t i = 0; i < kMr; ++i) {
+    acc[i] = _mm512_loadu_pd(c + (i * ldc));
+  }
+  for (size_t p = 0; p < kc; ++p) {
+    const __m512d b_row = _mm512_loadu_pd(b + (p * ldb));
+    for (size_t i = 0; i < kMr; ++i) {
+      acc[i] = _mm512_fmadd_pd(_mm512_set1_pd(a[(i * lda) + p]), b_row, acc[i]);
+    }
+  }
+  for (size_t i = 0; i < kMr; ++i) {
+    _mm512_storeu_pd(c + (i * ldc), acc[i]);
+  }
+}
+#endif
+
+struct Kernels {
+  MicroKernel micro;
+  EdgeKernel edge;
+  const char* name;
+};
+
+Kernels SelectKernels() {
+#ifdef PPC_RUNTIME_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") != 0) {
+    return {.micro = MicroKernelAvx512, .edge = EdgeKernelFused, .name = "avx512"};
+  }
+  if (__builtin_cpu_supports("avx2") != 0 && __builtin_cpu_supports("fma") != 0) {
+    return {.micro = MicroKernelAvx2, .edge = EdgeKernelFused, .name = "avx2"};
+  }
+  return {.micro = MicroKernelScalar, .edge = EdgeKernelImpl<false>, .name = "scalar"};
+#elif defined(PPC_HAS_AVX512)
+  return {.micro = MicroKernelAvx512, .edge = EdgeKernelFused, .name = "avx512"};
+#elif defined(PPC_HAS_AVX2)
+  return {.micro = MicroKernelAvx2, .edge = EdgeKernelFused, .name = "avx2"};
+#else
+  return {.micro = MicroKernelScalar, .edge = EdgeKernelImpl<false>, .name = "scalar"};
+#endif
+}
+
+const Kernels& GetKernels() {
+  static const Kernels kKernels = SelectKernels();
+  return kKernels;
+}
+
+}  // namespace
+
+void deryabin_m_cannons_algorithm_mpi::GemmAdd(const double* a, const double* b, double* c, size_t m, size_t n,
+                                               size_t k, size_t lda, size_t ldb, size_t ldc) {
+  const auto& kernels = GetKernels();
+  for (size_t j0 = 0; j0 < n; j0 += kNc) {
+    const size_t nc = std::min(kNc, n - j0);
+    for (size_t p0 = 0; p0 < k; p0 += kKc) {
+      const size_t kc = std::min(kKc, k - p0);
+      for (size_t i0 = 0; i0 < m; i0 += kMc) {
+        const size_t mc = std::min(kMc, m - i0);
+        for (size_t i = i0; i < i0 + mc; i += kMr) {
+          const size_t mr = std::min(kMr, i0 + mc - i);
+          for (size_t j = j0; j < j0 + nc; j += kNr) {
+            const size_t nr = std::min(kNr, j0 + nc - j);
+            const double* a_tile = a + (i * lda) + p0;
+            const double* b_tile = b + (p0 * ldb) + j;
+            double* c_tile = c + (i * ldc) + j;
+            if (mr == kMr && nr == kNr) {
+              kernels.micro(a_tile, b_tile, c_tile, kc, lda, ldb, ldc);
+            } else {
+              kernels.edge(a_tile, b_tile, c_tile, mr, nr, kc, lda, ldb, ldc);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+const char* deryabin_m_cannons_algorithm_mpi::GemmKernelName() { return GetKernels().name; }
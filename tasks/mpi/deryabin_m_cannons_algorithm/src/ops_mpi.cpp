@@ -1,39 +1,84 @@
 #include "mpi/deryabin_m_cannons_algorithm/include/ops_mpi.hpp"
 
+#include <mpi.h>
+
 #include <algorithm>
+#include <boost/mpi/cartesian_communicator.hpp>
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/nonblocking.hpp>
+#include <boost/mpi/request.hpp>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
+#include "mpi/deryabin_m_cannons_algorithm/include/local_gemm.hpp"
+
+namespace {
+
+size_t SquareRoot(uint64_t count) { return static_cast<size_t>(std::llround(std::sqrt(static_cast<double>(count)))); }
+
+bool IsSquare(uint64_t count) {
+  const auto root = static_cast<uint64_t>(SquareRoot(count));
+  return root * root == count;
+}
+
+// число слоёв 2.5D: requested, уменьшенное до делителя size; по умолчанию
+// наибольший делитель c с c^3 <= size
+int ReplicationFactor(int size, int requested) {
+  int layers = requested;
+  if (layers <= 0) {
+    layers = 1;
+    for (int c = 2; c * c * c <= size; ++c) {
+      if (size % c == 0) {
+        layers = c;
+      }
+    }
+  }
+  layers = std::min(layers, size);
+  while (size % layers != 0) {
+    --layers;
+  }
+  return layers;
+}
+
+// блок block_dimension x block_dimension матрицы dimension x dimension; экстент
+// сжат до block_dimension элементов, поэтому смещение блока (i, j) в Scatterv и
+// Gatherv равно i * dimension + j
+MPI_Datatype CreateBlockType(size_t dimension, size_t block_dimension) {
+  const int sizes[2] = {static_cast<int>(dimension), static_cast<int>(dimension)};
+  const int subsizes[2] = {static_cast<int>(block_dimension), static_cast<int>(block_dimension)};
+  const int starts[2] = {0, 0};
+  MPI_Datatype block = MPI_DATATYPE_NULL;
+  MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, &block);
+  MPI_Datatype block_type = MPI_DATATYPE_NULL;
+  MPI_Type_create_resized(block, 0, static_cast<MPI_Aint>(block_dimension * sizeof(double)), &block_type);
+  MPI_Type_commit(&block_type);
+  MPI_Type_free(&block);
+  return block_type;
+}
+
+}  // namespace
+
 bool deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskSequential::PreProcessingImpl() {
-  input_matrix_A_ = std::vector<double>(task_data->inputs_count[0]);
-  input_matrix_B_ = std::vector<double>(task_data->inputs_count[1]);
-  auto* tmp_ptr_a = reinterpret_cast<double*>(task_data->inputs[0]);
-  auto* tmp_ptr_b = reinterpret_cast<double*>(task_data->inputs[1]);
-  std::copy(tmp_ptr_a, tmp_ptr_a + task_data->inputs_count[0], input_matrix_A_.begin());
-  std::copy(tmp_ptr_b, tmp_ptr_b + task_data->inputs_count[1], input_matrix_B_.begin());
+  input_matrix_A_ = task_data->InputView<const double>(0).Span();
+  input_matrix_B_ = task_data->InputView<const double>(1).Span();
   output_matrix_C_ = std::vector<double>(input_matrix_A_.size());
   return true;
 }
 
 bool deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskSequential::ValidationImpl() {
-  return task_data->inputs_count[0] == task_data->inputs_count[1] &&
-         task_data->inputs_count[1] == pow((unsigned short)sqrt(task_data->inputs_count[0]), 2) &&
+  return task_data->inputs_count[0] == task_data->inputs_count[1] && IsSquare(task_data->inputs_count[1]) &&
          task_data->outputs_count[0] == 1;
 }
 
 bool deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskSequential::RunImpl() {
-  auto dimension = (unsigned short)sqrt(static_cast<unsigned short>(input_matrix_A_.size()));
-  output_matrix_C_.resize(dimension * dimension, 0.0);
-  for (unsigned short i = 0; i < dimension; ++i) {
-    for (unsigned short j = 0; j < dimension; ++j) {
-      for (unsigned short k = 0; k < dimension; ++k) {
-        output_matrix_C_[(i * dimension) + j] +=
-            input_matrix_A_[(i * dimension) + k] * input_matrix_B_[(k * dimension) + j];
-      }
-    }
-  }
+  auto dimension = SquareRoot(input_matrix_A_.size());
+  output_matrix_C_.assign(dimension * dimension, 0.0);
+  GemmAdd(input_matrix_A_.data(), input_matrix_B_.data(), output_matrix_C_.data(), dimension, dimension, dimension,
+          dimension, dimension, dimension);
   return true;
 }
 
@@ -56,8 +101,7 @@ bool deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::PreProce
 
 bool deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::ValidationImpl() {
   if (world_.rank() == 0) {
-    return task_data->inputs_count[0] == task_data->inputs_count[1] &&
-           task_data->inputs_count[1] == pow((unsigned short)sqrt(task_data->inputs_count[0]), 2) &&
+    return task_data->inputs_count[0] == task_data->inputs_count[1] && IsSquare(task_data->inputs_count[1]) &&
            task_data->outputs_count[0] == 1;
   }
   return true;
@@ -65,23 +109,17 @@ bool deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::Validati
 
 void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::HandleTrivialCase() {
   if (world_.rank() == 0) {
-    dimension_ = static_cast<unsigned short>(std::sqrt(static_cast<unsigned short>(input_matrix_A_.size())));
-    output_matrix_C_.resize(dimension_ * dimension_, 0.0);
-    for (unsigned short i = 0; i < dimension_; ++i) {
-      for (unsigned short j = 0; j < dimension_; ++j) {
-        for (unsigned short k = 0; k < dimension_; ++k) {
-          output_matrix_C_[(i * dimension_) + j] +=
-              input_matrix_A_[(i * dimension_) + k] * input_matrix_B_[(k * dimension_) + j];
-        }
-      }
-    }
+    dimension_ = SquareRoot(input_matrix_A_.size());
+    output_matrix_C_.assign(dimension_ * dimension_, 0.0);
+    GemmAdd(input_matrix_A_.data(), input_matrix_B_.data(), output_matrix_C_.data(), dimension_, dimension_,
+            dimension_, dimension_, dimension_, dimension_);
   }
 }
 
 void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::InitializeAndBroadcastParams() {
   if (world_.rank() == 0) {
-    dimension_ = static_cast<unsigned short>(std::sqrt(static_cast<unsigned short>(input_matrix_A_.size())));
-    block_rows_columns_ = static_cast<unsigned short>(std::sqrt(static_cast<unsigned short>(world_.size())));
+    dimension_ = SquareRoot(input_matrix_A_.size());
+    block_rows_columns_ = SquareRoot(world_.size());
     block_dimension_ = dimension_ / block_rows_columns_;
   }
   boost::mpi::broadcast(world_, dimension_, 0);
@@ -89,181 +127,139 @@ void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::Initiali
   boost::mpi::broadcast(world_, block_rows_columns_, 0);
 }
 
-void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::SendMatrixAData(unsigned short i,
-                                                                                        unsigned short j,
-                                                                                        unsigned short k,
-                                                                                        int destination_proc) {
-  if (i == 0) {
-    world_.send(destination_proc, 0,
-                input_matrix_A_.data() + ((i * block_dimension_ + k) * dimension_) + (j * block_dimension_),
-                block_dimension_);
-  } else {
-    if (static_cast<int>((i * block_rows_columns_) + j - i) < static_cast<int>(i * block_rows_columns_)) {
-      world_.send(destination_proc + block_rows_columns_ - i, 0,
-                  input_matrix_A_.data() + ((i * block_dimension_ + k) * dimension_) + (j * block_dimension_),
-                  block_dimension_);
-    } else {
-      world_.send(destination_proc - i, 0,
-                  input_matrix_A_.data() + ((i * block_dimension_ + k) * dimension_) + (j * block_dimension_),
-                  block_dimension_);
+void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::ScatterSkewedBlocks(
+    const boost::mpi::cartesian_communicator& grid, MPI_Datatype block_type) {
+  std::vector<int> counts;
+  std::vector<int> displacements_a;
+  std::vector<int> displacements_b;
+  if (grid.rank() == 0) {
+    const auto q = static_cast<int>(block_rows_columns_);
+    const auto dimension = static_cast<int>(dimension_);
+    counts.assign(grid.size(), 1);
+    for (int proc = 0; proc < grid.size(); ++proc) {
+      const auto coords = grid.coordinates(proc);
+      const int shifted = (coords[0] + coords[1]) % q;
+      displacements_a.push_back((coords[0] * dimension) + shifted);
+      displacements_b.push_back((shifted * dimension) + coords[1]);
     }
   }
-}
-
-void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::SendMatrixBData(unsigned short i,
-                                                                                        unsigned short j,
-                                                                                        unsigned short k,
-                                                                                        int destination_proc) {
-  if (j == 0) {
-    world_.send(destination_proc, 1,
-                input_matrix_B_.data() + ((i * block_dimension_ + k) * dimension_) + (j * block_dimension_),
-                block_dimension_);
-  } else {
-    if ((static_cast<int>((i - j) * block_rows_columns_) + j) < 0) {
-      world_.send(((i + block_rows_columns_ - j) * block_rows_columns_) + j, 1,
-                  input_matrix_B_.data() + ((i * block_dimension_ + k) * dimension_) + (j * block_dimension_),
-                  block_dimension_);
-    } else {
-      world_.send(((i - j) * block_rows_columns_) + j, 1,
-                  input_matrix_B_.data() + (((i * block_dimension_) + k) * dimension_) + (j * block_dimension_),
-                  block_dimension_);
-    }
-  }
-}
-
-void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::DistributeDataAcrossProcesses() {
-  for (unsigned short i = 0; i < block_rows_columns_; ++i) {
-    for (unsigned short j = 0; j < block_rows_columns_; ++j) {
-      if (i == 0 && j == 0) {
-        continue;
-      }
-      for (unsigned short k = 0; k < block_dimension_; ++k) {
-        int destination_proc = (i * block_rows_columns_) + j;
-        SendMatrixAData(i, j, k, destination_proc);
-        SendMatrixBData(i, j, k, destination_proc);
-      }
-    }
-  }
-}
-
-void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::PrepareLocalMatrices() {
-  for (unsigned short k = 0; k < block_dimension_; ++k) {
-    std::copy(input_matrix_A_.data() + (k * dimension_), input_matrix_A_.data() + (k * dimension_) + block_dimension_,
-              local_input_matrix_A_.begin() + (k * block_dimension_));
-    std::copy(input_matrix_B_.data() + (k * dimension_), input_matrix_B_.data() + (k * dimension_) + block_dimension_,
-              local_input_matrix_B_.begin() + (k * block_dimension_));
-  }
-}
-
-void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::DistributeDataIfRoot() {
-  PrepareLocalMatrices();
-  DistributeDataAcrossProcesses();
-}
-
-void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::ReceiveDataIfNotRoot() {
-  for (unsigned short k = 0; k < block_dimension_; ++k) {
-    world_.recv(0, 0, local_input_matrix_A_.data() + (k * block_dimension_), block_dimension_);
-    world_.recv(0, 1, local_input_matrix_B_.data() + (k * block_dimension_), block_dimension_);
-  }
+  const auto block_size = static_cast<int>(block_dimension_ * block_dimension_);
+  MPI_Scatterv(grid.rank() == 0 ? input_matrix_A_.data() : nullptr, counts.data(), displacements_a.data(), block_type,
+               local_input_matrix_A_.data(), block_size, MPI_DOUBLE, 0, grid);
+  MPI_Scatterv(grid.rank() == 0 ? input_matrix_B_.data() : nullptr, counts.data(), displacements_b.data(), block_type,
+               local_input_matrix_B_.data(), block_size, MPI_DOUBLE, 0, grid);
 }
 
 void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::MultiplyLocalBlocks() {
-  for (unsigned short i = 0; i < block_dimension_; ++i) {
-    for (unsigned short j = 0; j < block_dimension_; ++j) {
-      for (unsigned short k = 0; k < block_dimension_; ++k) {
-        local_output_matrix_C_[(i * block_dimension_) + j] +=
-            local_input_matrix_A_[(i * block_dimension_) + k] * local_input_matrix_B_[(k * block_dimension_) + j];
-      }
-    }
-  }
+  GemmAdd(local_input_matrix_A_.data(), local_input_matrix_B_.data(), local_output_matrix_C_.data(), block_dimension_,
+          block_dimension_, block_dimension_, block_dimension_, block_dimension_, block_dimension_);
 }
 
-void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::PerformCannonShifts() {
-  for (unsigned short p = 1; p < block_rows_columns_; ++p) {
-    if (block_rows_columns_ != 0 && (world_.rank() % block_rows_columns_ == 0)) {
-      world_.send(world_.rank() + block_rows_columns_ - 1, 2, local_input_matrix_A_.data(),
-                  block_dimension_ * block_dimension_);
-    } else {
-      world_.send(world_.rank() - 1, 3, local_input_matrix_A_.data(), block_dimension_ * block_dimension_);
-    }
-    if (world_.rank() < block_rows_columns_) {
-      world_.send(world_.rank() + (block_rows_columns_ * (block_rows_columns_ - 1)), 4, local_input_matrix_B_.data(),
-                  block_dimension_ * block_dimension_);
-    } else {
-      world_.send(world_.rank() - block_rows_columns_, 5, local_input_matrix_B_.data(),
-                  block_dimension_ * block_dimension_);
-    }
-    if (block_rows_columns_ != 0 && ((world_.rank() + 1) % block_rows_columns_ == 0)) {
-      world_.recv(world_.rank() - block_rows_columns_ + 1, 2, local_input_matrix_A_.data(),
-                  block_dimension_ * block_dimension_);
-    } else {
-      world_.recv(world_.rank() + 1, 3, local_input_matrix_A_.data(), block_dimension_ * block_dimension_);
-    }
-    if (world_.rank() >= block_rows_columns_ * (block_rows_columns_ - 1)) {
-      world_.recv(world_.rank() - (block_rows_columns_ * (block_rows_columns_ - 1)), 4, local_input_matrix_B_.data(),
-                  block_dimension_ * block_dimension_);
-    } else {
-      world_.recv(world_.rank() + block_rows_columns_, 5, local_input_matrix_B_.data(),
-                  block_dimension_ * block_dimension_);
+// Блоки следующего шага передаются неблокирующими обменами в next_* буферы,
+// пока считается произведение текущих блоков. Отправляемые буферы во время
+// передачи только читаются.
+void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::PerformCannonShifts(
+    const boost::mpi::cartesian_communicator& grid) {
+  // A уходит влево по строке сетки, B вверх по столбцу
+  const auto [right, left] = grid.shifted_ranks(1, -1);
+  const auto [down, up] = grid.shifted_ranks(0, -1);
+  const auto block_size = static_cast<int>(block_dimension_ * block_dimension_);
+
+  std::vector<boost::mpi::request> requests;
+  for (size_t step = 0; step < block_rows_columns_; ++step) {
+    const bool shift = step + 1 < block_rows_columns_;
+    requests.clear();
+    if (shift) {
+      requests.push_back(grid.irecv(right, 2, next_input_matrix_A_.data(), block_size));
+      requests.push_back(grid.irecv(down, 3, next_input_matrix_B_.data(), block_size));
+      requests.push_back(grid.isend(left, 2, local_input_matrix_A_.data(), block_size));
+      requests.push_back(grid.isend(up, 3, local_input_matrix_B_.data(), block_size));
     }
-    for (unsigned short i = 0; i < block_dimension_; ++i) {
-      for (unsigned short j = 0; j < block_dimension_; ++j) {
-        for (unsigned short k = 0; k < block_dimension_; ++k) {
-          local_output_matrix_C_[(i * block_dimension_) + j] +=
-              local_input_matrix_A_[(i * block_dimension_) + k] * local_input_matrix_B_[(k * block_dimension_) + j];
-        }
-      }
+    MultiplyLocalBlocks();
+    if (shift) {
+      boost::mpi::wait_all(requests.begin(), requests.end());
+      std::swap(local_input_matrix_A_, next_input_matrix_A_);
+      std::swap(local_input_matrix_B_, next_input_matrix_B_);
     }
   }
 }
 
-void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::GatherResults() {
-  if (world_.rank() != 0) {
-    for (unsigned short block_row = 0; block_row < block_dimension_; ++block_row) {
-      world_.send(0, 0, local_output_matrix_C_.data() + (block_row * block_dimension_), block_dimension_);
-    }
-  } else {
-    for (int proc = 1; proc < world_.size(); ++proc) {
-      for (unsigned short block_row = 0; block_row < block_dimension_; ++block_row) {
-        std::copy(local_output_matrix_C_.begin() + (block_row * block_dimension_),
-                  local_output_matrix_C_.begin() + ((block_row + 1) * block_dimension_),
-                  output_matrix_C_.begin() +
-                      (((world_.rank() / block_rows_columns_) * block_dimension_ + block_row) * dimension_) +
-                      ((world_.rank() % block_rows_columns_) * block_dimension_));
-        world_.recv(proc, 0,
-                    output_matrix_C_.data() +
-                        ((((proc / block_rows_columns_) * block_dimension_) + block_row) * dimension_) +
-                        ((proc % block_rows_columns_) * block_dimension_),
-                    block_dimension_);
-      }
+void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::GatherResults(
+    const boost::mpi::cartesian_communicator& grid, MPI_Datatype block_type) {
+  std::vector<int> counts;
+  std::vector<int> displacements;
+  if (grid.rank() == 0) {
+    const auto dimension = static_cast<int>(dimension_);
+    counts.assign(grid.size(), 1);
+    for (int proc = 0; proc < grid.size(); ++proc) {
+      const auto coords = grid.coordinates(proc);
+      displacements.push_back((coords[0] * dimension) + coords[1]);
     }
   }
+  MPI_Gatherv(local_output_matrix_C_.data(), static_cast<int>(block_dimension_ * block_dimension_), MPI_DOUBLE,
+              grid.rank() == 0 ? output_matrix_C_.data() : nullptr, counts.data(), displacements.data(), block_type, 0,
+              grid);
 }
 
 void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::PerformCannonAlgorithm() {
   InitializeAndBroadcastParams();
-  output_matrix_C_.resize(dimension_ * dimension_, 0.0);
-  local_input_matrix_A_.resize(block_dimension_ * block_dimension_, 0.0);
-  local_input_matrix_B_.resize(block_dimension_ * block_dimension_, 0.0);
-  local_output_matrix_C_.resize(block_dimension_ * block_dimension_, 0.0);
   if (world_.rank() == 0) {
-    DistributeDataIfRoot();
-  } else {
-    ReceiveDataIfNotRoot();
+    output_matrix_C_.assign(dimension_ * dimension_, 0.0);
   }
-  MultiplyLocalBlocks();
-  PerformCannonShifts();
-  GatherResults();
+  const size_t block_size = block_dimension_ * block_dimension_;
+  local_input_matrix_A_ = Scratch().AllocateArray<double>(block_size);
+  local_input_matrix_B_ = Scratch().AllocateArray<double>(block_size);
+  next_input_matrix_A_ = Scratch().AllocateArray<double>(block_size);
+  next_input_matrix_B_ = Scratch().AllocateArray<double>(block_size);
+  local_output_matrix_C_ = Scratch().AllocateArray<double>(block_size);
+
+  // периодическая сетка q x q без перенумерации: ранги совпадают с world_
+  const auto q = static_cast<int>(block_rows_columns_);
+  const boost::mpi::cartesian_communicator grid(
+      world_, boost::mpi::cartesian_topology({boost::mpi::cartesian_dimension(q, true),
+                                              boost::mpi::cartesian_dimension(q, true)}));
+  MPI_Datatype block_type = CreateBlockType(dimension_, block_dimension_);
+  ScatterSkewedBlocks(grid, block_type);
+  PerformCannonShifts(grid);
+  GatherResults(grid, block_type);
+  MPI_Type_free(&block_type);
 }
 
 bool deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::RunImpl() {
-  if (world_.size() != 1 && world_.size() == pow((unsigned short)sqrt(world_.size()), 2) &&
-      static_cast<unsigned short>(std::sqrt(static_cast<unsigned short>(input_matrix_A_.size()))) %
-              static_cast<unsigned short>(std::sqrt(world_.size())) ==
-          0) {
-    PerformCannonAlgorithm();
-  } else {
-    HandleTrivialCase();
+  // решение принимает rank 0: только у него есть размер матриц
+  Engine engine = engine_;
+  int layers = 1;
+  if (world_.rank() == 0) {
+    const int size = world_.size();
+    const auto dimension = SquareRoot(input_matrix_A_.size());
+    const bool cannon_fits =
+        IsSquare(static_cast<uint64_t>(size)) && dimension % SquareRoot(static_cast<uint64_t>(size)) == 0;
+    if (size == 1 || dimension == 0) {
+      engine = Engine::kSerial;
+    } else if (engine == Engine::kAuto) {
+      engine = cannon_fits ? Engine::kCannon : Engine::kSumma;
+    } else if (engine == Engine::kCannon && !cannon_fits) {
+      engine = Engine::kSumma;
+    }
+    if (engine == Engine::k25D) {
+      layers = ReplicationFactor(size, replication_);
+    }
+  }
+  auto engine_id = static_cast<int>(engine);
+  boost::mpi::broadcast(world_, engine_id, 0);
+  boost::mpi::broadcast(world_, layers, 0);
+  switch (static_cast<Engine>(engine_id)) {
+    case Engine::kCannon:
+      PerformCannonAlgorithm();
+      break;
+    case Engine::kSumma:
+    case Engine::k25D:
+      PerformSumma(layers);
+      break;
+    case Engine::kAuto:
+    case Engine::kSerial:
+      HandleTrivialCase();
+      break;
   }
   return true;
 }
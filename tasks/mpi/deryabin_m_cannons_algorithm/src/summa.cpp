@@ -0,0 +1,225 @@
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "mpi/deryabin_m_cannons_algorithm/include/local_gemm.hpp"
+#include "mpi/deryabin_m_cannons_algorithm/include/ops_mpi.hpp"
+
+namespace {
+
+// начало части part при делении n на parts почти равных частей
+size_t PartBegin(size_t n, size_t parts, size_t part) { return ((n / parts) * part) + std::min(part, n % parts); }
+
+// сетка layers x rows x columns: слой считает часть суммы по k, внутри слоя
+// процесс (row, column) отвечает за блок C, а k-часть слоя делится между
+// столбцами сетки (для A) и строками сетки (для B)
+struct Grid {
+  size_t dimension;
+  size_t rows;
+  size_t columns;
+  size_t layers;
+};
+
+struct Block {
+  size_t row_begin, row_end;
+  size_t column_begin, column_end;
+  size_t k_begin, k_end;      // k-часть слоя
+  size_t a_k_begin, a_k_end;  // столбцы A процесса
+  size_t b_k_begin, b_k_end;  // строки B процесса
+  size_t row, column, layer;
+
+  [[nodiscard]] size_t Rows() const { return row_end - row_begin; }
+  [[nodiscard]] size_t Columns() const { return column_end - column_begin; }
+  [[nodiscard]] size_t ACount() const { return Rows() * (a_k_end - a_k_begin); }
+  [[nodiscard]] size_t BCount() const { return (b_k_end - b_k_begin) * Columns(); }
+};
+
+Block Locate(const Grid& grid, size_t rank) {
+  Block block{};
+  const size_t layer_size = grid.rows * grid.columns;
+  block.layer = rank / layer_size;
+  block.row = (rank % layer_size) / grid.columns;
+  block.column = rank % grid.columns;
+  block.row_begin = PartBegin(grid.dimension, grid.rows, block.row);
+  block.row_end = PartBegin(grid.dimension, grid.rows, block.row + 1);
+  block.column_begin = PartBegin(grid.dimension, grid.columns, block.column);
+  block.column_end = PartBegin(grid.dimension, grid.columns, block.column + 1);
+  block.k_begin = PartBegin(grid.dimension, grid.layers, block.layer);
+  block.k_end = PartBegin(grid.dimension, grid.layers, block.layer + 1);
+  const size_t k_size = block.k_end - block.k_begin;
+  block.a_k_begin = block.k_begin + PartBegin(k_size, grid.columns, block.column);
+  block.a_k_end = block.k_begin + PartBegin(k_size, grid.columns, block.column + 1);
+  block.b_k_begin = block.k_begin + PartBegin(k_size, grid.rows, block.row);
+  block.b_k_end = block.k_begin + PartBegin(k_size, grid.rows, block.row + 1);
+  return block;
+}
+
+void AppendBlock(std::span<const double> matrix, size_t dimension, size_t row_begin, size_t row_end,
+                 size_t column_begin, size_t column_end, std::vector<double>& packed) {
+  for (size_t i = row_begin; i < row_end; ++i) {
+    const auto* row = matrix.data() + (i * dimension);
+    packed.insert(packed.end(), row + column_begin, row + column_end);
+  }
+}
+
+// Блоки всех процессов подряд, в порядке рангов, и их размеры для Scatterv/Gatherv.
+// Если matrix пуста (не root), заполняются только размеры.
+void PackBlocks(const Grid& grid, int size, std::span<const double> matrix, bool is_a, std::vector<double>& packed,
+                std::vector<int>& counts, std::vector<int>& displacements) {
+  for (int proc = 0; proc < size; ++proc) {
+    const auto block = Locate(grid, static_cast<size_t>(proc));
+    displacements.push_back(counts.empty() ? 0 : displacements.back() + counts.back());
+    counts.push_back(static_cast<int>(is_a ? block.ACount() : block.BCount()));
+    if (matrix.empty()) {
+      continue;
+    }
+    if (is_a) {
+      AppendBlock(matrix, grid.dimension, block.row_begin, block.row_end, block.a_k_begin, block.a_k_end, packed);
+    } else {
+      AppendBlock(matrix, grid.dimension, block.b_k_begin, block.b_k_end, block.column_begin, block.column_end, packed);
+    }
+  }
+}
+
+}  // namespace
+
+void deryabin_m_cannons_algorithm_mpi::CannonsAlgorithmMPITaskParallel::PerformSumma(int layers) {
+  if (world_.rank() == 0) {
+    dimension_ = static_cast<size_t>(std::lround(std::sqrt(static_cast<double>(input_matrix_A_.size()))));
+  }
+  boost::mpi::broadcast(world_, dimension_, 0);
+
+  const int size = world_.size();
+  std::array<int, 2> dims{0, 0};
+  MPI_Dims_create(size / layers, 2, dims.data());
+  const Grid grid{.dimension = dimension_,
+                  .rows = static_cast<size_t>(dims[0]),
+                  .columns = static_cast<size_t>(dims[1]),
+                  .layers = static_cast<size_t>(layers)};
+  const auto block = Locate(grid, static_cast<size_t>(world_.rank()));
+  const size_t m = block.Rows();
+  const size_t n = block.Columns();
+
+  // раздача: каждому процессу его часть A и B одним Scatterv
+  std::span<double> local_a = Scratch().AllocateArray<double>(block.ACount());
+  std::span<double> local_b = Scratch().AllocateArray<double>(block.BCount());
+  std::span<double> local_c = Scratch().AllocateArray<double>(m * n);
+  {
+    std::vector<double> packed;
+    std::vector<int> counts;
+    std::vector<int> displacements;
+    const bool root = world_.rank() == 0;
+    const auto matrix_a = root ? std::span<const double>(input_matrix_A_) : std::span<const double>();
+    PackBlocks(grid, size, matrix_a, true, packed, counts, displacements);
+    MPI_Scatterv(packed.data(), counts.data(), displacements.data(), MPI_DOUBLE, local_a.data(),
+                 static_cast<int>(local_a.size()), MPI_DOUBLE, 0, world_);
+    packed.clear();
+    counts.clear();
+    displacements.clear();
+    const auto matrix_b = root ? std::span<const double>(input_matrix_B_) : std::span<const double>();
+    PackBlocks(grid, size, matrix_b, false, packed, counts, displacements);
+    MPI_Scatterv(packed.data(), counts.data(), displacements.data(), MPI_DOUBLE, local_b.data(),
+                 static_cast<int>(local_b.size()), MPI_DOUBLE, 0, world_);
+  }
+
+  // SUMMA внутри слоя: панель k в [k0, k1) лежит у одного столбца сетки в A и у
+  // одной строки сетки в B; владельцы рассылают её по строке и столбцу
+  const auto row_color = static_cast<int>((block.layer * grid.rows) + block.row);
+  const auto column_color = static_cast<int>((block.layer * grid.columns) + block.column);
+  const boost::mpi::communicator row_comm = world_.split(row_color, static_cast<int>(block.column));
+  const boost::mpi::communicator column_comm = world_.split(column_color, static_cast<int>(block.row));
+
+  std::vector<size_t> bounds;
+  const size_t k_size = block.k_end - block.k_begin;
+  for (size_t part = 0; part <= grid.columns; ++part) {
+    bounds.push_back(block.k_begin + PartBegin(k_size, grid.columns, part));
+  }
+  for (size_t part = 0; part <= grid.rows; ++part) {
+    bounds.push_back(block.k_begin + PartBegin(k_size, grid.rows, part));
+  }
+  std::ranges::sort(bounds);
+  const auto [last, end] = std::ranges::unique(bounds);
+  bounds.erase(last, end);
+
+  size_t max_width = 0;
+  for (size_t i = 1; i < bounds.size(); ++i) {
+    max_width = std::max(max_width, bounds[i] - bounds[i - 1]);
+  }
+  std::span<double> panel_a = Scratch().AllocateArray<double>(m * max_width);
+  std::span<double> panel_b = Scratch().AllocateArray<double>(max_width * n);
+
+  size_t a_owner = 0;
+  size_t b_owner = 0;
+  for (size_t i = 1; i < bounds.size(); ++i) {
+    const size_t k0 = bounds[i - 1];
+    const size_t width = bounds[i] - k0;
+    while (k0 >= block.k_begin + PartBegin(k_size, grid.columns, a_owner + 1)) {
+      ++a_owner;
+    }
+    while (k0 >= block.k_begin + PartBegin(k_size, grid.rows, b_owner + 1)) {
+      ++b_owner;
+    }
+    if (block.column == a_owner) {
+      const size_t a_width = block.a_k_end - block.a_k_begin;
+      for (size_t row = 0; row < m; ++row) {
+        const auto* source = local_a.data() + (row * a_width) + (k0 - block.a_k_begin);
+        std::copy(source, source + width, panel_a.data() + (row * width));
+      }
+    }
+    if (block.row == b_owner) {
+      const auto* source = local_b.data() + ((k0 - block.b_k_begin) * n);
+      std::copy(source, source + (width * n), panel_b.data());
+    }
+    boost::mpi::broadcast(row_comm, panel_a.data(), static_cast<int>(m * width), static_cast<int>(a_owner));
+    boost::mpi::broadcast(column_comm, panel_b.data(), static_cast<int>(width * n), static_cast<int>(b_owner));
+    GemmAdd(panel_a.data(), panel_b.data(), local_c.data(), m, n, width, width, n, n);
+  }
+
+  // 2.5D: частичные суммы слоёв складываются на слое 0
+  std::span<double> result = local_c;
+  if (layers > 1) {
+    const boost::mpi::communicator depth_comm =
+        world_.split(static_cast<int>((block.row * grid.columns) + block.column), static_cast<int>(block.layer));
+    result = Scratch().AllocateArray<double>(block.layer == 0 ? m * n : 0);
+    boost::mpi::reduce(depth_comm, local_c.data(), static_cast<int>(m * n), result.data(), std::plus<double>(), 0);
+  }
+
+  // сбор C со слоя 0 одним Gatherv
+  std::vector<int> counts;
+  std::vector<int> displacements;
+  std::vector<double> packed;
+  if (world_.rank() == 0) {
+    for (int proc = 0; proc < size; ++proc) {
+      const auto proc_block = Locate(grid, static_cast<size_t>(proc));
+      displacements.push_back(counts.empty() ? 0 : displacements.back() + counts.back());
+      counts.push_back(proc_block.layer == 0 ? static_cast<int>(proc_block.Rows() * proc_block.Columns()) : 0);
+    }
+    packed.resize(dimension_ * dimension_);
+  }
+  MPI_Gatherv(result.data(), block.layer == 0 ? static_cast<int>(m * n) : 0, MPI_DOUBLE, packed.data(), counts.data(),
+              displacements.data(), MPI_DOUBLE, 0, world_);
+  if (world_.rank() == 0) {
+    output_matrix_C_.assign(dimension_ * dimension_, 0.0);
+    for (int proc = 0; proc < size; ++proc) {
+      const auto proc_block = Locate(grid, static_cast<size_t>(proc));
+      if (proc_block.layer != 0) {
+        continue;
+      }
+      const auto* source = packed.data() + displacements[static_cast<size_t>(proc)];
+      for (size_t i = proc_block.row_begin; i < proc_block.row_end; ++i) {
+        std::copy(source, source + proc_block.Columns(),
+                  output_matrix_C_.data() + (i * dimension_) + proc_block.column_begin);
+        source += proc_block.Columns();
+      }
+    }
+  }
+}
@@ -19,6 +19,39 @@ std::vector<int> CreateRandomBinaryImage(int r, int c) {
   }
   return vec;
 }
+
+std::vector<int> RunSequential(std::vector<int>& image, int rows, int cols) {
+  std::vector<int> labeled_image(rows * cols);
+  auto task_data_seq = std::make_shared<ppc::core::TaskData>();
+  task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t*>(image.data()));
+  task_data_seq->inputs_count = {static_cast<uint32_t>(rows), static_cast<uint32_t>(cols)};
+  task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t*>(labeled_image.data()));
+  task_data_seq->outputs_count = {static_cast<uint32_t>(rows), static_cast<uint32_t>(cols)};
+  karaseva_e_binaryimage_mpi::TestMPITaskSequential test_mpi_task_sequential(task_data_seq);
+  EXPECT_TRUE(test_mpi_task_sequential.Validation());
+  test_mpi_task_sequential.PreProcessing();
+  test_mpi_task_sequential.Run();
+  test_mpi_task_sequential.PostProcessing();
+  return labeled_image;
+}
+
+std::vector<int> RunParallel(std::vector<int>& image, int rows, int cols) {
+  boost::mpi::communicator world;
+  std::vector<int> labeled_image(rows * cols);
+  auto task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t*>(image.data()));
+    task_data_par->inputs_count = {static_cast<uint32_t>(rows), static_cast<uint32_t>(cols)};
+    task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t*>(labeled_image.data()));
+    task_data_par->outputs_count = {static_cast<uint32_t>(rows), static_cast<uint32_t>(cols)};
+  }
+  karaseva_e_binaryimage_mpi::TestMPITaskParallel test_mpi_task_parallel(task_data_par);
+  EXPECT_TRUE(test_mpi_task_parallel.Validation());
+  test_mpi_task_parallel.PreProcessing();
+  test_mpi_task_parallel.Run();
+  test_mpi_task_parallel.PostProcessing();
+  return labeled_image;
+}
 }  // namespace
 
 TEST(karaseva_e_binaryimage_mpi, test_on_random_ing_25x25) {
@@ -163,4 +196,76 @@ TEST(karaseva_e_binaryimage_mpi, test_on_random_ing_75x75) {
     test_mpi_task_sequential.PostProcessingImpl();
     ASSERT_EQ(reference_labeled_image, global_labeled_image);
   }
-}
\ No newline at end of file
+}
+
+TEST(karaseva_e_binaryimage_mpi, test_snake_across_all_strips) {
+  boost::mpi::communicator world;
+  const int rows = 15;
+  const int cols = 9;
+  // one object winding down through every strip: full rows joined at alternating ends
+  std::vector<int> image(rows * cols, 1);
+  for (int x = 0; x < rows; x++) {
+    for (int y = 0; y < cols; y++) {
+      bool joint = (x % 4 == 1 && y == cols - 1) || (x % 4 == 3 && y == 0);
+      if (x % 2 == 0 || joint) {
+        image[(x * cols) + y] = 0;
+      }
+    }
+  }
+  std::vector<int> expected(rows * cols);
+  for (int i = 0; i < rows * cols; i++) {
+    expected[i] = image[i] == 0 ? 2 : 1;
+  }
+
+  auto labeled_image = RunParallel(image, rows, cols);
+  if (world.rank() == 0) {
+    EXPECT_EQ(labeled_image, expected);
+  }
+}
+
+TEST(karaseva_e_binaryimage_mpi, test_fewer_rows_than_processes) {
+  boost::mpi::communicator world;
+  const int rows = 2;
+  const int cols = 5;
+  std::vector<int> image = {0, 1, 0, 1, 0, 1, 0, 1, 1, 0};
+  std::vector<int> expected = {2, 1, 2, 1, 3, 1, 2, 1, 1, 3};
+
+  auto labeled_image = RunParallel(image, rows, cols);
+  if (world.rank() == 0) {
+    EXPECT_EQ(labeled_image, expected);
+  }
+}
+
+TEST(karaseva_e_binaryimage_mpi, test_distributed_layout) {
+  boost::mpi::communicator world;
+  const int rows = 64;
+  const int cols = 48;
+  std::mt19937 gen(42);
+  std::vector<int> image(rows * cols);
+  for (auto& pixel : image) {
+    pixel = static_cast<int>(gen() % 2);
+  }
+
+  std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t*>(image.data()));
+    task_data_par->inputs_count = {rows, cols};
+  }
+  karaseva_e_binaryimage_mpi::TestMPITaskParallel test_mpi_task_parallel(
+      task_data_par, karaseva_e_binaryimage_mpi::ResultLayout::kDistributed);
+  ASSERT_TRUE(test_mpi_task_parallel.Validation());
+  test_mpi_task_parallel.PreProcessing();
+  test_mpi_task_parallel.Run();
+  test_mpi_task_parallel.PostProcessing();
+
+  // the strip of rank r: rows / size rows, one more for the first rows % size ranks
+  auto reference = RunSequential(image, rows, cols);
+  int first_row = 0;
+  for (int r = 0; r < world.rank(); r++) {
+    first_row += (rows / world.size()) + (r < rows % world.size() ? 1 : 0);
+  }
+  int strip_rows = (rows / world.size()) + (world.rank() < rows % world.size() ? 1 : 0);
+  std::vector<int> expected(reference.begin() + (first_row * cols),
+                            reference.begin() + ((first_row + strip_rows) * cols));
+  EXPECT_EQ(test_mpi_task_parallel.LocalResult(), expected);
+}
@@ -2,9 +2,6 @@
 
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
-#include <map>
-#include <set>
-#include <sstream>
 #include <utility>
 #include <vector>
 
@@ -12,19 +9,8 @@
 
 namespace karaseva_e_binaryimage_mpi {
 
-// Function declarations
-int GetRootLabel(std::map<int, std::set<int>>& label_parent_map, int label);
-void PropagateLabelEquivalences(std::map<int, std::set<int>>& label_parent_map);
-void UpdateLabels(std::vector<int>& labeled_image, int rows, int cols);
-void UnionLabels(std::map<int, std::set<int>>& label_parent_map, int new_label, int neighbour_label);
-void Labeling(std::vector<int>& input_image, std::vector<int>& labeled_image, int rows, int cols, int min_label,
-              std::map<int, std::set<int>>& label_parent_map);
-void SaveLabelMapToStream(std::ostringstream& oss, const std::map<int, std::set<int>>& label_map);
-void LoadLabelMapFromStream(std::istringstream& iss, std::map<int, std::set<int>>& label_map);
-void SaveLabelSetToStream(std::ostringstream& oss, const std::set<int>& label_set);
-void LoadLabelSetFromStream(std::istringstream& iss, std::set<int>& label_set);
-// std::vector<int> FindNeighbors(const std::vector<int>& labeled_image, int x, int y, int rows, int cols);
-
+// Objects are the pixels equal to 0 and 8-connected; background pixels get
+// label 1, objects 2, 3, ... in raster order of their first pixel.
 class TestMPITaskSequential : public ppc::core::Task {
  public:
   explicit TestMPITaskSequential(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
@@ -40,17 +26,27 @@ class TestMPITaskSequential : public ppc::core::Task {
   int columns_;
 };
 
+using ppc::core::ResultLayout;
+
+// Every rank labels a strip of rows and sends its last row to the next rank,
+// which lists the components that touch across the border. Rank 0 numbers
+// the components from these pairs only and sends every rank the numbers of
+// its joined components, so the image itself is never collected for labeling.
 class TestMPITaskParallel : public ppc::core::Task {
  public:
-  explicit TestMPITaskParallel(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
+  explicit TestMPITaskParallel(ppc::core::TaskDataPtr task_data, ResultLayout layout = ResultLayout::kGathered)
+      : Task(std::move(task_data)), layout_(layout) {}
   bool PreProcessingImpl() override;
   bool ValidationImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
+  [[nodiscard]] const std::vector<int>& LocalResult() const { return local_labeled_image_; }
+
  private:
+  ResultLayout layout_;
   std::vector<int> image_, local_image_;
-  std::vector<int> labeled_image_;
+  std::vector<int> labeled_image_, local_labeled_image_;
   int rows_;
   int columns_;
   boost::mpi::communicator world_;
@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <boost/mpi/environment.hpp>
 #include <boost/serialization/vector.hpp>  //NOLINT
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <random>
 #include <vector>
@@ -317,4 +320,104 @@ TEST(kavtorev_d_radix_double_sort_mpi, ReverseSortedData) {
       ASSERT_NEAR(result_par[i], result_seq[i], 1e-12);
     }
   }
-}
\ No newline at end of file
+}
+
+namespace {
+void CheckAgainstStdSort(std::vector<double> input_data, ResultLayout layout) {
+  mpi::communicator world;
+  int n = static_cast<int>(input_data.size());
+  std::vector<double> x_par(n, 0.0);
+
+  auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t*>(&n));
+    task_data_mpi->inputs_count.emplace_back(1);
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t*>(input_data.data()));
+    task_data_mpi->inputs_count.emplace_back(n);
+    if (layout == ResultLayout::kGathered) {
+      task_data_mpi->outputs.emplace_back(reinterpret_cast<uint8_t*>(x_par.data()));
+      task_data_mpi->outputs_count.emplace_back(n);
+    }
+  }
+
+  RadixSortParallel test_task_parallel(task_data_mpi, layout);
+  ASSERT_TRUE(test_task_parallel.Validation());
+  test_task_parallel.PreProcessing();
+  test_task_parallel.Run();
+  test_task_parallel.PostProcessing();
+
+  const auto& local = test_task_parallel.LocalResult();
+  ASSERT_TRUE(std::ranges::is_sorted(local));
+  if (layout == ResultLayout::kDistributed) {
+    // the parts in rank order are the sorted array
+    std::vector<std::vector<double>> parts;
+    mpi::gather(world, local, parts, 0);
+    if (world.rank() == 0) {
+      x_par.clear();
+      for (const auto& part : parts) {
+        x_par.insert(x_par.end(), part.begin(), part.end());
+      }
+    }
+  }
+
+  if (world.rank() == 0) {
+    std::ranges::sort(input_data);
+    ASSERT_EQ(x_par, input_data);
+  }
+}
+
+std::vector<double> RandomData(int n, int distinct) {
+  std::vector<double> data;
+  mpi::communicator world;
+  if (world.rank() == 0) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(-distinct / 2, distinct / 2);
+    data.resize(n);
+    for (auto& value : data) {
+      value = dist(gen) * 0.5;
+    }
+  }
+  return data;
+}
+}  // namespace
+
+TEST(kavtorev_d_radix_double_sort_mpi, DistributedLayout) {
+  CheckAgainstStdSort(RandomData(20000, 1000000), ResultLayout::kDistributed);
+}
+
+TEST(kavtorev_d_radix_double_sort_mpi, ManyDuplicates) {
+  CheckAgainstStdSort(RandomData(5000, 3), ResultLayout::kGathered);
+  CheckAgainstStdSort(RandomData(5000, 3), ResultLayout::kDistributed);
+}
+
+TEST(kavtorev_d_radix_double_sort_mpi, EqualKeysAreSpreadOverRanks) {
+  mpi::communicator world;
+  const int block = 2000;
+  int n = block * world.size();
+  std::vector<double> input_data(world.rank() == 0 ? n : 0, 1.5);
+
+  auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t*>(&n));
+    task_data_mpi->inputs_count.emplace_back(1);
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t*>(input_data.data()));
+    task_data_mpi->inputs_count.emplace_back(n);
+  }
+
+  RadixSortParallel test_task_parallel(task_data_mpi, ResultLayout::kDistributed);
+  ASSERT_TRUE(test_task_parallel.Validation());
+  test_task_parallel.PreProcessing();
+  test_task_parallel.Run();
+  test_task_parallel.PostProcessing();
+
+  // sample sort bound: no rank ends up with more than twice its block
+  const auto& local = test_task_parallel.LocalResult();
+  EXPECT_LE(local.size(), 2U * block);
+  EXPECT_TRUE(std::ranges::all_of(local, [](double value) { return value == 1.5; }));
+  EXPECT_EQ(mpi::all_reduce(world, static_cast<int>(local.size()), std::plus<>()), n);
+}
+
+TEST(kavtorev_d_radix_double_sort_mpi, FewerElementsThanRanks) {
+  CheckAgainstStdSort(RandomData(2, 100), ResultLayout::kGathered);
+  CheckAgainstStdSort(RandomData(1, 100), ResultLayout::kDistributed);
+}
@@ -28,20 +28,31 @@ class RadixSortSequential : public ppc::core::Task {
   static void RadixSortUint64(std::vector<uint64_t>& keys);
 };
 
+using ppc::core::ResultLayout;
+
+// Sample sort: every rank radix sorts a block of the input, picks regular
+// samples of it, and the samples of all ranks give size - 1 splitters. One
+// alltoallv sends every key to the rank of its splitter range, which merges
+// the sorted runs it received.
 class RadixSortParallel : public ppc::core::Task {
  public:
-  explicit RadixSortParallel(std::shared_ptr<ppc::core::TaskData> task_data) : Task(std::move(task_data)) {}
+  explicit RadixSortParallel(std::shared_ptr<ppc::core::TaskData> task_data,
+                             ResultLayout layout = ResultLayout::kGathered)
+      : Task(std::move(task_data)), layout_(layout) {}
   bool PreProcessingImpl() override;
   bool ValidationImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
+  [[nodiscard]] const std::vector<double>& LocalResult() const { return local_result_; }
+
  private:
+  ResultLayout layout_;
   std::vector<double> data_;
+  std::vector<double> local_result_;
   int n_ = 0;
   boost::mpi::communicator world_;
 
-  static void RadixSortDoubles(std::vector<double>& data);
   static void RadixSortUint64(std::vector<uint64_t>& keys);
 };
 
@@ -1,11 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <boost/mpi/environment.hpp>
 #include <boost/mpi/timer.hpp>
 #include <boost/serialization/vector.hpp>  //NOLINT
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <random>
 #include <vector>
@@ -123,4 +126,53 @@ TEST(kavtorev_d_radix_double_sort_mpi, test_task_run) {
   if (world.rank() == 0) {
     ppc::core::Perf::PrintPerfStatistic(perf_results);
   }
-}
\ No newline at end of file
+}
+
+TEST(kavtorev_d_radix_double_sort_mpi, test_task_run_distributed) {
+  mpi::environment env;
+  mpi::communicator world;
+
+  int n = 1000000;
+  std::vector<double> input_data;
+  if (world.rank() == 0) {
+    input_data.resize(n);
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<double> dist(-1e9, 1e9);
+
+    for (int i = 0; i < n; ++i) {
+      input_data[i] = dist(gen);
+    }
+  }
+
+  auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
+
+  if (world.rank() == 0) {
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t*>(&n));
+    task_data_mpi->inputs_count.emplace_back(1);
+
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t*>(input_data.data()));
+    task_data_mpi->inputs_count.emplace_back(n);
+  }
+
+  // the sorted parts stay on their ranks, nothing is gathered
+  auto test_task_mpi =
+      std::make_shared<kavtorev_d_radix_double_sort::RadixSortParallel>(task_data_mpi, ResultLayout::kDistributed);
+
+  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
+  perf_attr->num_running = 5;
+  const mpi::timer current_timer;
+  perf_attr->current_timer = [&] { return current_timer.elapsed(); };
+
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+
+  auto perf_analyzer = std::make_shared<ppc::core::Perf>(test_task_mpi);
+  perf_analyzer->TaskRun(perf_attr, perf_results);
+
+  if (world.rank() == 0) {
+    ppc::core::Perf::PrintPerfStatistic(perf_results);
+  }
+  const auto& local = test_task_mpi->LocalResult();
+  ASSERT_TRUE(std::is_sorted(local.begin(), local.end()));
+  ASSERT_EQ(mpi::all_reduce(world, local.size(), std::plus<>()), static_cast<size_t>(n));
+}
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <boost/mpi/environment.hpp>
+#include <boost/serialization/vector.hpp>  //NOLINT
 #include <cstdint>
 #include <memory>
 #include <random>
@@ -298,3 +300,79 @@ TEST(komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi, AlreadySorte
     }
   }
 }
+
+TEST(komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi, DistributedResult) {
+  mpi::environment env;
+  mpi::communicator world;
+
+  std::shared_ptr<ppc::core::TaskData> task_data_mpi = std::make_shared<ppc::core::TaskData>();
+
+  int size = 20000;
+  std::vector<double> in(size);
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1e6, 1e6);
+
+  if (world.rank() == 0) {
+    for (double& val : in) {
+      val = dist(gen);
+    }
+
+    task_data_mpi->inputs = {reinterpret_cast<uint8_t*>(&size), reinterpret_cast<uint8_t*>(in.data())};
+    task_data_mpi->inputs_count = {1, static_cast<unsigned int>(size)};
+  }
+
+  TestTaskMPI test_task_mpi(task_data_mpi, ResultLayout::kDistributed);
+  ASSERT_TRUE(test_task_mpi.ValidationImpl());
+  test_task_mpi.PreProcessingImpl();
+  test_task_mpi.RunImpl();
+  test_task_mpi.PostProcessingImpl();
+
+  const auto& local = test_task_mpi.LocalResult();
+  ASSERT_TRUE(std::ranges::is_sorted(local));
+  std::vector<std::vector<double>> parts;
+  mpi::gather(world, local, parts, 0);
+
+  if (world.rank() == 0) {
+    std::vector<double> result;
+    for (const auto& part : parts) {
+      result.insert(result.end(), part.begin(), part.end());
+    }
+    std::ranges::sort(in);
+    ASSERT_EQ(result, in);
+  }
+}
+
+TEST(komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi, ManyEqualNumbers) {
+  mpi::environment env;
+  mpi::communicator world;
+
+  std::shared_ptr<ppc::core::TaskData> task_data_mpi = std::make_shared<ppc::core::TaskData>();
+
+  int size = 5000;
+  std::vector<double> in(size);
+  std::vector<double> out(size, 0.0);
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(-1, 1);
+
+  if (world.rank() == 0) {
+    for (double& val : in) {
+      val = dist(gen) * 0.25;
+    }
+
+    task_data_mpi->inputs = {reinterpret_cast<uint8_t*>(&size), reinterpret_cast<uint8_t*>(in.data())};
+    task_data_mpi->inputs_count = {1, static_cast<unsigned int>(size)};
+    task_data_mpi->outputs = {reinterpret_cast<uint8_t*>(out.data())};
+    task_data_mpi->outputs_count = {static_cast<unsigned int>(size)};
+  }
+
+  TestTaskMPI test_task_mpi(task_data_mpi);
+  ASSERT_TRUE(test_task_mpi.ValidationImpl());
+  test_task_mpi.PreProcessingImpl();
+  test_task_mpi.RunImpl();
+  test_task_mpi.PostProcessingImpl();
+
+  if (world.rank() == 0) {
+    std::ranges::sort(in);
+    ASSERT_EQ(out, in);
+  }
+}
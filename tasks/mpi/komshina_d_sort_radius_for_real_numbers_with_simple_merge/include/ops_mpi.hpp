@@ -10,19 +10,28 @@
 
 namespace komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi {
 
+using ppc::core::ResultLayout;
+
+// Sample sort: blocks of the input are radix sorted locally, regular samples of
+// all blocks give size - 1 splitters, one MPI_Alltoallv moves every number to
+// the rank of its splitter range and each rank merges the runs it received.
 class TestTaskMPI : public ppc::core::Task {
  public:
-  explicit TestTaskMPI(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
+  explicit TestTaskMPI(ppc::core::TaskDataPtr task_data, ResultLayout layout = ResultLayout::kGathered)
+      : Task(std::move(task_data)), layout_(layout) {}
   bool PreProcessingImpl() override;
   bool ValidationImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
+  [[nodiscard]] const std::vector<double>& LocalResult() const { return local_numbers_; }
+
  private:
+  ResultLayout layout_;
   std::vector<double> numbers_;
+  std::vector<double> local_numbers_;
   int total_size_ = 0;
 
-  static void SortDoubles(std::vector<double>& arr);
   static void SortUint64(std::vector<uint64_t>& keys);
   boost::mpi::communicator world_;
 };
@@ -4,13 +4,14 @@
 
 #include <algorithm>
 #include <array>
-#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <iterator>
 #include <vector>
 
+#include "core/sort/include/sort.hpp"
+#include "core/sort/include/sort_mpi.hpp"
+
 bool komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi::TestTaskMPI::PreProcessingImpl() {
   if (world_.rank() == 0) {
     numbers_.resize(total_size_);
@@ -27,7 +28,8 @@ bool komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi::TestTaskMPI:
   if (is_valid) {
     total_size_ = *reinterpret_cast<int*>(task_data->inputs[0]);
     is_valid = task_data->inputs_count[0] == 1 && task_data->inputs_count[1] == static_cast<size_t>(total_size_) &&
-               task_data->outputs_count[0] == static_cast<size_t>(total_size_);
+               (layout_ == ResultLayout::kDistributed ||
+                task_data->outputs_count[0] == static_cast<size_t>(total_size_));
   }
 
   MPI_Bcast(&is_valid, 1, MPI_C_BOOL, 0, MPI_COMM_WORLD);
@@ -58,33 +60,24 @@ bool komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi::TestTaskMPI:
   MPI_Scatterv(numbers_.data(), sizes.data(), offsets.data(), MPI_DOUBLE, local_data.data(), sizes[rank], MPI_DOUBLE, 0,
                MPI_COMM_WORLD);
 
-  SortDoubles(local_data);
-
-  int step = 1;
-  while (step < size) {
-    if (rank % (2 * step) == 0) {
-      int partner = rank + step;
-      if (partner < size) {
-        int partner_size = 0;
-        MPI_Recv(&partner_size, 1, MPI_INT, partner, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-        std::vector<double> partner_data(partner_size);
-        MPI_Recv(partner_data.data(), partner_size, MPI_DOUBLE, partner, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-        std::vector<double> merged;
-        merged.reserve(local_data.size() + partner_data.size());
-        std::ranges::merge(local_data, partner_data, std::back_inserter(merged));
-        local_data.swap(merged);
-      }
-    } else if (rank % (2 * step) == step) {
-      int local_size = static_cast<int>(local_data.size());
-      MPI_Send(&local_size, 1, MPI_INT, rank - step, 0, MPI_COMM_WORLD);
-      MPI_Send(local_data.data(), static_cast<int>(local_data.size()), MPI_DOUBLE, rank - step, 1, MPI_COMM_WORLD);
-      local_data.clear();
-    }
-    step *= 2;
+  std::vector<uint64_t> keys(local_data.size());
+  std::ranges::transform(local_data, keys.begin(), ppc::sort::ToKey);
+  SortUint64(keys);
+  if (size > 1) {
+    keys = ppc::sort::ExchangeBySplitters(keys, MPI_COMM_WORLD);
   }
-
-  if (rank == 0) {
-    numbers_.swap(local_data);
+  local_numbers_.resize(keys.size());
+  std::ranges::transform(keys, local_numbers_.begin(), ppc::sort::FromKey);
+
+  if (layout_ == ResultLayout::kGathered) {
+    int local_size = static_cast<int>(local_numbers_.size());
+    MPI_Gather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    for (int i = 1; i < size; ++i) {
+      offsets[i] = offsets[i - 1] + sizes[i - 1];
+    }
+    numbers_.resize(rank == 0 ? total_size_ : 0);
+    MPI_Gatherv(local_numbers_.data(), local_size, MPI_DOUBLE, numbers_.data(), sizes.data(), offsets.data(),
+                MPI_DOUBLE, 0, MPI_COMM_WORLD);
   }
   return true;
 }
@@ -92,7 +85,7 @@ bool komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi::TestTaskMPI:
 bool komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi::TestTaskMPI::PostProcessingImpl() {
   int rank = 0;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  if (rank == 0) {
+  if (rank == 0 && layout_ == ResultLayout::kGathered) {
     std::memcpy(task_data->outputs[0], numbers_.data(), total_size_ * sizeof(double));
   }
   return true;
@@ -100,26 +93,6 @@ bool komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi::TestTaskMPI:
 
 namespace komshina_d_sort_radius_for_real_numbers_with_simple_merge_mpi {
 
-void TestTaskMPI::SortDoubles(std::vector<double>& arr) {
-  std::vector<uint64_t> keys(arr.size());
-  const uint64_t sign_mask = (1ULL << 63);
-
-  for (size_t i = 0; i < arr.size(); ++i) {
-    uint64_t temp = 0;
-    std::memcpy(&temp, &arr[i], sizeof(double));
-    temp = ((temp & sign_mask) != 0) ? ~temp : (temp | sign_mask);
-    keys[i] = temp;
-  }
-
-  SortUint64(keys);
-
-  for (size_t i = 0; i < arr.size(); ++i) {
-    uint64_t temp = keys[i];
-    temp = ((temp & sign_mask) != 0) ? (temp & ~sign_mask) : ~temp;
-    std::memcpy(&arr[i], &temp, sizeof(double));
-  }
-}
-
 void TestTaskMPI::SortUint64(std::vector<uint64_t>& keys) {
   constexpr int kBitCount = 64;
   constexpr int kBucketCount = 256;
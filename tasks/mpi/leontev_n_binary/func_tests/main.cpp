@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <random>
 #include <set>
 #include <vector>
 
@@ -299,3 +300,64 @@ TEST(leontev_n_binary_mpi, lines_test) {
     ASSERT_EQ(actual, expected);
   }
 }
+
+TEST(leontev_n_binary_mpi, snake_test) {
+  boost::mpi::communicator world;
+  size_t rows = 15;
+  size_t cols = 9;
+  // one component winding through every row, so through every strip
+  std::vector<uint8_t> img(rows * cols, 0);
+  for (size_t row = 0; row < rows; row++) {
+    for (size_t col = 0; col < cols; col++) {
+      bool turn = (row % 4 == 1) ? col == cols - 1 : col == 0;
+      img[(row * cols) + col] = (row % 2 == 0 || turn) ? 1 : 0;
+    }
+  }
+  std::vector<uint32_t> expected(rows * cols);
+  std::ranges::transform(img, expected.begin(), [](uint8_t pixel) { return static_cast<uint32_t>(pixel); });
+  std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
+  std::vector<uint32_t> actual(rows * cols);
+  if (world.rank() == 0) {
+    TaskEmplacement(task_data_par, img, rows, cols, actual);
+  }
+  leontev_n_binary_mpi::BinarySegmentsMPI binary_segments(task_data_par);
+  binary_segments.Validation();
+  binary_segments.PreProcessing();
+  binary_segments.Run();
+  binary_segments.PostProcessing();
+  if (world.rank() == 0) {
+    ASSERT_EQ(actual, expected);
+  }
+}
+
+TEST(leontev_n_binary_mpi, distributed_layout_test) {
+  boost::mpi::communicator world;
+  size_t rows = 64;
+  size_t cols = 48;
+  std::mt19937 gen(42);
+  std::vector<uint8_t> img(rows * cols);
+  for (auto& pixel : img) {
+    pixel = gen() % 2;
+  }
+  std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_par->inputs.emplace_back(img.data());
+    task_data_par->inputs_count.emplace_back(rows);
+    task_data_par->inputs_count.emplace_back(cols);
+  }
+  leontev_n_binary_mpi::BinarySegmentsMPI binary_segments(task_data_par,
+                                                          leontev_n_binary_mpi::ResultLayout::kDistributed);
+  ASSERT_TRUE(binary_segments.Validation());
+  binary_segments.PreProcessing();
+  binary_segments.Run();
+  binary_segments.PostProcessing();
+
+  // rank 0 holds the remainder rows
+  auto size = static_cast<size_t>(world.size());
+  size_t first_row = (world.rank() == 0) ? 0 : (rows % size) + ((rows / size) * world.rank());
+  size_t strip_rows = (rows / size) + ((world.rank() == 0) ? rows % size : 0);
+  auto expected = RunSeq(img, rows, cols);
+  std::vector<uint32_t> expected_strip(expected.begin() + static_cast<std::ptrdiff_t>(first_row * cols),
+                                       expected.begin() + static_cast<std::ptrdiff_t>((first_row + strip_rows) * cols));
+  EXPECT_EQ(binary_segments.LocalResult(), expected_strip);
+}
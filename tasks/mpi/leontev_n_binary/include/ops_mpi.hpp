@@ -5,7 +5,6 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
-#include <set>
 #include <utility>
 #include <vector>
 
@@ -13,25 +12,31 @@
 
 namespace leontev_n_binary_mpi {
 
+using ppc::core::ResultLayout;
+
+// Labels the nonzero pixels 1, 2, ... by component in raster order, zero
+// pixels stay 0. A pixel is connected to its left, up and up-left neighbour
+// (and down, right, down-right), not to the up-right one.
+// Every rank labels a strip of rows; only the border rows go to the neighbour
+// ranks and only the pairs of touching border components to rank 0, which
+// numbers the components and returns the numbers of the joined ones.
 class BinarySegmentsMPI : public ppc::core::Task {
  public:
-  explicit BinarySegmentsMPI(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
+  explicit BinarySegmentsMPI(ppc::core::TaskDataPtr task_data, ResultLayout layout = ResultLayout::kGathered)
+      : Task(std::move(task_data)), layout_(layout) {}
   bool ValidationImpl() override;
   bool PreProcessingImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
+  [[nodiscard]] const std::vector<uint32_t>& LocalResult() const { return local_labels_; }
+
  private:
-  [[nodiscard]] size_t GetIndex(size_t i, size_t j) const;
-  void RootLoop(std::vector<int>& offsets);
-  void RootLoopProcess(size_t border, size_t col, std::vector<std::set<uint32_t>>& label_equivalences);
-  void LocalLoop(size_t local_size, uint32_t& next_label, std::vector<uint32_t>& local_labels,
-                 std::vector<std::set<uint32_t>>& local_label_equivalences);
-  void LocalLoopProcess(size_t row, size_t col, uint32_t& next_label, std::vector<uint32_t>& local_labels,
-                        std::vector<std::set<uint32_t>>& local_label_equivalences);
+  ResultLayout layout_;
   boost::mpi::communicator world_;
   std::vector<uint8_t> input_image_;
   std::vector<uint8_t> local_image_;
+  std::vector<uint32_t> local_labels_;
   std::vector<uint32_t> labels_;
   size_t rows_;
   size_t cols_;
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <array>
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <boost/mpi/environment.hpp>
@@ -8,11 +9,88 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <random>
 #include <vector>
 
+#include "core/stencil/include/stencil.hpp"
 #include "core/task/include/task.hpp"
+#include "mpi/mezhuev_m_sobel_edge_detection_mpi/include/halo_stencil.hpp"
 #include "mpi/mezhuev_m_sobel_edge_detection_mpi/include/mpi.hpp"
 
+namespace {
+
+using mezhuev_m_sobel_edge_detection_mpi::BorderMode;
+using ppc::stencil::Filter;
+
+std::vector<uint8_t> RandomImage(size_t height, size_t width, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> value(0, 255);
+  std::vector<uint8_t> image(height * width);
+  for (auto& pixel : image) {
+    pixel = static_cast<uint8_t>(value(gen));
+  }
+  return image;
+}
+
+// the filter of the whole image on one process
+std::vector<uint8_t> FilterImage(const std::vector<uint8_t>& image, size_t height, size_t width, Filter filter,
+                                 BorderMode border) {
+  const size_t radius = ppc::stencil::Radius(filter);
+  const size_t stride = width + (2 * radius);
+  std::vector<uint8_t> padded((height + (2 * radius)) * stride);
+  for (size_t y = 0; y < height + (2 * radius); ++y) {
+    for (size_t x = 0; x < stride; ++x) {
+      const size_t row = std::clamp(y, radius, height + radius - 1) - radius;
+      const size_t col = std::clamp(x, radius, width + radius - 1) - radius;
+      padded[(y * stride) + x] = image[(row * width) + col];
+    }
+  }
+  std::vector<uint8_t> filtered(height * width);
+  ppc::stencil::ApplyFilter(filter, padded.data() + (radius * stride) + radius, stride, height, width,
+                            filtered.data(), width);
+  if (border == BorderMode::kZero) {
+    for (size_t y = 0; y < height; ++y) {
+      for (size_t x = 0; x < width; ++x) {
+        if (y < radius || y + radius >= height || x < radius || x + radius >= width) {
+          filtered[(y * width) + x] = 0;
+        }
+      }
+    }
+  }
+  return filtered;
+}
+
+// ppc::stencil::Sobel of the whole image on one process, 0 on the edges
+std::vector<uint8_t> SobelImage(const std::vector<uint8_t>& image, size_t height, size_t width,
+                                const ppc::stencil::SobelOptions& options) {
+  const size_t radius = ppc::stencil::SobelRadius(options);
+  std::vector<uint8_t> filtered(height * width, 0);
+  if (height > 2 * radius && width > 2 * radius) {
+    ppc::stencil::Sobel(image.data() + (radius * width) + radius, width, height - (2 * radius), width - (2 * radius),
+                        filtered.data() + (radius * width) + radius, width, options);
+  }
+  return filtered;
+}
+
+std::vector<uint8_t> RunStencilFilter(std::vector<uint8_t>& image, size_t height, size_t width, Filter filter,
+                                      BorderMode border, size_t halo = 0) {
+  boost::mpi::communicator world;
+  std::vector<uint8_t> out(height * width, 0);
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data->AddInput(image.data(), {height, width});
+    task_data->AddOutput(out.data(), {height, width});
+  }
+  mezhuev_m_sobel_edge_detection_mpi::StencilFilter task(task_data, filter, border, halo);
+  EXPECT_TRUE(task.Validation());
+  task.PreProcessing();
+  task.Run();
+  task.PostProcessing();
+  return out;
+}
+
+}  // namespace
+
 TEST(mezhuev_m_sobel_edge_detection_mpi, test_basic_case) {
   boost::mpi::environment env;
   boost::mpi::communicator world;
@@ -29,10 +107,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_basic_case) {
     }
   }
   auto task_data = std::make_shared<ppc::core::TaskData>();
-  task_data->inputs = {in.data()};
-  task_data->inputs_count = {kImageSize};
-  task_data->outputs = {out.data()};
-  task_data->outputs_count = {kImageSize};
+  task_data->AddInput(in.data(), {kHeight, kWidth});
+  task_data->AddOutput(out.data(), {kHeight, kWidth});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
 
@@ -51,10 +127,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_small_image_3x3) {
   std::vector<uint8_t> in(9, 255);
   std::vector<uint8_t> out(9, 0);
   auto task_data = std::make_shared<ppc::core::TaskData>();
-  task_data->inputs = {in.data()};
-  task_data->inputs_count = {static_cast<uint32_t>(in.size())};
-  task_data->outputs = {out.data()};
-  task_data->outputs_count = {static_cast<uint32_t>(out.size())};
+  task_data->AddInput(in.data(), {3, 3});
+  task_data->AddOutput(out.data(), {3, 3});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
   ASSERT_TRUE(sobel_task->PreProcessingImpl() && sobel_task->RunImpl() && sobel_task->ValidationImpl() &&
@@ -84,10 +158,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_single_bright_pixel) {
   in[12] = 255;
 
   auto task_data = std::make_shared<ppc::core::TaskData>();
-  task_data->inputs = {in.data()};
-  task_data->inputs_count = {static_cast<uint32_t>(in.size())};
-  task_data->outputs = {out.data()};
-  task_data->outputs_count = {static_cast<uint32_t>(out.size())};
+  task_data->AddInput(in.data(), {5, 5});
+  task_data->AddOutput(out.data(), {5, 5});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
   ASSERT_TRUE(sobel_task->PreProcessingImpl() && sobel_task->RunImpl() && sobel_task->ValidationImpl() &&
@@ -106,10 +178,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_large_image) {
   std::vector<uint8_t> out(1024 * 1024, 0);
 
   auto task_data = std::make_shared<ppc::core::TaskData>();
-  task_data->inputs = {in.data()};
-  task_data->inputs_count = {static_cast<uint32_t>(in.size())};
-  task_data->outputs = {out.data()};
-  task_data->outputs_count = {static_cast<uint32_t>(out.size())};
+  task_data->AddInput(in.data(), {1024, 1024});
+  task_data->AddOutput(out.data(), {1024, 1024});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
   ASSERT_TRUE(sobel_task->PreProcessingImpl() && sobel_task->RunImpl() && sobel_task->ValidationImpl() &&
@@ -128,10 +198,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_vertical_gradient) {
     }
   }
   auto task_data = std::make_shared<ppc::core::TaskData>();
-  task_data->inputs = {in.data()};
-  task_data->inputs_count = {static_cast<uint32_t>(in.size())};
-  task_data->outputs = {out.data()};
-  task_data->outputs_count = {static_cast<uint32_t>(out.size())};
+  task_data->AddInput(in.data(), {5, 5});
+  task_data->AddOutput(out.data(), {5, 5});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
   ASSERT_TRUE(sobel_task->PreProcessingImpl() && sobel_task->RunImpl() && sobel_task->ValidationImpl() &&
@@ -150,10 +218,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_black_image) {
   std::vector<uint8_t> out(25, 0);
 
   auto task_data = std::make_shared<ppc::core::TaskData>();
-  task_data->inputs = {in.data()};
-  task_data->inputs_count = {static_cast<uint32_t>(in.size())};
-  task_data->outputs = {out.data()};
-  task_data->outputs_count = {static_cast<uint32_t>(out.size())};
+  task_data->AddInput(in.data(), {5, 5});
+  task_data->AddOutput(out.data(), {5, 5});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
   ASSERT_TRUE(sobel_task->PreProcessingImpl() && sobel_task->RunImpl() && sobel_task->ValidationImpl() &&
@@ -177,10 +243,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_diagonal_gradient) {
   }
 
   auto task_data = std::make_shared<ppc::core::TaskData>();
-  task_data->inputs = {in.data()};
-  task_data->inputs_count = {static_cast<uint32_t>(in.size())};
-  task_data->outputs = {out.data()};
-  task_data->outputs_count = {static_cast<uint32_t>(out.size())};
+  task_data->AddInput(in.data(), {5, 5});
+  task_data->AddOutput(out.data(), {5, 5});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
   ASSERT_TRUE(sobel_task->PreProcessingImpl() && sobel_task->RunImpl() && sobel_task->ValidationImpl() &&
@@ -204,10 +268,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_horizontal_gradient) {
   }
 
   auto task_data = std::make_shared<ppc::core::TaskData>();
-  task_data->inputs = {in.data()};
-  task_data->inputs_count = {static_cast<uint32_t>(in.size())};
-  task_data->outputs = {out.data()};
-  task_data->outputs_count = {static_cast<uint32_t>(out.size())};
+  task_data->AddInput(in.data(), {5, 5});
+  task_data->AddOutput(out.data(), {5, 5});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
   ASSERT_TRUE(sobel_task->PreProcessingImpl() && sobel_task->RunImpl() && sobel_task->ValidationImpl() &&
@@ -226,10 +288,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_constant_image) {
   std::vector<uint8_t> out(25, 0);
 
   auto task_data = std::make_shared<ppc::core::TaskData>();
-  task_data->inputs = {in.data()};
-  task_data->inputs_count = {static_cast<uint32_t>(in.size())};
-  task_data->outputs = {out.data()};
-  task_data->outputs_count = {static_cast<uint32_t>(out.size())};
+  task_data->AddInput(in.data(), {5, 5});
+  task_data->AddOutput(out.data(), {5, 5});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
   ASSERT_TRUE(sobel_task->PreProcessingImpl() && sobel_task->RunImpl() && sobel_task->ValidationImpl() &&
@@ -239,3 +299,127 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_constant_image) {
     ASSERT_TRUE(std::ranges::all_of(out.begin(), out.end(), [](uint8_t val) { return val == 0; }));
   }
 }
+
+TEST(mezhuev_m_sobel_edge_detection_mpi, test_non_square_image) {
+  boost::mpi::environment env;
+  boost::mpi::communicator world;
+
+  constexpr size_t kHeight = 37;
+  constexpr size_t kWidth = 61;
+  auto in = RandomImage(kHeight, kWidth, 5);
+  std::vector<uint8_t> out(kHeight * kWidth, 0);
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->AddInput(in.data(), {kHeight, kWidth});
+  task_data->AddOutput(out.data(), {kHeight, kWidth});
+
+  auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data);
+  ASSERT_TRUE(sobel_task->PreProcessingImpl() && sobel_task->RunImpl() && sobel_task->ValidationImpl() &&
+              sobel_task->PostProcessingImpl());
+
+  if (world.rank() == 0) {
+    ASSERT_EQ(out, FilterImage(in, kHeight, kWidth, Filter::kSobel3, BorderMode::kZero));
+  }
+}
+
+TEST(mezhuev_m_sobel_edge_detection_mpi, test_sobel_options_match_single_process) {
+  boost::mpi::environment env;
+  boost::mpi::communicator world;
+
+  for (auto [height, width] : std::array<std::array<size_t, 2>, 3>{{{37, 61}, {6, 133}, {90, 17}}}) {
+    auto in = RandomImage(height, width, static_cast<unsigned>(height + width));
+    for (auto magnitude : {ppc::stencil::Magnitude::kL2, ppc::stencil::Magnitude::kL1}) {
+      for (bool non_max_suppression : {false, true}) {
+        const ppc::stencil::SobelOptions options{.magnitude = magnitude, .non_max_suppression = non_max_suppression};
+        std::vector<uint8_t> out(height * width, 0);
+        auto task_data = std::make_shared<ppc::core::TaskData>();
+        task_data->AddInput(in.data(), {height, width});
+        task_data->AddOutput(out.data(), {height, width});
+        mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection task(world, task_data, options);
+        ASSERT_TRUE(task.ValidationImpl() && task.PreProcessingImpl() && task.RunImpl());
+        if (world.rank() == 0) {
+          ASSERT_EQ(out, SobelImage(in, height, width, options))
+              << height << " x " << width << ", L" << (magnitude == ppc::stencil::Magnitude::kL2 ? 2 : 1)
+              << ", suppression " << non_max_suppression;
+        }
+      }
+    }
+  }
+}
+
+TEST(mezhuev_m_sobel_edge_detection_mpi, test_filters_match_single_process) {
+  boost::mpi::environment env;
+  boost::mpi::communicator world;
+
+  constexpr size_t kHeight = 45;
+  constexpr size_t kWidth = 67;
+  auto in = RandomImage(kHeight, kWidth, 7);
+  for (auto filter : {Filter::kSobel3, Filter::kSobel5, Filter::kScharr3, Filter::kBox3, Filter::kBox5,
+                      Filter::kGaussian3, Filter::kGaussian5}) {
+    for (auto border : {BorderMode::kZero, BorderMode::kReplicate}) {
+      auto out = RunStencilFilter(in, kHeight, kWidth, filter, border);
+      if (world.rank() == 0) {
+        ASSERT_EQ(out, FilterImage(in, kHeight, kWidth, filter, border))
+            << "filter " << static_cast<int>(filter) << ", border " << static_cast<int>(border);
+      }
+    }
+  }
+}
+
+TEST(mezhuev_m_sobel_edge_detection_mpi, test_wide_halo_and_small_images) {
+  boost::mpi::environment env;
+  boost::mpi::communicator world;
+
+  // a wider halo than the filter needs, thin images, an image smaller than the window
+  for (auto [height, width, halo] : {std::array<size_t, 3>{40, 40, 4}, std::array<size_t, 3>{3, 200, 2},
+                                     std::array<size_t, 3>{150, 2, 2}, std::array<size_t, 3>{2, 3, 2}}) {
+    auto in = RandomImage(height, width, static_cast<unsigned>(height + width));
+    auto out = RunStencilFilter(in, height, width, Filter::kGaussian5, BorderMode::kReplicate, halo);
+    if (world.rank() == 0) {
+      ASSERT_EQ(out, FilterImage(in, height, width, Filter::kGaussian5, BorderMode::kReplicate))
+          << height << " x " << width;
+    }
+  }
+}
+
+TEST(mezhuev_m_sobel_edge_detection_mpi, test_halo_narrower_than_filter) {
+  boost::mpi::environment env;
+
+  std::vector<uint8_t> in(100, 0);
+  std::vector<uint8_t> out(100, 0);
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->AddInput(in.data(), {10, 10});
+  task_data->AddOutput(out.data(), {10, 10});
+  mezhuev_m_sobel_edge_detection_mpi::StencilFilter task(task_data, Filter::kSobel5, BorderMode::kZero, 1);
+  ASSERT_FALSE(task.Validation());
+}
+
+TEST(mezhuev_m_sobel_edge_detection_mpi, test_chained_filters_stay_distributed) {
+  boost::mpi::environment env;
+  boost::mpi::communicator world;
+
+  constexpr size_t kHeight = 50;
+  constexpr size_t kWidth = 33;
+  auto in = RandomImage(kHeight, kWidth, 9);
+  std::vector<uint8_t> out(kHeight * kWidth, 0);
+  mezhuev_m_sobel_edge_detection_mpi::HaloStencil stencil(world, kHeight, kWidth, 2);
+  stencil.Scatter(in.data());
+  stencil.Apply(Filter::kGaussian5, BorderMode::kReplicate);
+  stencil.Next();
+  stencil.Apply(Filter::kSobel3, BorderMode::kZero);
+  stencil.Gather(out.data());
+
+  auto expected = FilterImage(FilterImage(in, kHeight, kWidth, Filter::kGaussian5, BorderMode::kReplicate), kHeight,
+                              kWidth, Filter::kSobel3, BorderMode::kZero);
+  if (world.rank() == 0) {
+    ASSERT_EQ(out, expected);
+  }
+  // every block is the matching part of the result
+  if (stencil.HasBlock()) {
+    for (size_t row = 0; row < stencil.BlockRows(); ++row) {
+      for (size_t col = 0; col < stencil.BlockCols(); ++col) {
+        ASSERT_EQ(stencil.Output()[(row * stencil.BlockCols()) + col],
+                  expected[((stencil.RowBegin() + row) * kWidth) + stencil.ColBegin() + col]);
+      }
+    }
+  }
+}
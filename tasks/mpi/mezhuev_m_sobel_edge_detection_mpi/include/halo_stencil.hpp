@@ -0,0 +1,87 @@
+#pragma once
+
+#include <boost/mpi/cartesian_communicator.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "core/stencil/include/stencil.hpp"
+
+namespace mezhuev_m_sobel_edge_detection_mpi {
+
+// What a filter sees beyond the edges of the image.
+enum class BorderMode : uint8_t {
+  kZero,       // nothing: the pixels whose window leaves the image are set to 0
+  kReplicate,  // the nearest pixel of the image
+};
+
+// A height x width image split into blocks over a 2-D Cartesian grid of
+// ranks, every block stored with a halo of halo pixels on each side.
+// The grid takes as many ranks as possible while every block keeps at least
+// halo rows and columns, so that halos only come from the 8 neighbours; the
+// other ranks hold no block and skip all calls.
+// Apply() sends the halo strips to the neighbours with nonblocking transfers
+// of subarray types, straight from and into the block buffers, and filters
+// the pixels whose window stays inside the block while they travel.
+class HaloStencil {
+ public:
+  // collective over world; halo: the largest radius of the filters to apply
+  HaloStencil(const boost::mpi::communicator& world, size_t height, size_t width, size_t halo);
+
+  // blocks of the image of rank 0
+  void Scatter(const uint8_t* image);
+  // filters the blocks into the output blocks; throws std::invalid_argument
+  // if the radius of the filter is larger than the halo
+  void Apply(ppc::stencil::Filter filter, BorderMode border);
+  // the same with ppc::stencil::Sobel, whose radius is SobelRadius(options)
+  void Apply(const ppc::stencil::SobelOptions& options, BorderMode border);
+  // makes the output of the last Apply() the input of the next one
+  void Next();
+  // output blocks into the image of rank 0
+  void Gather(uint8_t* image);
+
+  [[nodiscard]] bool HasBlock() const { return grid_.has_value(); }
+  [[nodiscard]] size_t GridRows() const { return grid_rows_; }
+  [[nodiscard]] size_t GridCols() const { return grid_cols_; }
+  // first row and column of the block of this rank, and its size
+  [[nodiscard]] size_t RowBegin() const { return row_begin_; }
+  [[nodiscard]] size_t ColBegin() const { return col_begin_; }
+  [[nodiscard]] size_t BlockRows() const { return block_rows_; }
+  [[nodiscard]] size_t BlockCols() const { return block_cols_; }
+  // output block of this rank, row-major
+  [[nodiscard]] std::span<const uint8_t> Output() const { return output_; }
+
+ private:
+  // filters a tile laid out as for ppc::stencil::ApplyFilter
+  using RegionKernel = std::function<void(const uint8_t* input, size_t input_stride, size_t rows, size_t cols,
+                                          uint8_t* output, size_t output_stride)>;
+
+  void ApplyKernel(size_t radius, BorderMode border, const RegionKernel& kernel);
+  void ApplyToRegion(const RegionKernel& kernel, size_t row_begin, size_t row_end, size_t col_begin, size_t col_end);
+  void ReplicateEdges(size_t radius);
+  void ZeroEdges(size_t radius);
+  [[nodiscard]] size_t Stride() const { return block_cols_ + (2 * halo_); }
+
+  boost::mpi::communicator world_;
+  std::optional<boost::mpi::cartesian_communicator> grid_;
+  size_t height_;
+  size_t width_;
+  size_t halo_;
+  size_t grid_rows_ = 1;
+  size_t grid_cols_ = 1;
+  size_t grid_row_ = 0;
+  size_t grid_col_ = 0;
+  size_t row_begin_ = 0;
+  size_t col_begin_ = 0;
+  size_t block_rows_ = 0;
+  size_t block_cols_ = 0;
+  // (block_rows_ + 2 halo_) x (block_cols_ + 2 halo_)
+  std::vector<uint8_t> block_;
+  std::vector<uint8_t> output_;
+};
+
+}  // namespace mezhuev_m_sobel_edge_detection_mpi
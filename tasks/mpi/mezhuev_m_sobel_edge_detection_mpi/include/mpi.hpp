@@ -1,31 +1,66 @@
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
-#include <vector>
 
+#include "core/stencil/include/stencil.hpp"
 #include "core/task/include/task.hpp"
+#include "mpi/mezhuev_m_sobel_edge_detection_mpi/include/halo_stencil.hpp"
 
 namespace mezhuev_m_sobel_edge_detection_mpi {
 
+// Sobel magnitude of a height x width image by ppc::stencil::Sobel, by
+// default min(sqrt(gx^2 + gy^2), 255); the pixels closer to the edges of the
+// image than SobelRadius(options) are 0. Runs on a HaloStencil.
 class SobelEdgeDetection : public ppc::core::Task {
  public:
-  SobelEdgeDetection(boost::mpi::communicator& world, std::shared_ptr<ppc::core::TaskData> task_data)
-      : Task(std::move(task_data)), world_(world) {}
+  SobelEdgeDetection(boost::mpi::communicator& world, std::shared_ptr<ppc::core::TaskData> task_data,
+                     ppc::stencil::SobelOptions options = {})
+      : Task(std::move(task_data)), world_(world), options_(options) {}
 
   bool ValidationImpl() override;
   bool PreProcessingImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
-  [[nodiscard]] const std::vector<int>& GetGradientX() const { return gradient_x_; }
-  [[nodiscard]] const std::vector<int>& GetGradientY() const { return gradient_y_; }
-
  private:
   boost::mpi::communicator& world_;
-  std::vector<int> gradient_x_;
-  std::vector<int> gradient_y_;
+  ppc::stencil::SobelOptions options_;
+  std::optional<HaloStencil> stencil_;
+  size_t height_ = 0;
+  size_t width_ = 0;
+};
+
+// One of the ppc::stencil filters of a height x width image on a
+// HaloStencil. inputs[0] and outputs[0]: the image, uint8_t with shape
+// {height, width}, on rank 0.
+class StencilFilter : public ppc::core::Task {
+ public:
+  // halo: 0 for the radius of the filter; a wider one is allowed
+  explicit StencilFilter(ppc::core::TaskDataPtr task_data, ppc::stencil::Filter filter,
+                         BorderMode border = BorderMode::kReplicate, size_t halo = 0)
+      : Task(std::move(task_data)),
+        filter_(filter),
+        border_(border),
+        halo_(halo == 0 ? ppc::stencil::Radius(filter) : halo) {}
+
+  bool ValidationImpl() override;
+  bool PreProcessingImpl() override;
+  bool RunImpl() override;
+  bool PostProcessingImpl() override;
+
+ private:
+  ppc::stencil::Filter filter_;
+  BorderMode border_;
+  size_t halo_;
+  boost::mpi::communicator world_;
+  std::optional<HaloStencil> stencil_;
+  size_t height_ = 0;
+  size_t width_ = 0;
 };
 
-}  // namespace mezhuev_m_sobel_edge_detection_mpi
\ No newline at end of file
+}  // namespace mezhuev_m_sobel_edge_detection_mpi
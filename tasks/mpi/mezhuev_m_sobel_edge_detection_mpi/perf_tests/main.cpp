@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <boost/mpi/environment.hpp>
@@ -7,10 +8,13 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "core/perf/include/perf.hpp"
+#include "core/stencil/include/stencil.hpp"
 #include "core/task/include/task.hpp"
+#include "core/util/include/util.hpp"
 #include "mpi/mezhuev_m_sobel_edge_detection_mpi/include/mpi.hpp"
 
 TEST(mezhuev_m_sobel_edge_detection_mpi, test_pipeline_run) {
@@ -31,10 +35,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_pipeline_run) {
   }
 
   auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
-  task_data_mpi->inputs.emplace_back(in.data());
-  task_data_mpi->inputs_count.emplace_back(kImageSize);
-  task_data_mpi->outputs.emplace_back(out.data());
-  task_data_mpi->outputs_count.emplace_back(kImageSize);
+  task_data_mpi->AddInput(in.data(), {kHeight, kWidth});
+  task_data_mpi->AddOutput(out.data(), {kHeight, kWidth});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data_mpi);
 
@@ -86,10 +88,8 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_task_run) {
   }
 
   auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
-  task_data_mpi->inputs.emplace_back(in.data());
-  task_data_mpi->inputs_count.emplace_back(kImageSize);
-  task_data_mpi->outputs.emplace_back(out.data());
-  task_data_mpi->outputs_count.emplace_back(kImageSize);
+  task_data_mpi->AddInput(in.data(), {kHeight, kWidth});
+  task_data_mpi->AddOutput(out.data(), {kHeight, kWidth});
 
   auto sobel_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::SobelEdgeDetection>(world, task_data_mpi);
 
@@ -122,3 +122,69 @@ TEST(mezhuev_m_sobel_edge_detection_mpi, test_task_run) {
     ASSERT_TRUE(has_edges);
   }
 }
+
+namespace {
+
+// image of GetScaledPerfSize(8192) rows of 8192 pixels through a StencilFilter, timed by run or by pipeline;
+// variant names the filter in the perf key (task_run.sobel5_8k)
+void RunFilterPerf(ppc::stencil::Filter filter, const std::string& variant, bool pipeline) {
+  boost::mpi::communicator world;
+
+  constexpr size_t kWidth = 8192;
+  const size_t height = ppc::util::GetScaledPerfSize(8192);
+
+  std::vector<uint8_t> in;
+  std::vector<uint8_t> out;
+  auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    in.resize(kWidth * height);
+    out.resize(kWidth * height);
+    for (size_t y = 0; y < height; ++y) {
+      for (size_t x = 0; x < kWidth; ++x) {
+        in[(y * kWidth) + x] = static_cast<uint8_t>(((x * x) + (3 * y)) % 256);
+      }
+    }
+    task_data_mpi->AddInput(in.data(), {height, kWidth});
+    task_data_mpi->AddOutput(out.data(), {height, kWidth});
+  }
+
+  auto filter_task = std::make_shared<mezhuev_m_sobel_edge_detection_mpi::StencilFilter>(task_data_mpi, filter);
+
+  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
+  perf_attr->num_running = 5;
+  const auto t0 = std::chrono::high_resolution_clock::now();
+  perf_attr->current_timer = [&] {
+    auto current_time_point = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(current_time_point - t0).count();
+    return static_cast<double>(duration) * 1e-9;
+  };
+
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+  perf_results->variant = variant;
+
+  auto perf_analyzer = std::make_shared<ppc::core::Perf>(filter_task);
+  if (pipeline) {
+    perf_analyzer->PipelineRun(perf_attr, perf_results);
+  } else {
+    perf_analyzer->TaskRun(perf_attr, perf_results);
+  }
+
+  if (world.rank() == 0) {
+    ppc::core::Perf::PrintPerfStatistic(perf_results);
+    ASSERT_TRUE(std::ranges::any_of(out, [](uint8_t val) { return val > 0; }));
+  }
+}
+
+}  // namespace
+
+TEST(mezhuev_m_sobel_edge_detection_mpi, test_pipeline_run_sobel5_8k) {
+  RunFilterPerf(ppc::stencil::Filter::kSobel5, "sobel5_8k", true);
+}
+
+TEST(mezhuev_m_sobel_edge_detection_mpi, test_task_run_sobel5_8k) {
+  RunFilterPerf(ppc::stencil::Filter::kSobel5, "sobel5_8k", false);
+}
+
+TEST(mezhuev_m_sobel_edge_detection_mpi, test_task_run_gaussian5_8k) {
+  RunFilterPerf(ppc::stencil::Filter::kGaussian5, "gaussian5_8k", false);
+}
@@ -0,0 +1,310 @@
+#include "mpi/mezhuev_m_sobel_edge_detection_mpi/include/halo_stencil.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <boost/mpi/cartesian_communicator.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "core/stencil/include/stencil.hpp"
+
+namespace {
+
+// start of part part when n is split into parts nearly equal parts
+size_t PartBegin(size_t n, size_t parts, size_t part) { return ((n / parts) * part) + std::min(part, n % parts); }
+
+// The largest grid of at most size ranks whose blocks keep min_block rows and
+// columns, with more blocks along the longer side of the image.
+std::pair<size_t, size_t> ChooseGrid(int size, size_t height, size_t width, size_t min_block) {
+  auto fits = [&](size_t n, size_t parts) { return parts == 1 || n / parts >= min_block; };
+  for (int ranks = size; ranks > 1; --ranks) {
+    std::array<int, 2> dims{0, 0};
+    MPI_Dims_create(ranks, 2, dims.data());
+    const auto larger = static_cast<size_t>(dims[0]);
+    const auto smaller = static_cast<size_t>(dims[1]);
+    const auto [rows, cols] = height >= width ? std::pair{larger, smaller} : std::pair{smaller, larger};
+    if (fits(height, rows) && fits(width, cols)) {
+      return {rows, cols};
+    }
+  }
+  return {1, 1};
+}
+
+struct Block {
+  size_t row_begin, row_end;
+  size_t col_begin, col_end;
+
+  [[nodiscard]] size_t Rows() const { return row_end - row_begin; }
+  [[nodiscard]] size_t Cols() const { return col_end - col_begin; }
+};
+
+Block Locate(size_t height, size_t width, size_t grid_rows, size_t grid_cols, const std::vector<int>& coords) {
+  const auto row = static_cast<size_t>(coords[0]);
+  const auto col = static_cast<size_t>(coords[1]);
+  return {.row_begin = PartBegin(height, grid_rows, row),
+          .row_end = PartBegin(height, grid_rows, row + 1),
+          .col_begin = PartBegin(width, grid_cols, col),
+          .col_end = PartBegin(width, grid_cols, col + 1)};
+}
+
+// region_rows x region_cols bytes at (row_begin, col_begin) of a rows x cols buffer
+MPI_Datatype CreateRegionType(size_t rows, size_t cols, size_t row_begin, size_t col_begin, size_t region_rows,
+                              size_t region_cols) {
+  const std::array<int, 2> sizes{static_cast<int>(rows), static_cast<int>(cols)};
+  const std::array<int, 2> subsizes{static_cast<int>(region_rows), static_cast<int>(region_cols)};
+  const std::array<int, 2> starts{static_cast<int>(row_begin), static_cast<int>(col_begin)};
+  MPI_Datatype region = MPI_DATATYPE_NULL;
+  MPI_Type_create_subarray(2, sizes.data(), subsizes.data(), starts.data(), MPI_ORDER_C, MPI_UINT8_T, &region);
+  MPI_Type_commit(&region);
+  return region;
+}
+
+}  // namespace
+
+mezhuev_m_sobel_edge_detection_mpi::HaloStencil::HaloStencil(const boost::mpi::communicator& world, size_t height,
+                                                             size_t width, size_t halo)
+    : world_(world), height_(height), width_(width), halo_(halo) {
+  std::tie(grid_rows_, grid_cols_) = ChooseGrid(world_.size(), height_, width_, std::max<size_t>(halo_, 1));
+  const bool in_grid = static_cast<size_t>(world_.rank()) < grid_rows_ * grid_cols_;
+  // split keeps the order of the ranks, so grid ranks are world ranks
+  const auto members = world_.split(in_grid ? 0 : 1);
+  if (!in_grid) {
+    return;
+  }
+  grid_.emplace(members,
+                boost::mpi::cartesian_topology({boost::mpi::cartesian_dimension(static_cast<int>(grid_rows_)),
+                                                boost::mpi::cartesian_dimension(static_cast<int>(grid_cols_))}));
+  const auto coords = grid_->coordinates(grid_->rank());
+  grid_row_ = static_cast<size_t>(coords[0]);
+  grid_col_ = static_cast<size_t>(coords[1]);
+  const auto block = Locate(height_, width_, grid_rows_, grid_cols_, coords);
+  row_begin_ = block.row_begin;
+  col_begin_ = block.col_begin;
+  block_rows_ = block.Rows();
+  block_cols_ = block.Cols();
+  block_.assign((block_rows_ + (2 * halo_)) * Stride(), 0);
+  output_.assign(block_rows_ * block_cols_, 0);
+}
+
+void mezhuev_m_sobel_edge_detection_mpi::HaloStencil::Scatter(const uint8_t* image) {
+  if (!grid_) {
+    return;
+  }
+  std::vector<uint8_t> packed;
+  std::vector<int> counts;
+  std::vector<int> displacements;
+  if (grid_->rank() == 0) {
+    packed.reserve(height_ * width_);
+    for (int proc = 0; proc < grid_->size(); ++proc) {
+      const auto block = Locate(height_, width_, grid_rows_, grid_cols_, grid_->coordinates(proc));
+      displacements.push_back(static_cast<int>(packed.size()));
+      counts.push_back(static_cast<int>(block.Rows() * block.Cols()));
+      for (size_t row = block.row_begin; row < block.row_end; ++row) {
+        const uint8_t* line = image + (row * width_);
+        packed.insert(packed.end(), line + block.col_begin, line + block.col_end);
+      }
+    }
+  }
+  // received straight into the block buffer, inside the halo
+  MPI_Datatype interior =
+      CreateRegionType(block_rows_ + (2 * halo_), Stride(), halo_, halo_, block_rows_, block_cols_);
+  MPI_Scatterv(packed.data(), counts.data(), displacements.data(), MPI_UINT8_T, block_.data(), 1, interior, 0,
+               *grid_);
+  MPI_Type_free(&interior);
+}
+
+void mezhuev_m_sobel_edge_detection_mpi::HaloStencil::Apply(ppc::stencil::Filter filter, BorderMode border) {
+  ApplyKernel(ppc::stencil::Radius(filter), border,
+              [filter](const uint8_t* input, size_t input_stride, size_t rows, size_t cols, uint8_t* output,
+                       size_t output_stride) {
+                ppc::stencil::ApplyFilter(filter, input, input_stride, rows, cols, output, output_stride);
+              });
+}
+
+void mezhuev_m_sobel_edge_detection_mpi::HaloStencil::Apply(const ppc::stencil::SobelOptions& options,
+                                                            BorderMode border) {
+  ApplyKernel(ppc::stencil::SobelRadius(options), border,
+              [&options](const uint8_t* input, size_t input_stride, size_t rows, size_t cols, uint8_t* output,
+                         size_t output_stride) {
+                ppc::stencil::Sobel(input, input_stride, rows, cols, output, output_stride, options);
+              });
+}
+
+void mezhuev_m_sobel_edge_detection_mpi::HaloStencil::ApplyKernel(size_t radius, BorderMode border,
+                                                                  const RegionKernel& kernel) {
+  if (radius > halo_) {
+    throw std::invalid_argument("HaloStencil: the radius of the filter is larger than the halo");
+  }
+  if (!grid_) {
+    return;
+  }
+
+  // strips of radius rows or columns towards the 8 neighbours; a strip is
+  // sent with the tag of its direction, the opposite direction has tag 7 - tag
+  const size_t buffer_rows = block_rows_ + (2 * halo_);
+  // (begin, size) along one axis of the strip towards step: own pixels, or the halo beyond them
+  auto strip = [&](int step, size_t size, bool own) -> std::pair<size_t, size_t> {
+    if (step == 0) {
+      return {halo_, size};
+    }
+    if (step < 0) {
+      return {own ? halo_ : halo_ - radius, radius};
+    }
+    return {own ? halo_ + size - radius : halo_ + size, radius};
+  };
+  std::vector<MPI_Request> requests;
+  std::vector<MPI_Datatype> types;
+  int tag = 0;
+  for (int row_step = -1; row_step <= 1; ++row_step) {
+    for (int col_step = -1; col_step <= 1; ++col_step) {
+      if (row_step == 0 && col_step == 0) {
+        continue;
+      }
+      const int neighbour_row = static_cast<int>(grid_row_) + row_step;
+      const int neighbour_col = static_cast<int>(grid_col_) + col_step;
+      if (neighbour_row >= 0 && neighbour_row < static_cast<int>(grid_rows_) && neighbour_col >= 0 &&
+          neighbour_col < static_cast<int>(grid_cols_)) {
+        const int neighbour = grid_->rank(std::vector<int>{neighbour_row, neighbour_col});
+        for (bool own : {false, true}) {
+          const auto [row_begin, rows] = strip(row_step, block_rows_, own);
+          const auto [col_begin, cols] = strip(col_step, block_cols_, own);
+          types.push_back(CreateRegionType(buffer_rows, Stride(), row_begin, col_begin, rows, cols));
+          requests.emplace_back();
+          if (own) {
+            MPI_Isend(block_.data(), 1, types.back(), neighbour, tag, *grid_, &requests.back());
+          } else {
+            MPI_Irecv(block_.data(), 1, types.back(), neighbour, 7 - tag, *grid_, &requests.back());
+          }
+        }
+      }
+      ++tag;
+    }
+  }
+
+  // the pixels whose window stays in the block while the halo travels
+  const bool has_inner = block_rows_ > 2 * radius && block_cols_ > 2 * radius;
+  if (has_inner) {
+    ApplyToRegion(kernel, radius, block_rows_ - radius, radius, block_cols_ - radius);
+  }
+  MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+  for (auto& type : types) {
+    MPI_Type_free(&type);
+  }
+  if (border == BorderMode::kReplicate) {
+    ReplicateEdges(radius);
+  }
+  if (has_inner) {
+    ApplyToRegion(kernel, 0, radius, 0, block_cols_);
+    ApplyToRegion(kernel, block_rows_ - radius, block_rows_, 0, block_cols_);
+    ApplyToRegion(kernel, radius, block_rows_ - radius, 0, radius);
+    ApplyToRegion(kernel, radius, block_rows_ - radius, block_cols_ - radius, block_cols_);
+  } else {
+    ApplyToRegion(kernel, 0, block_rows_, 0, block_cols_);
+  }
+  if (border == BorderMode::kZero) {
+    ZeroEdges(radius);
+  }
+}
+
+void mezhuev_m_sobel_edge_detection_mpi::HaloStencil::ApplyToRegion(const RegionKernel& kernel, size_t row_begin,
+                                                                    size_t row_end, size_t col_begin,
+                                                                    size_t col_end) {
+  kernel(block_.data() + ((halo_ + row_begin) * Stride()) + halo_ + col_begin, Stride(), row_end - row_begin,
+         col_end - col_begin, output_.data() + (row_begin * block_cols_) + col_begin, block_cols_);
+}
+
+// Fills the halo beyond the edges of the image with the nearest pixels:
+// first left and right along all rows, then whole rows up and down, which
+// also fills the corners.
+void mezhuev_m_sobel_edge_detection_mpi::HaloStencil::ReplicateEdges(size_t radius) {
+  const size_t stride = Stride();
+  const bool top = grid_row_ == 0;
+  const bool bottom = grid_row_ + 1 == grid_rows_;
+  const bool left = grid_col_ == 0;
+  const bool right = grid_col_ + 1 == grid_cols_;
+  for (size_t row = halo_ - radius; row < halo_ + block_rows_ + radius; ++row) {
+    uint8_t* line = block_.data() + (row * stride);
+    if (left) {
+      std::fill_n(line + halo_ - radius, radius, line[halo_]);
+    }
+    if (right) {
+      std::fill_n(line + halo_ + block_cols_, radius, line[halo_ + block_cols_ - 1]);
+    }
+  }
+  const size_t first_col = halo_ - radius;
+  const size_t cols = block_cols_ + (2 * radius);
+  const uint8_t* first_row = block_.data() + (halo_ * stride) + first_col;
+  const uint8_t* last_row = block_.data() + ((halo_ + block_rows_ - 1) * stride) + first_col;
+  for (size_t i = 1; i <= radius; ++i) {
+    if (top) {
+      std::copy_n(first_row, cols, block_.data() + ((halo_ - i) * stride) + first_col);
+    }
+    if (bottom) {
+      std::copy_n(last_row, cols, block_.data() + ((halo_ + block_rows_ - 1 + i) * stride) + first_col);
+    }
+  }
+}
+
+// output pixels closer than radius to an edge of the image
+void mezhuev_m_sobel_edge_detection_mpi::HaloStencil::ZeroEdges(size_t radius) {
+  const size_t edge_rows = std::min(radius, block_rows_);
+  const size_t edge_cols = std::min(radius, block_cols_);
+  if (grid_row_ == 0) {
+    std::fill_n(output_.begin(), edge_rows * block_cols_, 0);
+  }
+  if (grid_row_ + 1 == grid_rows_) {
+    std::fill_n(output_.end() - static_cast<std::ptrdiff_t>(edge_rows * block_cols_), edge_rows * block_cols_, 0);
+  }
+  for (size_t row = 0; row < block_rows_; ++row) {
+    uint8_t* line = output_.data() + (row * block_cols_);
+    if (grid_col_ == 0) {
+      std::fill_n(line, edge_cols, 0);
+    }
+    if (grid_col_ + 1 == grid_cols_) {
+      std::fill_n(line + block_cols_ - edge_cols, edge_cols, 0);
+    }
+  }
+}
+
+void mezhuev_m_sobel_edge_detection_mpi::HaloStencil::Next() {
+  for (size_t row = 0; row < block_rows_; ++row) {
+    std::copy_n(output_.data() + (row * block_cols_), block_cols_,
+                block_.data() + ((halo_ + row) * Stride()) + halo_);
+  }
+}
+
+void mezhuev_m_sobel_edge_detection_mpi::HaloStencil::Gather(uint8_t* image) {
+  if (!grid_) {
+    return;
+  }
+  std::vector<uint8_t> packed;
+  std::vector<int> counts;
+  std::vector<int> displacements;
+  std::vector<Block> blocks;
+  if (grid_->rank() == 0) {
+    packed.resize(height_ * width_);
+    int displacement = 0;
+    for (int proc = 0; proc < grid_->size(); ++proc) {
+      blocks.push_back(Locate(height_, width_, grid_rows_, grid_cols_, grid_->coordinates(proc)));
+      counts.push_back(static_cast<int>(blocks[proc].Rows() * blocks[proc].Cols()));
+      displacements.push_back(displacement);
+      displacement += counts[proc];
+    }
+  }
+  MPI_Gatherv(output_.data(), static_cast<int>(output_.size()), MPI_UINT8_T, packed.data(), counts.data(),
+              displacements.data(), MPI_UINT8_T, 0, *grid_);
+  const uint8_t* source = packed.data();
+  for (const auto& block : blocks) {
+    for (size_t row = block.row_begin; row < block.row_end; ++row) {
+      std::copy_n(source, block.Cols(), image + (row * width_) + block.col_begin);
+      source += block.Cols();
+    }
+  }
+}
@@ -1,11 +1,12 @@
 #include "mpi/mezhuev_m_sobel_edge_detection_mpi/include/mpi.hpp"
 
-#include <algorithm>
+#include <boost/mpi/collectives/broadcast.hpp>
 #include <boost/mpi/communicator.hpp>
-#include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <vector>
+
+#include "core/stencil/include/stencil.hpp"
+#include "mpi/mezhuev_m_sobel_edge_detection_mpi/include/halo_stencil.hpp"
 
 namespace mezhuev_m_sobel_edge_detection_mpi {
 
@@ -23,16 +24,18 @@ bool SobelEdgeDetection::PreProcessingImpl() {
     return false;
   }
 
-  size_t data_size = task_data->inputs_count[0];
-  auto width = static_cast<size_t>(std::sqrt(data_size));
-  size_t height = width;
+  auto shape = task_data->InputShape(0);
+  if (shape.size() != 2) {
+    return false;
+  }
+  height_ = shape[0];
+  width_ = shape[1];
 
-  if (width < 3 || height < 3) {
+  if (width_ < 3 || height_ < 3) {
     return false;
   }
 
-  gradient_x_.resize(data_size);
-  gradient_y_.resize(data_size);
+  stencil_.emplace(world_, height_, width_, ppc::stencil::SobelRadius(options_));
   return true;
 }
 
@@ -49,74 +52,17 @@ bool SobelEdgeDetection::ValidationImpl() {
   if (task_data->inputs_count.empty() || task_data->outputs_count.empty()) {
     return false;
   }
-  return task_data->inputs_count[0] == task_data->outputs_count[0];
+  return task_data->InputShape(0) == task_data->OutputShape(0);
 }
 
 bool SobelEdgeDetection::RunImpl() {
   if (!task_data || task_data->inputs.empty() || task_data->outputs.empty() || task_data->inputs_count.empty() ||
-      task_data->outputs_count.empty()) {
-    return false;
-  }
-  int rank = world_.rank();
-  int size = world_.size();
-  auto width = static_cast<size_t>(std::sqrt(task_data->inputs_count[0]));
-  auto height = width;
-  if (height < 3 || width < 3) {
+      task_data->outputs_count.empty() || !stencil_) {
     return false;
   }
-
-  uint8_t* input = task_data->inputs[0];
-  uint8_t* output = task_data->outputs[0];
-
-  size_t rows_per_proc = height / size;
-  size_t extra_rows = height % size;
-  size_t start_row = (rank * rows_per_proc) + std::min(rank, static_cast<int>(extra_rows));
-  size_t end_row = ((rank + 1) * rows_per_proc) + std::min(rank + 1, static_cast<int>(extra_rows));
-
-  auto exchange_boundaries = [&](int rank, int size) {
-    if (rank > 0) {
-      world_.send(rank - 1, 0, input + (start_row * width), static_cast<int>(width));
-      world_.recv(rank - 1, 0, input + ((start_row - 1) * width), static_cast<int>(width));
-    }
-    if (rank < size - 1) {
-      world_.recv(rank + 1, 0, input + (end_row * width), static_cast<int>(width));
-      world_.send(rank + 1, 0, input + ((end_row - 1) * width), static_cast<int>(width));
-    }
-  };
-  exchange_boundaries(rank, size);
-
-  auto apply_sobel = [&](size_t y, size_t x) -> uint8_t {
-    static constexpr int kSobelX[3][3] = {{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}};
-    static constexpr int kSobelY[3][3] = {{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}};
-
-    int gx = 0;
-    int gy = 0;
-    for (int ky = -1; ky <= 1; ++ky) {
-      for (int kx = -1; kx <= 1; ++kx) {
-        uint8_t pixel = input[((y + ky) * width) + (x + kx)];
-        gx += kSobelX[ky + 1][kx + 1] * pixel;
-        gy += kSobelY[ky + 1][kx + 1] * pixel;
-      }
-    }
-    return static_cast<uint8_t>(std::min(std::sqrt((gx * gx) + (gy * gy)), 255.0));
-  };
-
-  for (size_t y = std::max(start_row, size_t(1)); y < std::min(end_row, height - 1); ++y) {
-    for (size_t x = 1; x < width - 1; ++x) {
-      output[(y * width) + x] = apply_sobel(y, x);
-    }
-  }
-
-  if (rank == 0) {
-    for (int i = 1; i < size; ++i) {
-      size_t ws = (i * rows_per_proc) + std::min(i, static_cast<int>(extra_rows));
-      size_t we = ((i + 1) * rows_per_proc) + std::min(i + 1, static_cast<int>(extra_rows));
-      world_.recv(i, 0, output + (ws * width), static_cast<int>((we - ws) * width));
-    }
-  } else {
-    world_.send(0, 0, output + (start_row * width), static_cast<int>((end_row - start_row) * width));
-  }
-
+  stencil_->Scatter(task_data->inputs[0]);
+  stencil_->Apply(options_, BorderMode::kZero);
+  stencil_->Gather(task_data->outputs[0]);
   return true;
 }
 
@@ -136,4 +82,41 @@ bool SobelEdgeDetection::PostProcessingImpl() {
   return true;
 }
 
+bool StencilFilter::ValidationImpl() {
+  if (halo_ < ppc::stencil::Radius(filter_)) {
+    return false;
+  }
+  if (world_.rank() != 0) {
+    return true;
+  }
+  if (task_data->inputs.size() != 1 || task_data->outputs.size() != 1 || task_data->inputs[0] == nullptr ||
+      task_data->outputs[0] == nullptr) {
+    return false;
+  }
+  auto shape = task_data->InputShape(0);
+  return shape.size() == 2 && shape[0] > 0 && shape[1] > 0 && shape == task_data->OutputShape(0);
+}
+
+bool StencilFilter::PreProcessingImpl() {
+  if (world_.rank() == 0) {
+    auto shape = task_data->InputShape(0);
+    height_ = shape[0];
+    width_ = shape[1];
+  }
+  boost::mpi::broadcast(world_, height_, 0);
+  boost::mpi::broadcast(world_, width_, 0);
+  stencil_.emplace(world_, height_, width_, halo_);
+  return true;
+}
+
+bool StencilFilter::RunImpl() {
+  const bool root = world_.rank() == 0;
+  stencil_->Scatter(root ? task_data->inputs[0] : nullptr);
+  stencil_->Apply(filter_, border_);
+  stencil_->Gather(root ? task_data->outputs[0] : nullptr);
+  return true;
+}
+
+bool StencilFilter::PostProcessingImpl() { return true; }
+
 }  // namespace mezhuev_m_sobel_edge_detection_mpi
@@ -12,15 +12,16 @@
 
 #include "core/perf/include/perf.hpp"
 #include "core/task/include/task.hpp"
+#include "core/util/include/util.hpp"
 #include "mpi/muradov_k_radix_sort/include/ops_mpi.hpp"
 
 TEST(muradov_k_radix_sort_mpi, test_pipeline_run) {
-  constexpr int kN = 256 * 1024;
+  const auto n = static_cast<int>(ppc::util::GetScaledPerfSize(256 * 1024));
   int proc_rank = 0;
   MPI_Comm_rank(MPI_COMM_WORLD, &proc_rank);
-  std::vector<int> input(kN);
+  std::vector<int> input(n);
   std::srand(static_cast<unsigned int>(std::time(nullptr)));
-  for (int i = 0; i < kN; ++i) {
+  for (int i = 0; i < n; ++i) {
     input[i] = std::rand() % 1000;
   }
   std::vector<int> output(input.size(), 0);
@@ -51,12 +52,12 @@ TEST(muradov_k_radix_sort_mpi, test_pipeline_run) {
 }
 
 TEST(muradov_k_radix_sort_mpi, test_task_run) {
-  constexpr int kN = 20480;
+  const auto n = static_cast<int>(ppc::util::GetScaledPerfSize(20480));
   int proc_rank = 0;
   MPI_Comm_rank(MPI_COMM_WORLD, &proc_rank);
-  std::vector<int> input(kN);
+  std::vector<int> input(n);
   std::srand(static_cast<unsigned int>(std::time(nullptr)));
-  for (int i = 0; i < kN; ++i) {
+  for (int i = 0; i < n; ++i) {
     input[i] = std::rand() % 1000;
   }
   std::vector<int> output(input.size(), 0);
@@ -12,9 +12,9 @@ namespace muradov_k_radix_sort {
 
 namespace {
 
-void CountingSortForRadix(std::vector<int>& arr, int exp) {
+// stable scatter of arr into output by the digit at exp
+void CountingSortForRadix(const std::vector<int>& arr, std::vector<int>& output, int exp) {
   int n = static_cast<int>(arr.size());
-  std::vector<int> output(n);
   int count[10] = {0};
   for (int i = 0; i < n; ++i) {
     int digit = (arr[i] / exp) % 10;
@@ -28,9 +28,6 @@ void CountingSortForRadix(std::vector<int>& arr, int exp) {
     output[count[digit] - 1] = arr[i];
     count[digit]--;
   }
-  for (int i = 0; i < n; ++i) {
-    arr[i] = output[i];
-  }
 }
 
 void LSDRadixSort(std::vector<int>& arr) {
@@ -38,8 +35,11 @@ void LSDRadixSort(std::vector<int>& arr) {
     return;
   }
   int max_val = *std::ranges::max_element(arr);
+  // one buffer for all digits, the roles of arr and output swap every pass
+  std::vector<int> output(arr.size());
   for (int exp = 1; max_val / exp > 0; exp *= 10) {
-    CountingSortForRadix(arr, exp);
+    CountingSortForRadix(arr, output, exp);
+    arr.swap(output);
   }
 }
 
@@ -4,6 +4,8 @@
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <climits>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
@@ -13,6 +15,7 @@
 
 #include "core/task/include/task.hpp"
 #include "mpi/opolin_d_cg_method/include/ops_mpi.hpp"
+#include "mpi/opolin_d_cg_method/include/sparse_cg.hpp"
 
 namespace opolin_d_cg_method_mpi {
 namespace {
@@ -48,6 +51,53 @@ void GenDataCgMethod(size_t size, std::vector<double> &a, std::vector<double> &b
     }
   }
 }
+
+void AddSparseTaskData(const CsrMatrix &a, std::vector<double> &b, double &epsilon, std::vector<double> &x,
+                       ppc::core::TaskData &task_data) {
+  task_data.inputs.emplace_back(reinterpret_cast<uint8_t *>(const_cast<uint64_t *>(a.row_offsets.data())));
+  task_data.inputs_count.emplace_back(a.row_offsets.size());
+  task_data.inputs.emplace_back(reinterpret_cast<uint8_t *>(const_cast<uint32_t *>(a.columns.data())));
+  task_data.inputs_count.emplace_back(a.columns.size());
+  task_data.inputs.emplace_back(reinterpret_cast<uint8_t *>(const_cast<double *>(a.values.data())));
+  task_data.inputs_count.emplace_back(a.values.size());
+  task_data.inputs.emplace_back(reinterpret_cast<uint8_t *>(b.data()));
+  task_data.inputs_count.emplace_back(b.size());
+  task_data.inputs.emplace_back(reinterpret_cast<uint8_t *>(&epsilon));
+  task_data.inputs_count.emplace_back(1);
+  task_data.outputs.emplace_back(reinterpret_cast<uint8_t *>(x.data()));
+  task_data.outputs_count.emplace_back(x.size());
+}
+
+// solves A x = A x_ref and compares x with x_ref
+void CheckSparse(const CsrMatrix &a, Preconditioner preconditioner) {
+  boost::mpi::communicator world;
+  double epsilon = 1e-10;
+  std::vector<double> x_ref(a.rows);
+  std::vector<double> b(a.rows, 0.0);
+  for (size_t i = 0; i < a.rows; ++i) {
+    x_ref[i] = std::sin(static_cast<double>(i));
+  }
+  for (size_t i = 0; i < a.rows; ++i) {
+    for (uint64_t k = a.row_offsets[i]; k < a.row_offsets[i + 1]; ++k) {
+      b[i] += a.values[k] * x_ref[a.columns[k]];
+    }
+  }
+  std::vector<double> x_out(a.rows, 0.0);
+  auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    AddSparseTaskData(a, b, epsilon, x_out, *task_data_mpi);
+  }
+  SparseCGMethodMPI test_task_parallel(task_data_mpi, preconditioner);
+  ASSERT_EQ(test_task_parallel.Validation(), true);
+  test_task_parallel.PreProcessing();
+  ASSERT_EQ(test_task_parallel.Run(), true);
+  test_task_parallel.PostProcessing();
+  if (world.rank() == 0) {
+    for (size_t i = 0; i < x_ref.size(); ++i) {
+      ASSERT_NEAR(x_ref[i], x_out[i], 1e-6);
+    }
+  }
+}
 }  // namespace
 }  // namespace opolin_d_cg_method_mpi
 
@@ -310,4 +360,82 @@ TEST(opolin_d_cg_method_mpi, test_single_element) {
       ASSERT_NEAR(x_ref[i], x_out[i], 1e-3);
     }
   }
-}
\ No newline at end of file
+}
+
+TEST(opolin_d_cg_method_mpi, test_cheap_validation_skips_cholesky) {
+  boost::mpi::communicator world;
+  int size = 2;
+  double epsilon = 1e-8;
+  // symmetric with a positive diagonal, but indefinite
+  std::vector<double> a = {1.0, 2.0, 2.0, 1.0};
+  std::vector<double> b = {1.0, 0.0};
+  std::vector<double> x_out(size, 0.0);
+  auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(a.data()));
+    task_data_mpi->inputs_count.emplace_back(x_out.size());
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(b.data()));
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(&epsilon));
+    task_data_mpi->outputs.emplace_back(reinterpret_cast<uint8_t *>(x_out.data()));
+    task_data_mpi->outputs_count.emplace_back(x_out.size());
+    opolin_d_cg_method_mpi::CGMethodkMPI full_task(task_data_mpi);
+    ASSERT_EQ(full_task.Validation(), false);
+  }
+  opolin_d_cg_method_mpi::CGMethodkMPI cheap_task(task_data_mpi, opolin_d_cg_method_mpi::ValidationMode::kCheap);
+  ASSERT_EQ(cheap_task.Validation(), true);
+  cheap_task.PreProcessing();
+  ASSERT_EQ(cheap_task.Run(), false);
+}
+
+TEST(opolin_d_cg_method_mpi, test_sparse_poisson_2d) {
+  opolin_d_cg_method_mpi::CheckSparse(opolin_d_cg_method_mpi::Poisson2D(12),
+                                      opolin_d_cg_method_mpi::Preconditioner::kNone);
+}
+
+TEST(opolin_d_cg_method_mpi, test_sparse_poisson_2d_jacobi) {
+  opolin_d_cg_method_mpi::CheckSparse(opolin_d_cg_method_mpi::Poisson2D(13),
+                                      opolin_d_cg_method_mpi::Preconditioner::kJacobi);
+}
+
+TEST(opolin_d_cg_method_mpi, test_sparse_poisson_2d_ic0) {
+  opolin_d_cg_method_mpi::CheckSparse(opolin_d_cg_method_mpi::Poisson2D(11),
+                                      opolin_d_cg_method_mpi::Preconditioner::kBlockJacobiIc0);
+}
+
+TEST(opolin_d_cg_method_mpi, test_sparse_poisson_3d_ic0) {
+  opolin_d_cg_method_mpi::CheckSparse(opolin_d_cg_method_mpi::Poisson3D(6),
+                                      opolin_d_cg_method_mpi::Preconditioner::kBlockJacobiIc0);
+}
+
+TEST(opolin_d_cg_method_mpi, test_sparse_single_row) {
+  opolin_d_cg_method_mpi::CheckSparse(opolin_d_cg_method_mpi::Poisson2D(1),
+                                      opolin_d_cg_method_mpi::Preconditioner::kBlockJacobiIc0);
+}
+
+TEST(opolin_d_cg_method_mpi, test_sparse_validation) {
+  boost::mpi::communicator world;
+  if (world.rank() == 0) {
+    double epsilon = 1e-8;
+    std::vector<double> b(4, 1.0);
+    std::vector<double> x_out(4, 0.0);
+    auto a = opolin_d_cg_method_mpi::Poisson2D(2);
+    // not symmetric: only the full validation looks at the values
+    a.values[1] = -2.0;
+    auto task_data = std::make_shared<ppc::core::TaskData>();
+    opolin_d_cg_method_mpi::AddSparseTaskData(a, b, epsilon, x_out, *task_data);
+    opolin_d_cg_method_mpi::SparseCGMethodMPI full_task(task_data);
+    EXPECT_EQ(full_task.Validation(), false);
+    opolin_d_cg_method_mpi::SparseCGMethodMPI cheap_task(task_data, opolin_d_cg_method_mpi::Preconditioner::kJacobi,
+                                                         opolin_d_cg_method_mpi::ValidationMode::kCheap);
+    EXPECT_EQ(cheap_task.Validation(), true);
+
+    // broken offsets fail in both modes
+    a.row_offsets[2] = a.row_offsets[1] - 1;
+    auto broken_task_data = std::make_shared<ppc::core::TaskData>();
+    opolin_d_cg_method_mpi::AddSparseTaskData(a, b, epsilon, x_out, *broken_task_data);
+    opolin_d_cg_method_mpi::SparseCGMethodMPI broken_task(broken_task_data,
+                                                          opolin_d_cg_method_mpi::Preconditioner::kJacobi,
+                                                          opolin_d_cg_method_mpi::ValidationMode::kCheap);
+    EXPECT_EQ(broken_task.Validation(), false);
+  }
+}
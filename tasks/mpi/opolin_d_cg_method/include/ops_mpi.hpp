@@ -4,6 +4,8 @@
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <cstddef>
+#include <cstdint>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -11,13 +13,20 @@
 
 namespace opolin_d_cg_method_mpi {
 
+// kFull proves that A is positive definite (Cholesky, O(n^3) for dense A);
+// kCheap checks only the necessary conditions: symmetry and a positive diagonal.
+// A matrix that passes kCheap but is not positive definite makes Run() return false.
+enum class ValidationMode : uint8_t { kFull, kCheap };
+
 bool IsPositiveDefinite(const std::vector<double>& mat, size_t size);
 bool IsSimmetric(const std::vector<double>& mat, size_t size);
-double ScalarProduct(const std::vector<double>& a, const std::vector<double>& b);
+bool HasPositiveDiagonal(const std::vector<double>& mat, size_t size);
+double ScalarProduct(std::span<const double> a, std::span<const double> b);
 
 class CGMethodkMPI : public ppc::core::Task {
  public:
-  explicit CGMethodkMPI(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
+  explicit CGMethodkMPI(ppc::core::TaskDataPtr task_data, ValidationMode validation_mode = ValidationMode::kFull)
+      : Task(std::move(task_data)), validation_mode_(validation_mode) {}
   bool PreProcessingImpl() override;
   bool ValidationImpl() override;
   bool RunImpl() override;
@@ -29,6 +38,7 @@ class CGMethodkMPI : public ppc::core::Task {
   std::vector<double> x_;
   size_t n_;
   double epsilon_;
+  ValidationMode validation_mode_;
   boost::mpi::communicator world_;
 };
 
@@ -0,0 +1,105 @@
+// Copyright 2024 Nesterov Alexander
+#pragma once
+
+#include <boost/mpi/communicator.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "core/task/include/task.hpp"
+#include "mpi/opolin_d_cg_method/include/ops_mpi.hpp"
+
+namespace opolin_d_cg_method_mpi {
+
+// square matrix in compressed sparse rows
+struct CsrMatrix {
+  size_t rows = 0;
+  std::vector<uint64_t> row_offsets;  // rows + 1 entries
+  std::vector<uint32_t> columns;      // sorted within a row
+  std::vector<double> values;
+};
+
+// 5-point (2-D) and 7-point (3-D) Laplacian on an n x n (x n) grid, Dirichlet boundary
+CsrMatrix Poisson2D(size_t n);
+CsrMatrix Poisson3D(size_t n);
+
+enum class Preconditioner : uint8_t { kNone, kJacobi, kBlockJacobiIc0 };
+
+// CG for a sparse symmetric positive definite A in CSR.
+// inputs: row_offsets (uint64_t), columns (uint32_t), values, b, epsilon;
+// inputs_count: rows + 1, nnz, nnz, rows, 1; outputs: x, outputs_count: rows.
+// Ranks own contiguous row strips. SpMV sends each rank only the entries of the
+// vector its strip references (ghosts) and computes the rows without ghosts
+// while they travel. Preconditioners are local to a strip: Jacobi, or IC(0) of
+// the diagonal block of the strip (block Jacobi).
+// Validation: kCheap checks the CSR offsets only (O(n)); kFull also checks
+// columns, a positive diagonal and symmetry (O(nnz log nnz)). Positive
+// definiteness is not checked up front, Run() returns false on a breakdown.
+class SparseCGMethodMPI : public ppc::core::Task {
+ public:
+  explicit SparseCGMethodMPI(ppc::core::TaskDataPtr task_data,
+                             Preconditioner preconditioner = Preconditioner::kBlockJacobiIc0,
+                             ValidationMode validation_mode = ValidationMode::kFull)
+      : Task(std::move(task_data)), preconditioner_(preconditioner), validation_mode_(validation_mode) {}
+  bool PreProcessingImpl() override;
+  bool ValidationImpl() override;
+  bool RunImpl() override;
+  bool PostProcessingImpl() override;
+
+ private:
+  void DistributeRows();
+  void SetupGhosts();
+  bool SetupPreconditioner();
+  // out = A v; v holds the own entries followed by the ghosts, the ghosts are received here
+  void Multiply(std::span<double> v, std::span<double> out);
+  void ApplyPreconditioner(std::span<const double> r, std::span<double> z) const;
+
+  Preconditioner preconditioner_;
+  ValidationMode validation_mode_;
+
+  // root: the whole system
+  std::span<const uint64_t> row_offsets_;
+  std::span<const uint32_t> columns_;
+  std::span<const double> values_;
+  std::span<const double> b_;
+  std::vector<double> x_;
+  size_t n_ = 0;
+  double epsilon_ = 0.0;
+
+  // rows of every rank
+  std::vector<int> row_counts_;
+  std::vector<int> row_displs_;
+
+  // own strip; columns are local: own rows first, then ghosts
+  size_t local_n_ = 0;
+  std::vector<uint64_t> local_offsets_;
+  std::vector<uint32_t> local_columns_;
+  std::vector<double> local_values_;
+  std::vector<double> local_b_;
+  std::vector<uint32_t> interior_rows_;
+  std::vector<uint32_t> boundary_rows_;
+
+  // ghost exchange: (rank, count, offset) of every neighbour
+  struct Neighbour {
+    int rank;
+    int count;
+    int offset;
+  };
+  std::vector<Neighbour> recv_from_;
+  std::vector<Neighbour> send_to_;
+  std::vector<uint32_t> send_rows_;
+  std::vector<double> send_buffer_;
+  size_t ghost_count_ = 0;
+
+  // preconditioner: inverted diagonal or IC(0) factor L of the diagonal block (lower rows, diagonal last)
+  std::vector<double> inv_diagonal_;
+  std::vector<uint64_t> factor_offsets_;
+  std::vector<uint32_t> factor_columns_;
+  std::vector<double> factor_values_;
+
+  boost::mpi::communicator world_;
+};
+
+}  // namespace opolin_d_cg_method_mpi
@@ -2,8 +2,11 @@
 #include <gtest/gtest.h>
 
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/collectives/all_gather.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
@@ -13,7 +16,9 @@
 
 #include "core/perf/include/perf.hpp"
 #include "core/task/include/task.hpp"
+#include "core/util/include/util.hpp"
 #include "mpi/opolin_d_cg_method/include/ops_mpi.hpp"
+#include "mpi/opolin_d_cg_method/include/sparse_cg.hpp"
 
 namespace opolin_d_cg_method_mpi {
 namespace {
@@ -49,6 +54,59 @@ void GenDataCgMethod(size_t size, std::vector<double> &a, std::vector<double> &b
     }
   }
 }
+
+// b = A * 1, TaskRun of the sparse solver, checks x = 1 on the root
+void RunSparsePerf(const CsrMatrix &a) {
+  boost::mpi::communicator world;
+  double epsilon = 1e-10;
+  std::vector<double> b(a.rows, 0.0);
+  for (size_t i = 0; i < a.rows; ++i) {
+    for (uint64_t k = a.row_offsets[i]; k < a.row_offsets[i + 1]; ++k) {
+      b[i] += a.values[k];
+    }
+  }
+  std::vector<double> out(a.rows, 0.0);
+  auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(const_cast<uint64_t *>(a.row_offsets.data())));
+    task_data_mpi->inputs_count.emplace_back(a.row_offsets.size());
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(const_cast<uint32_t *>(a.columns.data())));
+    task_data_mpi->inputs_count.emplace_back(a.columns.size());
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(const_cast<double *>(a.values.data())));
+    task_data_mpi->inputs_count.emplace_back(a.values.size());
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(b.data()));
+    task_data_mpi->inputs_count.emplace_back(b.size());
+    task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(&epsilon));
+    task_data_mpi->inputs_count.emplace_back(1);
+    task_data_mpi->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+    task_data_mpi->outputs_count.emplace_back(out.size());
+  }
+  auto test_task_mpi = std::make_shared<SparseCGMethodMPI>(task_data_mpi, Preconditioner::kBlockJacobiIc0,
+                                                           ValidationMode::kCheap);
+  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
+  perf_attr->num_running = 10;
+  const auto t0 = std::chrono::high_resolution_clock::now();
+  perf_attr->current_timer = [&] {
+    auto current_time_point = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(current_time_point - t0).count();
+    return static_cast<double>(duration) * 1e-9;
+  };
+  perf_attr->barrier = [&] { world.barrier(); };
+  perf_attr->gather_samples = [&](const std::vector<double> &local_samples) {
+    std::vector<double> all_samples(local_samples.size() * world.size());
+    boost::mpi::all_gather(world, local_samples.data(), static_cast<int>(local_samples.size()), all_samples.data());
+    return all_samples;
+  };
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+  auto perf_analyzer = std::make_shared<ppc::core::Perf>(test_task_mpi);
+  perf_analyzer->TaskRun(perf_attr, perf_results);
+  if (world.rank() == 0) {
+    ppc::core::Perf::PrintPerfStatistic(perf_results);
+    for (size_t i = 0; i < out.size(); ++i) {
+      ASSERT_NEAR(out[i], 1.0, 1e-6);
+    }
+  }
+}
 }  // namespace
 }  // namespace opolin_d_cg_method_mpi
 
@@ -88,6 +146,12 @@ TEST(opolin_d_cg_method_mpi, test_pipeline_run) {
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(current_time_point - t0).count();
     return static_cast<double>(duration) * 1e-9;
   };
+  perf_attr->barrier = [&] { world.barrier(); };
+  perf_attr->gather_samples = [&](const std::vector<double> &local_samples) {
+    std::vector<double> all_samples(local_samples.size() * world.size());
+    boost::mpi::all_gather(world, local_samples.data(), static_cast<int>(local_samples.size()), all_samples.data());
+    return all_samples;
+  };
 
   // Create and init perf results
   auto perf_results = std::make_shared<ppc::core::PerfResults>();
@@ -134,6 +198,12 @@ TEST(opolin_d_cg_method_mpi, test_task_run) {
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(current_time_point - t0).count();
     return static_cast<double>(duration) * 1e-9;
   };
+  perf_attr->barrier = [&] { world.barrier(); };
+  perf_attr->gather_samples = [&](const std::vector<double> &local_samples) {
+    std::vector<double> all_samples(local_samples.size() * world.size());
+    boost::mpi::all_gather(world, local_samples.data(), static_cast<int>(local_samples.size()), all_samples.data());
+    return all_samples;
+  };
   auto perf_results = std::make_shared<ppc::core::PerfResults>();
   // Create Perf attributes
   auto perf_analyzer = std::make_shared<ppc::core::Perf>(test_task_mpi);
@@ -142,4 +212,17 @@ TEST(opolin_d_cg_method_mpi, test_task_run) {
   if (world.rank() == 0) {
     ppc::core::Perf::PrintPerfStatistic(perf_results);
   }
-}
\ No newline at end of file
+}
+
+// PPC_PERF_SCALE=16 gives 10^6 unknowns and more: a 1024 x 1024 and a 121^3 grid
+TEST(opolin_d_cg_method_mpi, test_sparse_poisson_2d_task_run) {
+  const auto unknowns = static_cast<double>(ppc::util::GetScaledPerfSize(256 * 256));
+  opolin_d_cg_method_mpi::RunSparsePerf(
+      opolin_d_cg_method_mpi::Poisson2D(static_cast<size_t>(std::lround(std::sqrt(unknowns)))));
+}
+
+TEST(opolin_d_cg_method_mpi, test_sparse_poisson_3d_task_run) {
+  const auto unknowns = static_cast<double>(ppc::util::GetScaledPerfSize(48 * 48 * 48));
+  opolin_d_cg_method_mpi::RunSparsePerf(
+      opolin_d_cg_method_mpi::Poisson3D(static_cast<size_t>(std::lround(std::cbrt(unknowns)))));
+}
@@ -1,15 +1,18 @@
 // Copyright 2024 Nesterov Alexander
 #include "mpi/opolin_d_cg_method/include/ops_mpi.hpp"
 
+#include <mpi.h>
+
 #include <algorithm>
+#include <array>
+#include <boost/mpi/collectives/all_gatherv.hpp>
 #include <boost/mpi/collectives/broadcast.hpp>
 #include <boost/mpi/collectives/gatherv.hpp>
-#include <boost/mpi/collectives/reduce.hpp>
 #include <boost/mpi/collectives/scatterv.hpp>
 #include <boost/serialization/vector.hpp>  // NOLINT(misc-include-cleaner)
 #include <cmath>
 #include <cstddef>
-#include <functional>
+#include <span>
 #include <vector>
 
 bool opolin_d_cg_method_mpi::CGMethodkMPI::PreProcessingImpl() {
@@ -42,16 +45,20 @@ bool opolin_d_cg_method_mpi::CGMethodkMPI::ValidationImpl() {
     auto* ptr = reinterpret_cast<double*>(task_data->inputs[0]);
     A_.assign(ptr, ptr + (n_ * n_));
 
-    if (!IsSimmetric(A_, n_)) {
+    if (!IsSimmetric(A_, n_) || !HasPositiveDiagonal(A_, n_)) {
       return false;
     }
-    if (!IsPositiveDefinite(A_, n_)) {
+    if (validation_mode_ == ValidationMode::kFull && !IsPositiveDefinite(A_, n_)) {
       return false;
     }
   }
   return true;
 }
 
+namespace {
+constexpr size_t kReplacementPeriod = 50;
+}  // namespace
+
 bool opolin_d_cg_method_mpi::CGMethodkMPI::RunImpl() {
   int rank = world_.rank();
   int size = world_.size();
@@ -62,99 +69,115 @@ bool opolin_d_cg_method_mpi::CGMethodkMPI::RunImpl() {
   if (rank < static_cast<int>(n_ % size)) {
     ++local_n;
   }
-  std::vector<int> send_counts;
-  std::vector<int> displs;
+  // row counts are needed on every rank for the allgatherv of the search direction
+  std::vector<int> send_counts(size);
+  std::vector<int> displs(size);
   std::vector<int> send_counts_a;
   std::vector<int> displs_a;
+  size_t offset = 0;
+  for (int i = 0; i < size; ++i) {
+    size_t rows = (n_ / size) + static_cast<size_t>(i < static_cast<int>(n_ % size));
+    send_counts[i] = static_cast<int>(rows);
+    displs[i] = static_cast<int>(offset);
+    offset += rows;
+  }
   if (rank == 0) {
-    send_counts.resize(size);
-    displs.resize(size);
     send_counts_a.resize(size);
     displs_a.resize(size);
-
-    size_t offset = 0;
-    size_t offset_a = 0;
     for (int i = 0; i < size; ++i) {
-      size_t rows = (n_ / size) + static_cast<size_t>(i < static_cast<int>(n_ % size));
-      send_counts[i] = static_cast<int>(rows);
-      displs[i] = static_cast<int>(offset);
-      offset += rows;
-
-      send_counts_a[i] = static_cast<int>(rows * n_);
-      displs_a[i] = static_cast<int>(offset_a);
-      offset_a += rows * n_;
+      send_counts_a[i] = static_cast<int>(send_counts[i] * n_);
+      displs_a[i] = static_cast<int>(displs[i] * n_);
     }
   }
-  std::vector<double> local_a(local_n * n_);
-  if (rank == 0) {
-    boost::mpi::scatterv(world_, A_.data(), send_counts_a, displs_a, local_a.data(), static_cast<int>(local_n * n_), 0);
-  } else {
-    boost::mpi::scatterv(world_, local_a.data(), static_cast<int>(local_n * n_), 0);
-  }
-  std::vector<double> local_b(local_n);
-  if (rank == 0) {
-    boost::mpi::scatterv(world_, b_.data(), send_counts, displs, local_b.data(), static_cast<int>(local_n), 0);
-  } else {
-    boost::mpi::scatterv(world_, local_b.data(), static_cast<int>(local_n), 0);
-  }
-  std::vector<double> local_x(local_n, 0.0);
-  std::vector<double> local_r = local_b;
-  std::vector<double> local_p = local_r;
-  std::vector<double> local_ap(local_n);
-  std::vector<double> full_p(n_);
-
-  double rsquare_prev = 0.0;
-  while (true) {
-    double local_rsquare = opolin_d_cg_method_mpi::ScalarProduct(local_r, local_r);
-    double rsquare_k = 0.0;
-    boost::mpi::reduce(world_, local_rsquare, rsquare_k, std::plus<>(), 0);
-    boost::mpi::broadcast(world_, rsquare_k, 0);
-
-    rsquare_prev = rsquare_k;
+  // working vectors live in the scratch arena, so repeated runs do not allocate
+  auto local_a = Scratch().AllocateArray<double>(local_n * n_);
+  auto local_b = Scratch().AllocateArray<double>(local_n);
+  {
+    auto scope = OpenScope("scatter");
     if (rank == 0) {
-      boost::mpi::gatherv(world_, local_p.data(), static_cast<int>(local_n), full_p.data(), send_counts, displs, 0);
+      boost::mpi::scatterv(world_, A_.data(), send_counts_a, displs_a, local_a.data(), static_cast<int>(local_n * n_),
+                           0);
+      boost::mpi::scatterv(world_, b_.data(), send_counts, displs, local_b.data(), static_cast<int>(local_n), 0);
     } else {
-      boost::mpi::gatherv(world_, local_p.data(), static_cast<int>(local_n), 0);
+      boost::mpi::scatterv(world_, local_a.data(), static_cast<int>(local_n * n_), 0);
+      boost::mpi::scatterv(world_, local_b.data(), static_cast<int>(local_n), 0);
     }
-    boost::mpi::broadcast(world_, full_p, 0);
-
-    for (size_t i = 0; i < local_n; ++i) {
-      local_ap[i] = 0.0;
-      for (size_t j = 0; j < n_; ++j) {
-        local_ap[i] += local_a[(i * n_) + j] * full_p[j];
-      }
-    }
-
-    // p^T * A * p
-    double local_p_ap = opolin_d_cg_method_mpi::ScalarProduct(local_p, local_ap);
-    double p_ap = 0.0;
-    boost::mpi::reduce(world_, local_p_ap, p_ap, std::plus<>(), 0);
-    boost::mpi::broadcast(world_, p_ap, 0);
-
-    // alpha_k
-    double alpha_k = rsquare_prev / p_ap;
-
+  }
+  auto local_x = Scratch().AllocateArray<double>(local_n);
+  auto local_r = Scratch().AllocateArray<double>(local_n);
+  auto local_w = Scratch().AllocateArray<double>(local_n);
+  auto local_aw = Scratch().AllocateArray<double>(local_n);
+  auto local_p = Scratch().AllocateArray<double>(local_n);
+  auto local_s = Scratch().AllocateArray<double>(local_n);
+  auto local_z = Scratch().AllocateArray<double>(local_n);
+  auto full_v = Scratch().AllocateArray<double>(n_);
+
+  // local rows of A times the vector gathered from all ranks
+  auto multiply = [&](std::span<const double> local_v, std::span<double> out) {
+    boost::mpi::all_gatherv(world_, local_v.data(), full_v.data(), send_counts, displs);
     for (size_t i = 0; i < local_n; ++i) {
-      // x_k+1
-      local_x[i] += alpha_k * local_p[i];
-      // r_k+1
-      local_r[i] -= alpha_k * local_ap[i];
+      out[i] = ScalarProduct(local_a.subspan(i * n_, n_), full_v);
     }
-
-    local_rsquare = opolin_d_cg_method_mpi::ScalarProduct(local_r, local_r);
-    rsquare_k = 0.0;
-    boost::mpi::reduce(world_, local_rsquare, rsquare_k, std::plus<>(), 0);
-    boost::mpi::broadcast(world_, rsquare_k, 0);
-
-    if (sqrt(rsquare_k) < epsilon_) {
-      break;
-    }
-    double beta_k = rsquare_k / rsquare_prev;
-    for (size_t i = 0; i < local_n; ++i) {
-      local_p[i] = local_r[i] + beta_k * local_p[i];
+  };
+
+  // Pipelined CG (Ghysels, Vanroose): w = A r, s = A p and z = A s are updated by
+  // recurrences, so both dot products of an iteration go into one nonblocking
+  // allreduce that is overlapped with the only matvec, A w
+  {
+    auto scope = OpenScope("iterations");
+    std::ranges::copy(local_b, local_r.begin());
+    multiply(local_r, local_w);
+    double gamma_prev = 0.0;
+    double alpha = 0.0;
+    for (size_t iteration = 0;; ++iteration) {
+      if (iteration > 0 && iteration % kReplacementPeriod == 0) {
+        // residual replacement: the recurrences drift from b - A x in rounding
+        multiply(local_x, local_r);
+        for (size_t i = 0; i < local_n; ++i) {
+          local_r[i] = local_b[i] - local_r[i];
+        }
+        multiply(local_r, local_w);
+        multiply(local_p, local_s);
+        multiply(local_s, local_z);
+      }
+      std::array<double, 2> local_dots{ScalarProduct(local_r, local_r), ScalarProduct(local_w, local_r)};
+      std::array<double, 2> dots{};
+      MPI_Request request = MPI_REQUEST_NULL;
+      MPI_Iallreduce(local_dots.data(), dots.data(), 2, MPI_DOUBLE, MPI_SUM, world_, &request);
+      multiply(local_w, local_aw);
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+      const double gamma = dots[0];
+      const double delta = dots[1];
+      if (std::sqrt(gamma) < epsilon_) {
+        break;
+      }
+      // p^T * A * p
+      double beta = 0.0;
+      double p_ap = delta;
+      if (iteration > 0) {
+        beta = gamma / gamma_prev;
+        p_ap = delta - (beta * gamma / alpha);
+      }
+      if (p_ap <= 0.0) {
+        // A is not positive definite, only ValidationMode::kCheap lets such a matrix through
+        return false;
+      }
+      alpha = gamma / p_ap;
+      gamma_prev = gamma;
+
+      for (size_t i = 0; i < local_n; ++i) {
+        local_z[i] = local_aw[i] + (beta * local_z[i]);
+        local_s[i] = local_w[i] + (beta * local_s[i]);
+        local_p[i] = local_r[i] + (beta * local_p[i]);
+        local_x[i] += alpha * local_p[i];
+        local_r[i] -= alpha * local_s[i];
+        local_w[i] -= alpha * local_z[i];
+      }
     }
   }
 
+  auto scope = OpenScope("gather");
   x_.resize(n_);
   boost::mpi::gatherv(world_, local_x.data(), static_cast<int>(local_n), x_.data(), send_counts, displs, 0);
 
@@ -195,6 +218,15 @@ bool opolin_d_cg_method_mpi::IsPositiveDefinite(const std::vector<double>& mat,
   return true;
 }
 
+bool opolin_d_cg_method_mpi::HasPositiveDiagonal(const std::vector<double>& mat, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    if (mat[(i * size) + i] <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool opolin_d_cg_method_mpi::IsSimmetric(const std::vector<double>& mat, size_t size) {
   bool simetric = true;
   for (size_t i = 0; i < size; i++) {
@@ -209,7 +241,7 @@ bool opolin_d_cg_method_mpi::IsSimmetric(const std::vector<double>& mat, size_t
   return simetric;
 }
 
-double opolin_d_cg_method_mpi::ScalarProduct(const std::vector<double>& a, const std::vector<double>& b) {
+double opolin_d_cg_method_mpi::ScalarProduct(std::span<const double> a, std::span<const double> b) {
   size_t size = a.size();
   double result = 0.0;
   for (size_t i = 0; i < size; i++) {
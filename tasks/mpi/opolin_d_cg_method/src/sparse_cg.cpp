@@ -0,0 +1,488 @@
+// Copyright 2024 Nesterov Alexander
+#include "mpi/opolin_d_cg_method/include/sparse_cg.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/all_to_all.hpp>
+#include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/collectives/gatherv.hpp>
+#include <boost/mpi/collectives/scatterv.hpp>
+#include <boost/mpi/nonblocking.hpp>
+#include <boost/mpi/operations.hpp>
+#include <boost/mpi/request.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace {
+
+void AddRow(opolin_d_cg_method_mpi::CsrMatrix& matrix, std::span<const std::pair<uint32_t, double>> entries) {
+  for (const auto& [column, value] : entries) {
+    matrix.columns.push_back(column);
+    matrix.values.push_back(value);
+  }
+  matrix.row_offsets.push_back(matrix.columns.size());
+}
+
+}  // namespace
+
+opolin_d_cg_method_mpi::CsrMatrix opolin_d_cg_method_mpi::Poisson2D(size_t n) {
+  CsrMatrix matrix;
+  matrix.rows = n * n;
+  matrix.row_offsets.reserve(matrix.rows + 1);
+  matrix.columns.reserve(5 * matrix.rows);
+  matrix.values.reserve(5 * matrix.rows);
+  matrix.row_offsets.push_back(0);
+  std::vector<std::pair<uint32_t, double>> entries;
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      const auto id = static_cast<uint32_t>((i * n) + j);
+      entries.clear();
+      if (i > 0) {
+        entries.emplace_back(id - n, -1.0);
+      }
+      if (j > 0) {
+        entries.emplace_back(id - 1, -1.0);
+      }
+      entries.emplace_back(id, 4.0);
+      if (j + 1 < n) {
+        entries.emplace_back(id + 1, -1.0);
+      }
+      if (i + 1 < n) {
+        entries.emplace_back(id + n, -1.0);
+      }
+      AddRow(matrix, entries);
+    }
+  }
+  return matrix;
+}
+
+opolin_d_cg_method_mpi::CsrMatrix opolin_d_cg_method_mpi::Poisson3D(size_t n) {
+  CsrMatrix matrix;
+  matrix.rows = n * n * n;
+  matrix.row_offsets.reserve(matrix.rows + 1);
+  matrix.columns.reserve(7 * matrix.rows);
+  matrix.values.reserve(7 * matrix.rows);
+  matrix.row_offsets.push_back(0);
+  const auto plane = static_cast<uint32_t>(n * n);
+  std::vector<std::pair<uint32_t, double>> entries;
+  for (size_t k = 0; k < n; ++k) {
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < n; ++j) {
+        const auto id = static_cast<uint32_t>((k * n * n) + (i * n) + j);
+        entries.clear();
+        if (k > 0) {
+          entries.emplace_back(id - plane, -1.0);
+        }
+        if (i > 0) {
+          entries.emplace_back(id - n, -1.0);
+        }
+        if (j > 0) {
+          entries.emplace_back(id - 1, -1.0);
+        }
+        entries.emplace_back(id, 6.0);
+        if (j + 1 < n) {
+          entries.emplace_back(id + 1, -1.0);
+        }
+        if (i + 1 < n) {
+          entries.emplace_back(id + n, -1.0);
+        }
+        if (k + 1 < n) {
+          entries.emplace_back(id + plane, -1.0);
+        }
+        AddRow(matrix, entries);
+      }
+    }
+  }
+  return matrix;
+}
+
+bool opolin_d_cg_method_mpi::SparseCGMethodMPI::PreProcessingImpl() {
+  if (world_.rank() == 0) {
+    row_offsets_ = task_data->InputView<const uint64_t>(0).Span();
+    columns_ = task_data->InputView<const uint32_t>(1).Span();
+    values_ = task_data->InputView<const double>(2).Span();
+    b_ = task_data->InputView<const double>(3).Span();
+    epsilon_ = *reinterpret_cast<double*>(task_data->inputs[4]);
+  }
+  return true;
+}
+
+bool opolin_d_cg_method_mpi::SparseCGMethodMPI::ValidationImpl() {
+  if (world_.rank() != 0) {
+    return true;
+  }
+  if (task_data->inputs.size() != 5 || task_data->inputs_count.size() != 5 || task_data->outputs.empty() ||
+      task_data->outputs_count.empty()) {
+    return false;
+  }
+  const auto& counts = task_data->inputs_count;
+  if (counts[0] < 2 || counts[1] != counts[2] || counts[3] != counts[0] - 1 ||
+      task_data->outputs_count[0] != counts[3]) {
+    return false;
+  }
+  n_ = counts[3];
+  const auto* offsets = reinterpret_cast<const uint64_t*>(task_data->inputs[0]);
+  if (offsets[0] != 0 || offsets[n_] != counts[1] || !std::is_sorted(offsets, offsets + n_ + 1)) {
+    return false;
+  }
+  if (validation_mode_ == ValidationMode::kCheap) {
+    return true;
+  }
+
+  const auto* columns = reinterpret_cast<const uint32_t*>(task_data->inputs[1]);
+  const auto* values = reinterpret_cast<const double*>(task_data->inputs[2]);
+  auto find = [&](uint64_t row, uint32_t column) -> const double* {
+    const auto* begin = columns + offsets[row];
+    const auto* end = columns + offsets[row + 1];
+    const auto* it = std::lower_bound(begin, end, column);
+    return it != end && *it == column ? values + (it - columns) : nullptr;
+  };
+  for (uint64_t row = 0; row < n_; ++row) {
+    for (uint64_t k = offsets[row]; k < offsets[row + 1]; ++k) {
+      if (columns[k] >= n_ || (k > offsets[row] && columns[k] <= columns[k - 1])) {
+        return false;
+      }
+    }
+    const auto* diagonal = find(row, static_cast<uint32_t>(row));
+    if (diagonal == nullptr || *diagonal <= 0.0) {
+      return false;
+    }
+    for (uint64_t k = offsets[row]; k < offsets[row + 1]; ++k) {
+      const auto* mirror = find(columns[k], static_cast<uint32_t>(row));
+      if (mirror == nullptr || *mirror != values[k]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void opolin_d_cg_method_mpi::SparseCGMethodMPI::DistributeRows() {
+  const int size = world_.size();
+  const int rank = world_.rank();
+  row_counts_.assign(size, 0);
+  row_displs_.assign(size, 0);
+  int offset = 0;
+  for (int i = 0; i < size; ++i) {
+    row_counts_[i] = static_cast<int>((n_ / size) + static_cast<size_t>(i < static_cast<int>(n_ % size)));
+    row_displs_[i] = offset;
+    offset += row_counts_[i];
+  }
+  local_n_ = row_counts_[rank];
+
+  // nnz of every strip
+  std::vector<int> nnz_counts(size);
+  std::vector<int> nnz_displs(size);
+  if (rank == 0) {
+    for (int i = 0; i < size; ++i) {
+      nnz_displs[i] = static_cast<int>(row_offsets_[row_displs_[i]]);
+      nnz_counts[i] = static_cast<int>(row_offsets_[row_displs_[i] + row_counts_[i]]) - nnz_displs[i];
+    }
+  }
+  boost::mpi::broadcast(world_, nnz_counts.data(), size, 0);
+
+  // a strip takes local_n_ + 1 offsets, neighbouring strips share one
+  std::vector<int> offset_counts(size);
+  for (int i = 0; i < size; ++i) {
+    offset_counts[i] = row_counts_[i] + 1;
+  }
+  local_offsets_.resize(local_n_ + 1);
+  local_columns_.resize(nnz_counts[rank]);
+  local_values_.resize(nnz_counts[rank]);
+  local_b_.resize(local_n_);
+  if (rank == 0) {
+    boost::mpi::scatterv(world_, row_offsets_.data(), offset_counts, row_displs_, local_offsets_.data(),
+                         static_cast<int>(local_offsets_.size()), 0);
+    boost::mpi::scatterv(world_, columns_.data(), nnz_counts, nnz_displs, local_columns_.data(),
+                         static_cast<int>(local_columns_.size()), 0);
+    boost::mpi::scatterv(world_, values_.data(), nnz_counts, nnz_displs, local_values_.data(),
+                         static_cast<int>(local_values_.size()), 0);
+    boost::mpi::scatterv(world_, b_.data(), row_counts_, row_displs_, local_b_.data(), static_cast<int>(local_n_), 0);
+  } else {
+    boost::mpi::scatterv(world_, local_offsets_.data(), static_cast<int>(local_offsets_.size()), 0);
+    boost::mpi::scatterv(world_, local_columns_.data(), static_cast<int>(local_columns_.size()), 0);
+    boost::mpi::scatterv(world_, local_values_.data(), static_cast<int>(local_values_.size()), 0);
+    boost::mpi::scatterv(world_, local_b_.data(), static_cast<int>(local_n_), 0);
+  }
+  const uint64_t base = local_offsets_[0];
+  for (auto& row_offset : local_offsets_) {
+    row_offset -= base;
+  }
+}
+
+void opolin_d_cg_method_mpi::SparseCGMethodMPI::SetupGhosts() {
+  const int size = world_.size();
+  const auto row_begin = static_cast<uint32_t>(row_displs_[world_.rank()]);
+  const auto row_end = static_cast<uint32_t>(row_begin + local_n_);
+
+  // columns of other strips, sorted, so that the ghosts of one owner are contiguous
+  std::vector<uint32_t> ghosts;
+  for (auto column : local_columns_) {
+    if (column < row_begin || column >= row_end) {
+      ghosts.push_back(column);
+    }
+  }
+  std::ranges::sort(ghosts);
+  const auto [last, end] = std::ranges::unique(ghosts);
+  ghosts.erase(last, end);
+  ghost_count_ = ghosts.size();
+
+  for (auto& column : local_columns_) {
+    if (column >= row_begin && column < row_end) {
+      column -= row_begin;
+    } else {
+      column = static_cast<uint32_t>(local_n_ + (std::ranges::lower_bound(ghosts, column) - ghosts.begin()));
+    }
+  }
+  interior_rows_.clear();
+  boundary_rows_.clear();
+  for (size_t row = 0; row < local_n_; ++row) {
+    const auto first = local_columns_.begin() + static_cast<std::ptrdiff_t>(local_offsets_[row]);
+    const auto last_column = local_columns_.begin() + static_cast<std::ptrdiff_t>(local_offsets_[row + 1]);
+    const bool interior = std::all_of(first, last_column, [&](uint32_t column) { return column < local_n_; });
+    (interior ? interior_rows_ : boundary_rows_).push_back(static_cast<uint32_t>(row));
+  }
+
+  // who owns the ghosts, and which own rows the others need
+  std::vector<int> recv_counts(size, 0);
+  for (auto ghost : ghosts) {
+    const auto owner = std::ranges::upper_bound(row_displs_, static_cast<int>(ghost)) - row_displs_.begin() - 1;
+    ++recv_counts[owner];
+  }
+  std::vector<int> send_counts(size);
+  boost::mpi::all_to_all(world_, recv_counts, send_counts);
+  std::vector<int> recv_displs(size, 0);
+  std::vector<int> send_displs(size, 0);
+  for (int i = 1; i < size; ++i) {
+    recv_displs[i] = recv_displs[i - 1] + recv_counts[i - 1];
+    send_displs[i] = send_displs[i - 1] + send_counts[i - 1];
+  }
+  send_rows_.resize(std::accumulate(send_counts.begin(), send_counts.end(), size_t{0}));
+  MPI_Alltoallv(ghosts.data(), recv_counts.data(), recv_displs.data(), MPI_UINT32_T, send_rows_.data(),
+                send_counts.data(), send_displs.data(), MPI_UINT32_T, world_);
+  for (auto& row : send_rows_) {
+    row -= row_begin;
+  }
+  send_buffer_.resize(send_rows_.size());
+
+  recv_from_.clear();
+  send_to_.clear();
+  for (int i = 0; i < size; ++i) {
+    if (recv_counts[i] > 0) {
+      recv_from_.push_back({.rank = i, .count = recv_counts[i], .offset = recv_displs[i]});
+    }
+    if (send_counts[i] > 0) {
+      send_to_.push_back({.rank = i, .count = send_counts[i], .offset = send_displs[i]});
+    }
+  }
+}
+
+bool opolin_d_cg_method_mpi::SparseCGMethodMPI::SetupPreconditioner() {
+  auto diagonal_position = [&](size_t row) -> int64_t {
+    for (uint64_t k = local_offsets_[row]; k < local_offsets_[row + 1]; ++k) {
+      if (local_columns_[k] == row) {
+        return static_cast<int64_t>(k);
+      }
+    }
+    return -1;
+  };
+
+  if (preconditioner_ == Preconditioner::kJacobi) {
+    inv_diagonal_.resize(local_n_);
+    for (size_t row = 0; row < local_n_; ++row) {
+      const auto k = diagonal_position(row);
+      if (k < 0 || local_values_[k] <= 0.0) {
+        return false;
+      }
+      inv_diagonal_[row] = 1.0 / local_values_[k];
+    }
+  }
+  if (preconditioner_ != Preconditioner::kBlockJacobiIc0) {
+    return true;
+  }
+
+  // lower triangle of the diagonal block; own columns keep their order, so the diagonal is last
+  factor_offsets_.assign(1, 0);
+  factor_columns_.clear();
+  factor_values_.clear();
+  for (size_t row = 0; row < local_n_; ++row) {
+    for (uint64_t k = local_offsets_[row]; k < local_offsets_[row + 1]; ++k) {
+      if (local_columns_[k] <= row) {
+        factor_columns_.push_back(local_columns_[k]);
+        factor_values_.push_back(local_values_[k]);
+      }
+    }
+    factor_offsets_.push_back(factor_columns_.size());
+    if (factor_columns_.size() == factor_offsets_[row] || factor_columns_.back() != row ||
+        factor_values_.back() <= 0.0) {
+      return false;
+    }
+  }
+
+  // IC(0): L L^T = A on the pattern of the lower triangle
+  for (size_t row = 0; row < local_n_; ++row) {
+    const uint64_t begin = factor_offsets_[row];
+    const uint64_t diagonal = factor_offsets_[row + 1] - 1;
+    for (uint64_t t = begin; t < diagonal; ++t) {
+      const uint32_t column = factor_columns_[t];
+      const uint64_t column_diagonal = factor_offsets_[column + 1] - 1;
+      double sum = factor_values_[t];
+      uint64_t a = begin;
+      uint64_t b = factor_offsets_[column];
+      while (a < t && b < column_diagonal) {
+        if (factor_columns_[a] == factor_columns_[b]) {
+          sum -= factor_values_[a++] * factor_values_[b++];
+        } else if (factor_columns_[a] < factor_columns_[b]) {
+          ++a;
+        } else {
+          ++b;
+        }
+      }
+      factor_values_[t] = sum / factor_values_[column_diagonal];
+    }
+    double pivot = factor_values_[diagonal];
+    for (uint64_t t = begin; t < diagonal; ++t) {
+      pivot -= factor_values_[t] * factor_values_[t];
+    }
+    // IC(0) may break down for matrices that are not M-matrices; keep the diagonal of A then
+    factor_values_[diagonal] = std::sqrt(pivot > 0.0 ? pivot : factor_values_[diagonal]);
+  }
+  return true;
+}
+
+void opolin_d_cg_method_mpi::SparseCGMethodMPI::Multiply(std::span<double> v, std::span<double> out) {
+  std::vector<boost::mpi::request> requests;
+  requests.reserve(recv_from_.size() + send_to_.size());
+  for (const auto& neighbour : recv_from_) {
+    requests.push_back(world_.irecv(neighbour.rank, 0, v.data() + local_n_ + neighbour.offset, neighbour.count));
+  }
+  for (size_t k = 0; k < send_rows_.size(); ++k) {
+    send_buffer_[k] = v[send_rows_[k]];
+  }
+  for (const auto& neighbour : send_to_) {
+    requests.push_back(world_.isend(neighbour.rank, 0, send_buffer_.data() + neighbour.offset, neighbour.count));
+  }
+
+  auto row_product = [&](uint32_t row) {
+    double sum = 0.0;
+    for (uint64_t k = local_offsets_[row]; k < local_offsets_[row + 1]; ++k) {
+      sum += local_values_[k] * v[local_columns_[k]];
+    }
+    out[row] = sum;
+  };
+  std::ranges::for_each(interior_rows_, row_product);
+  boost::mpi::wait_all(requests.begin(), requests.end());
+  std::ranges::for_each(boundary_rows_, row_product);
+}
+
+void opolin_d_cg_method_mpi::SparseCGMethodMPI::ApplyPreconditioner(std::span<const double> r,
+                                                                     std::span<double> z) const {
+  switch (preconditioner_) {
+    case Preconditioner::kNone:
+      std::ranges::copy(r, z.begin());
+      break;
+    case Preconditioner::kJacobi:
+      for (size_t i = 0; i < local_n_; ++i) {
+        z[i] = r[i] * inv_diagonal_[i];
+      }
+      break;
+    case Preconditioner::kBlockJacobiIc0:
+      // L y = r
+      for (size_t i = 0; i < local_n_; ++i) {
+        const uint64_t diagonal = factor_offsets_[i + 1] - 1;
+        double sum = r[i];
+        for (uint64_t t = factor_offsets_[i]; t < diagonal; ++t) {
+          sum -= factor_values_[t] * z[factor_columns_[t]];
+        }
+        z[i] = sum / factor_values_[diagonal];
+      }
+      // L^T z = y, column by column
+      for (size_t i = local_n_; i-- > 0;) {
+        const uint64_t diagonal = factor_offsets_[i + 1] - 1;
+        z[i] /= factor_values_[diagonal];
+        for (uint64_t t = factor_offsets_[i]; t < diagonal; ++t) {
+          z[factor_columns_[t]] -= factor_values_[t] * z[i];
+        }
+      }
+      break;
+  }
+}
+
+bool opolin_d_cg_method_mpi::SparseCGMethodMPI::RunImpl() {
+  boost::mpi::broadcast(world_, n_, 0);
+  boost::mpi::broadcast(world_, epsilon_, 0);
+  {
+    auto scope = OpenScope("setup");
+    DistributeRows();
+    SetupGhosts();
+    // every rank has to agree, otherwise the others would wait in the iterations
+    const int ready = SetupPreconditioner() ? 1 : 0;
+    if (boost::mpi::all_reduce(world_, ready, boost::mpi::minimum<int>()) == 0) {
+      return false;
+    }
+  }
+
+  auto x = Scratch().AllocateArray<double>(local_n_);
+  auto r = Scratch().AllocateArray<double>(local_n_);
+  auto z = Scratch().AllocateArray<double>(local_n_);
+  auto q = Scratch().AllocateArray<double>(local_n_);
+  auto p = Scratch().AllocateArray<double>(local_n_ + ghost_count_);
+  auto own_p = p.first(local_n_);
+
+  {
+    auto scope = OpenScope("iterations");
+    std::ranges::copy(local_b_, r.begin());
+    ApplyPreconditioner(r, z);
+    std::ranges::copy(z, own_p.begin());
+    // (r, r) for the stopping test and (r, z) for the update share one allreduce
+    std::array<double, 2> local_dots{ScalarProduct(r, r), ScalarProduct(r, z)};
+    std::array<double, 2> dots{};
+    boost::mpi::all_reduce(world_, local_dots.data(), 2, dots.data(), std::plus<double>());
+    double rz = dots[1];
+    while (std::sqrt(dots[0]) >= epsilon_) {
+      Multiply(p, q);
+      const double p_aq = boost::mpi::all_reduce(world_, ScalarProduct(own_p, q), std::plus<double>());
+      if (p_aq <= 0.0) {
+        // A is not positive definite
+        return false;
+      }
+      const double alpha = rz / p_aq;
+      for (size_t i = 0; i < local_n_; ++i) {
+        x[i] += alpha * own_p[i];
+        r[i] -= alpha * q[i];
+      }
+      ApplyPreconditioner(r, z);
+      local_dots = {ScalarProduct(r, r), ScalarProduct(r, z)};
+      boost::mpi::all_reduce(world_, local_dots.data(), 2, dots.data(), std::plus<double>());
+      const double beta = dots[1] / rz;
+      rz = dots[1];
+      for (size_t i = 0; i < local_n_; ++i) {
+        own_p[i] = z[i] + (beta * own_p[i]);
+      }
+    }
+  }
+
+  auto scope = OpenScope("gather");
+  if (world_.rank() == 0) {
+    x_.resize(n_);
+    boost::mpi::gatherv(world_, x.data(), static_cast<int>(local_n_), x_.data(), row_counts_, row_displs_, 0);
+  } else {
+    boost::mpi::gatherv(world_, x.data(), static_cast<int>(local_n_), 0);
+  }
+  return true;
+}
+
+bool opolin_d_cg_method_mpi::SparseCGMethodMPI::PostProcessingImpl() {
+  if (world_.rank() == 0) {
+    std::ranges::copy(x_, reinterpret_cast<double*>(task_data->outputs[0]));
+  }
+  return true;
+}
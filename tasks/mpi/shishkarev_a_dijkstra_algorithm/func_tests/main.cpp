@@ -2,11 +2,13 @@
 #include <gtest/gtest.h>
 
 #include <boost/mpi/communicator.hpp>
+#include <climits>
 #include <cstdint>
 #include <memory>
 #include <random>
 #include <vector>
 
+#include "core/graph/include/graph.hpp"
 #include "core/task/include/task.hpp"
 #include "mpi/shishkarev_a_dijkstra_algorithm/include/ops_mpi.hpp"
 
@@ -29,6 +31,48 @@ void GenerateMatrix(std::vector<int> &w, Value value) {
     w[(i * value.n) + i] = 0;
   }
 }
+
+// delta-stepping on the edge list against the sequential task on the matrix
+void CheckEdgeList(int n, int degree, int delta) {
+  boost::mpi::communicator world;
+  int st = 0;
+  std::vector<int> matrix;
+  std::vector<int> edges;
+  std::vector<int> res(n, 0);
+
+  std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    ppc::graph::GenerateSparseGraph(n, degree, 50, matrix, edges);
+    task_data_par->AddInput(edges.data(), {edges.size() / 3, 3});
+    task_data_par->AddInput(&st, {1});
+    task_data_par->AddInput(&n, {1});
+    task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
+    task_data_par->outputs_count.emplace_back(res.size());
+  }
+
+  shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel test_mpi_task_parallel(task_data_par, delta);
+  ASSERT_TRUE(test_mpi_task_parallel.Validation());
+  test_mpi_task_parallel.PreProcessing();
+  ASSERT_TRUE(test_mpi_task_parallel.Run());
+  test_mpi_task_parallel.PostProcessing();
+
+  if (world.rank() == 0) {
+    std::vector<int> res_seq(n, 0);
+    std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
+    task_data_seq->AddInput(matrix.data(), {static_cast<uint64_t>(n), static_cast<uint64_t>(n)});
+    task_data_seq->AddInput(&st, {1});
+    task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res_seq.data()));
+    task_data_seq->outputs_count.emplace_back(res_seq.size());
+
+    shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential test_mpi_task_sequential(task_data_seq);
+    ASSERT_TRUE(test_mpi_task_sequential.Validation());
+    test_mpi_task_sequential.PreProcessing();
+    test_mpi_task_sequential.Run();
+    test_mpi_task_sequential.PostProcessing();
+
+    ASSERT_EQ(res_seq, res);
+  }
+}
 }  // namespace
 
 TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Graph_5_vertex) {
@@ -44,10 +88,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Graph_5_vertex) {
 
   if (world.rank() == 0) {
     GenerateMatrix(matrix, {.n = size, .min = min, .max = max});
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_par->inputs_count.emplace_back(matrix.size());
-    task_data_par->inputs_count.emplace_back(size);
-    task_data_par->inputs_count.emplace_back(st);
+    task_data_par->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_par->AddInput(&st, {1});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
     task_data_par->outputs_count.emplace_back(res.size());
   }
@@ -62,10 +104,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Graph_5_vertex) {
     std::vector<int> res_seq(size, 0);
 
     std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
-    task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_seq->inputs_count.emplace_back(matrix.size());
-    task_data_seq->inputs_count.emplace_back(size);
-    task_data_seq->inputs_count.emplace_back(st);
+    task_data_seq->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_seq->AddInput(&st, {1});
     task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res_seq.data()));
     task_data_seq->outputs_count.emplace_back(res_seq.size());
 
@@ -92,10 +132,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Graph_10_vertex) {
 
   if (world.rank() == 0) {
     GenerateMatrix(matrix, {.n = size, .min = min, .max = max});
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_par->inputs_count.emplace_back(matrix.size());
-    task_data_par->inputs_count.emplace_back(size);
-    task_data_par->inputs_count.emplace_back(st);
+    task_data_par->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_par->AddInput(&st, {1});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
     task_data_par->outputs_count.emplace_back(res.size());
   }
@@ -110,10 +148,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Graph_10_vertex) {
     std::vector<int> res_seq(size, 0);
 
     std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
-    task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_seq->inputs_count.emplace_back(matrix.size());
-    task_data_seq->inputs_count.emplace_back(size);
-    task_data_seq->inputs_count.emplace_back(st);
+    task_data_seq->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_seq->AddInput(&st, {1});
     task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res_seq.data()));
     task_data_seq->outputs_count.emplace_back(res_seq.size());
 
@@ -140,10 +176,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Graph_13_vertex) {
 
   if (world.rank() == 0) {
     GenerateMatrix(matrix, {.n = size, .min = min, .max = max});
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_par->inputs_count.emplace_back(matrix.size());
-    task_data_par->inputs_count.emplace_back(size);
-    task_data_par->inputs_count.emplace_back(st);
+    task_data_par->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_par->AddInput(&st, {1});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
     task_data_par->outputs_count.emplace_back(res.size());
   }
@@ -158,10 +192,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Graph_13_vertex) {
     std::vector<int> res_seq(size, 0);
 
     std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
-    task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_seq->inputs_count.emplace_back(matrix.size());
-    task_data_seq->inputs_count.emplace_back(size);
-    task_data_seq->inputs_count.emplace_back(st);
+    task_data_seq->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_seq->AddInput(&st, {1});
     task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res_seq.data()));
     task_data_seq->outputs_count.emplace_back(res_seq.size());
 
@@ -188,10 +220,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Graph_20_vertex) {
 
   if (world.rank() == 0) {
     GenerateMatrix(matrix, {.n = size, .min = min, .max = max});
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_par->inputs_count.emplace_back(matrix.size());
-    task_data_par->inputs_count.emplace_back(size);
-    task_data_par->inputs_count.emplace_back(st);
+    task_data_par->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_par->AddInput(&st, {1});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
     task_data_par->outputs_count.emplace_back(res.size());
   }
@@ -206,10 +236,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Graph_20_vertex) {
     std::vector<int> res_seq(size, 0);
 
     std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
-    task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_seq->inputs_count.emplace_back(matrix.size());
-    task_data_seq->inputs_count.emplace_back(size);
-    task_data_seq->inputs_count.emplace_back(st);
+    task_data_seq->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_seq->AddInput(&st, {1});
     task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res_seq.data()));
     task_data_seq->outputs_count.emplace_back(res_seq.size());
 
@@ -236,10 +264,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Source_Vertex_False) {
 
   if (world.rank() == 0) {
     GenerateMatrix(matrix, {.n = size, .min = min, .max = max});
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_par->inputs_count.emplace_back(matrix.size());
-    task_data_par->inputs_count.emplace_back(size);
-    task_data_par->inputs_count.emplace_back(st);
+    task_data_par->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_par->AddInput(&st, {1});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
     task_data_par->outputs_count.emplace_back(res.size());
   }
@@ -260,10 +286,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Negative_Value) {
   std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
 
   if (world.rank() == 0) {
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_par->inputs_count.emplace_back(matrix.size());
-    task_data_par->inputs_count.emplace_back(size);
-    task_data_par->inputs_count.emplace_back(st);
+    task_data_par->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_par->AddInput(&st, {1});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
     task_data_par->outputs_count.emplace_back(res.size());
   }
@@ -285,10 +309,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Spare_Graph_5x5) {
   std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
 
   if (world.rank() == 0) {
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_par->inputs_count.emplace_back(matrix.size());
-    task_data_par->inputs_count.emplace_back(size);
-    task_data_par->inputs_count.emplace_back(st);
+    task_data_par->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_par->AddInput(&st, {1});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
     task_data_par->outputs_count.emplace_back(res.size());
   }
@@ -303,10 +325,8 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Spare_Graph_5x5) {
     std::vector<int> res_seq(size, 0);
 
     std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
-    task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
-    task_data_seq->inputs_count.emplace_back(matrix.size());
-    task_data_seq->inputs_count.emplace_back(size);
-    task_data_seq->inputs_count.emplace_back(st);
+    task_data_seq->AddInput(matrix.data(), {static_cast<uint64_t>(size), static_cast<uint64_t>(size)});
+    task_data_seq->AddInput(&st, {1});
     task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res_seq.data()));
     task_data_seq->outputs_count.emplace_back(res_seq.size());
 
@@ -318,4 +338,122 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Spare_Graph_5x5) {
 
     ASSERT_EQ(res_seq, res);
   }
-}
\ No newline at end of file
+}
+
+TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Edge_List_Auto_Delta) { CheckEdgeList(200, 3, 0); }
+
+TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Edge_List_Unit_Delta) { CheckEdgeList(100, 2, 1); }
+
+TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Edge_List_Large_Delta) { CheckEdgeList(100, 4, 1000); }
+
+TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Edge_List_Zero_Weights_And_Unreachable) {
+  boost::mpi::communicator world;
+  int size = 5;
+  int st = 0;
+  // vertex 4 is not reachable
+  std::vector<int> edges = {0, 1, 0, 1, 2, 5, 0, 2, 7, 2, 3, 0, 4, 0, 1};
+  std::vector<int> res(size, 0);
+
+  std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_par->AddInput(edges.data(), {edges.size() / 3, 3});
+    task_data_par->AddInput(&st, {1});
+    task_data_par->AddInput(&size, {1});
+    task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
+    task_data_par->outputs_count.emplace_back(res.size());
+  }
+
+  shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel test_mpi_task_parallel(task_data_par);
+  ASSERT_TRUE(test_mpi_task_parallel.Validation());
+  test_mpi_task_parallel.PreProcessing();
+  ASSERT_TRUE(test_mpi_task_parallel.Run());
+  test_mpi_task_parallel.PostProcessing();
+
+  if (world.rank() == 0) {
+    ASSERT_EQ(res, (std::vector<int>{0, 0, 5, 5, INT_MAX}));
+  }
+}
+
+TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Sequential_Binary_And_Radix_Heap) {
+  boost::mpi::communicator world;
+  if (world.rank() != 0) {
+    return;
+  }
+  int n = 300;
+  int st = 7;
+  std::vector<int> matrix;
+  std::vector<int> edges;
+  ppc::graph::GenerateSparseGraph(n, 4, 50, matrix, edges);
+
+  auto run = [&](bool edge_list, shishkarev_a_dijkstra_algorithm_mpi::Queue queue) {
+    std::vector<int> res(n, 0);
+    std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
+    if (edge_list) {
+      task_data_seq->AddInput(edges.data(), {edges.size() / 3, 3});
+      task_data_seq->AddInput(&st, {1});
+      task_data_seq->AddInput(&n, {1});
+    } else {
+      task_data_seq->AddInput(matrix.data(), {static_cast<uint64_t>(n), static_cast<uint64_t>(n)});
+      task_data_seq->AddInput(&st, {1});
+    }
+    task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
+    task_data_seq->outputs_count.emplace_back(res.size());
+
+    shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential test_mpi_task_sequential(task_data_seq, queue);
+    EXPECT_TRUE(test_mpi_task_sequential.Validation());
+    test_mpi_task_sequential.PreProcessing();
+    test_mpi_task_sequential.Run();
+    test_mpi_task_sequential.PostProcessing();
+    return res;
+  };
+
+  auto expected = run(false, shishkarev_a_dijkstra_algorithm_mpi::Queue::kBinaryHeap);
+  ASSERT_EQ(expected, run(false, shishkarev_a_dijkstra_algorithm_mpi::Queue::kRadixHeap));
+  ASSERT_EQ(expected, run(true, shishkarev_a_dijkstra_algorithm_mpi::Queue::kBinaryHeap));
+  ASSERT_EQ(expected, run(true, shishkarev_a_dijkstra_algorithm_mpi::Queue::kRadixHeap));
+}
+
+TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Sequential_Large_Weights) {
+  boost::mpi::communicator world;
+  if (world.rank() != 0) {
+    return;
+  }
+  int size = 4;
+  int st = 0;
+  // the radix heap has to split its highest buckets
+  std::vector<int> edges = {0, 1, 2000000000, 0, 2, 1, 2, 1, 1999999998, 2, 3, 1000000000, 3, 1, 5};
+  std::vector<int> res(size, 0);
+
+  std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
+  task_data_seq->AddInput(edges.data(), {edges.size() / 3, 3});
+  task_data_seq->AddInput(&st, {1});
+  task_data_seq->AddInput(&size, {1});
+  task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
+  task_data_seq->outputs_count.emplace_back(res.size());
+
+  shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential test_mpi_task_sequential(task_data_seq);
+  ASSERT_TRUE(test_mpi_task_sequential.Validation());
+  test_mpi_task_sequential.PreProcessing();
+  test_mpi_task_sequential.Run();
+  test_mpi_task_sequential.PostProcessing();
+  ASSERT_EQ(res, (std::vector<int>{0, 1000000006, 1, 1000000001}));
+}
+
+TEST(shishkarev_a_dijkstra_algorithm_mpi, Test_Edge_List_Vertex_Out_Of_Range) {
+  boost::mpi::communicator world;
+  int size = 3;
+  int st = 0;
+  std::vector<int> edges = {0, 1, 2, 1, 3, 4};
+  std::vector<int> res(size, 0);
+
+  std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_par->AddInput(edges.data(), {edges.size() / 3, 3});
+    task_data_par->AddInput(&st, {1});
+    task_data_par->AddInput(&size, {1});
+    task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
+    task_data_par->outputs_count.emplace_back(res.size());
+    shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel test_mpi_task_parallel(task_data_par);
+    ASSERT_FALSE(test_mpi_task_parallel.ValidationImpl());
+  }
+}
@@ -3,53 +3,82 @@
 
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <utility>
 #include <vector>
 
+#include "core/graph/include/graph.hpp"
 #include "core/task/include/task.hpp"
 
 namespace shishkarev_a_dijkstra_algorithm_mpi {
 
-struct Matrix {
-  std::vector<int> values;
-  std::vector<int> col_index;
-  std::vector<int> row_ptr;
-};
-
-void ConvertToCrs(const std::vector<int>& w, Matrix& matrix, int n);
+using Matrix = ppc::graph::CsrGraph;
+using ppc::graph::ConvertEdgesToCrs;
+using ppc::graph::ConvertToCrs;
+using ppc::graph::Dijkstra;
+using ppc::graph::Queue;
 
+// Inputs: adjacency matrix {n, n} (0 = no edge) and source {1}, or an edge
+// list {m, 3} of (from, to, weight), source {1} and vertex count {1}.
 class TestMPITaskSequential : public ppc::core::Task {
  public:
-  explicit TestMPITaskSequential(std::shared_ptr<ppc::core::TaskData> task_data) : Task(std::move(task_data)) {}
+  explicit TestMPITaskSequential(std::shared_ptr<ppc::core::TaskData> task_data, Queue queue = Queue::kRadixHeap)
+      : Task(std::move(task_data)), queue_(queue) {}
   bool PreProcessingImpl() override;
   bool ValidationImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
  private:
-  std::vector<int> input_;
+  Queue queue_;
+  Matrix matrix_;
   std::vector<int> res_;
   int st_{};
   int size_{};
 };
 
+// Delta-stepping over a 1-D partition of the vertices: every process owns a
+// contiguous range of vertices and their outgoing edges. Vertices wait in
+// buckets of width delta; the lowest non-empty bucket is settled by relaxing
+// light edges (weight <= delta) until it stays empty, then the heavy edges of
+// the vertices it held are relaxed once. Only relaxations of edges into the
+// range of another process are exchanged (one all-to-all per round).
+// delta = 0 picks max weight / average out-degree.
+// Inputs: adjacency matrix {n, n} (0 = no edge) and source {1}, or an edge
+// list {m, 3} of (from, to, weight), source {1} and vertex count {1}.
+// Output: n distances, INT_MAX for unreachable vertices.
 class TestMPITaskParallel : public ppc::core::Task {
  public:
-  explicit TestMPITaskParallel(std::shared_ptr<ppc::core::TaskData> task_data) : Task(std::move(task_data)) {}
+  explicit TestMPITaskParallel(std::shared_ptr<ppc::core::TaskData> task_data, int delta = 0)
+      : Task(std::move(task_data)), delta_(delta) {}
   bool PreProcessingImpl() override;
   bool ValidationImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
  private:
-  std::vector<int> input_;
+  void DistributeEdges(int64_t delta);
+  void DeltaStepping(int64_t delta, std::vector<int64_t>& dist);
+
   std::vector<int> res_;
-  std::vector<int> values_;
-  std::vector<int> col_index_;
-  std::vector<int> row_ptr_;
+  // root: (from, to, weight) triples, built here for a matrix input
+  std::vector<int> edge_storage_;
+  std::span<const int> edges_;
   int st_{};
   int size_{};
+  int delta_;
+
+  // own vertices [first_vertex_, first_vertex_ + local_size_) out of chunks of chunk_,
+  // their edges in CSR with the light ones of a vertex first
+  int chunk_{};
+  int first_vertex_{};
+  int local_size_{};
+  std::vector<int> offsets_;
+  std::vector<int> light_end_;
+  std::vector<int> targets_;
+  std::vector<int> weights_;
   boost::mpi::communicator world_;
 };
 
@@ -7,37 +7,41 @@
 #include <memory>
 #include <vector>
 
+#include "core/graph/include/graph.hpp"
 #include "core/perf/include/perf.hpp"
 #include "core/task/include/task.hpp"
+#include "core/util/include/util.hpp"
 #include "mpi/shishkarev_a_dijkstra_algorithm/include/ops_mpi.hpp"
 
-TEST(shishkarev_a_dijkstra_algorithm_mpi, test_PipelineRun) {
+namespace {
+// binary heap Dijkstra over the edge list for the reference distances
+std::vector<int> ReferenceDistances(int n, int st, const std::vector<int> &edges) {
+  ppc::graph::CsrGraph graph;
+  ppc::graph::ConvertEdgesToCrs(edges, graph, n);
+  std::vector<int> dist(n);
+  ppc::graph::Dijkstra(graph, st, ppc::graph::Queue::kBinaryHeap, dist);
+  return dist;
+}
+
+void RunPerf(bool pipeline) {
   boost::mpi::communicator world;
-  int count_size_vector = 5000;
+  int n = static_cast<int>(ppc::util::GetScaledPerfSize(1 << 18));
   int st = 0;
-  std::vector<int> global_matrix(count_size_vector * count_size_vector, 3);
-  std::vector<int32_t> global_path(count_size_vector, 3);
+  std::vector<int> edges;
+  std::vector<int> global_path(n, 0);
 
   std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
   if (world.rank() == 0) {
-    for (int i = 0; i < count_size_vector; i++) {
-      global_matrix[(i * count_size_vector) + i] = 0;
-    }
-    global_path[0] = 0;
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t *>(global_matrix.data()));
-    task_data_par->inputs_count.emplace_back(global_matrix.size());
-    task_data_par->inputs_count.emplace_back(count_size_vector);
-    task_data_par->inputs_count.emplace_back(st);
+    edges = ppc::graph::GenerateRandomEdges(n, 8, 100, 42);
+    task_data_par->AddInput(edges.data(), {edges.size() / 3, 3});
+    task_data_par->AddInput(&st, {1});
+    task_data_par->AddInput(&n, {1});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(global_path.data()));
     task_data_par->outputs_count.emplace_back(global_path.size());
   }
 
   auto test_mpi_task_parallel =
       std::make_shared<shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel>(task_data_par);
-  ASSERT_EQ(test_mpi_task_parallel->ValidationImpl(), true);
-  test_mpi_task_parallel->PreProcessingImpl();
-  test_mpi_task_parallel->RunImpl();
-  test_mpi_task_parallel->PostProcessingImpl();
 
   auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
   perf_attr->num_running = 10;
@@ -47,52 +51,18 @@ TEST(shishkarev_a_dijkstra_algorithm_mpi, test_PipelineRun) {
   auto perf_results = std::make_shared<ppc::core::PerfResults>();
 
   auto perf_analyzer = std::make_shared<ppc::core::Perf>(test_mpi_task_parallel);
-  perf_analyzer->PipelineRun(perf_attr, perf_results);
+  if (pipeline) {
+    perf_analyzer->PipelineRun(perf_attr, perf_results);
+  } else {
+    perf_analyzer->TaskRun(perf_attr, perf_results);
+  }
   if (world.rank() == 0) {
     ppc::core::Perf::PrintPerfStatistic(perf_results);
-    ASSERT_EQ(3, global_path[3]);
+    ASSERT_EQ(ReferenceDistances(n, st, edges), global_path);
   }
 }
+}  // namespace
 
-TEST(shishkarev_a_dijkstra_algorithm_mpi, test_task_run) {
-  boost::mpi::communicator world;
-  int count_size_vector = 5000;
-  int st = 5;
-  std::vector<int> global_matrix(count_size_vector * count_size_vector, 3);
-  std::vector<int32_t> global_path(count_size_vector, 3);
-
-  std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
-  if (world.rank() == 0) {
-    for (int i = 0; i < count_size_vector; i++) {
-      global_matrix[(i * count_size_vector) + i] = 0;
-    }
-    global_path[0] = 0;
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t *>(global_matrix.data()));
-    task_data_par->inputs_count.emplace_back(global_matrix.size());
-    task_data_par->inputs_count.emplace_back(count_size_vector);
-    task_data_par->inputs_count.emplace_back(st);
-    task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t *>(global_path.data()));
-    task_data_par->outputs_count.emplace_back(global_path.size());
-  }
-
-  auto test_mpi_task_parallel =
-      std::make_shared<shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel>(task_data_par);
-  ASSERT_EQ(test_mpi_task_parallel->ValidationImpl(), true);
-  test_mpi_task_parallel->PreProcessingImpl();
-  test_mpi_task_parallel->RunImpl();
-  test_mpi_task_parallel->PostProcessingImpl();
-
-  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
-  perf_attr->num_running = 10;
-  const boost::mpi::timer current_timer;
-  perf_attr->current_timer = [&] { return current_timer.elapsed(); };
-
-  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+TEST(shishkarev_a_dijkstra_algorithm_mpi, test_PipelineRun) { RunPerf(true); }
 
-  auto perf_analyzer = std::make_shared<ppc::core::Perf>(test_mpi_task_parallel);
-  perf_analyzer->TaskRun(perf_attr, perf_results);
-  if (world.rank() == 0) {
-    ppc::core::Perf::PrintPerfStatistic(perf_results);
-    ASSERT_EQ(3, global_path[3]);
-  }
-}
\ No newline at end of file
+TEST(shishkarev_a_dijkstra_algorithm_mpi, test_task_run) { RunPerf(false); }
\ No newline at end of file
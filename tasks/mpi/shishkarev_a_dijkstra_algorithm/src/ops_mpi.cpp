@@ -1,108 +1,132 @@
 // Copyright 2023 Nesterov Alexander
 #include "mpi/shishkarev_a_dijkstra_algorithm/include/ops_mpi.hpp"
 
+#include <mpi.h>
+
 #include <algorithm>
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/all_to_all.hpp>
 #include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/collectives/gatherv.hpp>
 #include <boost/mpi/operations.hpp>
 #include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
-#include <utility>
+#include <map>
+#include <numeric>
+#include <span>
 #include <vector>
 
-void shishkarev_a_dijkstra_algorithm_mpi::ConvertToCrs(const std::vector<int>& w, Matrix& matrix, int n) {
-  matrix.row_ptr.resize(n + 1);
-  int nnz = 0;
-  for (int i = 0; i < n; i++) {
-    matrix.row_ptr[i] = nnz;
-    for (int j = 0; j < n; j++) {
-      int weight = w[(i * n) + j];
-      if (weight != 0) {
-        matrix.values.emplace_back(weight);
-        matrix.col_index.emplace_back(j);
-        nnz++;
-      }
-    }
-  }
-  matrix.row_ptr[n] = nnz;
-}
+#include "core/task/include/task.hpp"
 
-bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential::PreProcessingImpl() {
-  size_ = static_cast<int>(task_data->inputs_count[1]);
-  st_ = static_cast<int>(task_data->inputs_count[2]);
+namespace {
 
-  input_ = std::vector<int>(size_ * size_);
-  auto* tmp_ptr = reinterpret_cast<int*>(task_data->inputs[0]);
-  input_.assign(tmp_ptr, tmp_ptr + task_data->inputs_count[0]);
+// inputs: adjacency matrix {n, n} of non-negative weights and source vertex {1}
+bool IsValidTaskData(const ppc::core::TaskData& task_data) {
+  if (task_data.inputs.size() != 2 || task_data.outputs.size() != 1 || task_data.outputs[0] == nullptr) {
+    return false;
+  }
 
-  res_ = std::vector<int>(size_, 0);
-  return true;
-}
+  auto shape = task_data.InputShape(0);
+  if (shape.size() != 2 || shape[0] != shape[1] || shape[0] <= 1 ||
+      task_data.InputShape(1) != std::vector<uint64_t>{1}) {
+    return false;
+  }
 
-bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential::ValidationImpl() {
-  if (task_data->inputs.empty()) {
+  auto weights = task_data.InputView<const int>(0).Span();
+  if (!std::ranges::all_of(weights, [](int val) { return val >= 0; })) {
     return false;
   }
 
-  if (task_data->inputs_count.size() < 2 || task_data->inputs_count[1] <= 1) {
+  int st = task_data.InputView<const int>(1).At(0);
+  if (st < 0 || static_cast<uint64_t>(st) >= shape[0]) {
     return false;
   }
 
-  auto* tmp_ptr = reinterpret_cast<int*>(task_data->inputs[0]);
-  if (!std::all_of(tmp_ptr, tmp_ptr + task_data->inputs_count[0], [](int val) { return val >= 0; })) {
+  return task_data.outputs_count[0] == shape[0];
+}
+
+// inputs: edge list {m, 3} of (from, to, weight >= 0), source {1} and vertex count {1}
+bool IsValidEdgeList(const ppc::core::TaskData& task_data) {
+  if (task_data.inputs.size() != 3 || task_data.outputs.size() != 1 || task_data.outputs[0] == nullptr) {
     return false;
   }
 
-  if (task_data->inputs_count[2] >= task_data->inputs_count[1]) {
+  auto shape = task_data.InputShape(0);
+  if (shape.size() != 2 || shape[1] != 3 || task_data.InputShape(1) != std::vector<uint64_t>{1} ||
+      task_data.InputShape(2) != std::vector<uint64_t>{1}) {
     return false;
   }
 
-  if (task_data->outputs.empty() || task_data->outputs[0] == nullptr || task_data->outputs.size() != 1 ||
-      task_data->outputs_count[0] != task_data->inputs_count[1]) {
+  int n = task_data.InputView<const int>(2).At(0);
+  int st = task_data.InputView<const int>(1).At(0);
+  if (n < 1 || st < 0 || st >= n) {
     return false;
   }
-  return true;
-}
 
-bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential::RunImpl() {
-  const int inf = std::numeric_limits<int>::max();
-  Matrix matrix;
-  ConvertToCrs(input_, matrix, size_);
-
-  std::vector<bool> visited(size_, false);
-  std::vector<int> d(size_, inf);
-  d[st_] = 0;
-
-  for (int i = 0; i < size_; i++) {
-    int min = inf;
-    int index = -1;
-    for (int j = 0; j < size_; j++) {
-      if (!visited[j] && d[j] < min) {
-        min = d[j];
-        index = j;
-      }
+  auto edges = task_data.InputView<const int>(0).Span();
+  for (size_t i = 0; i < edges.size(); i += 3) {
+    if (edges[i] < 0 || edges[i] >= n || edges[i + 1] < 0 || edges[i + 1] >= n || edges[i + 2] < 0) {
+      return false;
     }
+  }
 
-    if (index == -1) {
-      break;
-    }
+  return task_data.outputs_count[0] == static_cast<uint64_t>(n);
+}
 
-    int u = index;
-    visited[u] = true;
+constexpr int64_t kNoBucket = std::numeric_limits<int64_t>::max();
 
-    for (int j = matrix.row_ptr[u]; j < matrix.row_ptr[u + 1]; j++) {
-      int v = matrix.col_index[j];
-      int weight = matrix.values[j];
+// sends (vertex, distance) pairs to the owners of the vertices, returns the pairs sent here
+std::vector<int64_t> ExchangeRequests(const boost::mpi::communicator& world,
+                                      std::vector<std::vector<int64_t>>& outgoing) {
+  const int size = world.size();
+  std::vector<int> send_counts(size);
+  for (int i = 0; i < size; i++) {
+    send_counts[i] = static_cast<int>(outgoing[i].size());
+  }
+  std::vector<int> recv_counts(size);
+  boost::mpi::all_to_all(world, send_counts, recv_counts);
+  std::vector<int> send_displs(size, 0);
+  std::vector<int> recv_displs(size, 0);
+  for (int i = 1; i < size; i++) {
+    send_displs[i] = send_displs[i - 1] + send_counts[i - 1];
+    recv_displs[i] = recv_displs[i - 1] + recv_counts[i - 1];
+  }
+  std::vector<int64_t> send(std::accumulate(send_counts.begin(), send_counts.end(), size_t{0}));
+  for (int i = 0; i < size; i++) {
+    std::ranges::copy(outgoing[i], send.begin() + send_displs[i]);
+    outgoing[i].clear();
+  }
+  std::vector<int64_t> received(std::accumulate(recv_counts.begin(), recv_counts.end(), size_t{0}));
+  MPI_Alltoallv(send.data(), send_counts.data(), send_displs.data(), MPI_INT64_T, received.data(), recv_counts.data(),
+                recv_displs.data(), MPI_INT64_T, world);
+  return received;
+}
 
-      if (!visited[v] && d[u] != inf && (d[u] + weight < d[v])) {
-        d[v] = d[u] + weight;
-      }
-    }
+}  // namespace
+
+bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential::PreProcessingImpl() {
+  st_ = task_data->InputView<const int>(1).At(0);
+  if (task_data->inputs.size() == 3) {
+    size_ = task_data->InputView<const int>(2).At(0);
+    ConvertEdgesToCrs(task_data->InputView<const int>(0).Span(), matrix_, size_);
+  } else {
+    size_ = static_cast<int>(task_data->InputShape(0)[0]);
+    ConvertToCrs(task_data->InputView<const int>(0).Span(), matrix_, size_);
   }
 
-  res_ = d;
+  res_ = std::vector<int>(size_, 0);
+  return true;
+}
+
+bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential::ValidationImpl() {
+  return task_data->inputs.size() == 3 ? IsValidEdgeList(*task_data) : IsValidTaskData(*task_data);
+}
 
+bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential::RunImpl() {
+  Dijkstra(matrix_, st_, queue_, res_);
   return true;
 }
 
@@ -113,135 +137,206 @@ bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskSequential::PostProcessingI
 
 bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel::PreProcessingImpl() {
   if (world_.rank() == 0) {
-    size_ = static_cast<int>(task_data->inputs_count[1]);
-    st_ = static_cast<int>(task_data->inputs_count[2]);
+    st_ = task_data->InputView<const int>(1).At(0);
+    if (task_data->inputs.size() == 3) {
+      size_ = task_data->InputView<const int>(2).At(0);
+      edges_ = task_data->InputView<const int>(0).Span();
+    } else {
+      size_ = static_cast<int>(task_data->InputShape(0)[0]);
+      auto weights = task_data->InputView<const int>(0).Span();
+      edge_storage_.clear();
+      for (int i = 0; i < size_; i++) {
+        for (int j = 0; j < size_; j++) {
+          if (weights[(i * size_) + j] != 0) {
+            edge_storage_.insert(edge_storage_.end(), {i, j, weights[(i * size_) + j]});
+          }
+        }
+      }
+      edges_ = edge_storage_;
+    }
   }
+  return true;
+}
 
+bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel::ValidationImpl() {
   if (world_.rank() == 0) {
-    input_ = std::vector<int>(size_ * size_);
-    auto* tmp_ptr = reinterpret_cast<int*>(task_data->inputs[0]);
-    input_.assign(tmp_ptr, tmp_ptr + task_data->inputs_count[0]);
-    Matrix temp_matrix;
-    ConvertToCrs(input_, temp_matrix, size_);
-    values_ = std::move(temp_matrix.values);
-    col_index_ = std::move(temp_matrix.col_index);
-    row_ptr_ = std::move(temp_matrix.row_ptr);
-  } else {
-    input_ = std::vector<int>(size_ * size_, 0);
+    return task_data->inputs.size() == 3 ? IsValidEdgeList(*task_data) : IsValidTaskData(*task_data);
   }
   return true;
 }
 
-bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel::ValidationImpl() {
+void shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel::DistributeEdges(int64_t delta) {
+  const int size = world_.size();
+  chunk_ = (size_ + size - 1) / size;
+  first_vertex_ = std::min(size_, world_.rank() * chunk_);
+  local_size_ = std::min(size_, first_vertex_ + chunk_) - first_vertex_;
+
+  // the edges of a vertex go to its owner, as (from, to, weight)
+  int local_count = 0;
+  std::span<int> local_edges;
   if (world_.rank() == 0) {
-    if (task_data->inputs.empty()) {
-      return false;
+    std::vector<int> counts(size, 0);
+    for (size_t i = 0; i < edges_.size(); i += 3) {
+      counts[edges_[i] / chunk_] += 3;
     }
-
-    if (task_data->inputs_count.size() < 2 || task_data->inputs_count[1] <= 1) {
-      return false;
+    std::vector<int> displs(size, 0);
+    for (int i = 1; i < size; i++) {
+      displs[i] = displs[i - 1] + counts[i - 1];
     }
-
-    auto* tmp_ptr = reinterpret_cast<int*>(task_data->inputs[0]);
-    if (!std::all_of(tmp_ptr, tmp_ptr + task_data->inputs_count[0], [](int val) { return val >= 0; })) {
-      return false;
+    auto packed = Scratch().AllocateArray<int>(edges_.size());
+    std::vector<int> positions = displs;
+    for (size_t i = 0; i < edges_.size(); i += 3) {
+      std::copy(edges_.begin() + static_cast<std::ptrdiff_t>(i), edges_.begin() + static_cast<std::ptrdiff_t>(i + 3),
+                packed.begin() + positions[edges_[i] / chunk_]);
+      positions[edges_[i] / chunk_] += 3;
     }
+    MPI_Scatter(counts.data(), 1, MPI_INT, &local_count, 1, MPI_INT, 0, world_);
+    local_edges = Scratch().AllocateArray<int>(local_count);
+    MPI_Scatterv(packed.data(), counts.data(), displs.data(), MPI_INT, local_edges.data(), local_count, MPI_INT, 0,
+                 world_);
+  } else {
+    MPI_Scatter(nullptr, 1, MPI_INT, &local_count, 1, MPI_INT, 0, world_);
+    local_edges = Scratch().AllocateArray<int>(local_count);
+    MPI_Scatterv(nullptr, nullptr, nullptr, MPI_INT, local_edges.data(), local_count, MPI_INT, 0, world_);
+  }
 
-    if (task_data->inputs_count[2] >= task_data->inputs_count[1]) {
-      return false;
+  offsets_.assign(local_size_ + 1, 0);
+  light_end_.assign(local_size_, 0);
+  std::vector<int> light_count(local_size_, 0);
+  for (int i = 0; i < local_count; i += 3) {
+    const int vertex = local_edges[i] - first_vertex_;
+    offsets_[vertex + 1]++;
+    light_count[vertex] += local_edges[i + 2] <= delta ? 1 : 0;
+  }
+  std::vector<int> light_position(local_size_);
+  std::vector<int> heavy_position(local_size_);
+  for (int v = 0; v < local_size_; v++) {
+    offsets_[v + 1] += offsets_[v];
+    light_position[v] = offsets_[v];
+    heavy_position[v] = light_end_[v] = offsets_[v] + light_count[v];
+  }
+  targets_.resize(local_count / 3);
+  weights_.resize(local_count / 3);
+  for (int i = 0; i < local_count; i += 3) {
+    const int vertex = local_edges[i] - first_vertex_;
+    const int position = local_edges[i + 2] <= delta ? light_position[vertex]++ : heavy_position[vertex]++;
+    targets_[position] = local_edges[i + 1];
+    weights_[position] = local_edges[i + 2];
+  }
+}
+
+void shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel::DeltaStepping(int64_t delta,
+                                                                            std::vector<int64_t>& dist) {
+  const int rank = world_.rank();
+  std::map<int64_t, std::vector<int>> buckets;
+  auto relax = [&](int vertex, int64_t distance) {
+    if (distance < dist[vertex]) {
+      dist[vertex] = distance;
+      buckets[distance / delta].push_back(vertex);
     }
+  };
+  if (st_ >= first_vertex_ && st_ < first_vertex_ + local_size_) {
+    relax(st_ - first_vertex_, 0);
+  }
 
-    if (task_data->outputs.empty() || task_data->outputs[0] == nullptr || task_data->outputs.size() != 1 ||
-        task_data->outputs_count[0] != task_data->inputs_count[1]) {
-      return false;
+  // edges into the own range are relaxed right away, the others are sent to their owners
+  std::vector<std::vector<int64_t>> outgoing(world_.size());
+  auto relax_edges = [&](const std::vector<int>& vertices, bool light) {
+    for (int vertex : vertices) {
+      const int begin = light ? offsets_[vertex] : light_end_[vertex];
+      const int end = light ? light_end_[vertex] : offsets_[vertex + 1];
+      for (int e = begin; e < end; e++) {
+        const int64_t distance = dist[vertex] + weights_[e];
+        const int owner = targets_[e] / chunk_;
+        if (owner == rank) {
+          relax(targets_[e] - first_vertex_, distance);
+        } else {
+          outgoing[owner].insert(outgoing[owner].end(), {targets_[e], distance});
+        }
+      }
     }
+    auto incoming = ExchangeRequests(world_, outgoing);
+    for (size_t i = 0; i < incoming.size(); i += 2) {
+      relax(static_cast<int>(incoming[i]) - first_vertex_, incoming[i + 1]);
+    }
+  };
+  auto lowest_bucket = [&] {
+    const int64_t local = buckets.empty() ? kNoBucket : buckets.begin()->first;
+    return boost::mpi::all_reduce(world_, local, boost::mpi::minimum<int64_t>());
+  };
+
+  // a vertex enters the frontier once per round even if it was put into the bucket several times
+  std::vector<int64_t> last_round(local_size_, -1);
+  int64_t round = 0;
+  for (int64_t bucket = lowest_bucket(); bucket != kNoBucket; bucket = lowest_bucket()) {
+    std::vector<int> settled;
+    int refilled = 1;
+    while (refilled != 0) {
+      std::vector<int> frontier;
+      if (auto it = buckets.find(bucket); it != buckets.end()) {
+        for (int vertex : it->second) {
+          if (dist[vertex] / delta == bucket && last_round[vertex] != round) {
+            last_round[vertex] = round;
+            frontier.push_back(vertex);
+          }
+        }
+        buckets.erase(it);
+      }
+      round++;
+      settled.insert(settled.end(), frontier.begin(), frontier.end());
+      relax_edges(frontier, true);
+      refilled = boost::mpi::all_reduce(world_, buckets.contains(bucket) ? 1 : 0, boost::mpi::maximum<int>());
+    }
+    std::ranges::sort(settled);
+    const auto [first, last] = std::ranges::unique(settled);
+    settled.erase(first, last);
+    relax_edges(settled, false);
   }
-  return true;
 }
 
 bool shishkarev_a_dijkstra_algorithm_mpi::TestMPITaskParallel::RunImpl() {
-  const int inf = std::numeric_limits<int>::max();
   boost::mpi::broadcast(world_, size_, 0);
   boost::mpi::broadcast(world_, st_, 0);
 
-  int values_size = static_cast<int>(values_.size());
-  int row_ptr_size = static_cast<int>(row_ptr_.size());
-  int col_index_size = static_cast<int>(col_index_.size());
-
-  boost::mpi::broadcast(world_, values_size, 0);
-  boost::mpi::broadcast(world_, row_ptr_size, 0);
-  boost::mpi::broadcast(world_, col_index_size, 0);
-
-  values_.resize(values_size);
-  row_ptr_.resize(row_ptr_size);
-  col_index_.resize(col_index_size);
-
-  boost::mpi::broadcast(world_, values_.data(), static_cast<int>(values_.size()), 0);
-  boost::mpi::broadcast(world_, row_ptr_.data(), static_cast<int>(row_ptr_.size()), 0);
-  boost::mpi::broadcast(world_, col_index_.data(), static_cast<int>(col_index_.size()), 0);
-
-  int delta = size_ / world_.size();
-  int extra = size_ % world_.size();
-  if (extra != 0) {
-    delta += 1;
+  int64_t delta = delta_;
+  if (world_.rank() == 0 && delta <= 0) {
+    int max_weight = 0;
+    for (size_t i = 2; i < edges_.size(); i += 3) {
+      max_weight = std::max(max_weight, edges_[i]);
+    }
+    const auto edge_count = static_cast<int64_t>(edges_.size() / 3);
+    const int64_t degree = std::max<int64_t>(1, (edge_count + size_ - 1) / size_);
+    delta = std::max<int64_t>(1, max_weight / degree);
   }
-  int start_index = world_.rank() * delta;
-  int end_index = std::min(size_, delta * (world_.rank() + 1));
-
-  res_.resize(size_, INT_MAX);
-  std::vector<bool> visited(size_, false);
-  std::vector<int> d(size_, inf);
+  boost::mpi::broadcast(world_, delta, 0);
 
-  if (world_.rank() == 0) {
-    res_[st_] = 0;
+  {
+    auto scope = OpenScope("distribute");
+    DistributeEdges(delta);
+  }
+  std::vector<int64_t> dist(local_size_, std::numeric_limits<int64_t>::max());
+  {
+    auto scope = OpenScope("delta stepping");
+    DeltaStepping(delta, dist);
   }
 
-  boost::mpi::broadcast(world_, res_.data(), size_, 0);
-
-  for (int k = 0; k < size_; k++) {
-    int local_min = inf;
-    int local_index = -1;
-
-    for (int i = start_index; i < end_index; i++) {
-      if (!visited[i] && res_[i] < local_min) {
-        local_min = res_[i];
-        local_index = i;
-      }
-    }
-
-    std::pair<int, int> local_pair = {local_min, local_index};
-    std::pair<int, int> global_pair = {inf, -1};
-
-    boost::mpi::all_reduce(world_, local_pair, global_pair,
-                           [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
-                             if (a.first < b.first) {
-                               return a;
-                             }
-                             if (a.first > b.first) {
-                               return b;
-                             }
-                             return a;
-                           });
-
-    if (global_pair.first == inf || global_pair.second == -1) {
-      break;
-    }
-
-    visited[global_pair.second] = true;
-
-    for (int j = row_ptr_[global_pair.second]; j < row_ptr_[global_pair.second + 1]; j++) {
-      int v = col_index_[j];
-      int w = values_[j];
-
-      if (!visited[v] && res_[global_pair.second] != inf && (res_[global_pair.second] + w < res_[v])) {
-        res_[v] = res_[global_pair.second] + w;
-      }
+  auto scope = OpenScope("gather");
+  std::vector<int> local_res(local_size_);
+  for (int i = 0; i < local_size_; i++) {
+    local_res[i] = static_cast<int>(std::min<int64_t>(dist[i], INT_MAX));
+  }
+  if (world_.rank() == 0) {
+    std::vector<int> counts(world_.size());
+    std::vector<int> displs(world_.size());
+    for (int i = 0; i < world_.size(); i++) {
+      displs[i] = std::min(size_, i * chunk_);
+      counts[i] = std::min(size_, displs[i] + chunk_) - displs[i];
     }
-
-    boost::mpi::all_reduce(world_, res_.data(), size_, d.data(), boost::mpi::minimum<int>());
-    res_ = d;
+    res_.resize(size_);
+    boost::mpi::gatherv(world_, local_res.data(), local_size_, res_.data(), counts, displs, 0);
+  } else {
+    boost::mpi::gatherv(world_, local_res.data(), local_size_, 0);
   }
-
   return true;
 }
 
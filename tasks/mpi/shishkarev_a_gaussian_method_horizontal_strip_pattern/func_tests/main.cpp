@@ -24,6 +24,53 @@ std::vector<double> GetRandomMatrix(int sz) {
 
 bool IsSingular(const std::vector<double>& matrix, Matrix mat) { return Determinant(mat, matrix) == 0; }
 
+namespace {
+
+// [A|b] with b = A x, x from [-1, 1]
+std::vector<double> GetRandomSystem(int n, std::vector<double>& x) {
+  std::random_device dev;
+  std::mt19937 gen(dev());
+  std::uniform_real_distribution<double> dis(-1, 1);
+  x.resize(n);
+  for (auto& value : x) {
+    value = dis(gen);
+  }
+  auto a = GetRandomMatrix(n * (n + 1));
+  for (int i = 0; i < n; ++i) {
+    a[(i * (n + 1)) + n] = 0;
+    for (int j = 0; j < n; ++j) {
+      a[(i * (n + 1)) + n] += a[(i * (n + 1)) + j] * x[j];
+    }
+  }
+  return a;
+}
+
+void CheckParallelSolve(int n, int block_size) {
+  boost::mpi::communicator world;
+  std::vector<double> expected;
+  std::vector<double> global_matrix;
+  std::vector<double> global_res(n, 0);
+  auto task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    global_matrix = GetRandomSystem(n, expected);
+    task_data_par->AddInput(global_matrix.data(), {static_cast<uint64_t>(n), static_cast<uint64_t>(n + 1)});
+    task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t*>(global_res.data()));
+    task_data_par->outputs_count.emplace_back(global_res.size());
+  }
+  MPIGaussHorizontalParallel mpi_gauss_horizontal_parallel(task_data_par, block_size);
+  ASSERT_TRUE(mpi_gauss_horizontal_parallel.Validation());
+  mpi_gauss_horizontal_parallel.PreProcessing();
+  ASSERT_TRUE(mpi_gauss_horizontal_parallel.Run());
+  mpi_gauss_horizontal_parallel.PostProcessing();
+  if (world.rank() == 0) {
+    for (int i = 0; i < n; ++i) {
+      ASSERT_NEAR(global_res[i], expected[i], 1e-6);
+    }
+  }
+}
+
+}  // namespace
+
 }  // namespace shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi
 
 TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_empty_matrix) {
@@ -37,10 +84,7 @@ TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_empty_matri
   std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
 
   if (world.rank() == 0) {
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t*>(global_matrix.data()));
-    task_data_par->inputs_count.emplace_back(global_matrix.size());
-    task_data_par->inputs_count.emplace_back(cols);
-    task_data_par->inputs_count.emplace_back(rows);
+    task_data_par->AddInput(global_matrix.data(), {rows, cols});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t*>(global_res.data()));
     task_data_par->outputs_count.emplace_back(global_res.size());
     shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel mpi_gauss_horizontal_parallel(
@@ -61,10 +105,7 @@ TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_matrix_with
 
   if (world.rank() == 0) {
     global_matrix = {1};
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t*>(global_matrix.data()));
-    task_data_par->inputs_count.emplace_back(global_matrix.size());
-    task_data_par->inputs_count.emplace_back(cols);
-    task_data_par->inputs_count.emplace_back(rows);
+    task_data_par->AddInput(global_matrix.data(), {rows, cols});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t*>(global_res.data()));
     task_data_par->outputs_count.emplace_back(global_res.size());
     shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel mpi_gauss_horizontal_parallel(
@@ -85,10 +126,7 @@ TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_not_square_
 
   if (world.rank() == 0) {
     global_matrix = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t*>(global_matrix.data()));
-    task_data_par->inputs_count.emplace_back(global_matrix.size());
-    task_data_par->inputs_count.emplace_back(cols);
-    task_data_par->inputs_count.emplace_back(rows);
+    task_data_par->AddInput(global_matrix.data(), {rows, cols});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t*>(global_res.data()));
     task_data_par->outputs_count.emplace_back(global_res.size());
     shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel mpi_gauss_horizontal_parallel(
@@ -96,3 +134,156 @@ TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_not_square_
     ASSERT_FALSE(mpi_gauss_horizontal_parallel.ValidationImpl());
   }
 }
+
+TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_solve_one_block) {
+  shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::CheckParallelSolve(20, 32);
+}
+
+TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_solve_small_blocks) {
+  shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::CheckParallelSolve(37, 4);
+}
+
+TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_solve_unit_blocks) {
+  shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::CheckParallelSolve(13, 1);
+}
+
+TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_solve_fewer_rows_than_processes) {
+  shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::CheckParallelSolve(2, 1);
+}
+
+TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_zero_leading_pivot) {
+  boost::mpi::communicator world;
+  // the unpivoted elimination would divide by a(0, 0) = 0
+  std::vector<double> global_matrix = {0, 1, 0, 5, 2, 0, 1, 4, 1, 0, 3, 7};
+  std::vector<double> global_res(3, 0);
+  auto task_data_par = std::make_shared<ppc::core::TaskData>();
+  auto task_data_seq = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_par->AddInput(global_matrix.data(), {3, 4});
+    task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t*>(global_res.data()));
+    task_data_par->outputs_count.emplace_back(global_res.size());
+  }
+  shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel mpi_gauss_horizontal_parallel(
+      task_data_par, 1);
+  ASSERT_TRUE(mpi_gauss_horizontal_parallel.Validation());
+  mpi_gauss_horizontal_parallel.PreProcessing();
+  ASSERT_TRUE(mpi_gauss_horizontal_parallel.Run());
+  mpi_gauss_horizontal_parallel.PostProcessing();
+  if (world.rank() == 0) {
+    EXPECT_NEAR(global_res[0], 1, 1e-12);
+    EXPECT_NEAR(global_res[1], 5, 1e-12);
+    EXPECT_NEAR(global_res[2], 2, 1e-12);
+
+    std::vector<double> seq_res(3, 0);
+    task_data_seq->AddInput(global_matrix.data(), {3, 4});
+    task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t*>(seq_res.data()));
+    task_data_seq->outputs_count.emplace_back(seq_res.size());
+    shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalSequential seq_gauss(task_data_seq);
+    ASSERT_TRUE(seq_gauss.Validation());
+    seq_gauss.PreProcessing();
+    ASSERT_TRUE(seq_gauss.Run());
+    seq_gauss.PostProcessing();
+    EXPECT_EQ(seq_res, global_res);
+  }
+}
+
+TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_singular_matrix) {
+  boost::mpi::communicator world;
+  // the third row is the sum of the first two
+  std::vector<double> global_matrix = {1, 2, 3, 1, 4, 5, 6, 2, 5, 7, 9, 3};
+  std::vector<double> global_res(3, 0);
+  auto task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_par->AddInput(global_matrix.data(), {3, 4});
+    task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t*>(global_res.data()));
+    task_data_par->outputs_count.emplace_back(global_res.size());
+  }
+  shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel mpi_gauss_horizontal_parallel(
+      task_data_par, 1);
+  ASSERT_TRUE(mpi_gauss_horizontal_parallel.Validation());
+  mpi_gauss_horizontal_parallel.PreProcessing();
+  ASSERT_FALSE(mpi_gauss_horizontal_parallel.Run());
+}
+
+TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_multiple_right_hand_sides) {
+  boost::mpi::communicator world;
+  const int n = 23;
+  const int k = 5;
+  std::vector<double> global_matrix(n * (n + k));
+  std::vector<double> expected(n * k);
+  std::vector<double> global_res(n * k, 0);
+  auto task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    std::vector<double> x;
+    auto system = shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::GetRandomSystem(n, x);
+    expected = shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::GetRandomMatrix(n * k);
+    // [A|B] with B = A X
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+        global_matrix[(i * (n + k)) + j] = system[(i * (n + 1)) + j];
+      }
+      for (int r = 0; r < k; ++r) {
+        for (int j = 0; j < n; ++j) {
+          global_matrix[(i * (n + k)) + n + r] += system[(i * (n + 1)) + j] * expected[(j * k) + r];
+        }
+      }
+    }
+    task_data_par->AddInput(global_matrix.data(), {n, n + k});
+    task_data_par->AddOutput(global_res.data(), {n, k});
+  }
+  shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel mpi_gauss_horizontal_parallel(
+      task_data_par, 4);
+  ASSERT_TRUE(mpi_gauss_horizontal_parallel.Validation());
+  mpi_gauss_horizontal_parallel.PreProcessing();
+  ASSERT_TRUE(mpi_gauss_horizontal_parallel.Run());
+  mpi_gauss_horizontal_parallel.PostProcessing();
+  if (world.rank() == 0) {
+    for (int i = 0; i < n * k; ++i) {
+      ASSERT_NEAR(global_res[i], expected[i], 1e-6);
+    }
+  }
+}
+
+TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_reuse_factors) {
+  boost::mpi::communicator world;
+  const int n = 17;
+  const int k = 3;
+  std::vector<double> a(n * n);
+  std::vector<double> b(n * k);
+  std::vector<double> global_res(n * k, 0);
+  auto task_data_par = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    a = shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::GetRandomMatrix(n * n);
+    task_data_par->AddInput(a.data(), {n, n});
+    task_data_par->AddInput(b.data(), {n, k});
+    task_data_par->AddOutput(global_res.data(), {n, k});
+  }
+  const auto original_a = a;
+  shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel mpi_gauss_horizontal_parallel(
+      task_data_par, 3, shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::Factors::kReuse);
+  for (int run = 0; run < 3; ++run) {
+    std::vector<double> expected(n * k);
+    if (world.rank() == 0) {
+      expected = shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::GetRandomMatrix(n * k);
+      std::ranges::fill(b, 0.0);
+      for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+          for (int r = 0; r < k; ++r) {
+            b[(i * k) + r] += original_a[(i * n) + j] * expected[(j * k) + r];
+          }
+        }
+      }
+    }
+    ASSERT_TRUE(mpi_gauss_horizontal_parallel.Validation());
+    mpi_gauss_horizontal_parallel.PreProcessing();
+    ASSERT_TRUE(mpi_gauss_horizontal_parallel.Run());
+    mpi_gauss_horizontal_parallel.PostProcessing();
+    if (world.rank() == 0) {
+      for (int i = 0; i < n * k; ++i) {
+        ASSERT_NEAR(global_res[i], expected[i], 1e-6);
+      }
+    }
+    // later runs only solve with the factors of the first one
+    std::ranges::fill(a, 0.0);
+  }
+}
@@ -2,7 +2,9 @@
 
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -16,13 +18,6 @@ struct Matrix {
   int delta;
 };
 
-struct Vector {
-  std::vector<double> local_matrix;
-  std::vector<double> local_res;
-  std::vector<double> res;
-  std::vector<double> row;
-};
-
 int MatrixRank(Matrix matrix, std::vector<double> a);
 
 double Determinant(Matrix matrix, std::vector<double> a);
@@ -33,20 +28,6 @@ bool IsSingular(const std::vector<double>& matrix, Matrix mat);
 
 double AxB(int n, int m, std::vector<double> a, std::vector<double> res);
 
-void BroadcastMatrixSize(boost::mpi::communicator& world, int& rows, int& cols);
-
-std::vector<int> ComputeRowDistribution(boost::mpi::communicator& world, int rows);
-
-void DistributeMatrix(boost::mpi::communicator& world, const std::vector<int>& row_num, int delta, int cols,
-                      std::vector<double>& matrix);
-
-void ReceiveMatrix(boost::mpi::communicator& world, int delta, int cols, std::vector<double>& local_matrix,
-                   std::vector<double>& matrix);
-
-void ForwardElimination(boost::mpi::communicator& world, Matrix matrix, Vector& vector);
-
-void BackSubstitution(boost::mpi::communicator& world, Matrix matrix, Vector& vector);
-
 class MPIGaussHorizontalSequential : public ppc::core::Task {
  public:
   explicit MPIGaussHorizontalSequential(std::shared_ptr<ppc::core::TaskData> task_data) : Task(std::move(task_data)) {}
@@ -60,18 +41,69 @@ class MPIGaussHorizontalSequential : public ppc::core::Task {
   int rows_{}, cols_{};
 };
 
+// kReuse keeps the LU factors of MPIGaussHorizontalParallel for later runs
+enum class Factors : uint8_t { kRefactor, kReuse };
+
+// Right-looking blocked LU with partial pivoting. The matrix is distributed
+// 2-D block-cyclically with block_size x block_size blocks over a grid of
+// grid_rows x grid_cols processes (grid_cols is the largest divisor of the
+// process count not above its square root, so a prime count gives horizontal
+// strips). Every step factors one panel of block_size columns inside its
+// process column, broadcasts it along the process rows and updates the
+// trailing matrix; the next panel is factored and its broadcast started before
+// the rest of the trailing update (lookahead of one panel).
+// Singular matrices are detected from the pivots: Run() returns false.
+// Inputs: the augmented n x (n + k) matrix [A|B], or A (n x n) and B (n x k)
+// as two inputs; output: X (n x k, row-major) with A X = B.
+// With Factors::kReuse the LU factors stay with the instance and later runs
+// of the same size only do the triangular solves ("solve" phase) for the
+// current B; A is not even read then, so B may change between runs while A
+// must not. Give A and B as separate inputs to skip copying A as well.
 class MPIGaussHorizontalParallel : public ppc::core::Task {
  public:
-  explicit MPIGaussHorizontalParallel(std::shared_ptr<ppc::core::TaskData> task_data) : Task(std::move(task_data)) {}
+  static constexpr int kDefaultBlockSize = 32;
+
+  explicit MPIGaussHorizontalParallel(std::shared_ptr<ppc::core::TaskData> task_data,
+                                      int block_size = kDefaultBlockSize, Factors factors = Factors::kRefactor)
+      : Task(std::move(task_data)), block_size_(block_size), factors_(factors) {}
   bool PreProcessingImpl() override;
   bool ValidationImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
  private:
-  std::vector<double> matrix_, local_matrix_, res_, local_res_;
-  int rows_{}, cols_{};
+  void SetupGrid();
+  void DistributeMatrix();
+  bool Factorize();
+  // factors panel k in its process column and packs its pivots and rows into panel
+  bool FactorPanel(int k, std::span<double> panel);
+  // swaps global rows a and b in the local columns outside [skip_begin, skip_end)
+  void SwapRows(int a, int b, int skip_begin, int skip_end);
+  // x (n x nrhs, the same on every process) holds b on entry and the solution on exit
+  void Solve(std::span<double> x, int nrhs);
+
+  [[nodiscard]] bool HasFactors() const;
+
+  // root: A (n x n) when it has to be factored, B and X (n x k)
+  std::vector<double> matrix_, res_;
+  int rows_{}, nrhs_{};
+  int block_size_;
+  Factors factors_;
+  int factored_rows_{};
+
+  int grid_rows_{}, grid_cols_{}, my_row_{}, my_col_{};
   boost::mpi::communicator world_;
+  boost::mpi::communicator row_comm_;
+  boost::mpi::communicator col_comm_;
+
+  // local blocks of L (unit diagonal) and U, row-major
+  std::vector<double> local_matrix_;
+  int local_rows_{}, local_cols_{};
+  // row i was swapped with row pivots_[i] at step i
+  std::vector<int> pivots_;
+  // B, then X, on every process
+  std::vector<double> rhs_;
+  double tolerance_{};
 };
 
 }  // namespace shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi
\ No newline at end of file
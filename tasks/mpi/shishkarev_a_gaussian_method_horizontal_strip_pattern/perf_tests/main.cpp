@@ -10,6 +10,7 @@
 
 #include "core/perf/include/perf.hpp"
 #include "core/task/include/task.hpp"
+#include "core/util/include/util.hpp"
 #include "mpi/shishkarev_a_gaussian_method_horizontal_strip_pattern/include/ops_mpi.hpp"
 
 namespace shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi {
@@ -47,8 +48,8 @@ double AxB(int n, int m, std::vector<double> a, std::vector<double> res) {
 TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_pipeline_run) {
   boost::mpi::communicator world;
 
-  const int cols = 101;
-  const int rows = 100;
+  const int rows = static_cast<int>(ppc::util::GetScaledPerfSize(512));
+  const int cols = rows + 1;
   std::vector<double> global_matrix(cols * rows);
   std::vector<double> global_res(cols - 1, 0);
 
@@ -56,10 +57,7 @@ TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_pipeline_ru
 
   if (world.rank() == 0) {
     global_matrix = shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::GetRandomMatrix(cols * rows);
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t*>(global_matrix.data()));
-    task_data_par->inputs_count.emplace_back(global_matrix.size());
-    task_data_par->inputs_count.emplace_back(cols);
-    task_data_par->inputs_count.emplace_back(rows);
+    task_data_par->AddInput(global_matrix.data(), {static_cast<uint64_t>(rows), static_cast<uint64_t>(cols)});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t*>(global_res.data()));
     task_data_par->outputs_count.emplace_back(global_res.size());
   }
@@ -91,8 +89,8 @@ TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_pipeline_ru
 TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_task_run) {
   boost::mpi::communicator world;
 
-  const int cols = 101;
-  const int rows = 100;
+  const int rows = static_cast<int>(ppc::util::GetScaledPerfSize(512));
+  const int cols = rows + 1;
   std::vector<double> global_matrix(cols * rows);
   std::vector<double> global_res(cols - 1, 0);
 
@@ -100,10 +98,7 @@ TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_task_run) {
 
   if (world.rank() == 0) {
     global_matrix = shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::GetRandomMatrix(cols * rows);
-    task_data_par->inputs.emplace_back(reinterpret_cast<uint8_t*>(global_matrix.data()));
-    task_data_par->inputs_count.emplace_back(global_matrix.size());
-    task_data_par->inputs_count.emplace_back(cols);
-    task_data_par->inputs_count.emplace_back(rows);
+    task_data_par->AddInput(global_matrix.data(), {static_cast<uint64_t>(rows), static_cast<uint64_t>(cols)});
     task_data_par->outputs.emplace_back(reinterpret_cast<uint8_t*>(global_res.data()));
     task_data_par->outputs_count.emplace_back(global_res.size());
   }
@@ -130,4 +125,59 @@ TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_task_run) {
     ASSERT_NEAR(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::AxB(cols, rows, global_matrix, global_res),
                 0, 1e-6);
   }
-}
\ No newline at end of file
+}
+
+TEST(shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi, test_solve_only_task_run) {
+  boost::mpi::communicator world;
+
+  const int rows = static_cast<int>(ppc::util::GetScaledPerfSize(512));
+  const int nrhs = 16;
+  std::vector<double> a(rows * rows);
+  std::vector<double> b(rows * nrhs);
+  std::vector<double> global_res(rows * nrhs, 0);
+
+  std::shared_ptr<ppc::core::TaskData> task_data_par = std::make_shared<ppc::core::TaskData>();
+
+  if (world.rank() == 0) {
+    a = shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::GetRandomMatrix(rows * rows);
+    b = shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::GetRandomMatrix(rows * nrhs);
+    task_data_par->AddInput(a.data(), {static_cast<uint64_t>(rows), static_cast<uint64_t>(rows)});
+    task_data_par->AddInput(b.data(), {static_cast<uint64_t>(rows), static_cast<uint64_t>(nrhs)});
+    task_data_par->AddOutput(global_res.data(), {static_cast<uint64_t>(rows), static_cast<uint64_t>(nrhs)});
+  }
+
+  // the first run factors A, the timed ones only solve
+  using shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel;
+  auto mpi_gauss_horizontal_parallel = std::make_shared<MPIGaussHorizontalParallel>(
+      task_data_par, MPIGaussHorizontalParallel::kDefaultBlockSize,
+      shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::Factors::kReuse);
+  ASSERT_EQ(mpi_gauss_horizontal_parallel->Validation(), true);
+  mpi_gauss_horizontal_parallel->PreProcessing();
+  ASSERT_EQ(mpi_gauss_horizontal_parallel->Run(), true);
+  mpi_gauss_horizontal_parallel->PostProcessing();
+
+  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
+  perf_attr->num_running = 10;
+  const boost::mpi::timer current_timer;
+  perf_attr->current_timer = [&] { return current_timer.elapsed(); };
+
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+  perf_results->variant = "solve_only";
+
+  auto perf_analyzer = std::make_shared<ppc::core::Perf>(mpi_gauss_horizontal_parallel);
+  perf_analyzer->TaskRun(perf_attr, perf_results);
+  if (world.rank() == 0) {
+    ppc::core::Perf::PrintPerfStatistic(perf_results);
+    for (int r = 0; r < nrhs; ++r) {
+      double residual = 0;
+      for (int i = 0; i < rows; ++i) {
+        double value = -b[(i * nrhs) + r];
+        for (int j = 0; j < rows; ++j) {
+          value += a[(i * rows) + j] * global_res[(j * nrhs) + r];
+        }
+        residual += value * value;
+      }
+      ASSERT_NEAR(std::sqrt(residual), 0, 1e-6);
+    }
+  }
+}
@@ -1,16 +1,24 @@
 #include "mpi/shishkarev_a_gaussian_method_horizontal_strip_pattern/include/ops_mpi.hpp"
 
+#include <mpi.h>
+
 #include <algorithm>
+#include <array>
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
 #include <boost/mpi/collectives/broadcast.hpp>
-#include <boost/mpi/collectives/gather.hpp>
-#include <boost/mpi/status.hpp>
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/mpi/collectives/scatterv.hpp>
+#include <boost/mpi/operations.hpp>
+#include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <limits>
+#include <span>
 #include <vector>
 
-using namespace std::chrono_literals;
-
 int shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MatrixRank(Matrix matrix, std::vector<double> a) {
   int rank = matrix.cols;
   for (int i = 0; i < matrix.cols; ++i) {
@@ -73,33 +81,70 @@ double shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::Determinant(Ma
   return det;
 }
 
+namespace {
+
+// of the global indices [0, n) distributed block-cyclically in blocks of nb over count
+// processes, the number process p owns; also the local index of the first one >= n
+int LocalCount(int n, int nb, int p, int count) {
+  const int cycle = nb * count;
+  const int full = n / cycle;
+  return (full * nb) + std::clamp(n - (full * cycle) - (p * nb), 0, nb);
+}
+
+int OwnerOf(int global, int nb, int count) { return (global / nb) % count; }
+
+int LocalIndex(int global, int nb, int count) { return ((global / (nb * count)) * nb) + (global % nb); }
+
+int GlobalIndex(int local, int nb, int p, int count) { return ((((local / nb) * count) + p) * nb) + (local % nb); }
+
+// pivots at most this large make the matrix numerically singular
+double PivotTolerance(double max_abs, int n) {
+  return max_abs * static_cast<double>(n) * std::numeric_limits<double>::epsilon();
+}
+
+}  // namespace
+
 bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalSequential::PreProcessingImpl() {
-  matrix_ = std::vector<double>(task_data->inputs_count[0]);
-  auto* tmp_ptr = reinterpret_cast<double*>(task_data->inputs[0]);
-  std::ranges::copy(tmp_ptr, tmp_ptr + task_data->inputs_count[0], matrix_.begin());
-  cols_ = static_cast<int>(task_data->inputs_count[1]);
-  rows_ = static_cast<int>(task_data->inputs_count[2]);
+  matrix_ = CopyInput<double>(0);
+  auto shape = task_data->InputShape(0);
+  rows_ = static_cast<int>(shape[0]);
+  cols_ = static_cast<int>(shape[1]);
 
   res_ = std::vector<double>(cols_ - 1, 0);
   return true;
 }
 
 bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalSequential::ValidationImpl() {
-  matrix_ = std::vector<double>(task_data->inputs_count[0]);
-  auto* tmp_ptr = reinterpret_cast<double*>(task_data->inputs[0]);
-  std::ranges::copy(tmp_ptr, tmp_ptr + task_data->inputs_count[0], matrix_.begin());
-  cols_ = static_cast<int>(task_data->inputs_count[1]);
-  rows_ = static_cast<int>(task_data->inputs_count[2]);
-  Matrix matrix;
-  matrix.cols = cols_;
-  matrix.rows = rows_;
-
-  return task_data->inputs_count[0] > 1 && rows_ == cols_ - 1 && Determinant(matrix, matrix_) != 0 &&
-         MatrixRank(matrix, matrix_) == rows_;
+  if (task_data->inputs.empty() || task_data->InputShape(0).size() != 2) {
+    return false;
+  }
+  // singular matrices are detected by the elimination in Run()
+  auto shape = task_data->InputShape(0);
+  return shape[0] * shape[1] > 1 && shape[0] + 1 == shape[1];
 }
 
 bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalSequential::RunImpl() {
-  for (int i = 0; i < rows_ - 1; ++i) {
+  double max_abs = 0.0;
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < rows_; ++j) {
+      max_abs = std::max(max_abs, std::abs(matrix_[(i * cols_) + j]));
+    }
+  }
+  const double tolerance = PivotTolerance(max_abs, rows_);
+  for (int i = 0; i < rows_; ++i) {
+    int pivot = i;
+    for (int k = i + 1; k < rows_; ++k) {
+      if (std::abs(matrix_[(k * cols_) + i]) > std::abs(matrix_[(pivot * cols_) + i])) {
+        pivot = k;
+      }
+    }
+    if (std::abs(matrix_[(pivot * cols_) + i]) <= tolerance) {
+      return false;
+    }
+    if (pivot != i) {
+      std::swap_ranges(matrix_.begin() + (i * cols_), matrix_.begin() + ((i + 1) * cols_),
+                       matrix_.begin() + (pivot * cols_));
+    }
     for (int k = i + 1; k < rows_; ++k) {
       double m = matrix_[(k * cols_) + i] / matrix_[(i * cols_) + i];
       for (int j = i; j < cols_; ++j) {
@@ -125,160 +170,405 @@ bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizont
 
 bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::PreProcessingImpl() {
   if (world_.rank() == 0) {
-    matrix_ = std::vector<double>(task_data->inputs_count[0]);
-    auto* tmp_ptr = reinterpret_cast<double*>(task_data->inputs[0]);
-    std::ranges::copy(tmp_ptr, tmp_ptr + task_data->inputs_count[0], matrix_.begin());
-    cols_ = static_cast<int>(task_data->inputs_count[1]);
-    rows_ = static_cast<int>(task_data->inputs_count[2]);
-
-    res_ = std::vector<double>(cols_ - 1, 0);
+    auto shape = task_data->InputShape(0);
+    rows_ = static_cast<int>(shape[0]);
+    const auto n = static_cast<size_t>(rows_);
+    if (task_data->inputs.size() == 1) {
+      // [A|B]
+      nrhs_ = static_cast<int>(shape[1] - shape[0]);
+      const auto cols = n + nrhs_;
+      auto augmented = CopyInput<double>(0);
+      matrix_.resize(n * n);
+      rhs_.resize(n * nrhs_);
+      for (size_t i = 0; i < n; ++i) {
+        std::copy(augmented.begin() + static_cast<std::ptrdiff_t>(i * cols),
+                  augmented.begin() + static_cast<std::ptrdiff_t>((i * cols) + n), matrix_.begin() + (i * n));
+        std::copy(augmented.begin() + static_cast<std::ptrdiff_t>((i * cols) + n),
+                  augmented.begin() + static_cast<std::ptrdiff_t>((i + 1) * cols), rhs_.begin() + (i * nrhs_));
+      }
+    } else {
+      nrhs_ = static_cast<int>(task_data->InputView<const double>(1).Size() / n);
+      if (!HasFactors()) {
+        matrix_ = CopyInput<double>(0);
+      }
+      rhs_ = CopyInput<double>(1);
+    }
+    res_ = std::vector<double>(n * nrhs_, 0);
   }
   return true;
 }
 
 bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::ValidationImpl() {
   if (world_.rank() == 0) {
-    Matrix matrix;
-    matrix_ = std::vector<double>(task_data->inputs_count[0]);
-    auto* tmp_ptr = reinterpret_cast<double*>(task_data->inputs[0]);
-    std::ranges::copy(tmp_ptr, tmp_ptr + task_data->inputs_count[0], matrix_.begin());
-    cols_ = static_cast<int>(task_data->inputs_count[1]);
-    rows_ = static_cast<int>(task_data->inputs_count[2]);
-    matrix.cols = static_cast<int>(task_data->inputs_count[1]);
-    matrix.rows = static_cast<int>(task_data->inputs_count[2]);
-
-    return task_data->inputs_count[0] > 1 && rows_ == cols_ - 1 && Determinant(matrix, matrix_) != 0 &&
-           MatrixRank(matrix, matrix_) == rows_;
+    const auto& inputs = task_data->inputs;
+    if (inputs.empty() || inputs.size() > 2 || task_data->outputs.empty() || task_data->InputShape(0).size() != 2 ||
+        block_size_ < 1) {
+      return false;
+    }
+    // singular matrices are detected from the pivots in Run()
+    auto shape = task_data->InputShape(0);
+    uint64_t nrhs = 0;
+    if (inputs.size() == 1) {
+      nrhs = shape[1] > shape[0] ? shape[1] - shape[0] : 0;
+    } else {
+      // B is n x k, or a vector of n
+      auto rhs_shape = task_data->InputShape(1);
+      if (shape[0] != shape[1] || rhs_shape[0] != shape[0] || rhs_shape.size() > 2) {
+        return false;
+      }
+      nrhs = rhs_shape.size() == 2 ? rhs_shape[1] : 1;
+    }
+    return shape[0] > 0 && nrhs > 0 && task_data->outputs_count[0] == shape[0] * nrhs;
   }
   return true;
 }
 
-void shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::BroadcastMatrixSize(boost::mpi::communicator& world,
-                                                                                    int& rows, int& cols) {
-  broadcast(world, cols, 0);
-  broadcast(world, rows, 0);
+bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::HasFactors() const {
+  return factors_ == Factors::kReuse && factored_rows_ > 0 && factored_rows_ == rows_;
 }
 
-std::vector<int> shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::ComputeRowDistribution(
-    boost::mpi::communicator& world, int rows) {
-  std::vector<int> row_num(world.size());
-  int delta = rows / world.size();
-  int remainder = rows % world.size();
-  if (world.rank() < remainder) {
-    delta++;
+void shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::SetupGrid() {
+  const int size = world_.size();
+  grid_cols_ = 1;
+  for (int c = 2; c * c <= size; ++c) {
+    if (size % c == 0) {
+      grid_cols_ = c;
+    }
   }
-  boost::mpi::gather(world, delta, row_num, 0);
-  return row_num;
+  grid_rows_ = size / grid_cols_;
+  my_row_ = world_.rank() / grid_cols_;
+  my_col_ = world_.rank() % grid_cols_;
+  // ranks in row_comm_ are process columns, in col_comm_ process rows
+  row_comm_ = world_.split(my_row_, my_col_);
+  col_comm_ = world_.split(my_col_, my_row_);
 }
 
-void shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::DistributeMatrix(boost::mpi::communicator& world,
-                                                                                 const std::vector<int>& row_num,
-                                                                                 int delta, int cols,
-                                                                                 std::vector<double>& matrix) {
-  if (world.rank() == 0) {
-    std::vector<double> send_matrix((delta * cols));
-    for (int proc = 1; proc < world.size(); ++proc) {
-      for (int i = 0; i < row_num[proc]; ++i) {
-        for (int j = 0; j < cols; ++j) {
-          send_matrix[(i * cols) + j] = matrix[((proc + (world.size() * i)) * cols) + j];
+void shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::DistributeMatrix() {
+  const int n = rows_;
+  const int nb = block_size_;
+  local_rows_ = LocalCount(n, nb, my_row_, grid_rows_);
+  local_cols_ = LocalCount(n, nb, my_col_, grid_cols_);
+  local_matrix_.resize(static_cast<size_t>(local_rows_) * local_cols_);
+
+  if (world_.rank() == 0) {
+    std::vector<int> counts(world_.size());
+    std::vector<int> displs(world_.size());
+    auto packed = Scratch().AllocateArray<double>(static_cast<size_t>(n) * n);
+    int offset = 0;
+    for (int p = 0; p < world_.size(); ++p) {
+      const int p_row = p / grid_cols_;
+      const int p_col = p % grid_cols_;
+      const int p_rows = LocalCount(n, nb, p_row, grid_rows_);
+      const int p_cols = LocalCount(n, nb, p_col, grid_cols_);
+      displs[p] = offset;
+      counts[p] = p_rows * p_cols;
+      for (int i = 0; i < p_rows; ++i) {
+        const double* row = matrix_.data() + (static_cast<size_t>(GlobalIndex(i, nb, p_row, grid_rows_)) * n);
+        for (int j = 0; j < p_cols; ++j) {
+          packed[offset++] = row[GlobalIndex(j, nb, p_col, grid_cols_)];
         }
       }
-      world.send(proc, 0, send_matrix.data(), row_num[proc] * cols);
     }
+    boost::mpi::scatterv(world_, packed.data(), counts, displs, local_matrix_.data(),
+                         static_cast<int>(local_matrix_.size()), 0);
+  } else {
+    boost::mpi::scatterv(world_, local_matrix_.data(), static_cast<int>(local_matrix_.size()), 0);
   }
+
+  double max_abs = 0.0;
+  for (double value : local_matrix_) {
+    max_abs = std::max(max_abs, std::abs(value));
+  }
+  tolerance_ = PivotTolerance(boost::mpi::all_reduce(world_, max_abs, boost::mpi::maximum<double>()), n);
+}
+
+void shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::SwapRows(int a, int b,
+                                                                                                    int skip_begin,
+                                                                                                    int skip_end) {
+  const int owner_a = OwnerOf(a, block_size_, grid_rows_);
+  const int owner_b = OwnerOf(b, block_size_, grid_rows_);
+  if (my_row_ != owner_a && my_row_ != owner_b) {
+    return;
+  }
+  auto row_of = [&](int global) {
+    return local_matrix_.begin() + (LocalIndex(global, block_size_, grid_rows_) * local_cols_);
+  };
+  if (owner_a == owner_b) {
+    std::swap_ranges(row_of(a), row_of(a) + skip_begin, row_of(b));
+    std::swap_ranges(row_of(a) + skip_end, row_of(a) + local_cols_, row_of(b) + skip_end);
+    return;
+  }
+  const auto row = row_of(my_row_ == owner_a ? a : b);
+  std::vector<double> buffer(row, row + skip_begin);
+  buffer.insert(buffer.end(), row + skip_end, row + local_cols_);
+  const int partner = my_row_ == owner_a ? owner_b : owner_a;
+  MPI_Sendrecv_replace(buffer.data(), static_cast<int>(buffer.size()), MPI_DOUBLE, partner, 0, partner, 0, col_comm_,
+                       MPI_STATUS_IGNORE);
+  std::copy(buffer.begin(), buffer.begin() + skip_begin, row);
+  std::copy(buffer.begin() + skip_begin, buffer.end(), row + skip_end);
 }
 
-void shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::ReceiveMatrix(boost::mpi::communicator& world,
-                                                                              int delta, int cols,
-                                                                              std::vector<double>& local_matrix,
-                                                                              std::vector<double>& matrix) {
-  local_matrix.resize(delta * cols);
-  if (world.rank() == 0) {
-    for (int i = 0; i < delta; ++i) {
-      for (int j = 0; j < cols; ++j) {
-        local_matrix[(i * cols) + j] = matrix[(i * cols * world.size()) + j];
+bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::FactorPanel(
+    int k, std::span<double> panel) {
+  const int nb = block_size_;
+  const int k0 = k * nb;
+  const int width = std::min(nb, rows_ - k0);
+  const int c0 = LocalIndex(k0, nb, grid_cols_);
+  auto at = [&](int local_row) { return local_matrix_.data() + (static_cast<size_t>(local_row) * local_cols_) + c0; };
+  std::vector<double> pivot_row(width);
+  std::vector<double> replaced_row(width);
+  bool regular = true;
+
+  for (int j = k0; j < k0 + width; ++j) {
+    const int t = j - k0;
+    struct {
+      double value;
+      int index;
+    } local{.value = -1.0, .index = rows_}, best{};
+    for (int i = LocalCount(j, nb, my_row_, grid_rows_); i < local_rows_; ++i) {
+      if (std::abs(at(i)[t]) > local.value) {
+        local = {.value = std::abs(at(i)[t]), .index = GlobalIndex(i, nb, my_row_, grid_rows_)};
       }
     }
-  } else {
-    world.recv(0, 0, local_matrix.data(), delta * cols);
+    MPI_Allreduce(&local, &best, 1, MPI_DOUBLE_INT, MPI_MAXLOC, col_comm_);
+    if (best.value <= tolerance_) {
+      // nothing to eliminate in this column
+      regular = false;
+      pivots_[j] = j;
+      continue;
+    }
+    pivots_[j] = best.index;
+
+    // swap rows j and best.index inside the panel; every process of the column needs the pivot row
+    const int owner_j = OwnerOf(j, nb, grid_rows_);
+    const int owner_p = OwnerOf(best.index, nb, grid_rows_);
+    if (my_row_ == owner_p) {
+      std::copy(at(LocalIndex(best.index, nb, grid_rows_)), at(LocalIndex(best.index, nb, grid_rows_)) + width,
+                pivot_row.begin());
+    }
+    boost::mpi::broadcast(col_comm_, pivot_row.data(), width, owner_p);
+    if (best.index != j) {
+      if (my_row_ == owner_j) {
+        std::copy(at(LocalIndex(j, nb, grid_rows_)), at(LocalIndex(j, nb, grid_rows_)) + width, replaced_row.begin());
+        std::ranges::copy(pivot_row, at(LocalIndex(j, nb, grid_rows_)));
+        if (owner_j != owner_p) {
+          col_comm_.send(owner_p, 0, replaced_row.data(), width);
+        }
+      }
+      if (my_row_ == owner_p) {
+        if (owner_j != owner_p) {
+          col_comm_.recv(owner_j, 0, replaced_row.data(), width);
+        }
+        std::ranges::copy(replaced_row, at(LocalIndex(best.index, nb, grid_rows_)));
+      }
+    }
+
+    for (int i = LocalCount(j + 1, nb, my_row_, grid_rows_); i < local_rows_; ++i) {
+      double* row = at(i);
+      const double l = row[t] / pivot_row[t];
+      row[t] = l;
+      for (int c = t + 1; c < width; ++c) {
+        row[c] -= l * pivot_row[c];
+      }
+    }
+  }
+
+  // pivots, then the local rows of the panel from row k0 on
+  for (int t = 0; t < width; ++t) {
+    panel[t] = static_cast<double>(pivots_[k0 + t]);
+  }
+  double* out = panel.data() + width;
+  for (int i = LocalCount(k0, nb, my_row_, grid_rows_); i < local_rows_; ++i, out += width) {
+    std::copy(at(i), at(i) + width, out);
   }
+  return regular;
 }
 
-void shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::ForwardElimination(boost::mpi::communicator& world,
-                                                                                   Matrix matrix, Vector& vector) {
-  std::vector<double> pivot{static_cast<double>(matrix.cols)};
-  int r = 0;
-  for (int i = 0; i < matrix.rows - 1; ++i) {
-    if (i == vector.row[r]) {
-      for (int j = 0; j < matrix.cols; ++j) {
-        pivot[j] = vector.local_matrix[(r * matrix.cols) + j];
+bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::Factorize() {
+  const int n = rows_;
+  const int nb = block_size_;
+  const int blocks = (n + nb - 1) / nb;
+  pivots_.assign(n, 0);
+  int singular = 0;
+
+  const size_t panel_size = static_cast<size_t>(nb) * (local_rows_ + 1);
+  std::array<std::span<double>, 2> panels{Scratch().AllocateArray<double>(panel_size),
+                                          Scratch().AllocateArray<double>(panel_size)};
+  auto u_block = Scratch().AllocateArray<double>(static_cast<size_t>(nb) * local_cols_);
+  MPI_Request request = MPI_REQUEST_NULL;
+  // panel k goes along the process rows while the previous trailing update runs
+  auto start_panel = [&](int k) {
+    const int k0 = k * nb;
+    const int width = std::min(nb, n - k0);
+    const int root = OwnerOf(k0, nb, grid_cols_);
+    auto panel = panels[k % 2];
+    if (my_col_ == root && !FactorPanel(k, panel)) {
+      singular = 1;
+    }
+    const int count = width * (1 + local_rows_ - LocalCount(k0, nb, my_row_, grid_rows_));
+    MPI_Ibcast(panel.data(), count, MPI_DOUBLE, root, row_comm_, &request);
+  };
+
+  start_panel(0);
+  for (int k = 0; k < blocks; ++k) {
+    const int k0 = k * nb;
+    const int k1 = std::min(n, k0 + nb);
+    const int width = k1 - k0;
+    const int owner_row = OwnerOf(k0, nb, grid_rows_);
+    const int owner_col = OwnerOf(k0, nb, grid_cols_);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    const auto panel = panels[k % 2];
+    const double* l_panel = panel.data() + width;
+    const int panel_row = LocalCount(k0, nb, my_row_, grid_rows_);
+
+    // the panel's interchanges in all other columns, L included
+    for (int t = 0; t < width; ++t) {
+      pivots_[k0 + t] = static_cast<int>(panel[t]);
+    }
+    const int skip_begin = my_col_ == owner_col ? LocalIndex(k0, nb, grid_cols_) : 0;
+    const int skip_end = my_col_ == owner_col ? skip_begin + width : 0;
+    for (int j = k0; j < k1; ++j) {
+      if (pivots_[j] != j) {
+        SwapRows(j, pivots_[j], skip_begin, skip_end);
       }
-      broadcast(world, pivot.data(), matrix.cols, world.rank());
-      r++;
-    } else {
-      broadcast(world, pivot.data(), matrix.cols, i % world.size());
     }
-    for (int k = r; k < matrix.delta; ++k) {
-      double m = vector.local_matrix[(k * matrix.cols) + i] / pivot[i];
-      for (int j = i; j < matrix.cols; ++j) {
-        vector.local_matrix[(k * matrix.cols) + j] -= pivot[j] * m;
+
+    // U12 = L11^-1 A12 in the process row of the panel, then down the process columns
+    const int trail_col = LocalCount(k1, nb, my_col_, grid_cols_);
+    const int trail_width = local_cols_ - trail_col;
+    if (my_row_ == owner_row) {
+      for (int i = 0; i < width; ++i) {
+        double* row = local_matrix_.data() + (static_cast<size_t>(panel_row + i) * local_cols_) + trail_col;
+        for (int t = 0; t < i; ++t) {
+          const double l = l_panel[(i * width) + t];
+          const double* pivot_row =
+              local_matrix_.data() + (static_cast<size_t>(panel_row + t) * local_cols_) + trail_col;
+          for (int c = 0; c < trail_width; ++c) {
+            row[c] -= l * pivot_row[c];
+          }
+        }
+        std::copy(row, row + trail_width, u_block.begin() + (i * trail_width));
       }
     }
+    boost::mpi::broadcast(col_comm_, u_block.data(), width * trail_width, owner_row);
+
+    // A22 -= L21 U12 over the local columns [begin, end) of the trailing matrix
+    const int trail_row = LocalCount(k1, nb, my_row_, grid_rows_);
+    auto update = [&](int begin, int end) {
+      for (int i = trail_row; i < local_rows_; ++i) {
+        double* row = local_matrix_.data() + (static_cast<size_t>(i) * local_cols_) + trail_col;
+        const double* l_row = l_panel + ((i - panel_row) * width);
+        for (int t = 0; t < width; ++t) {
+          const double l = l_row[t];
+          const double* u_row = u_block.data() + (t * trail_width);
+          for (int c = begin; c < end; ++c) {
+            row[c] -= l * u_row[c];
+          }
+        }
+      }
+    };
+    int split = 0;
+    if (k + 1 < blocks) {
+      // lookahead: the columns of the next panel first, so that it can be factored and sent
+      if (my_col_ == OwnerOf(k1, nb, grid_cols_)) {
+        split = std::min(nb, n - k1);
+        update(0, split);
+      }
+      start_panel(k + 1);
+    }
+    update(split, trail_width);
   }
+  return boost::mpi::all_reduce(world_, singular, boost::mpi::maximum<int>()) == 0;
 }
 
-void shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::BackSubstitution(boost::mpi::communicator& world,
-                                                                                 Matrix matrix, Vector& vector) {
-  int r = matrix.delta - 1;
-  for (int i = matrix.rows - 1; i > 0; --i) {
-    if (r >= 0 && i == vector.row[r]) {
-      vector.local_res[i] /= vector.local_matrix[(r * matrix.cols) + i];
-      broadcast(world, vector.local_res[i], world.rank());
-      r--;
-    } else {
-      broadcast(world, vector.local_res[i], i % world.size());
+void shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::Solve(std::span<double> x,
+                                                                                                 int nrhs) {
+  const int n = rows_;
+  const int nb = block_size_;
+  const int blocks = (n + nb - 1) / nb;
+  for (int i = 0; i < n; ++i) {
+    if (pivots_[i] != i) {
+      std::swap_ranges(x.begin() + (i * nrhs), x.begin() + ((i + 1) * nrhs), x.begin() + (pivots_[i] * nrhs));
     }
-    if (r >= 0) {
-      for (int j = 0; j <= r; ++j) {
-        vector.local_res[static_cast<size_t>(vector.row[j])] -=
-            vector.local_matrix[(j * matrix.cols) + i] * vector.local_res[i];
+  }
+  std::vector<double> partial(static_cast<size_t>(nb) * nrhs);
+  std::vector<double> sum(partial.size());
+  // block row k of x: the process row of the block sums up its part of L or U times the known
+  // blocks of x, the owner of the diagonal block solves with it and sends the result to everyone
+  auto solve_block = [&](int k, bool lower) {
+    const int k0 = k * nb;
+    const int width = std::min(nb, n - k0);
+    const int owner_row = OwnerOf(k0, nb, grid_rows_);
+    const int owner_col = OwnerOf(k0, nb, grid_cols_);
+    if (my_row_ == owner_row) {
+      const int first_row = LocalIndex(k0, nb, grid_rows_);
+      const int begin = lower ? 0 : LocalCount(k0 + width, nb, my_col_, grid_cols_);
+      const int end = lower ? LocalCount(k0, nb, my_col_, grid_cols_) : local_cols_;
+      std::ranges::fill(partial, 0.0);
+      for (int i = 0; i < width; ++i) {
+        const double* row = local_matrix_.data() + (static_cast<size_t>(first_row + i) * local_cols_);
+        for (int c = begin; c < end; ++c) {
+          const double* x_row = x.data() + (static_cast<size_t>(GlobalIndex(c, nb, my_col_, grid_cols_)) * nrhs);
+          for (int r = 0; r < nrhs; ++r) {
+            partial[(i * nrhs) + r] += row[c] * x_row[r];
+          }
+        }
+      }
+      boost::mpi::reduce(row_comm_, partial.data(), width * nrhs, sum.data(), std::plus<double>(), owner_col);
+      if (my_col_ == owner_col) {
+        const int first_col = LocalIndex(k0, nb, grid_cols_);
+        auto diagonal = [&](int i, int t) {
+          return local_matrix_[(static_cast<size_t>(first_row + i) * local_cols_) + first_col + t];
+        };
+        for (int step = 0; step < width; ++step) {
+          const int i = lower ? step : width - 1 - step;
+          double* x_i = x.data() + (static_cast<size_t>(k0 + i) * nrhs);
+          for (int r = 0; r < nrhs; ++r) {
+            double value = x_i[r] - sum[(i * nrhs) + r];
+            for (int t = lower ? 0 : i + 1; t < (lower ? i : width); ++t) {
+              value -= diagonal(i, t) * x[(static_cast<size_t>(k0 + t) * nrhs) + r];
+            }
+            x_i[r] = lower ? value : value / diagonal(i, i);
+          }
+        }
       }
     }
-    if (world.rank() == 0) {
-      vector.local_res[0] /= vector.local_matrix[0];
-      vector.res = vector.local_res;
-    }
+    boost::mpi::broadcast(world_, x.data() + (static_cast<size_t>(k0) * nrhs), width * nrhs,
+                          (owner_row * grid_cols_) + owner_col);
+  };
+  for (int k = 0; k < blocks; ++k) {
+    solve_block(k, true);
+  }
+  for (int k = blocks - 1; k >= 0; --k) {
+    solve_block(k, false);
   }
 }
 
 bool shishkarev_a_gaussian_method_horizontal_strip_pattern_mpi::MPIGaussHorizontalParallel::RunImpl() {
-  BroadcastMatrixSize(world_, rows_, cols_);
-  std::vector<int> row_num = ComputeRowDistribution(world_, rows_);
-  DistributeMatrix(world_, row_num, row_num[world_.rank()], cols_, matrix_);
-  ReceiveMatrix(world_, row_num[world_.rank()], cols_, local_matrix_, matrix_);
-
-  std::vector<double> row(row_num[world_.rank()]);
-  for (int i = 0; i < static_cast<int>(row.size()); ++i) {
-    row[i] = world_.rank() + world_.size() * i;
+  boost::mpi::broadcast(world_, rows_, 0);
+  boost::mpi::broadcast(world_, nrhs_, 0);
+  if (grid_cols_ == 0) {
+    SetupGrid();
+  }
+  if (!HasFactors()) {
+    factored_rows_ = 0;
+    {
+      auto scope = OpenScope("distribute");
+      DistributeMatrix();
+    }
+    auto scope = OpenScope("factorize");
+    if (!Factorize()) {
+      return false;
+    }
+    factored_rows_ = rows_;
+  }
+  auto scope = OpenScope("solve");
+  rhs_.resize(static_cast<size_t>(rows_) * nrhs_);
+  boost::mpi::broadcast(world_, rhs_.data(), static_cast<int>(rhs_.size()), 0);
+  Solve(rhs_, nrhs_);
+  if (world_.rank() == 0) {
+    std::ranges::copy(rhs_, res_.begin());
   }
-
-  Matrix matrix;
-  matrix.cols = cols_;
-  matrix.rows = rows_;
-  matrix.delta = row_num[world_.rank()];
-
-  Vector vector;
-  vector.local_matrix = local_matrix_;
-  vector.local_res = local_res_;
-  vector.res = res_;
-  vector.row = row;
-
-  ForwardElimination(world_, matrix, vector);
-
-  local_res_.resize(cols_ - 1, 0);
-  vector.local_res = local_res_;
-
-  BackSubstitution(world_, matrix, vector);
   return true;
 }
 
@@ -1,15 +1,40 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <boost/mpi/communicator.hpp>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <random>
 #include <vector>
 
 #include "core/task/include/task.hpp"
 #include "mpi/shuravina_o_contrast/include/ops_mpi.hpp"
 
+namespace {
+
+// the stretched image, with the image given on rank 0 only
+std::vector<uint8_t> RunContrast(std::vector<uint8_t>& in) {
+  boost::mpi::communicator world;
+  std::vector<uint8_t> out(in.size(), 0);
+  auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
+  if (world.rank() == 0) {
+    task_data_mpi->inputs.emplace_back(in.data());
+    task_data_mpi->inputs_count.emplace_back(in.size());
+    task_data_mpi->outputs.emplace_back(out.data());
+    task_data_mpi->outputs_count.emplace_back(out.size());
+  }
+  shuravina_o_contrast::ContrastTaskMPI test_task_mpi(task_data_mpi);
+  EXPECT_TRUE(test_task_mpi.Validation());
+  test_task_mpi.PreProcessing();
+  test_task_mpi.Run();
+  test_task_mpi.PostProcessing();
+  return out;
+}
+
+}  // namespace
+
 TEST(shuravina_o_contrast, test_min_max_values) {
   constexpr size_t kCount = 256;
 
@@ -34,8 +59,10 @@ TEST(shuravina_o_contrast, test_min_max_values) {
   test_task_mpi.Run();
   test_task_mpi.PostProcessing();
 
-  uint8_t max_val = *std::ranges::max_element(out);
-  EXPECT_EQ(max_val, 255);
+  if (boost::mpi::communicator().rank() == 0) {
+    uint8_t max_val = *std::ranges::max_element(out);
+    EXPECT_EQ(max_val, 255);
+  }
 }
 
 TEST(shuravina_o_contrast, test_random_values) {
@@ -62,10 +89,12 @@ TEST(shuravina_o_contrast, test_random_values) {
   test_task_mpi.Run();
   test_task_mpi.PostProcessing();
 
-  uint8_t min_val = *std::ranges::min_element(out);
-  uint8_t max_val = *std::ranges::max_element(out);
-  EXPECT_EQ(min_val, 0);
-  EXPECT_EQ(max_val, 255);
+  if (boost::mpi::communicator().rank() == 0) {
+    uint8_t min_val = *std::ranges::min_element(out);
+    uint8_t max_val = *std::ranges::max_element(out);
+    EXPECT_EQ(min_val, 0);
+    EXPECT_EQ(max_val, 255);
+  }
 }
 TEST(shuravina_o_contrast, test_all_values_same) {
   constexpr size_t kCount = 256;
@@ -85,10 +114,12 @@ TEST(shuravina_o_contrast, test_all_values_same) {
   test_task_mpi.Run();
   test_task_mpi.PostProcessing();
 
-  uint8_t max_val = *std::ranges::max_element(out);
-  uint8_t min_val = *std::ranges::min_element(out);
-  EXPECT_EQ(max_val, 255);
-  EXPECT_EQ(min_val, 255);
+  if (boost::mpi::communicator().rank() == 0) {
+    uint8_t max_val = *std::ranges::max_element(out);
+    uint8_t min_val = *std::ranges::min_element(out);
+    EXPECT_EQ(max_val, 255);
+    EXPECT_EQ(min_val, 255);
+  }
 }
 
 TEST(shuravina_o_contrast, test_all_values_max) {
@@ -109,10 +140,12 @@ TEST(shuravina_o_contrast, test_all_values_max) {
   test_task_mpi.Run();
   test_task_mpi.PostProcessing();
 
-  uint8_t max_val = *std::ranges::max_element(out);
-  uint8_t min_val = *std::ranges::min_element(out);
-  EXPECT_EQ(max_val, 255);
-  EXPECT_EQ(min_val, 255);
+  if (boost::mpi::communicator().rank() == 0) {
+    uint8_t max_val = *std::ranges::max_element(out);
+    uint8_t min_val = *std::ranges::min_element(out);
+    EXPECT_EQ(max_val, 255);
+    EXPECT_EQ(min_val, 255);
+  }
 }
 
 TEST(shuravina_o_contrast, test_alternating_min_max_values) {
@@ -139,10 +172,12 @@ TEST(shuravina_o_contrast, test_alternating_min_max_values) {
   test_task_mpi.Run();
   test_task_mpi.PostProcessing();
 
-  uint8_t max_val = *std::ranges::max_element(out);
-  uint8_t min_val = *std::ranges::min_element(out);
-  EXPECT_EQ(max_val, 255);
-  EXPECT_EQ(min_val, 0);
+  if (boost::mpi::communicator().rank() == 0) {
+    uint8_t max_val = *std::ranges::max_element(out);
+    uint8_t min_val = *std::ranges::min_element(out);
+    EXPECT_EQ(max_val, 255);
+    EXPECT_EQ(min_val, 0);
+  }
 }
 
 TEST(shuravina_o_contrast, test_single_unique_value) {
@@ -163,8 +198,39 @@ TEST(shuravina_o_contrast, test_single_unique_value) {
   test_task_mpi.Run();
   test_task_mpi.PostProcessing();
 
-  uint8_t max_val = *std::ranges::max_element(out);
-  uint8_t min_val = *std::ranges::min_element(out);
-  EXPECT_EQ(max_val, 255);
-  EXPECT_EQ(min_val, 255);
-}
\ No newline at end of file
+  if (boost::mpi::communicator().rank() == 0) {
+    uint8_t max_val = *std::ranges::max_element(out);
+    uint8_t min_val = *std::ranges::min_element(out);
+    EXPECT_EQ(max_val, 255);
+    EXPECT_EQ(min_val, 255);
+  }
+}
+
+TEST(shuravina_o_contrast, test_matches_direct_stretch) {
+  boost::mpi::communicator world;
+  // a size that does not split evenly, values between 37 and 201
+  std::vector<uint8_t> in(7007);
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> value(37, 201);
+  for (auto &pixel : in) {
+    pixel = static_cast<uint8_t>(value(gen));
+  }
+  in[100] = 37;
+  in[6000] = 201;
+
+  const auto out = RunContrast(in);
+  if (world.rank() == 0) {
+    for (size_t i = 0; i < in.size(); ++i) {
+      ASSERT_EQ(out[i], (in[i] - 37) * 255 / (201 - 37)) << "pixel " << i;
+    }
+  }
+}
+
+TEST(shuravina_o_contrast, test_fewer_pixels_than_ranks) {
+  boost::mpi::communicator world;
+  std::vector<uint8_t> in = {30, 10, 20};
+  const auto out = RunContrast(in);
+  if (world.rank() == 0) {
+    EXPECT_EQ(out, std::vector<uint8_t>({255, 0, 127}));
+  }
+}
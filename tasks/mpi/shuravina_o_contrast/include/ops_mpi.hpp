@@ -1,7 +1,7 @@
 #pragma once
 
-#include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
+#include <cstddef>
 #include <cstdint>
 #include <utility>
 #include <vector>
@@ -10,6 +10,11 @@
 
 namespace shuravina_o_contrast {
 
+// Linear contrast stretch of an 8-bit image, (in - min) * 255 / (max - min),
+// or 255 everywhere for a constant image. inputs[0] and outputs[0] are only
+// needed on rank 0. Every rank gets a strip of the pixels, finds its min and
+// max, one allreduce combines them, every rank stretches its strip through a
+// 256-entry table and only rank 0 gathers the result.
 class ContrastTaskMPI : public ppc::core::Task {
  public:
   explicit ContrastTaskMPI(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
@@ -19,11 +24,12 @@ class ContrastTaskMPI : public ppc::core::Task {
   bool PostProcessingImpl() override;
 
  private:
-  std::vector<uint8_t> input_, output_;
-  int rc_size_{};
   boost::mpi::communicator world_;
-
-  void IncreaseContrast();
+  // pixels of every rank and where they start in the image
+  std::vector<int> counts_;
+  std::vector<int> displacements_;
+  // the strip of this rank, stretched in place
+  std::vector<uint8_t> strip_;
 };
 
-}  // namespace shuravina_o_contrast
\ No newline at end of file
+}  // namespace shuravina_o_contrast
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <boost/mpi/communicator.hpp>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -8,23 +9,54 @@
 
 #include "core/perf/include/perf.hpp"
 #include "core/task/include/task.hpp"
+#include "core/util/include/util.hpp"
 #include "mpi/shuravina_o_contrast/include/ops_mpi.hpp"
 
-TEST(shuravina_o_contrast_mpi, test_pipeline_run) {
-  constexpr size_t kSize = 4096;
-  std::vector<uint8_t> in(kSize * kSize, 128);
-  std::vector<uint8_t> out(kSize * kSize, 0);
+namespace {
+
+// GetScaledPerfSize(10000) rows of 10000 pixels (100 megapixels at scale 1), between 40 and 199
+std::vector<uint8_t> MakeImage() {
+  constexpr size_t kWidth = 10000;
+  std::vector<uint8_t> image(ppc::util::GetScaledPerfSize(10000) * kWidth);
+  for (size_t i = 0; i < image.size(); ++i) {
+    image[i] = static_cast<uint8_t>(40 + ((i * 7919) % 160));
+  }
+  return image;
+}
 
+// the image on rank 0 only, as the task needs it
+std::shared_ptr<ppc::core::TaskData> MakeTaskData(const boost::mpi::communicator &world, std::vector<uint8_t> &in,
+                                                  std::vector<uint8_t> &out) {
   auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
-  task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
-  task_data_mpi->inputs_count.emplace_back(in.size());
-  task_data_mpi->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
-  task_data_mpi->outputs_count.emplace_back(out.size());
+  if (world.rank() == 0) {
+    task_data_mpi->inputs.emplace_back(in.data());
+    task_data_mpi->inputs_count.emplace_back(in.size());
+    task_data_mpi->outputs.emplace_back(out.data());
+    task_data_mpi->outputs_count.emplace_back(out.size());
+  }
+  return task_data_mpi;
+}
+
+void ExpectStretched(const boost::mpi::communicator &world, const std::vector<uint8_t> &in,
+                     const std::vector<uint8_t> &out) {
+  if (world.rank() == 0) {
+    for (size_t i = 0; i < in.size(); i += 9973) {
+      ASSERT_EQ(out[i], (in[i] - 40) * 255 / 159);
+    }
+  }
+}
 
-  auto test_task_mpi = std::make_shared<shuravina_o_contrast::ContrastTaskMPI>(task_data_mpi);
+}  // namespace
+
+TEST(shuravina_o_contrast_mpi, test_pipeline_run) {
+  boost::mpi::communicator world;
+  std::vector<uint8_t> in = world.rank() == 0 ? MakeImage() : std::vector<uint8_t>{};
+  std::vector<uint8_t> out(in.size(), 0);
+
+  auto test_task_mpi = std::make_shared<shuravina_o_contrast::ContrastTaskMPI>(MakeTaskData(world, in, out));
 
   auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
-  perf_attr->num_running = 100;
+  perf_attr->num_running = 5;
   const auto t0 = std::chrono::high_resolution_clock::now();
   perf_attr->current_timer = [&] {
     auto current_time_point = std::chrono::high_resolution_clock::now();
@@ -35,24 +67,21 @@ TEST(shuravina_o_contrast_mpi, test_pipeline_run) {
   auto perf_results = std::make_shared<ppc::core::PerfResults>();
   auto perf_analyzer = std::make_shared<ppc::core::Perf>(test_task_mpi);
   perf_analyzer->PipelineRun(perf_attr, perf_results);
-  ppc::core::Perf::PrintPerfStatistic(perf_results);
+  if (world.rank() == 0) {
+    ppc::core::Perf::PrintPerfStatistic(perf_results);
+  }
+  ExpectStretched(world, in, out);
 }
 
 TEST(shuravina_o_contrast_mpi, test_task_run) {
-  constexpr size_t kSize = 4096;
-  std::vector<uint8_t> in(kSize * kSize, 128);
-  std::vector<uint8_t> out(kSize * kSize, 0);
+  boost::mpi::communicator world;
+  std::vector<uint8_t> in = world.rank() == 0 ? MakeImage() : std::vector<uint8_t>{};
+  std::vector<uint8_t> out(in.size(), 0);
 
-  auto task_data_mpi = std::make_shared<ppc::core::TaskData>();
-  task_data_mpi->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
-  task_data_mpi->inputs_count.emplace_back(in.size());
-  task_data_mpi->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
-  task_data_mpi->outputs_count.emplace_back(out.size());
-
-  auto test_task_mpi = std::make_shared<shuravina_o_contrast::ContrastTaskMPI>(task_data_mpi);
+  auto test_task_mpi = std::make_shared<shuravina_o_contrast::ContrastTaskMPI>(MakeTaskData(world, in, out));
 
   auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
-  perf_attr->num_running = 1000;
+  perf_attr->num_running = 5;
   const auto t0 = std::chrono::high_resolution_clock::now();
   perf_attr->current_timer = [&] {
     auto current_time_point = std::chrono::high_resolution_clock::now();
@@ -63,5 +92,8 @@ TEST(shuravina_o_contrast_mpi, test_task_run) {
   auto perf_results = std::make_shared<ppc::core::PerfResults>();
   auto perf_analyzer = std::make_shared<ppc::core::Perf>(test_task_mpi);
   perf_analyzer->TaskRun(perf_attr, perf_results);
-  ppc::core::Perf::PrintPerfStatistic(perf_results);
-}
\ No newline at end of file
+  if (world.rank() == 0) {
+    ppc::core::Perf::PrintPerfStatistic(perf_results);
+  }
+  ExpectStretched(world, in, out);
+}
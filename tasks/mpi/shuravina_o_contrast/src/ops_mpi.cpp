@@ -1,57 +1,112 @@
 #include "mpi/shuravina_o_contrast/include/ops_mpi.hpp"
 
+#include <mpi.h>
+
 #include <algorithm>
-#include <boost/mpi/collectives.hpp>
+#include <array>
 #include <boost/mpi/collectives/broadcast.hpp>
-#include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <stdexcept>
+#include <limits>
+#include <utility>
 #include <vector>
 
-bool shuravina_o_contrast::ContrastTaskMPI::PreProcessingImpl() {
-  const unsigned int input_size = task_data->inputs_count[0];
-  auto *in_ptr = reinterpret_cast<uint8_t *>(task_data->inputs[0]);
-  if (in_ptr == nullptr) {
-    throw std::runtime_error("Input pointer is null");
-  }
-  input_ = std::vector<uint8_t>(in_ptr, in_ptr + input_size);
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-  const unsigned int output_size = task_data->outputs_count[0];
-  output_ = std::vector<uint8_t>(output_size, 0);
+namespace {
 
-  rc_size_ = static_cast<int>(std::sqrt(input_size));
-  return true;
+// smallest and largest pixel, (255, 0) for none; 16 pixels per step with SSE2,
+// which every x86-64 processor has
+std::pair<uint8_t, uint8_t> MinMax(const uint8_t* pixels, size_t count) {
+  uint8_t low = 255;
+  uint8_t high = 0;
+  size_t i = 0;
+#if defined(__SSE2__)
+  constexpr size_t kWidth = 16;
+  if (count >= kWidth) {
+    __m128i lows = _mm_set1_epi8(static_cast<char>(-1));
+    __m128i highs = _mm_setzero_si128();
+    for (; i + kWidth <= count; i += kWidth) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+      lows = _mm_min_epu8(lows, block);
+      highs = _mm_max_epu8(highs, block);
+    }
+    std::array<uint8_t, kWidth> lanes{};
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.data()), lows);
+    low = *std::ranges::min_element(lanes);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.data()), highs);
+    high = *std::ranges::max_element(lanes);
+  }
+#endif
+  for (; i < count; ++i) {
+    low = std::min(low, pixels[i]);
+    high = std::max(high, pixels[i]);
+  }
+  return {low, high};
 }
 
-bool shuravina_o_contrast::ContrastTaskMPI::ValidationImpl() {
-  return task_data->inputs_count[0] == task_data->outputs_count[0];
+// the stretched value of every possible pixel
+std::array<uint8_t, 256> StretchTable(uint8_t low, uint8_t high) {
+  std::array<uint8_t, 256> table{};
+  if (low >= high) {
+    table.fill(255);
+    return table;
+  }
+  for (int value = low; value <= high; ++value) {
+    table[value] = static_cast<uint8_t>((value - low) * 255 / (high - low));
+  }
+  return table;
 }
 
-void shuravina_o_contrast::ContrastTaskMPI::IncreaseContrast() {
-  const uint8_t min_val = *std::ranges::min_element(input_);
-  const uint8_t max_val = *std::ranges::max_element(input_);
+}  // namespace
 
-  if (min_val == max_val) {
-    std::ranges::fill(output_, 255);
-    return;
+bool shuravina_o_contrast::ContrastTaskMPI::ValidationImpl() {
+  if (world_.rank() != 0) {
+    return true;
   }
+  return task_data->inputs.size() == 1 && task_data->outputs.size() == 1 && task_data->inputs[0] != nullptr &&
+         task_data->outputs[0] != nullptr && !task_data->inputs_count.empty() &&
+         task_data->inputs_count == task_data->outputs_count &&
+         task_data->inputs_count[0] <= static_cast<unsigned int>(std::numeric_limits<int>::max());
+}
 
-  for (size_t i = 0; i < input_.size(); ++i) {
-    output_[i] = static_cast<uint8_t>((input_[i] - min_val) * 255 / (max_val - min_val));
+bool shuravina_o_contrast::ContrastTaskMPI::PreProcessingImpl() {
+  int size = world_.rank() == 0 ? static_cast<int>(task_data->inputs_count[0]) : 0;
+  boost::mpi::broadcast(world_, size, 0);
+  const int ranks = world_.size();
+  counts_.assign(ranks, size / ranks);
+  displacements_.assign(ranks, 0);
+  for (int rank = 0; rank < ranks; ++rank) {
+    counts_[rank] += rank < size % ranks ? 1 : 0;
+    if (rank > 0) {
+      displacements_[rank] = displacements_[rank - 1] + counts_[rank - 1];
+    }
   }
+  strip_.resize(counts_[world_.rank()]);
+  return true;
 }
 
 bool shuravina_o_contrast::ContrastTaskMPI::RunImpl() {
-  if (world_.rank() == 0) {
-    IncreaseContrast();
+  const bool root = world_.rank() == 0;
+  const int count = counts_[world_.rank()];
+  MPI_Scatterv(root ? task_data->inputs[0] : nullptr, counts_.data(), displacements_.data(), MPI_UINT8_T,
+               strip_.data(), count, MPI_UINT8_T, 0, world_);
+
+  // min and 255 - max in one reduction; an empty strip gives (255, 255), the identity
+  const auto [low, high] = MinMax(strip_.data(), strip_.size());
+  std::array<uint8_t, 2> bounds = {low, static_cast<uint8_t>(255 - high)};
+  MPI_Allreduce(MPI_IN_PLACE, bounds.data(), 2, MPI_UINT8_T, MPI_MIN, world_);
+
+  const auto table = StretchTable(bounds[0], static_cast<uint8_t>(255 - bounds[1]));
+  for (auto& pixel : strip_) {
+    pixel = table[pixel];
   }
-  world_.barrier();
-  boost::mpi::broadcast(world_, output_.data(), static_cast<int>(output_.size()), 0);
+
+  MPI_Gatherv(strip_.data(), count, MPI_UINT8_T, root ? task_data->outputs[0] : nullptr, counts_.data(),
+              displacements_.data(), MPI_UINT8_T, 0, world_);
   return true;
 }
 
-bool shuravina_o_contrast::ContrastTaskMPI::PostProcessingImpl() {
-  std::ranges::copy(output_, reinterpret_cast<uint8_t *>(task_data->outputs[0]));
-  return true;
-}
\ No newline at end of file
+bool shuravina_o_contrast::ContrastTaskMPI::PostProcessingImpl() { return true; }
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <map>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -9,6 +7,8 @@
 
 namespace karaseva_e_binaryimage_seq {
 
+// Objects are the pixels equal to 0 and 8-connected; background pixels get
+// label 1, objects 2, 3, ... in raster order of their first pixel.
 class TestTaskSequential : public ppc::core::Task {
  public:
   explicit TestTaskSequential(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
@@ -18,15 +18,6 @@ class TestTaskSequential : public ppc::core::Task {
   bool PostProcessingImpl() override;
 
  private:
-  int GetRootLabel(std::unordered_map<int, int>& label_parent, int label);
-  void UnionLabels(std::unordered_map<int, int>& label_parent, int label1, int label2);
-  void Labeling(std::vector<int>& image, std::vector<int>& labeled_image, int rows, int cols, int min_label,
-                std::unordered_map<int, int>& label_parent, int x, int y);
-
-  std::vector<int> input_;
-  std::vector<int> output_;
-  int rc_size_{};
-  std::map<int, int> label_equivalence_;
   std::vector<int> image_;
   std::vector<int> labeled_image_;
   int rows_;
@@ -3,7 +3,6 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
-#include <set>
 #include <utility>
 #include <vector>
 
@@ -11,6 +10,9 @@
 
 namespace leontev_n_binary_seq {
 
+// Labels the nonzero pixels 1, 2, ... by component in raster order, zero
+// pixels stay 0. A pixel is connected to its left, up and up-left neighbour
+// (and down, right, down-right), not to the up-right one.
 class BinarySegmentsSeq : public ppc::core::Task {
  public:
   explicit BinarySegmentsSeq(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
@@ -20,8 +22,6 @@ class BinarySegmentsSeq : public ppc::core::Task {
   bool PostProcessingImpl() override;
 
  private:
-  [[nodiscard]] size_t GetIndex(size_t i, size_t j) const;
-  void LoopProcess(size_t col, size_t row, uint32_t& cur_label, std::vector<std::set<uint32_t>>& label_equivalences);
   std::vector<uint8_t> input_image_;
   std::vector<uint32_t> labels_;
   size_t rows_;
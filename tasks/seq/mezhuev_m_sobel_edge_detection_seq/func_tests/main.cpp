@@ -8,6 +8,7 @@
 #include <memory>
 #include <vector>
 
+#include "core/stencil/include/stencil.hpp"
 #include "core/task/include/task.hpp"
 #include "seq/mezhuev_m_sobel_edge_detection_seq/include/seq.hpp"
 
@@ -155,3 +156,67 @@ TEST(mezhuev_m_sobel_edge_detection_seq, test_horizontal_gradient) {
               sobel_task->PostProcessingImpl());
   ASSERT_TRUE(std::ranges::any_of(out, [](uint8_t val) { return val > 0; }));
 }
+
+TEST(mezhuev_m_sobel_edge_detection_seq, test_non_square_image) {
+  constexpr size_t kHeight = 7;
+  constexpr size_t kWidth = 29;
+  std::vector<uint8_t> in(kHeight * kWidth);
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<uint8_t>((i * 37) % 251);
+  }
+  std::vector<uint8_t> out(in.size(), 7);
+  auto task_data = std::make_shared<ppc::core::TaskData>();
+  task_data->AddInput(in.data(), {kHeight, kWidth});
+  task_data->AddOutput(out.data(), {kHeight, kWidth});
+
+  mezhuev_m_sobel_edge_detection_seq::SobelEdgeDetectionSeq sobel_task(task_data);
+  ASSERT_TRUE(sobel_task.ValidationImpl() && sobel_task.PreProcessingImpl() && sobel_task.RunImpl());
+  for (size_t y = 0; y < kHeight; ++y) {
+    for (size_t x = 0; x < kWidth; ++x) {
+      int expected = 0;
+      if (y > 0 && y + 1 < kHeight && x > 0 && x + 1 < kWidth) {
+        auto at = [&](size_t row, size_t col) { return static_cast<int>(in[(row * kWidth) + col]); };
+        const int gx = at(y - 1, x + 1) + (2 * at(y, x + 1)) + at(y + 1, x + 1) - at(y - 1, x - 1) -
+                       (2 * at(y, x - 1)) - at(y + 1, x - 1);
+        const int gy = at(y + 1, x - 1) + (2 * at(y + 1, x)) + at(y + 1, x + 1) - at(y - 1, x - 1) -
+                       (2 * at(y - 1, x)) - at(y - 1, x + 1);
+        expected = std::min(static_cast<int>(std::sqrt(static_cast<double>((gx * gx) + (gy * gy)))), 255);
+      }
+      ASSERT_EQ(out[(y * kWidth) + x], expected) << "pixel " << y << ", " << x;
+    }
+  }
+}
+
+TEST(mezhuev_m_sobel_edge_detection_seq, test_l1_magnitude_and_suppression) {
+  // a soft vertical edge: the gradients of the columns 3-6 are 80, 200, 160 and 40
+  constexpr size_t kSize = 10;
+  const std::vector<uint8_t> profile = {0, 0, 0, 0, 20, 50, 60, 60, 60, 60};
+  std::vector<uint8_t> in(kSize * kSize);
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = profile[i % kSize];
+  }
+  auto run = [&](const ppc::stencil::SobelOptions& options) {
+    std::vector<uint8_t> out(in.size(), 7);
+    auto task_data = std::make_shared<ppc::core::TaskData>();
+    task_data->inputs = {in.data()};
+    task_data->inputs_count = {static_cast<uint32_t>(in.size())};
+    task_data->outputs = {out.data()};
+    task_data->outputs_count = {static_cast<uint32_t>(out.size())};
+    mezhuev_m_sobel_edge_detection_seq::SobelEdgeDetectionSeq sobel_task(task_data, options);
+    EXPECT_TRUE(sobel_task.ValidationImpl() && sobel_task.PreProcessingImpl() && sobel_task.RunImpl());
+    return out;
+  };
+
+  const auto l1 = run({.magnitude = ppc::stencil::Magnitude::kL1, .non_max_suppression = false});
+  const auto thin = run({.magnitude = ppc::stencil::Magnitude::kL2, .non_max_suppression = true});
+  const std::vector<uint8_t> l1_row = {0, 0, 0, 80, 200, 160, 40, 0, 0, 0};
+  const std::vector<uint8_t> thin_row = {0, 0, 0, 0, 200, 0, 0, 0, 0, 0};
+  for (size_t y = 0; y < kSize; ++y) {
+    for (size_t x = 0; x < kSize; ++x) {
+      const bool l1_inside = y >= 1 && y + 1 < kSize;
+      const bool thin_inside = y >= 2 && y + 2 < kSize;
+      EXPECT_EQ(l1[(y * kSize) + x], l1_inside ? l1_row[x] : 0) << "pixel " << y << ", " << x;
+      EXPECT_EQ(thin[(y * kSize) + x], thin_inside ? thin_row[x] : 0) << "pixel " << y << ", " << x;
+    }
+  }
+}
@@ -1,16 +1,21 @@
-#include <cmath>
-#include <cstdint>
+#include <cstddef>
 #include <memory>
 #include <utility>
-#include <vector>
 
+#include "core/stencil/include/stencil.hpp"
 #include "core/task/include/task.hpp"
 
 namespace mezhuev_m_sobel_edge_detection_seq {
 
+// Sobel magnitude by ppc::stencil::Sobel, by default min(sqrt(gx^2 + gy^2), 255).
+// The image is height x width from the shape of inputs[0], or a square of
+// inputs_count[0] pixels without one; the pixels closer to its edges than
+// SobelRadius(options) are 0.
 class SobelEdgeDetectionSeq : public ppc::core::Task {
  public:
-  explicit SobelEdgeDetectionSeq(std::shared_ptr<ppc::core::TaskData> task_data) : Task(std::move(task_data)) {}
+  explicit SobelEdgeDetectionSeq(std::shared_ptr<ppc::core::TaskData> task_data,
+                                 ppc::stencil::SobelOptions options = {})
+      : Task(std::move(task_data)), options_(options) {}
 
   bool PreProcessingImpl() override;
   bool RunImpl() override;
@@ -18,8 +23,9 @@ class SobelEdgeDetectionSeq : public ppc::core::Task {
   bool PostProcessingImpl() override;
 
  private:
-  std::vector<int16_t> gradient_x_;
-  std::vector<int16_t> gradient_y_;
+  ppc::stencil::SobelOptions options_;
+  size_t height_ = 0;
+  size_t width_ = 0;
 };
 
 }  // namespace mezhuev_m_sobel_edge_detection_seq
\ No newline at end of file
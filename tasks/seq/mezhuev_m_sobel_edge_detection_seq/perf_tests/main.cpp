@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -7,7 +8,9 @@
 #include <vector>
 
 #include "core/perf/include/perf.hpp"
+#include "core/stencil/include/stencil.hpp"
 #include "core/task/include/task.hpp"
+#include "core/util/include/util.hpp"
 #include "seq/mezhuev_m_sobel_edge_detection_seq/include/seq.hpp"
 
 TEST(mezhuev_m_sobel_edge_detection_seq, test_pipeline_run) {
@@ -101,4 +104,46 @@ TEST(mezhuev_m_sobel_edge_detection_seq, test_task_run) {
     }
   }
   ASSERT_TRUE(has_edges);
-}
\ No newline at end of file
+}
+
+TEST(mezhuev_m_sobel_edge_detection_seq, test_task_run_suppression_4k) {
+  // a frame much larger than the caches (GetScaledPerfSize(4096) rows of 4096 pixels), with L1 magnitudes and
+  // non-maximum suppression
+  constexpr size_t kWidth = 4096;
+  const size_t height = ppc::util::GetScaledPerfSize(4096);
+
+  std::vector<uint8_t> in(kWidth * height, 0);
+  std::vector<uint8_t> out(kWidth * height, 0);
+
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < kWidth; ++x) {
+      in[(y * kWidth) + x] = static_cast<uint8_t>(((x * x) + (3 * y)) % 256);
+    }
+  }
+
+  auto task_data_seq = std::make_shared<ppc::core::TaskData>();
+  task_data_seq->AddInput(in.data(), {height, kWidth});
+  task_data_seq->AddOutput(out.data(), {height, kWidth});
+
+  const ppc::stencil::SobelOptions options{.magnitude = ppc::stencil::Magnitude::kL1, .non_max_suppression = true};
+  auto sobel_task =
+      std::make_shared<mezhuev_m_sobel_edge_detection_seq::SobelEdgeDetectionSeq>(task_data_seq, options);
+
+  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
+  perf_attr->num_running = 10;
+  const auto t0 = std::chrono::high_resolution_clock::now();
+  perf_attr->current_timer = [&] {
+    auto current_time_point = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(current_time_point - t0).count();
+    return static_cast<double>(duration) * 1e-9;
+  };
+
+  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+  perf_results->variant = "suppression_4k";
+
+  auto perf_analyzer = std::make_shared<ppc::core::Perf>(sobel_task);
+  perf_analyzer->TaskRun(perf_attr, perf_results);
+  ppc::core::Perf::PrintPerfStatistic(perf_results);
+
+  ASSERT_TRUE(std::ranges::any_of(out, [](uint8_t value) { return value > 0; }));
+}
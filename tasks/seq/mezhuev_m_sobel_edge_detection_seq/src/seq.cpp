@@ -5,6 +5,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "core/stencil/include/stencil.hpp"
+
 namespace mezhuev_m_sobel_edge_detection_seq {
 
 bool SobelEdgeDetectionSeq::PreProcessingImpl() {
@@ -12,18 +14,16 @@ bool SobelEdgeDetectionSeq::PreProcessingImpl() {
     return false;
   }
 
-  size_t total_pixels = task_data->inputs_count[0];
-  auto width = static_cast<size_t>(std::sqrt(total_pixels));
-  auto height = width;
-
-  if (width < 3 || height < 3) {
-    return false;
+  const auto shape = task_data->InputShape(0);
+  if (shape.size() == 2) {
+    height_ = shape[0];
+    width_ = shape[1];
+  } else {
+    width_ = static_cast<size_t>(std::sqrt(task_data->inputs_count[0]));
+    height_ = width_;
   }
 
-  gradient_x_.resize(width * height);
-  gradient_y_.resize(width * height);
-
-  return true;
+  return width_ >= 3 && height_ >= 3;
 }
 
 bool SobelEdgeDetectionSeq::ValidationImpl() {
@@ -54,35 +54,23 @@ bool SobelEdgeDetectionSeq::RunImpl() {
     return false;
   }
 
-  size_t total_pixels = task_data->inputs_count[0];
-  auto width = static_cast<size_t>(std::sqrt(total_pixels));
-  auto height = width;
-
-  if (width < 3 || height < 3) {
+  if (width_ < 3 || height_ < 3) {
     return false;
   }
 
-  static constexpr int kSobelX[3][3] = {{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}};
-  static constexpr int kSobelY[3][3] = {{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}};
-
-  for (size_t y = 1; y < height - 1; ++y) {
-    for (size_t x = 1; x < width - 1; ++x) {
-      int32_t gx = 0;
-      int32_t gy = 0;
-
-      for (int ky = -1; ky <= 1; ++ky) {
-        for (int kx = -1; kx <= 1; ++kx) {
-          uint8_t pixel_value = input_image[((y + ky) * width) + (x + kx)];
-          gx += kSobelX[ky + 1][kx + 1] * pixel_value;
-          gy += kSobelY[ky + 1][kx + 1] * pixel_value;
-        }
-      }
-
-      int magnitude = static_cast<int>(std::sqrt(static_cast<double>((gx * gx) + (gy * gy))));
-      output_image[(y * width) + x] = static_cast<uint8_t>(std::min(std::max(magnitude, 0), 255));
-    }
+  const size_t radius = ppc::stencil::SobelRadius(options_);
+  if (height_ <= 2 * radius || width_ <= 2 * radius) {
+    std::fill_n(output_image, height_ * width_, 0);
+    return true;
   }
-
+  std::fill_n(output_image, radius * width_, 0);
+  std::fill_n(output_image + ((height_ - radius) * width_), radius * width_, 0);
+  for (size_t y = radius; y < height_ - radius; ++y) {
+    std::fill_n(output_image + (y * width_), radius, 0);
+    std::fill_n(output_image + ((y + 1) * width_) - radius, radius, 0);
+  }
+  ppc::stencil::Sobel(input_image + (radius * width_) + radius, width_, height_ - (2 * radius), width_ - (2 * radius),
+                      output_image + (radius * width_) + radius, width_, options_);
   return true;
 }
 
@@ -1,13 +1,35 @@
 // Copyright 2023 Nesterov Alexander
 #include <gtest/gtest.h>
 
+#include <climits>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "core/graph/include/graph.hpp"
 #include "core/task/include/task.hpp"
 #include "seq/shishkarev_a_dijkstra_algorithm/include/ops_seq.hpp"
 
+namespace {
+std::vector<int> RunEdgeList(std::vector<int> &edges, int n, int st,
+                             shishkarev_a_dijkstra_algorithm_seq::Queue queue) {
+  std::vector<int> res(n, 0);
+  std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
+  task_data_seq->AddInput(edges.data(), {edges.size() / 3, 3});
+  task_data_seq->AddInput(&st, {1});
+  task_data_seq->AddInput(&n, {1});
+  task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
+  task_data_seq->outputs_count.emplace_back(res.size());
+
+  shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential test_task_sequential(task_data_seq, queue);
+  EXPECT_TRUE(test_task_sequential.Validation());
+  test_task_sequential.PreProcessing();
+  test_task_sequential.Run();
+  test_task_sequential.PostProcessing();
+  return res;
+}
+}  // namespace
+
 TEST(shishkarev_a_dijkstra_algorithm_seq, Test_Graph_3x3) {
   int size = 3;
   int st = 0;
@@ -126,4 +148,64 @@ TEST(shishkarev_a_dijkstra_algorithm_seq, Test_Source_Vertex_False) {
   // Create Task
   shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential test_task_sequential(task_data_seq);
   ASSERT_FALSE(test_task_sequential.ValidationImpl());
-}
\ No newline at end of file
+}
+
+TEST(shishkarev_a_dijkstra_algorithm_seq, Test_Edge_List_Binary_And_Radix_Heap) {
+  int n = 300;
+  int st = 3;
+  std::vector<int> matrix;
+  std::vector<int> edges;
+  ppc::graph::GenerateSparseGraph(n, 4, 50, matrix, edges);
+
+  std::vector<int> res(n, 0);
+  std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
+  task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t *>(matrix.data()));
+  task_data_seq->inputs_count.emplace_back(matrix.size());
+  task_data_seq->inputs_count.emplace_back(n);
+  task_data_seq->inputs_count.emplace_back(st);
+  task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
+  task_data_seq->outputs_count.emplace_back(res.size());
+
+  shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential test_task_sequential(
+      task_data_seq, shishkarev_a_dijkstra_algorithm_seq::Queue::kBinaryHeap);
+  ASSERT_TRUE(test_task_sequential.Validation());
+  test_task_sequential.PreProcessing();
+  test_task_sequential.Run();
+  test_task_sequential.PostProcessing();
+
+  ASSERT_EQ(res, RunEdgeList(edges, n, st, shishkarev_a_dijkstra_algorithm_seq::Queue::kBinaryHeap));
+  ASSERT_EQ(res, RunEdgeList(edges, n, st, shishkarev_a_dijkstra_algorithm_seq::Queue::kRadixHeap));
+}
+
+TEST(shishkarev_a_dijkstra_algorithm_seq, Test_Edge_List_Zero_Weights_And_Unreachable) {
+  // vertex 4 is not reachable
+  std::vector<int> edges = {0, 1, 0, 1, 2, 5, 0, 2, 7, 2, 3, 0, 4, 0, 1};
+  std::vector<int> ans = {0, 0, 5, 5, INT_MAX};
+  ASSERT_EQ(ans, RunEdgeList(edges, 5, 0, shishkarev_a_dijkstra_algorithm_seq::Queue::kBinaryHeap));
+  ASSERT_EQ(ans, RunEdgeList(edges, 5, 0, shishkarev_a_dijkstra_algorithm_seq::Queue::kRadixHeap));
+}
+
+TEST(shishkarev_a_dijkstra_algorithm_seq, Test_Edge_List_Large_Weights) {
+  // the radix heap has to split its highest buckets
+  std::vector<int> edges = {0, 1, 2000000000, 0, 2, 1, 2, 1, 1999999998, 2, 3, 1000000000, 3, 1, 5};
+  std::vector<int> ans = {0, 1000000006, 1, 1000000001};
+  ASSERT_EQ(ans, RunEdgeList(edges, 4, 0, shishkarev_a_dijkstra_algorithm_seq::Queue::kBinaryHeap));
+  ASSERT_EQ(ans, RunEdgeList(edges, 4, 0, shishkarev_a_dijkstra_algorithm_seq::Queue::kRadixHeap));
+}
+
+TEST(shishkarev_a_dijkstra_algorithm_seq, Test_Edge_List_Negative_Weight) {
+  int size = 3;
+  int st = 0;
+  std::vector<int> edges = {0, 1, 2, 1, 2, -4};
+  std::vector<int> res(size, 0);
+
+  std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
+  task_data_seq->AddInput(edges.data(), {edges.size() / 3, 3});
+  task_data_seq->AddInput(&st, {1});
+  task_data_seq->AddInput(&size, {1});
+  task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(res.data()));
+  task_data_seq->outputs_count.emplace_back(res.size());
+
+  shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential test_task_sequential(task_data_seq);
+  ASSERT_FALSE(test_task_sequential.ValidationImpl());
+}
@@ -1,32 +1,37 @@
 // Copyright 2023 Nesterov Alexander
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <utility>
 #include <vector>
 
+#include "core/graph/include/graph.hpp"
 #include "core/task/include/task.hpp"
 
 namespace shishkarev_a_dijkstra_algorithm_seq {
 
-struct Matrix {
-  std::vector<int> values;
-  std::vector<int> col_index;
-  std::vector<int> row_ptr;
-};
-
-void ConvertToCrs(const std::vector<int>& w, Matrix& matrix, int n);
+using Matrix = ppc::graph::CsrGraph;
+using ppc::graph::ConvertEdgesToCrs;
+using ppc::graph::ConvertToCrs;
+using ppc::graph::Dijkstra;
+using ppc::graph::Queue;
 
+// Inputs: the adjacency matrix (inputs_count: n * n, n, source; 0 = no edge),
+// or an edge list {m, 3} of (from, to, weight), source {1} and vertex count {1}.
 class TestTaskSequential : public ppc::core::Task {
  public:
-  explicit TestTaskSequential(std::shared_ptr<ppc::core::TaskData> task_data) : Task(std::move(task_data)) {}
+  explicit TestTaskSequential(std::shared_ptr<ppc::core::TaskData> task_data, Queue queue = Queue::kRadixHeap)
+      : Task(std::move(task_data)), queue_(queue) {}
   bool PreProcessingImpl() override;
   bool ValidationImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
 
  private:
-  std::vector<int> input_;
+  Queue queue_;
+  Matrix matrix_;
   std::vector<int> res_;
   int st_{};
   int size_{};
@@ -2,34 +2,59 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <climits>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "core/graph/include/graph.hpp"
 #include "core/perf/include/perf.hpp"
 #include "core/task/include/task.hpp"
+#include "core/util/include/util.hpp"
 #include "seq/shishkarev_a_dijkstra_algorithm/include/ops_seq.hpp"
 
-TEST(shishkarev_a_dijkstra_algorithm_seq, test_PipelineRun) {
-  int count_size_vector = 5000;
-  int st = 0;
-  std::vector<int> global_matrix(count_size_vector * count_size_vector, 1);
-  std::vector<int32_t> global_path(count_size_vector, 1);
-
-  for (int i = 0; i < count_size_vector; i++) {
-    global_matrix[(i * count_size_vector) + i] = 0;
+namespace {
+// dist are the shortest distances from st iff no edge can be relaxed and every
+// reached vertex but st is reached by a tight edge
+bool AreShortestDistances(const std::vector<int> &edges, int st, const std::vector<int> &dist) {
+  std::vector<bool> tight(dist.size(), false);
+  tight[st] = dist[st] == 0;
+  for (size_t i = 0; i < edges.size(); i += 3) {
+    if (dist[edges[i]] == INT_MAX) {
+      continue;
+    }
+    const int64_t candidate = static_cast<int64_t>(dist[edges[i]]) + edges[i + 2];
+    if (candidate < dist[edges[i + 1]]) {
+      return false;
+    }
+    if (candidate == dist[edges[i + 1]]) {
+      tight[edges[i + 1]] = true;
+    }
   }
-  global_path[0] = 0;
+  for (size_t v = 0; v < dist.size(); v++) {
+    if (dist[v] != INT_MAX && !tight[v]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RunPerf(shishkarev_a_dijkstra_algorithm_seq::Queue queue, bool pipeline) {
+  int n = static_cast<int>(ppc::util::GetScaledPerfSize(1 << 20));
+  int st = 0;
+  std::vector<int> edges = ppc::graph::GenerateRandomEdges(n, 4, 1000, 42);
+  std::vector<int32_t> global_path(n, 0);
 
   std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
-  task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t *>(global_matrix.data()));
-  task_data_seq->inputs_count.emplace_back(global_matrix.size());
-  task_data_seq->inputs_count.emplace_back(count_size_vector);
-  task_data_seq->inputs_count.emplace_back(st);
+  task_data_seq->AddInput(edges.data(), {edges.size() / 3, 3});
+  task_data_seq->AddInput(&st, {1});
+  task_data_seq->AddInput(&n, {1});
   task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(global_path.data()));
   task_data_seq->outputs_count.emplace_back(global_path.size());
 
-  auto test_task_sequential = std::make_shared<shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential>(task_data_seq);
+  auto test_task_sequential =
+      std::make_shared<shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential>(task_data_seq, queue);
 
   auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
   perf_attr->num_running = 10;
@@ -41,47 +66,30 @@ TEST(shishkarev_a_dijkstra_algorithm_seq, test_PipelineRun) {
   };
 
   auto perf_results = std::make_shared<ppc::core::PerfResults>();
+  // the radix heap is the default queue and keeps the plain pipeline/task_run keys
+  if (queue == shishkarev_a_dijkstra_algorithm_seq::Queue::kBinaryHeap) {
+    perf_results->variant = "binary_heap";
+  }
 
   auto perf_analyzer = std::make_shared<ppc::core::Perf>(test_task_sequential);
-  perf_analyzer->PipelineRun(perf_attr, perf_results);
+  if (pipeline) {
+    perf_analyzer->PipelineRun(perf_attr, perf_results);
+  } else {
+    perf_analyzer->TaskRun(perf_attr, perf_results);
+  }
   ppc::core::Perf::PrintPerfStatistic(perf_results);
-  ASSERT_EQ(1, global_path[1]);
+  ASSERT_TRUE(AreShortestDistances(edges, st, global_path));
 }
+}  // namespace
 
-TEST(shishkarev_a_dijkstra_algorithm_seq, test_task_run) {
-  int count_size_vector = 5000;
-  int st = 0;
-  std::vector<int> global_matrix(count_size_vector * count_size_vector, 1);
-  std::vector<int32_t> global_path(count_size_vector, 1);
-
-  for (int i = 0; i < count_size_vector; i++) {
-    global_matrix[(i * count_size_vector) + i] = 0;
-  }
-  global_path[0] = 0;
-
-  std::shared_ptr<ppc::core::TaskData> task_data_seq = std::make_shared<ppc::core::TaskData>();
-  task_data_seq->inputs.emplace_back(reinterpret_cast<uint8_t *>(global_matrix.data()));
-  task_data_seq->inputs_count.emplace_back(global_matrix.size());
-  task_data_seq->inputs_count.emplace_back(count_size_vector);
-  task_data_seq->inputs_count.emplace_back(st);
-  task_data_seq->outputs.emplace_back(reinterpret_cast<uint8_t *>(global_path.data()));
-  task_data_seq->outputs_count.emplace_back(global_path.size());
-
-  auto test_task_sequential = std::make_shared<shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential>(task_data_seq);
-
-  auto perf_attr = std::make_shared<ppc::core::PerfAttr>();
-  perf_attr->num_running = 10;
-  const auto t0 = std::chrono::high_resolution_clock::now();
-  perf_attr->current_timer = [&] {
-    auto current_time_point = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(current_time_point - t0).count();
-    return static_cast<double>(duration) * 1e-9;
-  };
+TEST(shishkarev_a_dijkstra_algorithm_seq, test_PipelineRun) {
+  RunPerf(shishkarev_a_dijkstra_algorithm_seq::Queue::kRadixHeap, true);
+}
 
-  auto perf_results = std::make_shared<ppc::core::PerfResults>();
+TEST(shishkarev_a_dijkstra_algorithm_seq, test_task_run) {
+  RunPerf(shishkarev_a_dijkstra_algorithm_seq::Queue::kRadixHeap, false);
+}
 
-  auto perf_analyzer = std::make_shared<ppc::core::Perf>(test_task_sequential);
-  perf_analyzer->TaskRun(perf_attr, perf_results);
-  ppc::core::Perf::PrintPerfStatistic(perf_results);
-  ASSERT_EQ(1, global_path[1]);
+TEST(shishkarev_a_dijkstra_algorithm_seq, test_task_run_binary_heap) {
+  RunPerf(shishkarev_a_dijkstra_algorithm_seq::Queue::kBinaryHeap, false);
 }
\ No newline at end of file
@@ -2,40 +2,62 @@
 #include "seq/shishkarev_a_dijkstra_algorithm/include/ops_seq.hpp"
 
 #include <algorithm>
-#include <limits>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
-void shishkarev_a_dijkstra_algorithm_seq::ConvertToCrs(const std::vector<int>& w, Matrix& matrix, int n) {
-  matrix.row_ptr.resize(n + 1);
-  int nnz = 0;
-
-  for (int i = 0; i < n; i++) {
-    matrix.row_ptr[i] = nnz;
-    for (int j = 0; j < n; j++) {
-      int weight = w[(i * n) + j];
-      if (weight != 0) {
-        matrix.values.emplace_back(weight);
-        matrix.col_index.emplace_back(j);
-        nnz++;
-      }
+#include "core/task/include/task.hpp"
+
+namespace {
+
+// inputs: edge list {m, 3} of (from, to, weight >= 0), source {1} and vertex count {1}
+bool IsValidEdgeList(const ppc::core::TaskData& task_data) {
+  auto shape = task_data.InputShape(0);
+  if (shape.size() != 2 || shape[1] != 3 || task_data.InputShape(1) != std::vector<uint64_t>{1} ||
+      task_data.InputShape(2) != std::vector<uint64_t>{1}) {
+    return false;
+  }
+
+  int n = task_data.InputView<const int>(2).At(0);
+  int st = task_data.InputView<const int>(1).At(0);
+  if (n < 1 || st < 0 || st >= n) {
+    return false;
+  }
+
+  auto edges = task_data.InputView<const int>(0).Span();
+  for (size_t i = 0; i < edges.size(); i += 3) {
+    if (edges[i] < 0 || edges[i] >= n || edges[i + 1] < 0 || edges[i + 1] >= n || edges[i + 2] < 0) {
+      return false;
     }
   }
-  matrix.row_ptr[n] = nnz;
+
+  return task_data.outputs.size() == 1 && task_data.outputs[0] != nullptr &&
+         task_data.outputs_count[0] == static_cast<uint64_t>(n);
 }
 
-bool shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential::PreProcessingImpl() {
-  size_ = static_cast<int>(task_data->inputs_count[1]);
-  st_ = static_cast<int>(task_data->inputs_count[2]);
+}  // namespace
 
-  input_ = std::vector<int>(size_ * size_);
-  auto* tmp_ptr = reinterpret_cast<int*>(task_data->inputs[0]);
-  input_.assign(tmp_ptr, tmp_ptr + task_data->inputs_count[0]);
+bool shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential::PreProcessingImpl() {
+  if (task_data->inputs.size() == 3) {
+    size_ = task_data->InputView<const int>(2).At(0);
+    st_ = task_data->InputView<const int>(1).At(0);
+    ConvertEdgesToCrs(task_data->InputView<const int>(0).Span(), matrix_, size_);
+  } else {
+    size_ = static_cast<int>(task_data->inputs_count[1]);
+    st_ = static_cast<int>(task_data->inputs_count[2]);
+    auto* tmp_ptr = reinterpret_cast<int*>(task_data->inputs[0]);
+    ConvertToCrs({tmp_ptr, task_data->inputs_count[0]}, matrix_, size_);
+  }
 
   res_ = std::vector<int>(size_, 0);
   return true;
 }
 
 bool shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential::ValidationImpl() {
+  if (task_data->inputs.size() == 3) {
+    return IsValidEdgeList(*task_data);
+  }
+
   if (task_data->inputs.empty()) {
     return false;
   }
@@ -62,43 +84,7 @@ bool shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential::ValidationImpl() {
 }
 
 bool shishkarev_a_dijkstra_algorithm_seq::TestTaskSequential::RunImpl() {
-  const int inf = std::numeric_limits<int>::max();
-  Matrix matrix;
-  ConvertToCrs(input_, matrix, size_);
-
-  std::vector<bool> visited(size_, false);
-  std::vector<int> d(size_, inf);
-  d[st_] = 0;
-
-  for (int i = 0; i < size_; i++) {
-    int min = inf;
-    int index = -1;
-    for (int j = 0; j < size_; j++) {
-      if (!visited[j] && d[j] < min) {
-        min = d[j];
-        index = j;
-      }
-    }
-
-    if (index == -1) {
-      break;
-    }
-
-    int u = index;
-    visited[u] = true;
-
-    for (int j = matrix.row_ptr[u]; j < matrix.row_ptr[u + 1]; j++) {
-      int v = matrix.col_index[j];
-      int weight = matrix.values[j];
-
-      if (!visited[v] && d[u] != inf && (d[u] + weight < d[v])) {
-        d[v] = d[u] + weight;
-      }
-    }
-  }
-
-  res_ = d;
-
+  Dijkstra(matrix_, st_, queue_, res_);
   return true;
 }
 
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <queue>
 #include <utility>
 #include <vector>
 
@@ -8,20 +7,8 @@
 
 namespace solovev_a_binary_image_marking {
 
-struct Point {
-  int x, y;
-};
-
-using Matrix = std::vector<int>;
-using Directions = std::vector<Point>;
-
-void Bfs(int i, int j, int label, Matrix& labels_tmp, const Matrix& data_tmp, int m_tmp, int n_tmp,
-         const Directions& directions);
-void ProcessNeighbor(std::queue<Point>& q, int new_x, int new_y, Matrix& labels_tmp, const Matrix& data_tmp, int label,
-                     int n_tmp);
-bool ShouldProcess(int i, int j, const Matrix& data_tmp, const Matrix& labels_tmp, int n_tmp);
-bool IsValid(int x, int y, int m_tmp, int n_tmp);
-
+// Labels the 4-connected components of nonzero pixels with 1, 2, ... in raster
+// order of their first pixel, zero pixels get 0.
 class TestTaskSequential : public ppc::core::Task {
  public:
   explicit TestTaskSequential(ppc::core::TaskDataPtr task_data) : Task(std::move(task_data)) {}
@@ -1,48 +1,10 @@
 #include <algorithm>
-#include <queue>
+#include <span>
 #include <vector>
 
+#include "core/ccl/include/ccl.hpp"
 #include "seq/solovev_a_binary_image_marking/include/ops_sec.hpp"
 
-bool solovev_a_binary_image_marking::ShouldProcess(int i, int j, const Matrix &data_tmp, const Matrix &labels_tmp,
-                                                   int n_tmp) {
-  return data_tmp[(i * n_tmp) + j] == 1 && labels_tmp[(i * n_tmp) + j] == 0;
-}
-
-bool solovev_a_binary_image_marking::IsValid(int x, int y, int m_tmp, int n_tmp) {
-  return x >= 0 && x < m_tmp && y >= 0 && y < n_tmp;
-}
-
-void solovev_a_binary_image_marking::ProcessNeighbor(std::queue<Point> &q, int new_x, int new_y, Matrix &labels_tmp,
-                                                     const Matrix &data_tmp, int label, int n_tmp) {
-  int new_idx = (new_x * n_tmp) + new_y;
-  if (data_tmp[new_idx] == 1 && labels_tmp[new_idx] == 0) {
-    labels_tmp[new_idx] = label;
-    q.push({new_x, new_y});
-  }
-}
-
-void solovev_a_binary_image_marking::Bfs(int i, int j, int label, Matrix &labels_tmp, const Matrix &data_tmp, int m_tmp,
-                                         int n_tmp, const Directions &directions) {
-  std::queue<Point> q;
-  q.push({i, j});
-  labels_tmp[(i * n_tmp) + j] = label;
-
-  while (!q.empty()) {
-    Point current = q.front();
-    q.pop();
-
-    for (const Point &dir : directions) {
-      int new_x = current.x + dir.x;
-      int new_y = current.y + dir.y;
-
-      if (IsValid(new_x, new_y, m_tmp, n_tmp)) {
-        ProcessNeighbor(q, new_x, new_y, labels_tmp, data_tmp, label, n_tmp);
-      }
-    }
-  }
-}
-
 bool solovev_a_binary_image_marking::TestTaskSequential::PreProcessingImpl() {
   int m_tmp = *reinterpret_cast<int *>(task_data->inputs[0]);
   int n_tmp = *reinterpret_cast<int *>(task_data->inputs[1]);
@@ -80,18 +42,8 @@ bool solovev_a_binary_image_marking::TestTaskSequential::ValidationImpl() {
 }
 
 bool solovev_a_binary_image_marking::TestTaskSequential::RunImpl() {
-  Directions directions = {{.x = -1, .y = 0}, {.x = 1, .y = 0}, {.x = 0, .y = -1}, {.x = 0, .y = 1}};
-  int label = 1;
-
-  for (int i = 0; i < m_; ++i) {
-    for (int j = 0; j < n_; ++j) {
-      if (ShouldProcess(i, j, data_, labels_, n_)) {
-        Bfs(i, j, label, labels_, data_, m_, n_, directions);
-        ++label;
-      }
-    }
-  }
-
+  ppc::ccl::LabelComponents(std::span<const int>(data_), m_, n_, std::span<int>(labels_),
+                            {.connectivity = ppc::ccl::Connectivity::k4});
   return true;
 }
 